@@ -0,0 +1,102 @@
+/**
+ * @file HttpBenchmarks.cpp
+ * @brief Request parsing and response serving for the local Twitch endpoints
+ *
+ *   BM_ParseRequest      the game's OAuth2 authorize request, line and headers
+ *   BM_ParseQuery        its query string, decoded
+ *   BM_ServeFormatted    formatting a response for every request
+ *   BM_ServeCached       a ResponseCache hit, copied out as a socket write would
+ *   BM_Route             parse and dispatch through HttpServer's route table
+ *
+ * Argument "body" is the response body size in bytes.
+ */
+
+#include "HttpMessage.h"
+#include "HttpRouter.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+const std::string AUTHORIZE_REQUEST =
+    "GET /kraken/oauth2/authorize?client_id=ffxvwindowsedition0001&redirect_uri=http%3A%2F%2Flocalhost%3A443"
+    "%2Fcallback&response_type=token&scope=user_read%20user_subscriptions&state=4f2d8c1a HTTP/1.1\r\n"
+    "Host: localhost:443\r\n"
+    "User-Agent: Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko)\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Encoding: gzip, deflate\r\n"
+    "Accept-Language: en-US,en;q=0.9\r\n"
+    "Connection: keep-alive\r\n"
+    "\r\n";
+
+void BM_ParseRequest(benchmark::State& state)
+{
+    Http::Request request;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Http::parseRequest(AUTHORIZE_REQUEST, request));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * AUTHORIZE_REQUEST.size()));
+}
+BENCHMARK(BM_ParseRequest);
+
+void BM_ParseQuery(benchmark::State& state)
+{
+    Http::Request request;
+    Http::parseRequest(AUTHORIZE_REQUEST, request);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Http::parseQuery(request.query));
+    }
+}
+BENCHMARK(BM_ParseQuery);
+
+void BM_ServeFormatted(benchmark::State& state)
+{
+    std::string body(static_cast<size_t>(state.range(0)), 'x');
+    std::string socket;
+    for (auto _ : state) {
+        socket = Http::formatResponse(200, "OK", body, "text/html");
+        benchmark::DoNotOptimize(socket.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * socket.size()));
+}
+BENCHMARK(BM_ServeFormatted)->ArgName("body")->Arg(64)->Arg(4096)->Arg(65536);
+
+void BM_ServeCached(benchmark::State& state)
+{
+    const std::string key = "/kraken/commerce/user/goods";
+    Http::ResponseCache cache;
+    cache.store(key, Http::formatResponse(200, "OK", std::string(static_cast<size_t>(state.range(0)), 'x'),
+                                          "text/html"));
+    std::string socket;
+    for (auto _ : state) {
+        socket.assign(*cache.find(key));
+        benchmark::DoNotOptimize(socket.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * socket.size()));
+}
+BENCHMARK(BM_ServeCached)->ArgName("body")->Arg(64)->Arg(4096)->Arg(65536);
+
+void BM_Route(benchmark::State& state)
+{
+    // HttpServer's table; the handlers return prepared responses
+    const std::string page = Http::formatResponse(200, "OK", std::string(4096, 'x'), "text/html");
+    Http::Router router;
+    router.add("GET", "/kraken/oauth2/authorize", [&](const Http::Request& request) {
+        return Http::redirectResponse(Http::parseQuery(request.query)["redirect_uri"]);
+    });
+    router.add("GET", "/login", [&](const Http::Request&) { return page; });
+    router.add("GET", "/blog/", [&](const Http::Request&) { return page; });
+    router.add("POST", "/kraken/commerce/user/goods", [&](const Http::Request&) { return page; });
+    router.add("GET", "/metrics", [&](const Http::Request&) { return page; });
+    router.setFallback([&](const Http::Request&) { return page; });
+
+    Http::Request request;
+    for (auto _ : state) {
+        Http::parseRequest(AUTHORIZE_REQUEST, request);
+        std::string socket = router.route(request);
+        benchmark::DoNotOptimize(socket.data());
+    }
+}
+BENCHMARK(BM_Route);
+
+} // namespace
@@ -0,0 +1,163 @@
+/**
+ * @file ScanBenchmarks.cpp
+ * @brief Pattern matching, chunked scans and multi-pattern scans
+ *
+ *   BM_MatchEveryOffset     matchAt at every offset of a 64 KB chunk
+ *   BM_FirstBytePrefilter   the first-byte check PatternScanner used before ScanEngine
+ *   BM_FindInBuffer         ScanEngine's memchr on the anchor byte
+ *   BM_FindPattern          a missing pattern over a whole synthetic module (64 MB - 1 GB)
+ *   BM_FindEachPattern      every built-in pattern, one scan each, as attach without hints
+ *   BM_FindPatternsOnePass  the same patterns in one pass
+ *
+ * Argument "masked" 1 uses the Phase 4 table reference (operand wildcarded),
+ * 0 the Unlock 1 pattern; both with their last byte changed so they are
+ * never found and every offset is considered.
+ */
+
+#include "ScanEngine.h"
+#include "SyntheticTarget.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+struct MissingPattern {
+    std::vector<uint8_t> pattern;
+    std::vector<uint8_t> mask;
+};
+
+MissingPattern missingPattern(bool masked)
+{
+    MissingPattern missing;
+    if (masked) {
+        missing.pattern = Patches::UNLOCK_TABLE_REFERENCE.pattern.toVector();
+        missing.mask = Patches::UNLOCK_TABLE_REFERENCE.mask.toVector();
+    } else {
+        missing.pattern = Patches::UNLOCK1_BOUNDS_BYPASS.pattern.toVector();
+    }
+    missing.pattern.back() ^= 0x5A;
+    if (!missing.mask.empty()) missing.mask.back() = 0xFF;
+    return missing;
+}
+
+/// The first chunk of .text: pseudo-random, like code to a byte matcher
+const std::vector<uint8_t>& textChunk()
+{
+    static const std::vector<uint8_t> chunk = [] {
+        SyntheticImage::Image image;
+        SyntheticImage::build(SyntheticImage::MIN_SIZE, Patches::DEFAULT_IMAGE_BASE, image);
+        auto text = image.bytes.begin() + SyntheticImage::TEXT_RVA;
+        return std::vector<uint8_t>(text, text + Scan::CHUNK_SIZE);
+    }();
+    return chunk;
+}
+
+std::vector<Scan::Pattern> builtInPatterns()
+{
+    std::vector<Scan::Pattern> patterns;
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        patterns.push_back({patch->pattern, patch->mask});
+    }
+    for (const Patches::OperandReference* reference :
+         {&Patches::UNLOCK_TABLE_REFERENCE, &Patches::JUMP_TABLE_REFERENCE}) {
+        patterns.push_back({reference->pattern, reference->mask});
+    }
+    return patterns;
+}
+
+void BM_MatchEveryOffset(benchmark::State& state)
+{
+    MissingPattern missing = missingPattern(state.range(0) != 0);
+    const std::vector<uint8_t>& chunk = textChunk();
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (size_t i = 0; i + missing.pattern.size() <= chunk.size(); ++i) {
+            matches += Scan::matchAt(chunk.data(), chunk.size(), missing.pattern, missing.mask, i);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * chunk.size()));
+}
+BENCHMARK(BM_MatchEveryOffset)->ArgName("masked")->Arg(0)->Arg(1);
+
+void BM_FirstBytePrefilter(benchmark::State& state)
+{
+    MissingPattern missing = missingPattern(state.range(0) != 0);
+    ByteView pattern(missing.pattern), mask(missing.mask);
+    const std::vector<uint8_t>& chunk = textChunk();
+    uint8_t firstMask = mask.empty() ? 0xFF : mask[0];
+    uint8_t first = pattern[0] & firstMask;
+    for (auto _ : state) {
+        size_t matches = 0;
+        for (size_t i = 0; i + pattern.size <= chunk.size(); ++i) {
+            if ((chunk[i] & firstMask) != first) continue;
+            matches += Scan::matchAt(chunk.data(), chunk.size(), pattern, mask, i);
+        }
+        benchmark::DoNotOptimize(matches);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * chunk.size()));
+}
+BENCHMARK(BM_FirstBytePrefilter)->ArgName("masked")->Arg(0)->Arg(1);
+
+void BM_FindInBuffer(benchmark::State& state)
+{
+    MissingPattern missing = missingPattern(state.range(0) != 0);
+    const std::vector<uint8_t>& chunk = textChunk();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Scan::findInBuffer(chunk.data(), chunk.size(), missing.pattern, missing.mask));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * chunk.size()));
+}
+BENCHMARK(BM_FindInBuffer)->ArgName("masked")->Arg(0)->Arg(1);
+
+void BM_FindPattern(benchmark::State& state)
+{
+    size_t size = static_cast<size_t>(state.range(0)) * Bench::MB;
+    MissingPattern missing = missingPattern(state.range(1) != 0);
+    InMemoryBackend& target = Bench::syntheticTarget(size);
+    MemoryReader read = target.reader();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Scan::findPattern(read, target.base(), size, missing.pattern, missing.mask));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * size));
+    state.counters["reads"] = benchmark::Counter(static_cast<double>(target.readCalls()),
+                                                 benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FindPattern)
+    ->ArgNames({"MB", "masked"})
+    ->ArgsProduct({{64, 256, 1024}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_FindEachPattern(benchmark::State& state)
+{
+    size_t size = static_cast<size_t>(state.range(0)) * Bench::MB;
+    std::vector<Scan::Pattern> patterns = builtInPatterns();
+    InMemoryBackend& target = Bench::syntheticTarget(size);
+    MemoryReader read = target.reader();
+    for (auto _ : state) {
+        for (const Scan::Pattern& pattern : patterns) {
+            benchmark::DoNotOptimize(Scan::findPattern(read, target.base(), size, pattern.pattern, pattern.mask));
+        }
+    }
+    state.counters["patterns"] = static_cast<double>(patterns.size());
+    state.counters["reads"] = benchmark::Counter(static_cast<double>(target.readCalls()),
+                                                 benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FindEachPattern)->ArgName("MB")->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+void BM_FindPatternsOnePass(benchmark::State& state)
+{
+    size_t size = static_cast<size_t>(state.range(0)) * Bench::MB;
+    std::vector<Scan::Pattern> patterns = builtInPatterns();
+    InMemoryBackend& target = Bench::syntheticTarget(size);
+    MemoryReader read = target.reader();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Scan::findPatterns(read, target.base(), size, patterns));
+    }
+    state.counters["patterns"] = static_cast<double>(patterns.size());
+    state.counters["reads"] = benchmark::Counter(static_cast<double>(target.readCalls()),
+                                                 benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FindPatternsOnePass)->ArgName("MB")->Arg(64)->Arg(256)->Arg(1024)->Unit(benchmark::kMillisecond);
+
+} // namespace
@@ -0,0 +1,126 @@
+/**
+ * @file SessionBenchmarks.cpp
+ * @brief SessionManager over several copies of the synthetic module
+ *
+ * Every target is its own InMemoryBackend holding the same build, as
+ * several instances of one game install would. Argument "targets" is how
+ * many; "threads" the manager's limit (0 = one per target).
+ *
+ *   BM_PrepareTargets   fingerprint, look up and verify every target; counter
+ *                       "scans" stays 1 however many targets share the build
+ *   BM_ApplyTargets     every code patch and table byte on every target, at
+ *                       1 µs per emulated syscall
+ */
+
+#include "SessionManager.h"
+#include "SyntheticImage.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+/// A target the manager can own while the copy itself stays with the benchmark
+class TargetView : public MemoryBackend {
+public:
+    explicit TargetView(InMemoryBackend& target) : m_target(target) {}
+
+    size_t read(uintptr_t address, void* buffer, size_t size) const override
+    {
+        return m_target.read(address, buffer, size);
+    }
+    bool writeProtected(uintptr_t address, ByteView data) override
+    {
+        return m_target.writeProtected(address, data);
+    }
+
+private:
+    InMemoryBackend& m_target;
+};
+
+constexpr size_t MAX_TARGETS = 8;
+
+/// Copies of a freshly built synthetic module, made once; the write
+/// benchmarks' shared target may hold their patches
+std::vector<std::unique_ptr<InMemoryBackend>>& targetCopies()
+{
+    static std::vector<std::unique_ptr<InMemoryBackend>> copies = [] {
+        std::vector<std::unique_ptr<InMemoryBackend>> copies;
+        SyntheticImage::Image image;
+        SyntheticImage::build(SyntheticImage::MIN_SIZE, Patches::DEFAULT_IMAGE_BASE, image);
+        for (size_t i = 0; i < MAX_TARGETS; ++i) {
+            copies.push_back(std::make_unique<InMemoryBackend>(Patches::DEFAULT_IMAGE_BASE, image.bytes));
+        }
+        return copies;
+    }();
+    return copies;
+}
+
+const std::vector<Patches::Patch*>& codePatches()
+{
+    static const std::vector<Patches::Patch*> patches = [] {
+        std::vector<Patches::Patch*> patches;
+        for (Patches::Patch* patch : Patches::getAllPatches()) {
+            if (patch->section != Patches::SectionHint::RData) patches.push_back(patch);
+        }
+        return patches;
+    }();
+    return patches;
+}
+
+void addTargets(SessionManager& manager, size_t count, std::chrono::nanoseconds syscallCost)
+{
+    auto& copies = targetCopies();
+    for (size_t i = 0; i < count; ++i) {
+        copies[i]->setSyscallCost(syscallCost);
+        manager.add("target " + std::to_string(i), std::make_unique<TargetView>(*copies[i]),
+                    copies[i]->base(), copies[i]->bytes().size());
+    }
+}
+
+void BM_PrepareTargets(benchmark::State& state)
+{
+    const std::vector<Patches::Patch*>& patches = codePatches();
+    size_t targets = static_cast<size_t>(state.range(0));
+    size_t ready = 0;
+    size_t scans = 0;
+    for (auto _ : state) {
+        SessionManager manager(static_cast<unsigned>(state.range(1)));
+        addTargets(manager, targets, std::chrono::nanoseconds(0));
+        ready = manager.prepare(patches);
+        scans = manager.scansRun();
+    }
+    if (ready != targets) state.SkipWithError("Not every target prepared");
+    state.counters["scans"] = static_cast<double>(scans);
+}
+BENCHMARK(BM_PrepareTargets)
+    ->ArgNames({"targets", "threads"})
+    ->Args({1, 0})->Args({4, 1})->Args({4, 0})->Args({8, 0})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+void BM_ApplyTargets(benchmark::State& state)
+{
+    const std::vector<Patches::Patch*>& patches = codePatches();
+    size_t targets = static_cast<size_t>(state.range(0));
+    SessionManager manager(static_cast<unsigned>(state.range(1)));
+    addTargets(manager, targets, std::chrono::microseconds(1));
+    if (manager.prepare(patches) != targets) {
+        state.SkipWithError("Not every target prepared");
+        return;
+    }
+
+    UnlockRegistry registry;
+    registry.rebuild();
+    UnlockMask mask = registry.itemMask();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.apply(patches, mask));
+    }
+    manager.restore(patches);
+}
+BENCHMARK(BM_ApplyTargets)
+    ->ArgNames({"targets", "threads"})
+    ->Args({1, 0})->Args({8, 1})->Args({8, 0})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+} // namespace
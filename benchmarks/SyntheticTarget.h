@@ -0,0 +1,40 @@
+/**
+ * @file SyntheticTarget.h
+ * @brief The synthetic game module the benchmarks scan and write
+ */
+
+#pragma once
+
+#include "MemoryBackend.h"
+#include "Patches.h"
+#include "SyntheticImage.h"
+
+#include <memory>
+
+namespace Bench {
+
+constexpr size_t MB = 1024 * 1024;
+
+/**
+ * @brief An InMemoryBackend holding a SyntheticImage of the given size
+ *
+ * Only the most recent size is kept: building a 1 GB image takes a while,
+ * and keeping every size alive would not fit small runners.
+ */
+inline InMemoryBackend& syntheticTarget(size_t size)
+{
+    static std::unique_ptr<InMemoryBackend> target;
+    static size_t targetSize = 0;
+    if (!target || targetSize != size) {
+        target.reset();
+        SyntheticImage::Image image;
+        SyntheticImage::build(size, Patches::DEFAULT_IMAGE_BASE, image);
+        target = std::make_unique<InMemoryBackend>(Patches::DEFAULT_IMAGE_BASE, std::move(image.bytes));
+        targetSize = size;
+    }
+    target->resetCounters();
+    target->setSyscallCost(std::chrono::nanoseconds(0));
+    return *target;
+}
+
+} // namespace Bench
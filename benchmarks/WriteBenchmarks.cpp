@@ -0,0 +1,121 @@
+/**
+ * @file WriteBenchmarks.cpp
+ * @brief Applying a full profile: per-byte, per-write and coalesced writes
+ *
+ * The profile is every code patch site plus every unlock table byte, found
+ * in a synthetic module held by an InMemoryBackend. Argument "syscall_ns"
+ * is the cost charged per emulated syscall (0 = the bookkeeping alone);
+ * counter "syscalls" is what the Windows backend would make per apply.
+ *
+ *   BM_ApplyPerByte      one protected write per byte
+ *   BM_ApplyPerWrite     one protected write per patch site or table byte
+ *   BM_ApplyCoalesced    one WriteTransaction, neighbours merged
+ */
+
+#include "ScanEngine.h"
+#include "SyntheticTarget.h"
+#include "UnlockRegistry.h"
+#include "WriteTransaction.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+struct Write {
+    uintptr_t address;
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> original;
+};
+
+/// Located once, before any benchmark writes to the target
+const std::vector<Write>& profileWrites()
+{
+    static const std::vector<Write> writes = [] {
+        std::vector<Write> writes;
+        InMemoryBackend& target = Bench::syntheticTarget(SyntheticImage::MIN_SIZE);
+        MemoryReader read = target.reader();
+        for (const Patches::Patch* patch : Patches::getAllPatches()) {
+            if (patch->section == Patches::SectionHint::RData) continue;
+            auto match = Scan::findPattern(read, target.base(), target.bytes().size(), patch->pattern, patch->mask);
+            if (match) writes.push_back({*match + patch->offset, patch->patched.toVector(), patch->original.toVector()});
+        }
+        uintptr_t table = target.base() + (Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+        UnlockRegistry registry;
+        registry.rebuild();
+        for (size_t i = 0; i < registry.itemCount(); ++i) {
+            writes.push_back({table + registry.itemId(i), {1}, {0}});
+        }
+        return writes;
+    }();
+    return writes;
+}
+
+void setCounters(benchmark::State& state, const InMemoryBackend& target, size_t writes)
+{
+    state.counters["writes"] = static_cast<double>(writes);
+    state.counters["syscalls"] = benchmark::Counter(static_cast<double>(target.syscalls()),
+                                                    benchmark::Counter::kAvgIterations);
+}
+
+/// Puts the original bytes back; the target is shared with the other benchmarks
+void restoreTarget(InMemoryBackend& target)
+{
+    for (const Write& write : profileWrites()) {
+        target.writeProtected(write.address, write.original);
+    }
+}
+
+InMemoryBackend& costedTarget(benchmark::State& state)
+{
+    InMemoryBackend& target = Bench::syntheticTarget(SyntheticImage::MIN_SIZE);
+    target.setSyscallCost(std::chrono::nanoseconds(state.range(0)));
+    return target;
+}
+
+void BM_ApplyPerByte(benchmark::State& state)
+{
+    const std::vector<Write>& writes = profileWrites();
+    InMemoryBackend& target = costedTarget(state);
+    for (auto _ : state) {
+        for (const Write& write : writes) {
+            for (size_t i = 0; i < write.bytes.size(); ++i) {
+                target.writeProtected(write.address + i, ByteView(&write.bytes[i], 1));
+            }
+        }
+    }
+    setCounters(state, target, writes.size());
+    restoreTarget(target);
+}
+BENCHMARK(BM_ApplyPerByte)->ArgName("syscall_ns")->Arg(0)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+void BM_ApplyPerWrite(benchmark::State& state)
+{
+    const std::vector<Write>& writes = profileWrites();
+    InMemoryBackend& target = costedTarget(state);
+    for (auto _ : state) {
+        for (const Write& write : writes) {
+            target.writeProtected(write.address, write.bytes);
+        }
+    }
+    setCounters(state, target, writes.size());
+    restoreTarget(target);
+}
+BENCHMARK(BM_ApplyPerWrite)->ArgName("syscall_ns")->Arg(0)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+void BM_ApplyCoalesced(benchmark::State& state)
+{
+    const std::vector<Write>& writes = profileWrites();
+    InMemoryBackend& target = costedTarget(state);
+    for (auto _ : state) {
+        WriteTransaction transaction;
+        for (const Write& write : writes) {
+            transaction.add(write.address, write.bytes);
+        }
+        benchmark::DoNotOptimize(transaction.commit(target));
+    }
+    setCounters(state, target, writes.size());
+    restoreTarget(target);
+}
+BENCHMARK(BM_ApplyCoalesced)->ArgName("syscall_ns")->Arg(0)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+} // namespace
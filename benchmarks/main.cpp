@@ -0,0 +1,25 @@
+/**
+ * @file main.cpp
+ * @brief Benchmark runner; tags results with the version and build options
+ *
+ * Run with --benchmark_out=<file> --benchmark_out_format=json (or build the
+ * bench_json target) for results that can be compared between releases.
+ */
+
+#include "ScanStats.h"
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char* argv[])
+{
+    benchmark::AddCustomContext("ffxv_version", FFXV_VERSION);
+    benchmark::AddCustomContext("scan_stats", ScanStats::ENABLED ? "on" : "off");
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
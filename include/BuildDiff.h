@@ -0,0 +1,138 @@
+/**
+ * @file BuildDiff.h
+ * @brief Aligns two builds of an executable and maps addresses between them
+ *
+ * When ffxv_s.exe is updated every patch site and table address has to be
+ * found again. BuildDiff carries them over from a build where they are known:
+ *
+ *   1. Functions come from the exception table (.pdata), which lists every
+ *      non-leaf function in an x64 image. Each is decoded into instructions,
+ *      hashed with displacements, rel32 targets and 64-bit immediates masked
+ *      out (the bytes that change when code moves, as in SignatureGenerator).
+ *   2. Functions are matched: first by identical normalised hash, then by
+ *      rolling-hash anchors (a hash over every ANCHOR_INSTRUCTIONS consecutive
+ *      instructions, winnowed to the minimum of each ANCHOR_WINDOW), voted
+ *      across functions, and finally by position between matched neighbours.
+ *   3. Each matched pair is aligned instruction by instruction (longest common
+ *      subsequence over the normalised hashes, after trimming the common
+ *      prefix and suffix).
+ *
+ * A code address maps through its instruction's alignment. A data address
+ * maps through the code that references it: every instruction referencing
+ * near it in the old build is mapped to the new build, its new target read
+ * back, and the candidates voted on. Each mapping carries a confidence in
+ * [0, 1]: the function match score, reduced for instructions that only
+ * align after normalisation or are interpolated from a neighbour, and for
+ * data, the share of the vote.
+ *
+ * Decoding, hashing, anchor voting and alignment run per function across
+ * threads. Both images must be laid out by RVA and outlive the diff.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "XrefIndex.h"
+
+class BuildDiff {
+public:
+    static constexpr size_t ANCHOR_INSTRUCTIONS = 4;
+    static constexpr size_t ANCHOR_WINDOW = 4;
+    static constexpr double MIN_ANCHOR_SCORE = 0.3;
+    static constexpr size_t MAX_ALIGNMENT_CELLS = 4 << 20;   ///< LCS table limit per function
+    static constexpr uint32_t DATA_REFERENCE_WINDOW = 0x100;  ///< Data references considered around an address
+
+    enum class Method : uint8_t {
+        Identical,      ///< Function hash matched uniquely
+        Anchors,        ///< Function matched by anchor votes
+        Neighbours,     ///< Only unmatched function between two matched ones
+        References      ///< Data address, voted from referencing code
+    };
+
+    struct Mapping {
+        uint32_t oldRva = 0;
+        uint32_t newRva = 0;
+        double confidence = 0;
+        Method method = Method::Identical;
+        bool interpolated = false;  ///< Instruction not aligned; offset from the nearest aligned one
+    };
+
+    struct Stats {
+        size_t oldFunctions = 0;
+        size_t newFunctions = 0;
+        size_t identical = 0;
+        size_t anchored = 0;
+        size_t neighbours = 0;
+        size_t oldInstructions = 0;
+        size_t alignedInstructions = 0;
+        unsigned threads = 1;
+        double elapsedMs = 0;
+    };
+
+    /**
+     * @brief Matches and aligns the functions of two builds
+     * @param threads 0 = all cores
+     * @return false if either image has no exception table
+     */
+    bool build(const uint8_t* oldImage, size_t oldSize, const uint8_t* newImage, size_t newSize,
+               unsigned threads = 0);
+
+    /// Maps an address inside a function of the old build
+    std::optional<Mapping> mapCode(uint32_t oldRva) const;
+
+    /// Maps a data address through the code that references it
+    std::optional<Mapping> mapData(uint32_t oldRva) const;
+
+    /// mapCode() for addresses in executable sections, mapData() otherwise
+    std::optional<Mapping> map(uint32_t oldRva) const;
+
+    const Stats& stats() const { return m_stats; }
+    std::string getLastError() const { return m_lastError; }
+
+    static const char* methodName(Method method);
+
+private:
+    struct Instruction {
+        uint32_t offset;    ///< From the function start
+        uint32_t hash;      ///< Of the normalised bytes
+    };
+
+    struct Function {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+        uint64_t hash = 0;
+        std::vector<Instruction> instructions;
+        std::vector<uint64_t> anchors;          ///< Sorted, unique
+    };
+
+    struct Side {
+        Xref::Image image;
+        std::vector<Function> functions;        ///< Ordered by begin
+    };
+
+    struct Match {
+        uint32_t newFunction = UINT32_MAX;
+        double score = 0;
+        Method method = Method::Identical;
+        std::vector<int32_t> alignment;         ///< New instruction per old instruction; -1 = none
+    };
+
+    Side m_old;
+    Side m_new;
+    std::vector<Match> m_matches;               ///< Per old function
+    XrefIndex m_oldReferences;
+    Stats m_stats;
+    std::string m_lastError;
+
+    bool loadFunctions(Side& side, const uint8_t* image, size_t size, unsigned threads);
+    void matchIdentical();
+    void matchAnchors(unsigned threads);
+    void matchNeighbours();
+    void align(size_t oldFunction);
+    const Function* findFunction(const Side& side, uint32_t rva, size_t* index = nullptr) const;
+    bool fail(const std::string& error);
+};
@@ -0,0 +1,41 @@
+/**
+ * @file BuildFingerprint.h
+ * @brief Identifies which ffxv_s.exe build is running
+ *
+ * Steam, Origin and Microsoft Store ship different executables, and code or
+ * data can move between them. The fingerprint lets the signature database
+ * map a running module straight to a known address set instead of scanning.
+ *
+ * Hashed input (FNV-1a 64):
+ *   - The header page, with OptionalHeader.ImageBase zeroed so a rebased
+ *     module hashes the same as one loaded at its preferred base
+ *   - The page containing the entry point
+ *   - The first page of every non-writable section
+ *
+ * Patch sites (0x751CA8 etc.) sit well inside .text, never on the first page
+ * of a section, so applying patches does not change the fingerprint.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+
+/// Reads target memory; returns the number of bytes actually read
+using MemoryReader = std::function<size_t(uintptr_t address, void* buffer, size_t size)>;
+
+struct BuildFingerprint {
+    uint64_t hash = 0;
+    uint32_t timeDateStamp = 0;
+    uint32_t sizeOfImage = 0;
+
+    std::string toString() const;
+
+    /**
+     * @brief Fingerprints the module mapped at moduleBase
+     * @return nullopt if the headers cannot be read or are not PE32+
+     */
+    static std::optional<BuildFingerprint> compute(const MemoryReader& read, uintptr_t moduleBase);
+};
@@ -0,0 +1,46 @@
+/**
+ * @file ByteView.h
+ * @brief Non-owning view over a contiguous run of bytes
+ *
+ * Patch byte data can live in three places: constexpr arrays compiled into
+ * the executable (built-in fallback), a memory-mapped signature database, or
+ * a caller-owned buffer. ByteView lets Patches::Patch and PatternScanner refer
+ * to any of them without copying.
+ *
+ * The viewed storage must outlive the view.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ByteView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    constexpr ByteView() = default;
+
+    constexpr ByteView(const uint8_t* bytes, size_t length)
+        : data(bytes), size(length) {}
+
+    template <size_t N>
+    constexpr ByteView(const uint8_t (&bytes)[N])
+        : data(bytes), size(N) {}
+
+    template <size_t N>
+    constexpr ByteView(const std::array<uint8_t, N>& bytes)
+        : data(bytes.data()), size(N) {}
+
+    ByteView(const std::vector<uint8_t>& bytes)
+        : data(bytes.data()), size(bytes.size()) {}
+
+    constexpr bool empty() const { return size == 0; }
+    constexpr const uint8_t* begin() const { return data; }
+    constexpr const uint8_t* end() const { return data + size; }
+    constexpr uint8_t operator[](size_t index) const { return data[index]; }
+
+    std::vector<uint8_t> toVector() const { return std::vector<uint8_t>(begin(), end()); }
+};
@@ -0,0 +1,116 @@
+/**
+ * @file FmIndex.h
+ * @brief FM-index over a module image or memory dump
+ *
+ * For reverse-engineering sessions: any byte string (a SKU prefix such as
+ * "FFXV_TP_", a URL, an instruction sequence) can be counted in time
+ * proportional to its length and located with a bounded number of steps
+ * per hit, independent of the image size.
+ *
+ * LAYOUT, for a text of n bytes (n + 1 rows, row 0 is the sentinel suffix):
+ *
+ *   bwt          n + 1 bytes; row m_primary holds the sentinel
+ *   superblocks  256 x uint32 per 64 KB of rows: counts before the superblock
+ *   blocks       256 x uint16 per 256 rows: counts since the superblock
+ *   samples      text position of every row whose position is a multiple of
+ *                SAMPLE_RATE, plus a bit per row marking them
+ *
+ * rank(c, i) is one superblock entry, one block entry and a scan of at most
+ * 255 bytes. count() takes two ranks per pattern byte; locate() walks LF at
+ * most SAMPLE_RATE - 1 steps per hit. About 3.2 bytes per text byte in all.
+ *
+ * The suffix array comes from SA-IS; the BWT, rank tables and samples are
+ * then derived from it in parallel, one contiguous row range per thread.
+ *
+ * FILE FORMAT (.fmi, little-endian): FileHeader, the BWT, the sample marks
+ * and the samples. Rank tables are rebuilt on load, which takes one pass
+ * over the BWT and keeps the file at about 1.25 bytes per text byte.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ByteView.h"
+
+namespace Fm {
+
+constexpr char MAGIC[4] = {'F', 'X', 'F', 'M'};
+constexpr uint16_t FORMAT_VERSION = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint16_t formatVersion;
+    uint16_t sampleRate;
+    uint32_t textSize;
+    uint32_t primary;
+    uint32_t sampleCount;
+    uint32_t reserved[3];
+};
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout is part of the file format");
+
+} // namespace Fm
+
+class FmIndex {
+public:
+    static constexpr uint32_t SAMPLE_RATE = 32;
+    static constexpr size_t BLOCK_SIZE = 256;
+    static constexpr size_t SUPERBLOCK_SIZE = 65536;
+
+    /// Wall-clock time of each build phase
+    struct BuildStats {
+        double suffixSortMs = 0;
+        double bwtMs = 0;           ///< BWT and sample marks
+        double rankMs = 0;          ///< Superblock and block tables
+        double sampleMs = 0;
+        unsigned threads = 1;
+    };
+
+    /**
+     * @brief Indexes text[0..size)
+     * @param threads 0 = all cores
+     */
+    bool build(const uint8_t* text, size_t size, unsigned threads = 0, BuildStats* stats = nullptr);
+    void clear();
+    bool isBuilt() const { return !m_bwt.empty(); }
+
+    size_t textSize() const { return m_bwt.empty() ? 0 : m_bwt.size() - 1; }
+    size_t memoryUsage() const;
+
+    // === Queries ===
+    size_t count(ByteView pattern) const;
+
+    /**
+     * @brief Text positions where pattern occurs, ascending
+     * @param limit Positions to resolve at most; 0 = all
+     */
+    std::vector<uint32_t> locate(ByteView pattern, size_t limit = 0) const;
+
+    // === Persistence ===
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, unsigned threads = 0);
+    std::string getLastError() const { return m_lastError; }
+
+private:
+    std::vector<uint8_t> m_bwt;
+    uint32_t m_primary = 0;
+    std::array<uint32_t, 257> m_first = {};   ///< Row of the first suffix starting with each byte (C array)
+    std::vector<uint32_t> m_superblocks;
+    std::vector<uint16_t> m_blocks;
+    std::vector<uint64_t> m_sampleMarks;     ///< Bit per row
+    std::vector<uint32_t> m_markRanks;       ///< Marked rows before each 64-bit word
+    std::vector<uint32_t> m_samples;         ///< Text positions of marked rows, in row order
+    std::string m_lastError;
+
+    void buildRankTables(unsigned threads);
+    void buildMarkRanks();
+    size_t rank(uint8_t c, size_t row) const;
+    bool isMarked(size_t row) const { return (m_sampleMarks[row >> 6] >> (row & 63)) & 1; }
+    size_t markRank(size_t row) const;
+    bool findRange(ByteView pattern, size_t& low, size_t& high) const;
+    bool fail(const std::string& error);
+};
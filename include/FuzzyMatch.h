@@ -0,0 +1,72 @@
+/**
+ * @file FuzzyMatch.h
+ * @brief Bit-parallel Hamming-distance pattern search (Shift-Or)
+ *
+ * A game update that changes one byte inside a signature makes the exact
+ * scan fail outright. This finds every window within k substituted bytes of
+ * the pattern instead, so a broken signature becomes a short candidate list.
+ *
+ * Shift-Or keeps one 64-bit state word per allowed error count; bit i of
+ * state d is clear when the last i + 1 bytes match the first i + 1 pattern
+ * bytes with at most d substitutions:
+ *
+ *   state[0] = (state[0] << 1) | byteMask[c]
+ *   state[d] = ((state[d] << 1) | byteMask[c]) & (previous state[d - 1] << 1)
+ *
+ * The text is split into LANES interleaved segments that advance in lock
+ * step, so the per-byte update is the same few operations on LANES
+ * independent words; the compiler turns that into vector code. Hits are
+ * rare, so they are checked for all lanes at once and only then resolved.
+ *
+ * Wildcard bytes (mask 0x00) match everything and are never counted.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ByteView.h"
+
+namespace Fuzzy {
+
+constexpr size_t MAX_PATTERN_LENGTH = 64;   ///< One state word per error count
+constexpr unsigned MAX_DISTANCE = 8;
+constexpr size_t LANES = 8;
+
+struct Difference {
+    uint8_t offset;     ///< Within the pattern
+    uint8_t expected;
+    uint8_t actual;
+};
+
+struct Match {
+    size_t offset = 0;  ///< Of the window start in the searched data
+    unsigned distance = 0;
+    std::vector<Difference> differences;
+
+    /// "+4 1A->1B, +9 00->08"
+    std::string describe() const;
+};
+
+/**
+ * @brief Largest distance worth searching for a pattern
+ *
+ * At least half of the fixed bytes must agree, otherwise short patterns
+ * match large parts of the image.
+ */
+unsigned maxUsefulDistance(ByteView pattern, ByteView mask);
+
+/**
+ * @brief Every window of data within maxDistance substitutions of pattern
+ * @param mask Per-byte mask as in PatternScanner; empty = exact
+ * @return Matches in data order; empty if pattern is longer than
+ *         MAX_PATTERN_LENGTH or maxDistance exceeds maxUsefulDistance()
+ */
+std::vector<Match> search(const uint8_t* data, size_t size, ByteView pattern, ByteView mask, unsigned maxDistance);
+
+/// Orders by distance, then offset, and keeps the first limit (0 = all)
+void rank(std::vector<Match>& matches, size_t limit = 0);
+
+} // namespace Fuzzy
@@ -0,0 +1,89 @@
+/**
+ * @file HeadlessRunner.h
+ * @brief Profile-driven unlocker without a window (FFXVUnlocker --profile <file>)
+ *
+ * Waits for ffxv_s.exe, applies the profile's patches and unlock table
+ * bytes with MemoryEditor::applyProfile(), and logs how long it took from
+ * process start to ready. A resident profile keeps running after that: the
+ * HTTP server serves the Twitch endpoints, the freeze timer writes back
+ * whatever the game changed, and a restarted game is attached and patched
+ * again.
+ *
+ * The game is looked for every WAIT_POLL_MS until it appears. Its exit is
+ * signalled by the process handle (QWinEventNotifier) rather than polled.
+ *
+ * Log lines go to stdout; main() attaches the parent console when there
+ * is one.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QWinEventNotifier>
+#include <Windows.h>
+#include <vector>
+
+#include "HttpServer.h"
+#include "MemoryEditor.h"
+#include "Patches.h"
+#include "SignatureDatabase.h"
+#include "UnlockProfile.h"
+
+class HeadlessRunner : public QObject {
+    Q_OBJECT
+
+public:
+    /// Process exit codes
+    enum ExitCode {
+        Success = 0,
+        ProfileError = 1,       ///< Unreadable, invalid, or names unknown to this build
+        WaitTimedOut = 2,
+        ApplyFailed = 3,
+        ServerFailed = 4
+    };
+
+    explicit HeadlessRunner(QObject* parent = nullptr);
+    ~HeadlessRunner();
+
+    /// Loads the profile and starts waiting; finished() is emitted from the event loop
+    void start(const QString& profilePath);
+
+signals:
+    void finished(int exitCode);
+
+private slots:
+    void pollForProcess();
+    void onProcessExited();
+    void onFreezeTick();
+
+private:
+    MemoryEditor* m_memoryEditor;
+    HttpServer* m_httpServer;
+    QTimer* m_pollTimer;
+    QTimer* m_freezeTimer;
+    QWinEventNotifier* m_exitNotifier = nullptr;
+    HANDLE m_exitHandle = nullptr;          ///< SYNCHRONIZE-only handle the notifier waits on
+
+    SignatureDatabase m_signatureDatabase;
+    UnlockProfile m_profile;
+    UnlockMask m_mask = 0;
+    std::vector<Patches::Patch*> m_patches;
+
+    QElapsedTimer m_waitTimer;
+    qint64 m_setupMs = 0;                   ///< Process start until waiting began
+    bool m_firstApply = true;
+
+    static constexpr const wchar_t* TARGET_PROCESS = L"ffxv_s.exe";
+    static constexpr const char* PATTERN_INDEX_DIRECTORY = "index";  // Opt-in: used only if it exists
+    static constexpr int WAIT_POLL_MS = 250;
+
+    bool loadProfile(const QString& profilePath);
+    void onAttached(qint64 waitedMs, qint64 attachMs);
+    void watchForExit();
+    void stopWatchingForExit();
+    void finish(int exitCode);
+    void log(const QString& message);
+};
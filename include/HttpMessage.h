@@ -0,0 +1,62 @@
+/**
+ * @file HttpMessage.h
+ * @brief HTTP/1.1 request parsing and response formatting without Qt
+ *
+ * HttpServer's per-request work: split the request line and headers, decode
+ * the query string, and serialise the response. The responses that never
+ * change (embedded pages, the goods list) are formatted once and kept in a
+ * ResponseCache, so serving them is one lookup and one socket write.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Http {
+
+struct Request {
+    std::string method;
+    std::string path;                   ///< Without the query string
+    std::string query;                  ///< After '?', still encoded
+    std::vector<std::pair<std::string, std::string>> headers;
+
+    /// Value of the first header with this name (case-insensitive); empty if absent
+    std::string header(std::string_view name) const;
+};
+
+/**
+ * @brief Parses the request line and headers
+ * @return false if there is no "METHOD target" request line
+ */
+bool parseRequest(std::string_view raw, Request& request);
+
+/// "a=1&b=%20x" -> {a: 1, b: " x"}; later keys win
+std::map<std::string, std::string> parseQuery(std::string_view query);
+
+/// %XX decoded ('+' is kept, as QUrl::fromPercentEncoding does); malformed escapes are kept
+std::string urlDecode(std::string_view text);
+
+/// Status line, Content-Type, Content-Length, Connection: close, then the body
+std::string formatResponse(int status, std::string_view statusText, std::string_view body,
+                           std::string_view contentType);
+
+/// Serialised responses by key (e.g. the request path)
+class ResponseCache {
+public:
+    /// nullptr if not cached
+    const std::string* find(const std::string& key) const;
+    const std::string& store(const std::string& key, std::string response);
+
+    void clear() { m_responses.clear(); }
+    size_t size() const { return m_responses.size(); }
+
+private:
+    std::unordered_map<std::string, std::string> m_responses;
+};
+
+} // namespace Http
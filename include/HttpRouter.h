@@ -0,0 +1,42 @@
+/**
+ * @file HttpRouter.h
+ * @brief Method and path dispatch for the local HTTP server
+ *
+ * Routes match the method and the path exactly; anything else goes to the
+ * fallback (HttpServer serves static files from there), or gets a 404 if
+ * none is set. A handler returns the whole serialised response, so cached
+ * responses are returned as they are.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include "HttpMessage.h"
+
+namespace Http {
+
+/// 302 with a Location header and no body
+std::string redirectResponse(std::string_view location);
+
+class Router {
+public:
+    using Handler = std::function<std::string(const Request& request)>;
+
+    /// Replaces any handler already set for the method and path
+    void add(const std::string& method, const std::string& path, Handler handler);
+    void remove(const std::string& method, const std::string& path);
+    bool contains(const std::string& method, const std::string& path) const;
+
+    void setFallback(Handler handler) { m_fallback = std::move(handler); }
+
+    std::string route(const Request& request) const;
+
+private:
+    std::map<std::pair<std::string, std::string>, Handler> m_routes;
+    Handler m_fallback;
+};
+
+} // namespace Http
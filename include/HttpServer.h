@@ -7,6 +7,9 @@
 #include <QMap>
 #include <QDir>
 #include <functional>
+#include <string>
+#include "HttpRouter.h"
+#include "Patches.h"
 
 class HttpServer : public QObject {
     Q_OBJECT
@@ -16,7 +19,7 @@ public:
     ~HttpServer();
 
     // Server control
-    bool start(quint16 port = 443);
+    bool start(quint16 port = Patches::REDIRECT_PORT);
     void stop();
     bool isRunning() const;
     quint16 port() const;
@@ -25,6 +28,9 @@ public:
     void setWebRoot(const QString& path);
     QString webRoot() const;
 
+    /// Body served at GET /metrics (Prometheus text format); unset = 404
+    void setMetricsProvider(std::function<QByteArray()> provider);
+
 signals:
     void serverStarted(quint16 port);
     void serverStopped();
@@ -39,26 +45,25 @@ private slots:
 private:
     QTcpServer* m_server = nullptr;
     QString m_webRoot;
-    quint16 m_port = 443;
+    quint16 m_port = Patches::REDIRECT_PORT;
+    std::function<QByteArray()> m_metricsProvider;
+    Http::Router m_router;
+    Http::ResponseCache m_responseCache;     ///< Embedded files and the goods list
 
-    // HTTP handling
+    // HTTP handling; handlers return the serialised response
     void handleRequest(QTcpSocket* socket, const QByteArray& request);
-    void sendResponse(QTcpSocket* socket, int statusCode, const QString& statusText,
-                      const QByteArray& body, const QString& contentType = "text/html");
-    void sendFile(QTcpSocket* socket, const QString& filePath);
-    void sendRedirect(QTcpSocket* socket, const QString& location);
+    void addRoutes();
+    void writeResponse(QTcpSocket* socket, const std::string& response);
+    std::string fileResponse(const QString& filePath);
 
     // Route handlers
-    void handleOAuth2Authorize(QTcpSocket* socket, const QMap<QString, QString>& params,
-                                const QMap<QString, QString>& headers);
-    void handleLogin(QTcpSocket* socket);
-    void handleBlog(QTcpSocket* socket);
-    void handleGoodsRequest(QTcpSocket* socket);
-    void handleStaticFile(QTcpSocket* socket, const QString& path);
+    std::string handleOAuth2Authorize(const Http::Request& request);
+    std::string handleLogin();
+    std::string handleBlog();
+    std::string handleGoodsRequest();
+    std::string handleMetrics();
+    std::string handleStaticFile(const QString& path);
 
     // Utility
     QString getMimeType(const QString& filePath);
-    QMap<QString, QString> parseQueryString(const QString& query);
-    QMap<QString, QString> parseHeaders(const QStringList& headerLines);
-    QString urlDecode(const QString& input);
 };
@@ -0,0 +1,77 @@
+/**
+ * @file JumpTable.h
+ * @brief The Phase 6 dispatch table: reading, retargeting and rolling back
+ *
+ * The table is data, and the anti-tamper check does not cover it, so
+ * individual items can be routed to another item's handler without
+ * touching code. Entries are handler RVAs (the game adds its image base).
+ *
+ * Targets are limited to handlers the game itself dispatches to; any other
+ * address could land mid-instruction. Every change is validated before
+ * anything is written, and the live table is checked against the last
+ * state written here, so a table modified elsewhere is not overwritten.
+ * Each successful retarget is one journal entry.
+ *
+ * Works on any MemoryBackend; MemoryEditor owns one for the attached game.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MemoryBackend.h"
+
+class JumpTable {
+public:
+    struct Entry {
+        uint8_t itemId;
+        uintptr_t address;          ///< Of the entry itself
+        uint32_t offset;            ///< Handler RVA as stored
+        uintptr_t target;           ///< Module base + offset
+        uint32_t originalOffset;    ///< Value before this tool changed it
+    };
+
+    struct Retarget {
+        uint8_t itemId;
+        uintptr_t target;           ///< Absolute; must be a handler the table already uses
+    };
+
+    /// Forgets the journal and points at a new table; tableBase 0 = none
+    void reset(uintptr_t tableBase = 0, uintptr_t moduleBase = 0);
+
+    uintptr_t base() const { return m_base; }
+    size_t journalSize() const { return m_journal.size(); }
+
+    /// Reads and decodes the whole table in one read; empty on failure
+    std::vector<Entry> read(const MemoryBackend& backend) const;
+
+    /**
+     * @brief Retargets entries in one write, or none at all
+     * @param changed Set to the number of entries written
+     */
+    bool retarget(MemoryBackend& backend, const std::vector<Retarget>& changes, size_t& changed);
+
+    bool rollback(MemoryBackend& backend, size_t& changed);    ///< Undoes the most recent retarget
+    bool restore(MemoryBackend& backend, size_t& changed);     ///< Undoes every retarget; true if nothing to undo
+
+    std::string getLastError() const { return m_lastError; }
+
+private:
+    struct Change {
+        size_t index;
+        uint32_t before;
+        uint32_t after;
+    };
+
+    uintptr_t m_base = 0;
+    uintptr_t m_moduleBase = 0;
+    std::vector<uint32_t> m_original;  ///< Snapshot at the first retarget; empty = untouched
+    std::vector<uint32_t> m_written;   ///< What the table should hold now
+    std::vector<std::vector<Change>> m_journal;
+    std::string m_lastError;
+
+    bool readOffsets(const MemoryBackend& backend, std::vector<uint32_t>& offsets) const;
+    bool writeOffsets(MemoryBackend& backend, const std::vector<uint32_t>& offsets, size_t first, size_t last);
+};
@@ -5,6 +5,7 @@
 #include <QPushButton>
 #include <QToolButton>
 #include <QLabel>
+#include <QSpinBox>
 #include <QGroupBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -18,6 +19,8 @@
 #include "MemoryEditor.h"
 #include "HttpServer.h"
 #include "Patches.h"
+#include "SignatureDatabase.h"
+#include "SlotProber.h"
 
 /**
  * @brief Main application window for FFXV Unlocker
@@ -46,11 +49,15 @@ private slots:
     // === Process Management ===
     void onAttachClicked();
     void onDetachClicked();
+    void onProbeClicked();
+    void stopProbeForExit();
+    void onTraceClicked();
     void checkForProcess();
 
     // === Server & URL Redirect ===
     void onServerToggled(bool checked);
     void onURLRedirectToggled(bool checked);
+    void onRedirectPortChanged();
 
     // === Unlock Controls ===
     void onUnlockAllToggled(bool checked);
@@ -64,8 +71,14 @@ private slots:
     void onUnlockWithWorkshopToggled(bool checked);
 
     // === Event Handlers ===
-    void onProcessAttached(const QString& name, DWORD pid);
+    void onProcessAttached(const QString& name, uint32_t pid);
     void onProcessDetached();
+    void onBuildIdentified(const QString& fingerprint, const QString& buildName);
+    void onUnlockTableResolved(quint64 address, bool fromSignature);
+    void onPatternIndexReady(const QString& path, bool built, qint64 elapsedMs);
+    void onJumpTableRetargeted(int changedEntries, int journalSize);
+    void onPatchCandidatesFound(const QString& name, const QStringList& candidates);
+    void onPatternScanned(const QString& summary);
     void onPatchApplied(const QString& name);
     void onPatchRemoved(const QString& name);
     void onUnlockEnabled(const QString& name);
@@ -75,11 +88,14 @@ private slots:
     void onServerStarted(quint16 port);
     void onServerStopped();
     void onRequestReceived(const QString& method, const QString& path);
+    void onSlotProbed(int itemId, int changedBytes);
+    void onProbeFinished(int slotsProbed, bool cancelled);
     void onError(const QString& error);
     void onTrayActivated(QSystemTrayIcon::ActivationReason reason);
 
 private:
     // === Initialization ===
+    QString loadSignatureDatabase();
     void setupUI();
     void setupConnections();
     void setupSystemTray();
@@ -89,7 +105,7 @@ private:
     /**
      * @brief Creates a collapsible group box for a category of unlock items
      * @param title Category display name
-     * @param items List of unlock items in this category
+     * @param category Category whose registry items get a checkbox each
      * @param allCheck Output: reference to the "Enable All" checkbox
      * @param itemChecks Output: list of individual item checkboxes
      * @param disableCategoryCheck If true, category checkbox is permanently disabled
@@ -98,7 +114,7 @@ private:
      */
     QGroupBox* createUnlockCategoryGroup(
         const QString& title,
-        std::vector<Patches::UnlockItem*> items,
+        Patches::UnlockCategory category,
         QCheckBox*& allCheck,
         std::vector<QCheckBox*>& itemChecks,
         bool disableCategoryCheck = false,
@@ -134,8 +150,10 @@ private:
     void restoreUnlockControlStates();
 
     // === Core Components ===
+    SignatureDatabase m_signatureDatabase;  // Must outlive patches that view into it
     MemoryEditor* m_memoryEditor;
     HttpServer* m_httpServer;
+    SlotProber* m_slotProber;
     QTimer* m_processCheckTimer;
 
     // === UI Widgets ===
@@ -147,10 +165,13 @@ private:
     QLabel* m_serverStatusLabel;
     QPushButton* m_attachButton;
     QPushButton* m_detachButton;
+    QPushButton* m_probeButton;
+    QPushButton* m_traceButton;
 
     // URL redirect controls
     QCheckBox* m_urlRedirectCheck;
     QCheckBox* m_serverCheck;
+    QSpinBox* m_portSpin;
 
     // Master unlock control
     QCheckBox* m_unlockAllCheck;
@@ -190,6 +211,8 @@ private:
 
     // === State ===
     bool m_autoAttach = true;  // Auto-attach on startup, disabled on manual detach
+    QString m_probeWatchSpec;  // Last watch list entered for the slot prober
     bool m_twitchPrimeWarningShown = false;  // Show info popup once per session
     static constexpr const wchar_t* TARGET_PROCESS = L"ffxv_s.exe";
+    static constexpr const char* PATTERN_INDEX_DIRECTORY = "index";  // Opt-in: used only if it exists
 };
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Read-only memory mapping of a file
+ *
+ * Used for data files that are consumed in place (signature database, dumps).
+ * The mapping stays valid until close() or destruction; any views handed out
+ * into data() share that lifetime.
+ *
+ * Paths are UTF-8. Move-only.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    std::string getLastError() const { return m_lastError; }
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::string m_lastError;
+
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#endif
+};
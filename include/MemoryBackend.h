@@ -0,0 +1,76 @@
+/**
+ * @file MemoryBackend.h
+ * @brief Read/write access to a target's memory, independent of the platform
+ *
+ * What the core needs from a target: reads, and writes that lift page
+ * protection for their duration. The platform layers implement it:
+ *
+ *   WindowsBackend    ReadProcessMemory; VirtualProtectEx around WriteProcessMemory
+ *   ProcessMemory     process_vm_readv; /proc/<pid>/mem (Linux)
+ *
+ * InMemoryBackend is a buffer at a fixed base address for benchmarks and
+ * offline checks. It counts the calls a real backend would turn into
+ * syscalls, and can spin for a fixed time per call to stand in for their
+ * cost.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BuildFingerprint.h"
+#include "ByteView.h"
+
+class MemoryBackend {
+public:
+    virtual ~MemoryBackend() = default;
+
+    /// @return Bytes read; 0 if the range starts outside readable memory
+    virtual size_t read(uintptr_t address, void* buffer, size_t size) const = 0;
+
+    /// Writes regardless of page protection, restoring it afterwards
+    virtual bool writeProtected(uintptr_t address, ByteView data) = 0;
+
+    /// read() as a MemoryReader; the backend must outlive it
+    MemoryReader reader() const
+    {
+        return [this](uintptr_t address, void* buffer, size_t size) { return read(address, buffer, size); };
+    }
+};
+
+class InMemoryBackend : public MemoryBackend {
+public:
+    /// Syscalls the Windows backend makes per call
+    static constexpr uint64_t READ_SYSCALLS = 1;         ///< ReadProcessMemory
+    static constexpr uint64_t WRITE_SYSCALLS = 3;        ///< VirtualProtectEx, WriteProcessMemory, VirtualProtectEx
+
+    InMemoryBackend(uintptr_t base, std::vector<uint8_t> bytes)
+        : m_base(base), m_bytes(std::move(bytes)) {}
+
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    bool writeProtected(uintptr_t address, ByteView data) override;
+
+    uintptr_t base() const { return m_base; }
+    const std::vector<uint8_t>& bytes() const { return m_bytes; }
+
+    /// Busy-waits this long per emulated syscall; zero (default) = no cost
+    void setSyscallCost(std::chrono::nanoseconds cost) { m_syscallCost = cost; }
+
+    uint64_t readCalls() const { return m_readCalls; }
+    uint64_t writeCalls() const { return m_writeCalls; }
+    uint64_t bytesWritten() const { return m_bytesWritten; }
+    uint64_t syscalls() const { return m_readCalls * READ_SYSCALLS + m_writeCalls * WRITE_SYSCALLS; }
+    void resetCounters() { m_readCalls = m_writeCalls = m_bytesWritten = 0; }
+
+private:
+    uintptr_t m_base;
+    std::vector<uint8_t> m_bytes;
+    std::chrono::nanoseconds m_syscallCost{0};
+    mutable uint64_t m_readCalls = 0;
+    uint64_t m_writeCalls = 0;
+    uint64_t m_bytesWritten = 0;
+
+    void spend(uint64_t syscalls) const;
+};
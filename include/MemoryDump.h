@@ -0,0 +1,114 @@
+/**
+ * @file MemoryDump.h
+ * @brief Offline view of process memory from a minidump or raw dump file
+ *
+ * When anti-tamper kills the game after a patch, the crash dump is the only
+ * record of what memory looked like. MemoryDump memory-maps the file and
+ * exposes it by virtual address, so the same lookups MemoryEditor does
+ * against a live process (pattern scan, near matches, fingerprint, reading
+ * patch sites and tables) run against the dump on any platform.
+ *
+ *   Minidump  "MDMP" header; memory from MemoryListStream (small dumps) and
+ *             Memory64ListStream (full dumps), modules from ModuleListStream
+ *   Raw       any other file, taken as one region starting at a given base
+ *             (a module dumped by RVA, or a memory region saved by hand)
+ *
+ * Regions point into the mapping; no dump contents are copied. Regions that
+ * are adjacent both in memory and in the file are merged, so a module saved
+ * in one piece is one contiguous view. Searches that cross the boundary of
+ * two adjacent regions stored apart are stitched with a buffer of at most
+ * two pattern lengths.
+ *
+ * Paths are UTF-8. Views and addresses stay valid until close().
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "BuildFingerprint.h"
+#include "ByteView.h"
+#include "FuzzyMatch.h"
+#include "MappedFile.h"
+
+class MemoryDump {
+public:
+    enum class Format : uint8_t {
+        Minidump,
+        Raw
+    };
+
+    struct Region {
+        uint64_t address = 0;
+        uint64_t size = 0;
+        const uint8_t* data = nullptr;  ///< Into the mapping
+    };
+
+    struct Module {
+        uint64_t base = 0;
+        uint32_t size = 0;
+        std::string name;               ///< Full path as recorded, UTF-8
+    };
+
+    /// Minidump if the file starts with "MDMP", raw at rawBase otherwise
+    bool open(const std::string& path, uint64_t rawBase = 0);
+    void close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    Format format() const { return m_format; }
+    const std::vector<Region>& regions() const { return m_regions; }
+    const std::vector<Module>& modules() const { return m_modules; }
+    uint64_t totalSize() const;
+    std::string getLastError() const { return m_lastError; }
+
+    /// Module whose file name (not path) matches, case-insensitively
+    const Module* findModule(const std::string& name) const;
+
+    /// Pointer to [address, address + size) if one region holds all of it
+    const uint8_t* view(uint64_t address, size_t size) const;
+
+    /**
+     * @brief Copies memory out, across region boundaries
+     * @return Bytes read; stops early at the first address the dump lacks
+     */
+    size_t read(uint64_t address, void* buffer, size_t size) const;
+
+    /// read() as a MemoryReader (for BuildFingerprint::compute)
+    MemoryReader reader() const;
+
+    /**
+     * @brief First match of a pattern in [start, start + size)
+     * @param mask optional per-byte mask, (byte & mask) == (pattern & mask); empty = exact
+     */
+    std::optional<uint64_t> findPattern(uint64_t start, uint64_t size, ByteView pattern, ByteView mask = {}) const;
+
+    /// Every match in address order, at most limit (0 = all)
+    std::vector<uint64_t> findAll(uint64_t start, uint64_t size, ByteView pattern, ByteView mask = {},
+                                  size_t limit = 0) const;
+
+    /**
+     * @brief Windows within maxDistance substituted bytes, as PatternScanner::findPatternFuzzy
+     * @return Ranked by distance, at most limit (0 = all); offsets relative to start
+     */
+    std::vector<Fuzzy::Match> findPatternFuzzy(uint64_t start, uint64_t size, ByteView pattern, ByteView mask,
+                                               unsigned maxDistance, size_t limit = 0) const;
+
+private:
+    MappedFile m_file;
+    Format m_format = Format::Raw;
+    std::vector<Region> m_regions;      ///< Sorted by address, non-overlapping
+    std::vector<Module> m_modules;
+    std::string m_lastError;
+
+    bool parseMinidump();
+    void addRegion(uint64_t address, uint64_t size, const uint8_t* data);
+    void normaliseRegions();
+
+    template <typename Search>
+    void forEachSpan(uint64_t start, uint64_t size, size_t window, Search&& search) const;
+
+    bool fail(const std::string& error);
+};
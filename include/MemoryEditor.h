@@ -2,11 +2,21 @@
 
 #include <QObject>
 #include <QString>
-#include <Windows.h>
+#include <QStringList>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <map>
+#include <optional>
+#include "BuildFingerprint.h"
+#include "JumpTable.h"
+#include "NgramIndex.h"
 #include "Patches.h"
+#include "ScanStats.h"
+#include "UnlockRegistry.h"
+#include "WindowsBackend.h"
+
+class SignatureDatabase;
 
 /**
  * @brief Memory manipulation interface for FFXV process
@@ -17,6 +27,25 @@
  * 1. AOB Pattern Patches: Scans for byte patterns and modifies code
  * 2. Byte Table Writes: Direct writes to known addresses for unlock items
  *
+ * On attach the running module is fingerprinted. If the signature database
+ * lists that build, its patch addresses are verified and cached up front and
+ * no pattern scan is needed; otherwise patches are located by scanning. The
+ * unlock table base is resolved from the code that reads it, so item
+ * addresses follow the module's actual load address.
+ *
+ * Patches that carry an RVA hint are checked at the hint first, then searched
+ * for outward from it, before any full scan.
+ *
+ * With a pattern index directory set, the module is n-gram indexed once per
+ * build (the index file is named after the fingerprint and reused on later
+ * attaches), and pattern lookups verify the index candidates instead of
+ * scanning the whole module.
+ *
+ * The Phase 6 jump table is data, and the anti-tamper check does not cover
+ * it, so individual items can be routed to another item's handler without
+ * touching code. Retargets are journaled and can be rolled back one call at
+ * a time or all at once.
+ *
  * Thread Safety: Not thread-safe. All operations should be called from
  * the main Qt thread.
  */
@@ -32,7 +61,13 @@ public:
     void detach();
     bool isAttached() const;
     std::wstring getProcessName() const;
-    DWORD getProcessId() const;
+    uint32_t getProcessId() const;
+    uintptr_t getModuleBase() const;
+
+    // === Build Identification ===
+    void setSignatureDatabase(const SignatureDatabase* database);  ///< Apply its overrides first; rebuilds the registry
+    void setPatternIndexDirectory(const std::string& directory);  ///< UTF-8; empty = no index
+    std::optional<BuildFingerprint> getBuildFingerprint() const;
 
     // === AOB Pattern-Based Patches ===
     bool applyPatch(Patches::Patch& patch);
@@ -42,6 +77,33 @@ public:
     bool removeAllPatches(std::vector<Patches::Patch*>& patches);
     bool isPatchApplied(const Patches::Patch& patch) const;
 
+    /// A site within a few substituted bytes of a patch pattern
+    struct PatchCandidate {
+        uintptr_t address;          ///< Of the match start, like findPatternAddress
+        unsigned distance;
+        std::string differences;    ///< "+4 1A->1B, ..." (pattern offset, expected, actual)
+    };
+
+    /**
+     * @brief Sites in the module within maxDistance bytes of the patch pattern
+     *
+     * For review when a game update broke a signature; nothing is patched.
+     * maxDistance is clamped to Fuzzy::maxUsefulDistance().
+     * @return Ranked by distance, at most limit
+     */
+    std::vector<PatchCandidate> findPatchCandidates(const Patches::Patch& patch, unsigned maxDistance, size_t limit);
+
+    /**
+     * @brief Rewrites the current patched bytes of every applied patch in one batch
+     *
+     * Used after patch data changes while applied (e.g. a new redirect port).
+     * Sites close together are merged into a single protected write.
+     */
+    bool rewriteAppliedPatches(std::vector<Patches::Patch*>& patches);
+
+    /// Latest stats per lookup name since attach; empty when built without FFXV_SCAN_STATS
+    const std::vector<ScanStats>& getScanStats() const;
+
     // === Direct Byte Table Unlocks ===
     bool enableUnlock(Patches::UnlockItem& item);
     bool disableUnlock(Patches::UnlockItem& item);
@@ -50,6 +112,54 @@ public:
     bool disableAllUnlocks(std::vector<Patches::UnlockItem*>& items);
     bool isUnlockEnabled(const Patches::UnlockItem& item) const;
 
+    // === Mask-Based Byte Table Access ===
+    /**
+     * @brief Brings the byte table to the desired state in one read-modify-write
+     *
+     * Only bytes whose bit differs from the current enabled mask are changed.
+     * Items and bundles covered by a changed bit get their enabled flag
+     * updated and their usual signal emitted.
+     */
+    bool applyUnlockMask(UnlockMask desired);
+    UnlockMask getUnlockMask() const;
+    const UnlockRegistry& getUnlockRegistry() const;
+
+    // === Profiles ===
+    /**
+     * @brief Brings the patches and the unlock table to a profile's state in one batch
+     *
+     * Every patch site is located before anything is written, so a missing
+     * pattern leaves the game untouched. The sites and the table bytes the
+     * profile owns (mask, plus bytes enabled outside it, which are cleared)
+     * are read back in one batch and only those that differ are written,
+     * merged as in writeBatch(). Run again, it writes back whatever changed
+     * since, which is all a freeze tick needs.
+     *
+     * @param rewritten Set to the number of sites and table bytes written
+     */
+    bool applyProfile(std::vector<Patches::Patch*>& patches, UnlockMask mask, size_t& rewritten);
+
+    // === Jump Table (Phase 6 Dispatch) ===
+    using JumpTableEntry = JumpTable::Entry;
+    using JumpTableRetarget = JumpTable::Retarget;
+
+    /// Reads and decodes the whole table in one read; empty on failure
+    std::vector<JumpTableEntry> readJumpTable();
+
+    /**
+     * @brief Retargets entries in one write, or none at all
+     *
+     * Every change is validated before anything is written, and the bytes
+     * are checked against the last state this tool wrote, so a table
+     * modified elsewhere is not overwritten. Each successful call is one
+     * journal entry.
+     */
+    bool retargetJumpTable(const std::vector<JumpTableRetarget>& changes);
+    bool rollbackJumpTable();   ///< Undoes the most recent retarget call
+    bool restoreJumpTable();    ///< Undoes every retarget; true if nothing to undo
+    size_t getJumpTableJournalSize() const;
+    uintptr_t getJumpTableBase() const;
+
     // === Bundle Operations (Multiple Addresses) ===
     bool enableBundle(Patches::UnlockBundle& bundle);
     bool disableBundle(Patches::UnlockBundle& bundle);
@@ -59,13 +169,26 @@ public:
     bool isBundleEnabled(const Patches::UnlockBundle& bundle) const;
 
     // === Low-Level Access ===
+    struct MemoryRange {
+        uintptr_t address;
+        size_t size;
+    };
+
     bool writeByte(uintptr_t address, uint8_t value);
     uint8_t readByte(uintptr_t address);
+    std::vector<std::vector<uint8_t>> readBatch(const std::vector<MemoryRange>& ranges);
+    bool writeBatch(std::vector<std::pair<uintptr_t, ByteView>> writes);
     std::string getLastError() const;
 
 signals:
-    void processAttached(const QString& processName, DWORD pid);
+    void processAttached(const QString& processName, uint32_t pid);
     void processDetached();
+    void buildIdentified(const QString& fingerprint, const QString& buildName);  ///< buildName empty if unknown
+    void unlockTableResolved(quint64 address, bool fromSignature);  ///< false = default RVA, shifted by load offset
+    void patternIndexReady(const QString& path, bool built, qint64 elapsedMs);  ///< built = false when loaded
+    void jumpTableRetargeted(int changedEntries, int journalSize);
+    void patchCandidatesFound(const QString& patchName, const QStringList& candidates);  ///< After a failed lookup
+    void patternScanned(const QString& summary);  ///< ScanStats::toString() of each lookup
     void patchApplied(const QString& patchName);
     void patchRemoved(const QString& patchName);
     void unlockEnabled(const QString& itemName);
@@ -76,19 +199,56 @@ signals:
 
 private:
     // Process state
-    HANDLE m_processHandle = nullptr;
-    DWORD m_processId = 0;
+    WindowsBackend m_process;
     std::wstring m_processName;
     std::string m_lastError;
 
+    // Build identification
+    const SignatureDatabase* m_signatureDatabase = nullptr;
+    uintptr_t m_moduleBase = 0;
+    size_t m_moduleSize = 0;
+    std::optional<BuildFingerprint> m_buildFingerprint;
+    uintptr_t m_restoreTableBase = 0;  ///< Table base to return to on detach; 0 = not rebased
+
+    // N-gram index of the module; candidates only, verified against live memory
+    std::string m_patternIndexDirectory;
+    NgramIndex m_patternIndex;
+
+    // Resolved RVAs per build fingerprint; kept across detach so a restarted
+    // game is not rescanned
+    struct ResolvedBuild {
+        uint32_t unlockTableRva = 0;
+        uint32_t jumpTableRva = 0;
+        std::map<std::string, uint32_t> patchRvas;
+    };
+    std::map<uint64_t, ResolvedBuild> m_buildCache;
+
+    // Item/bundle layout and the bytes this tool has enabled
+    UnlockRegistry m_registry;
+
+    // Jump table of the attached build and the retargets made to it
+    JumpTable m_jumpTable;
+
     // Pattern cache: avoids rescanning for same patterns
     std::map<std::string, uintptr_t> m_patternCache;
 
+    // Stats of the lookups since attach, latest per name
+    std::vector<ScanStats> m_scanStats;
+
     // Internal helpers
-    DWORD findProcessByName(const std::wstring& processName);
+    uint32_t findProcessByName(const std::wstring& processName);
     uintptr_t findPatternAddress(const Patches::Patch& patch);
-    bool writeMemory(uintptr_t address, const std::vector<uint8_t>& data);
+    std::optional<uintptr_t> locatePattern(const Patches::Patch& patch, std::string& method);
+    void recordScan(ScanStats stats);
+    void updateEnabledMask(UnlockMask desired);
+    void reportPatchCandidates(const Patches::Patch& patch);
+    void identifyBuild();
+    void loadPatternIndex();
+    std::vector<uint8_t> snapshotModule();
+    void resolveUnlockTable(uint32_t databaseRva, ResolvedBuild* resolved);
+    void resolveJumpTable(uint32_t databaseRva, ResolvedBuild* resolved);
+    uint32_t resolveTableRva(uint32_t databaseRva, uint32_t cachedRva, const Patches::OperandReference& reference);
+    MemoryReader statsReader();
     std::vector<uint8_t> readMemory(uintptr_t address, size_t size);
-    bool writeProtectedMemory(uintptr_t address, const std::vector<uint8_t>& data);
-    bool setMemoryProtection(uintptr_t address, size_t size, DWORD newProtection, DWORD& oldProtection);
+    bool writeProtectedMemory(uintptr_t address, ByteView data);
 };
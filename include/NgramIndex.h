@@ -0,0 +1,134 @@
+/**
+ * @file NgramIndex.h
+ * @brief 4-byte n-gram index over a module image
+ *
+ * Every position of the image is filed under a hash of the four bytes that
+ * start there. A pattern query looks up the buckets of its fully fixed
+ * 4-byte windows, intersects the rarest posting lists, and only verifies
+ * the positions that survive:
+ *
+ *   pattern   48 8D 0D ?? ?? ?? ?? E8 ?? ?? ?? ?? 84 C0 74 4F
+ *   windows   [E8 ?? ?? ??] no ... [84 C0 74 4F] 37 hits, [C0 74 4F ..] ...
+ *   verify    the starts present in every list, usually one
+ *
+ * Patterns with no fixed 4-byte window fall back to a linear scan.
+ *
+ * POSTING LISTS are stored per bucket as LEB128 varints: the first position,
+ * then the gap to each next one. Gaps in real code are small (padding, int3
+ * runs, common prologues), so most postings take one or two bytes.
+ *
+ * FILE FORMAT (.fxng, little-endian), written by save() and mapped in place
+ * by load():
+ *
+ *   FileHeader        32 bytes, magic "FXNG"
+ *   uint32_t          bucket offsets into the postings, BUCKET_COUNT + 1
+ *   uint8_t[]         postings
+ *
+ * The header records the BuildFingerprint hash and image size, so an index
+ * is only ever used with the build it was made from.
+ *
+ * A built index refers to the image it was built from; the caller keeps the
+ * image alive for find(), or calls setImage(nullptr) before freeing it and
+ * verifies candidates() itself.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "ByteView.h"
+#include "MappedFile.h"
+
+namespace Ngram {
+
+constexpr char MAGIC[4] = {'F', 'X', 'N', 'G'};
+constexpr uint16_t FORMAT_VERSION = 1;
+
+struct FileHeader {
+    char magic[4];
+    uint16_t formatVersion;
+    uint8_t gramSize;
+    uint8_t bucketBits;
+    uint32_t fingerprintLow;   ///< BuildFingerprint::hash, split to keep 4-byte alignment
+    uint32_t fingerprintHigh;
+    uint32_t imageSize;
+    uint32_t postingsSize;
+    uint32_t positionCount;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout is part of the file format");
+
+} // namespace Ngram
+
+class NgramIndex {
+public:
+    static constexpr size_t GRAM_SIZE = 4;
+    static constexpr unsigned BUCKET_BITS = 20;
+    static constexpr size_t BUCKET_COUNT = size_t(1) << BUCKET_BITS;
+
+    /// Posting lists intersected per query at most; the rest is left to verification
+    static constexpr size_t MAX_INTERSECTED_LISTS = 3;
+
+    /// Indexes image[0..size); positions are 32-bit, so size must be below 4 GB
+    bool build(const uint8_t* image, size_t size);
+    void clear();
+    bool isBuilt() const { return m_bucketOffsets != nullptr; }
+
+    // === Persistence ===
+    bool save(const std::string& path, uint64_t fingerprint) const;
+
+    /**
+     * @brief Maps an index written by save()
+     * @param image Image for find(), or nullptr when only candidates() is used
+     * @return false if the file is malformed or was built for another build
+     */
+    bool load(const std::string& path, uint64_t fingerprint, size_t imageSize, const uint8_t* image = nullptr);
+
+    std::string getLastError() const { return m_lastError; }
+
+    // === Queries ===
+    const uint8_t* image() const { return m_image; }
+    size_t imageSize() const { return m_size; }
+    void setImage(const uint8_t* image) { m_image = image; }  ///< Same size as indexed
+
+    /**
+     * @brief Start offsets that may match, ascending; verification is up to the caller
+     * @return nullopt if the pattern has no fixed 4-byte window to look up
+     */
+    std::optional<std::vector<uint32_t>> candidates(ByteView pattern, ByteView mask = {}) const;
+
+    /**
+     * @brief Offsets where pattern matches, ascending; requires the image
+     * @param mask Per-byte mask as in PatternScanner; empty = exact
+     * @param limit Stop after this many matches; 0 = all
+     */
+    std::vector<uint32_t> find(ByteView pattern, ByteView mask = {}, size_t limit = 0) const;
+
+    /// Number of matches, counting no further than limit (0 = all)
+    size_t count(ByteView pattern, ByteView mask = {}, size_t limit = 0) const;
+
+    size_t postingsSize() const { return m_postingsSize; }
+
+private:
+    const uint8_t* m_image = nullptr;
+    size_t m_size = 0;
+    const uint32_t* m_bucketOffsets = nullptr;  ///< BUCKET_COUNT + 1 byte offsets into m_postings
+    const uint8_t* m_postings = nullptr;
+    size_t m_postingsSize = 0;
+    size_t m_positionCount = 0;
+    std::string m_lastError;
+
+    // Storage for a built index; a loaded one points into m_file instead
+    std::vector<uint32_t> m_ownedOffsets;
+    std::vector<uint8_t> m_ownedPostings;
+    MappedFile m_file;
+
+    static uint32_t bucketOf(const uint8_t* gram);
+    std::vector<uint32_t> decodeBucket(uint32_t bucket) const;
+    bool matchAt(size_t offset, ByteView pattern, ByteView mask) const;
+    bool fail(const std::string& error);
+};
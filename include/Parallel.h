@@ -0,0 +1,53 @@
+/**
+ * @file Parallel.h
+ * @brief Splitting index ranges across worker threads
+ *
+ * Used by the offline indexes (SuffixArray, FmIndex, BuildDiff) for steps
+ * that are independent per position or per function.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace Parallel {
+
+/// Threads to use for a request (0 = hardware concurrency); at least 1
+inline unsigned threadCount(unsigned requested)
+{
+    if (requested == 0) requested = std::thread::hardware_concurrency();
+    return std::max(requested, 1u);
+}
+
+/**
+ * @brief Runs work(begin, end, thread) over [0, count), one range per thread
+ *
+ * Ranges are contiguous and ascending; range i goes to thread i. With one
+ * thread the work runs on the caller.
+ */
+inline void forRanges(size_t count, unsigned threads, const std::function<void(size_t, size_t, unsigned)>& work)
+{
+    threads = static_cast<unsigned>(std::min<size_t>(threadCount(threads), std::max<size_t>(count, 1)));
+    if (threads == 1) {
+        work(0, count, 0);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    size_t chunk = (count + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; ++t) {
+        size_t begin = std::min(count, t * chunk);
+        size_t end = std::min(count, begin + chunk);
+        workers.emplace_back(work, begin, end, t);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace Parallel
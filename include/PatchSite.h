@@ -0,0 +1,44 @@
+/**
+ * @file PatchSite.h
+ * @brief Checks on a located patch site, through any MemoryReader
+ *
+ * What MemoryEditor and SessionManager both need before they write a code
+ * patch: that the bytes at a match really are the patch pattern, that the
+ * reference build's RVA hint still points at it, and that the patch
+ * replaces whole instructions. Addresses are of the match start, as the
+ * scanners return them; the patch itself goes at match + patch.offset.
+ *
+ * A site that still holds our patched bytes from an earlier session counts
+ * as the right site, and is decoded with the original bytes laid back over
+ * it.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include "BuildFingerprint.h"
+#include "Patches.h"
+
+namespace PatchSite {
+
+/// The pattern at match, or the same with the patched bytes laid over it
+bool matches(const MemoryReader& read, uintptr_t match, const Patches::Patch& patch);
+
+/**
+ * @brief Match start at the patch's RVA hint, if the site there matches
+ * @return nullopt when the patch has no hint or the build moved it
+ */
+std::optional<uintptr_t> atHint(const MemoryReader& read, uintptr_t moduleBase, const Patches::Patch& patch);
+
+/**
+ * @brief Checks that a code patch replaces whole instructions
+ *
+ * Decodes the bytes spanning both the pattern match and the patch. The
+ * match start, the patch start and the patch end must all fall on
+ * instruction boundaries, and the patched bytes must themselves be whole
+ * instructions. Patches outside .text always pass.
+ */
+bool onBoundaries(const MemoryReader& read, uintptr_t match, const Patches::Patch& patch);
+
+} // namespace PatchSite
@@ -18,6 +18,11 @@
  * ANTI-TAMPER LIMITATION:
  * FFXV crashes if executable code is modified arbitrarily. Only specific patches
  * (Unlock 1, 2, 3) have been found to work. Data modifications (byte table) are safe.
+ *
+ * BUILT-IN FALLBACK:
+ * Patch bytes are constexpr arrays referenced through ByteView. A signature
+ * database (see SignatureDatabase.h) can replace any of them at startup by
+ * re-pointing the views into its mapping; without one, these definitions are used.
  */
 
 #pragma once
@@ -25,6 +30,8 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include "ByteView.h"
+#include "UrlRedirect.h"
 
 namespace Patches {
 
@@ -35,6 +42,26 @@ namespace Patches {
 /// Base address of the unlock byte table in FFXV's memory
 constexpr uintptr_t UNLOCK_TABLE_BASE = 0x140752038;
 
+/// Phase 6 jump table: one 4-byte handler RVA per item, indexed by
+/// itemId - JUMP_TABLE_FIRST_ITEM. The game bounds-checks the index against
+/// 0x14 before the lookup, so the table has 0x15 entries.
+constexpr uintptr_t JUMP_TABLE_BASE = 0x14075206C;
+constexpr uint8_t JUMP_TABLE_FIRST_ITEM = 0x1F;
+constexpr size_t JUMP_TABLE_ENTRIES = 0x15;
+
+/// Default port the URL redirect patches point at (the local HTTP server's
+/// port). Changing it regenerates the built-in patch bytes; ports that do
+/// not fit in the original URLs are rejected at compile time. The port can
+/// also be changed at runtime with setRedirectPort().
+constexpr uint16_t REDIRECT_PORT = 443;
+
+/// Preferred load address of ffxv_s.exe (RVAs are relative to this)
+constexpr uintptr_t DEFAULT_IMAGE_BASE = 0x140000000;
+
+/// Revision of the definitions in this file. A signature database with a
+/// lower data version is considered stale and ignored.
+constexpr uint32_t BUILTIN_DATA_VERSION = 1;
+
 // ============================================================================
 // Data Structures
 // ============================================================================
@@ -61,19 +88,59 @@ struct UnlockBundle {
     bool enabled = false;
 };
 
+/**
+ * @brief Image section a patch is expected to live in
+ *
+ * Only a hint: scans still cover the whole module.
+ */
+enum class SectionHint : uint8_t {
+    Any,
+    Text,    ///< Executable code
+    RData,   ///< Read-only data (string literals)
+    Data     ///< Writable data
+};
+
 /**
  * @brief AOB pattern-based code patch
  */
 struct Patch {
     std::string name;
     std::string description;
-    std::vector<uint8_t> pattern;   ///< Bytes to search for
-    std::vector<uint8_t> original;  ///< Original bytes (for restoration)
-    std::vector<uint8_t> patched;   ///< Replacement bytes
+    ByteView pattern;               ///< Bytes to search for
+    ByteView original;              ///< Original bytes (for restoration)
+    ByteView patched;               ///< Replacement bytes
     int offset;                     ///< Offset from pattern match to patch location
+    ByteView mask;                  ///< Per-byte match mask (0xFF = exact, 0x00 = wildcard); empty = exact
+    SectionHint section = SectionHint::Any;
+    uint32_t rvaHint = 0;           ///< Patch site (match + offset) in the reference build; 0 = none
     bool enabled = false;
 };
 
+/**
+ * @brief How an instruction operand encodes the address it refers to
+ */
+enum class OperandKind : uint8_t {
+    RipRelative,    ///< disp32 relative to the end of the instruction
+    ImageRelative,  ///< disp32 RVA, added to a register holding the image base
+    Absolute32,     ///< 32-bit absolute address
+    Absolute64      ///< 64-bit absolute address (mov r64, imm64)
+};
+
+/**
+ * @brief Pattern whose match contains an address operand
+ *
+ * Used to derive addresses from the code that references them, so they
+ * follow the build and the load address instead of being hardcoded.
+ */
+struct OperandReference {
+    std::string name;
+    ByteView pattern;
+    ByteView mask;                  ///< Wildcard the operand bytes
+    int operandOffset;              ///< Operand position from the match start
+    int instructionEnd;             ///< Next instruction from the match start (RipRelative only)
+    OperandKind kind;
+};
+
 /**
  * @brief Category for UI organization
  */
@@ -203,119 +270,75 @@ inline UnlockItem ALIEN_SHIELD = {
 // URL Redirect Patches (Twitch Prime Spoofing)
 // ============================================================================
 
-/// Redirects Twitch OAuth2 authorize URL to localhost:443
+inline constexpr char TWITCH_API_PREFIX[]  = "https://api.twitch.tv/";
+inline constexpr char TWITCH_BLOG_PREFIX[] = "https://blog.twitch.tv/";
+
+// Format string used by the game's OAuth2 login request
+inline constexpr char URL_OAUTH2_AUTHORIZE_TEXT[] =
+    "https://api.twitch.tv/kraken/oauth2/authorize?response_type=token+id_token"
+    "&client_id=%s&redirect_uri=http://localhost&scope=user_read+openid"
+    "&force_verify=true&state=%s";
+static_assert(UrlRedirect::startsWith(URL_OAUTH2_AUTHORIZE_TEXT, TWITCH_API_PREFIX), "OAuth2 URL must start with the API prefix");
+
+inline constexpr auto URL_OAUTH2_AUTHORIZE_ORIGINAL =
+    UrlRedirect::original<UrlRedirect::Terminator::Excluded>(URL_OAUTH2_AUTHORIZE_TEXT);
+inline constexpr auto URL_OAUTH2_AUTHORIZE_PATCHED =
+    UrlRedirect::patched<REDIRECT_PORT, UrlRedirect::Terminator::Excluded>(URL_OAUTH2_AUTHORIZE_TEXT, TWITCH_API_PREFIX);
+
+/// Redirects Twitch OAuth2 authorize URL to localhost:REDIRECT_PORT
 inline Patch URL_OAUTH2_AUTHORIZE = {
     "OAuth2 URL Redirect",
     "Redirects Twitch OAuth2 authorize URL to localhost",
-    // Pattern: "https://api.twitch.tv/kraken/oauth2/authorize?..."
-    {0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x61, 0x70, 0x69, 0x2E,
-     0x74, 0x77, 0x69, 0x74, 0x63, 0x68, 0x2E, 0x74, 0x76, 0x2F, 0x6B, 0x72,
-     0x61, 0x6B, 0x65, 0x6E, 0x2F, 0x6F, 0x61, 0x75, 0x74, 0x68, 0x32, 0x2F,
-     0x61, 0x75, 0x74, 0x68, 0x6F, 0x72, 0x69, 0x7A, 0x65, 0x3F, 0x72, 0x65,
-     0x73, 0x70, 0x6F, 0x6E, 0x73, 0x65, 0x5F, 0x74, 0x79, 0x70, 0x65, 0x3D,
-     0x74, 0x6F, 0x6B, 0x65, 0x6E, 0x2B, 0x69, 0x64, 0x5F, 0x74, 0x6F, 0x6B,
-     0x65, 0x6E, 0x26, 0x63, 0x6C, 0x69, 0x65, 0x6E, 0x74, 0x5F, 0x69, 0x64,
-     0x3D, 0x25, 0x73, 0x26, 0x72, 0x65, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74,
-     0x5F, 0x75, 0x72, 0x69, 0x3D, 0x68, 0x74, 0x74, 0x70, 0x3A, 0x2F, 0x2F,
-     0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x68, 0x6F, 0x73, 0x74, 0x26, 0x73, 0x63,
-     0x6F, 0x70, 0x65, 0x3D, 0x75, 0x73, 0x65, 0x72, 0x5F, 0x72, 0x65, 0x61,
-     0x64, 0x2B, 0x6F, 0x70, 0x65, 0x6E, 0x69, 0x64, 0x26, 0x66, 0x6F, 0x72,
-     0x63, 0x65, 0x5F, 0x76, 0x65, 0x72, 0x69, 0x66, 0x79, 0x3D, 0x74, 0x72,
-     0x75, 0x65, 0x26, 0x73, 0x74, 0x61, 0x74, 0x65, 0x3D, 0x25, 0x73},
-    // Original bytes (same as pattern for full replacement)
-    {0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x61, 0x70, 0x69, 0x2E,
-     0x74, 0x77, 0x69, 0x74, 0x63, 0x68, 0x2E, 0x74, 0x76, 0x2F, 0x6B, 0x72,
-     0x61, 0x6B, 0x65, 0x6E, 0x2F, 0x6F, 0x61, 0x75, 0x74, 0x68, 0x32, 0x2F,
-     0x61, 0x75, 0x74, 0x68, 0x6F, 0x72, 0x69, 0x7A, 0x65, 0x3F, 0x72, 0x65,
-     0x73, 0x70, 0x6F, 0x6E, 0x73, 0x65, 0x5F, 0x74, 0x79, 0x70, 0x65, 0x3D,
-     0x74, 0x6F, 0x6B, 0x65, 0x6E, 0x2B, 0x69, 0x64, 0x5F, 0x74, 0x6F, 0x6B,
-     0x65, 0x6E, 0x26, 0x63, 0x6C, 0x69, 0x65, 0x6E, 0x74, 0x5F, 0x69, 0x64,
-     0x3D, 0x25, 0x73, 0x26, 0x72, 0x65, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74,
-     0x5F, 0x75, 0x72, 0x69, 0x3D, 0x68, 0x74, 0x74, 0x70, 0x3A, 0x2F, 0x2F,
-     0x6C, 0x6F, 0x63, 0x61, 0x6C, 0x68, 0x6F, 0x73, 0x74, 0x26, 0x73, 0x63,
-     0x6F, 0x70, 0x65, 0x3D, 0x75, 0x73, 0x65, 0x72, 0x5F, 0x72, 0x65, 0x61,
-     0x64, 0x2B, 0x6F, 0x70, 0x65, 0x6E, 0x69, 0x64, 0x26, 0x66, 0x6F, 0x72,
-     0x63, 0x65, 0x5F, 0x76, 0x65, 0x72, 0x69, 0x66, 0x79, 0x3D, 0x74, 0x72,
-     0x75, 0x65, 0x26, 0x73, 0x74, 0x61, 0x74, 0x65, 0x3D, 0x25, 0x73},
-    // Patched: "http://localhost:443/kraken/oauth2/authorize?..."
-    {0x68, 0x74, 0x74, 0x70, 0x3A, 0x2F, 0x2F, 0x6C, 0x6F, 0x63, 0x61, 0x6C,
-     0x68, 0x6F, 0x73, 0x74, 0x3A, 0x34, 0x34, 0x33, 0x2F, 0x6B, 0x72, 0x61,
-     0x6B, 0x65, 0x6E, 0x2F, 0x6F, 0x61, 0x75, 0x74, 0x68, 0x32, 0x2F, 0x61,
-     0x75, 0x74, 0x68, 0x6F, 0x72, 0x69, 0x7A, 0x65, 0x3F, 0x72, 0x65, 0x73,
-     0x70, 0x6F, 0x6E, 0x73, 0x65, 0x5F, 0x74, 0x79, 0x70, 0x65, 0x3D, 0x74,
-     0x6F, 0x6B, 0x65, 0x6E, 0x2B, 0x69, 0x64, 0x5F, 0x74, 0x6F, 0x6B, 0x65,
-     0x6E, 0x26, 0x63, 0x6C, 0x69, 0x65, 0x6E, 0x74, 0x5F, 0x69, 0x64, 0x3D,
-     0x25, 0x73, 0x26, 0x72, 0x65, 0x64, 0x69, 0x72, 0x65, 0x63, 0x74, 0x5F,
-     0x75, 0x72, 0x69, 0x3D, 0x68, 0x74, 0x74, 0x70, 0x3A, 0x2F, 0x2F, 0x6C,
-     0x6F, 0x63, 0x61, 0x6C, 0x68, 0x6F, 0x73, 0x74, 0x26, 0x73, 0x63, 0x6F,
-     0x70, 0x65, 0x3D, 0x75, 0x73, 0x65, 0x72, 0x5F, 0x72, 0x65, 0x61, 0x64,
-     0x2B, 0x6F, 0x70, 0x65, 0x6E, 0x69, 0x64, 0x26, 0x66, 0x6F, 0x72, 0x63,
-     0x65, 0x5F, 0x76, 0x65, 0x72, 0x69, 0x66, 0x79, 0x3D, 0x74, 0x72, 0x75,
-     0x65, 0x26, 0x73, 0x74, 0x61, 0x74, 0x65, 0x3D, 0x25, 0x73, 0x00},
-    0
-};
-
-/// Redirects Twitch API base URL to localhost:443
+    URL_OAUTH2_AUTHORIZE_ORIGINAL,
+    URL_OAUTH2_AUTHORIZE_ORIGINAL,  // Same as pattern for full replacement
+    URL_OAUTH2_AUTHORIZE_PATCHED,
+    0, {}, SectionHint::RData
+};
+
+// Matched with its NUL so only the bare base URL string is rewritten
+inline constexpr auto URL_API_BASE_ORIGINAL =
+    UrlRedirect::original<UrlRedirect::Terminator::Included>(TWITCH_API_PREFIX);
+inline constexpr auto URL_API_BASE_PATCHED =
+    UrlRedirect::patched<REDIRECT_PORT, UrlRedirect::Terminator::Included>(TWITCH_API_PREFIX, TWITCH_API_PREFIX);
+
+/// Redirects Twitch API base URL to localhost:REDIRECT_PORT
 inline Patch URL_API_BASE = {
     "API Base URL Redirect",
     "Redirects Twitch API base URL to localhost",
-    // Pattern: "https://api.twitch.tv/"
-    {0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x61, 0x70, 0x69, 0x2E,
-     0x74, 0x77, 0x69, 0x74, 0x63, 0x68, 0x2E, 0x74, 0x76, 0x2F, 0x00},
-    {0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x61, 0x70, 0x69, 0x2E,
-     0x74, 0x77, 0x69, 0x74, 0x63, 0x68, 0x2E, 0x74, 0x76, 0x2F, 0x00},
-    // Patched: "http://localhost:443/"
-    {0x68, 0x74, 0x74, 0x70, 0x3A, 0x2F, 0x2F, 0x6C, 0x6F, 0x63, 0x61, 0x6C,
-     0x68, 0x6F, 0x73, 0x74, 0x3A, 0x34, 0x34, 0x33, 0x2F, 0x00, 0x00},
-    0
+    URL_API_BASE_ORIGINAL,
+    URL_API_BASE_ORIGINAL,
+    URL_API_BASE_PATCHED,
+    0, {}, SectionHint::RData
 };
 
+inline constexpr char URL_BLOG_TEXT[] =
+    "https://blog.twitch.tv/twitch-prime-members-get-your-own-kooky-chocobo-more-in-"
+    "final-fantasy-xv-windows-edition-87d04c6ae217";
+static_assert(UrlRedirect::startsWith(URL_BLOG_TEXT, TWITCH_BLOG_PREFIX), "Blog URL must start with the blog prefix");
+
+inline constexpr auto URL_BLOG_ORIGINAL =
+    UrlRedirect::original<UrlRedirect::Terminator::Excluded>(URL_BLOG_TEXT);
+inline constexpr auto URL_BLOG_PATCHED =
+    UrlRedirect::patched<REDIRECT_PORT, UrlRedirect::Terminator::Excluded>(URL_BLOG_TEXT, TWITCH_BLOG_PREFIX);
+
 /// Redirects Twitch blog URL to local page
 inline Patch URL_BLOG = {
     "Blog URL Redirect",
     "Redirects Twitch blog URL to local page",
-    // Pattern: "https://blog.twitch.tv/twitch-prime-members..."
-    {0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x62, 0x6C, 0x6F, 0x67,
-     0x2E, 0x74, 0x77, 0x69, 0x74, 0x63, 0x68, 0x2E, 0x74, 0x76, 0x2F, 0x74,
-     0x77, 0x69, 0x74, 0x63, 0x68, 0x2D, 0x70, 0x72, 0x69, 0x6D, 0x65, 0x2D,
-     0x6D, 0x65, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x2D, 0x67, 0x65, 0x74, 0x2D,
-     0x79, 0x6F, 0x75, 0x72, 0x2D, 0x6F, 0x77, 0x6E, 0x2D, 0x6B, 0x6F, 0x6F,
-     0x6B, 0x79, 0x2D, 0x63, 0x68, 0x6F, 0x63, 0x6F, 0x62, 0x6F, 0x2D, 0x6D,
-     0x6F, 0x72, 0x65, 0x2D, 0x69, 0x6E, 0x2D, 0x66, 0x69, 0x6E, 0x61, 0x6C,
-     0x2D, 0x66, 0x61, 0x6E, 0x74, 0x61, 0x73, 0x79, 0x2D, 0x78, 0x76, 0x2D,
-     0x77, 0x69, 0x6E, 0x64, 0x6F, 0x77, 0x73, 0x2D, 0x65, 0x64, 0x69, 0x74,
-     0x69, 0x6F, 0x6E, 0x2D, 0x38, 0x37, 0x64, 0x30, 0x34, 0x63, 0x36, 0x61,
-     0x65, 0x32, 0x31, 0x37},
-    {0x68, 0x74, 0x74, 0x70, 0x73, 0x3A, 0x2F, 0x2F, 0x62, 0x6C, 0x6F, 0x67,
-     0x2E, 0x74, 0x77, 0x69, 0x74, 0x63, 0x68, 0x2E, 0x74, 0x76, 0x2F, 0x74,
-     0x77, 0x69, 0x74, 0x63, 0x68, 0x2D, 0x70, 0x72, 0x69, 0x6D, 0x65, 0x2D,
-     0x6D, 0x65, 0x6D, 0x62, 0x65, 0x72, 0x73, 0x2D, 0x67, 0x65, 0x74, 0x2D,
-     0x79, 0x6F, 0x75, 0x72, 0x2D, 0x6F, 0x77, 0x6E, 0x2D, 0x6B, 0x6F, 0x6F,
-     0x6B, 0x79, 0x2D, 0x63, 0x68, 0x6F, 0x63, 0x6F, 0x62, 0x6F, 0x2D, 0x6D,
-     0x6F, 0x72, 0x65, 0x2D, 0x69, 0x6E, 0x2D, 0x66, 0x69, 0x6E, 0x61, 0x6C,
-     0x2D, 0x66, 0x61, 0x6E, 0x74, 0x61, 0x73, 0x79, 0x2D, 0x78, 0x76, 0x2D,
-     0x77, 0x69, 0x6E, 0x64, 0x6F, 0x77, 0x73, 0x2D, 0x65, 0x64, 0x69, 0x74,
-     0x69, 0x6F, 0x6E, 0x2D, 0x38, 0x37, 0x64, 0x30, 0x34, 0x63, 0x36, 0x61,
-     0x65, 0x32, 0x31, 0x37},
-    // Patched: "http://localhost:443/twitch-prime-members..."
-    {0x68, 0x74, 0x74, 0x70, 0x3A, 0x2F, 0x2F, 0x6C, 0x6F, 0x63, 0x61, 0x6C,
-     0x68, 0x6F, 0x73, 0x74, 0x3A, 0x34, 0x34, 0x33, 0x2F, 0x74, 0x77, 0x69,
-     0x74, 0x63, 0x68, 0x2D, 0x70, 0x72, 0x69, 0x6D, 0x65, 0x2D, 0x6D, 0x65,
-     0x6D, 0x62, 0x65, 0x72, 0x73, 0x2D, 0x67, 0x65, 0x74, 0x2D, 0x79, 0x6F,
-     0x75, 0x72, 0x2D, 0x6F, 0x77, 0x6E, 0x2D, 0x6B, 0x6F, 0x6F, 0x6B, 0x79,
-     0x2D, 0x63, 0x68, 0x6F, 0x63, 0x6F, 0x62, 0x6F, 0x2D, 0x6D, 0x6F, 0x72,
-     0x65, 0x2D, 0x69, 0x6E, 0x2D, 0x66, 0x69, 0x6E, 0x61, 0x6C, 0x2D, 0x66,
-     0x61, 0x6E, 0x74, 0x61, 0x73, 0x79, 0x2D, 0x78, 0x76, 0x2D, 0x77, 0x69,
-     0x6E, 0x64, 0x6F, 0x77, 0x73, 0x2D, 0x65, 0x64, 0x69, 0x74, 0x69, 0x6F,
-     0x6E, 0x2D, 0x38, 0x37, 0x64, 0x30, 0x34, 0x63, 0x36, 0x61, 0x65, 0x32,
-     0x31, 0x37, 0x00, 0x00},
-    0
+    URL_BLOG_ORIGINAL,
+    URL_BLOG_ORIGINAL,
+    URL_BLOG_PATCHED,
+    0, {}, SectionHint::RData
 };
 
 // ============================================================================
 // Platform Exclusive Unlock Patches
 // ============================================================================
 
+inline constexpr uint8_t UNLOCK1_PATTERN[]  = {0x83, 0xF8, 0x33, 0x77, 0x1A};  // cmp eax,33; ja +1A
+inline constexpr uint8_t UNLOCK1_ORIGINAL[] = {0x77, 0x1A};                    // ja +1A (original)
+inline constexpr uint8_t UNLOCK1_PATCHED[]  = {0xEB, 0x1A};                    // jmp +1A (patched)
+
 /**
  * Unlock 1 - Bounds Bypass
  * Required before Unlock 2. Changes conditional jump to unconditional.
@@ -324,12 +347,16 @@ inline Patch URL_BLOG = {
 inline Patch UNLOCK1_BOUNDS_BYPASS = {
     "Unlock 1 - Bounds Bypass",
     "Forces all items through unlock path",
-    {0x83, 0xF8, 0x33, 0x77, 0x1A},  // cmp eax,33; ja +1A
-    {0x77, 0x1A},                     // ja +1A (original)
-    {0xEB, 0x1A},                     // jmp +1A (patched)
-    3                                 // Offset to ja instruction
+    UNLOCK1_PATTERN,
+    UNLOCK1_ORIGINAL,
+    UNLOCK1_PATCHED,
+    3,                                // Offset to ja instruction
+    {}, SectionHint::Text, 0x751CA8
 };
 
+inline constexpr uint8_t UNLOCK2_ORIGINAL[] = {0x41, 0x80, 0xF4, 0x01, 0x83, 0xFD, 0x14};  // xor r12l,01; cmp ebp,14
+inline constexpr uint8_t UNLOCK2_PATCHED[]  = {0x4D, 0x31, 0xE4, 0x41, 0x38, 0xD4, 0xF8};  // xor r12,r12; cmp r12l,dl; clc
+
 /**
  * Unlock 2 - Steam Bypass (requires Unlock 1)
  * Clears r12 and CF for Steam/Promotional items.
@@ -338,12 +365,16 @@ inline Patch UNLOCK1_BOUNDS_BYPASS = {
 inline Patch UNLOCK2_STEAM_BYPASS = {
     "Unlock 2 - Steam Bypass",
     "Clears r12 and CF for Steam/Promotional items",
-    {0x41, 0x80, 0xF4, 0x01, 0x83, 0xFD, 0x14},  // xor r12l,01; cmp ebp,14
-    {0x41, 0x80, 0xF4, 0x01, 0x83, 0xFD, 0x14},  // Original (7 bytes)
-    {0x4D, 0x31, 0xE4, 0x41, 0x38, 0xD4, 0xF8},  // xor r12,r12; cmp r12l,dl; clc
-    0
+    UNLOCK2_ORIGINAL,  // Pattern is the original 7 bytes
+    UNLOCK2_ORIGINAL,
+    UNLOCK2_PATCHED,
+    0, {}, SectionHint::Text, 0x751CC8
 };
 
+inline constexpr uint8_t UNLOCK3_PATTERN[]  = {0x84, 0xD2, 0x74, 0x4F, 0xEB, 0x0D};  // test dl,dl; je +4F; jmp +0D
+inline constexpr uint8_t UNLOCK3_ORIGINAL[] = {0x74, 0x4F};                          // je +4F (original)
+inline constexpr uint8_t UNLOCK3_PATCHED[]  = {0x90, 0x90};                          // nop nop (patched)
+
 /**
  * Unlock 3 - DL Bypass (Ownership Gate)
  * NOPs the jump that skips items with DL=0.
@@ -353,117 +384,195 @@ inline Patch UNLOCK2_STEAM_BYPASS = {
 inline Patch UNLOCK3_DL_BYPASS = {
     "Unlock 3 - DL Bypass",
     "NOPs ownership check jump - unlocks all platform exclusives",
-    {0x84, 0xD2, 0x74, 0x4F, 0xEB, 0x0D},  // test dl,dl; je +4F; jmp +0D
-    {0x74, 0x4F},                           // je +4F (original)
-    {0x90, 0x90},                           // nop nop (patched)
-    2                                       // Offset to je instruction
+    UNLOCK3_PATTERN,
+    UNLOCK3_ORIGINAL,
+    UNLOCK3_PATCHED,
+    2,                                      // Offset to je instruction
+    {}, SectionHint::Text, 0x751F5C
 };
 
 // ============================================================================
 // Twitch Prime Reward Patches
 // ============================================================================
 
+inline constexpr uint8_t GOODS_SIZE_CHECK_PATTERN[]  = {0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00, 0x44, 0x8B, 0xC6, 0x48};
+inline constexpr uint8_t GOODS_SIZE_CHECK_ORIGINAL[] = {0x0F, 0x8E, 0x10, 0x01, 0x00, 0x00};
+inline constexpr uint8_t GOODS_SIZE_CHECK_PATCHED[]  = {0x90, 0x90, 0x90, 0x90, 0x90, 0x90};
+
 inline Patch NOP_GOODS_ARRAY_SIZE_CHECK = {
     "Bypass Goods Array Size Check",
     "NOPs the conditional jump that validates goods array size",
-    {0x0F, 0x1F, 0x80, 0x00, 0x00, 0x00, 0x00, 0x44, 0x8B, 0xC6, 0x48},
-    {0x0F, 0x8E, 0x10, 0x01, 0x00, 0x00},
-    {0x90, 0x90, 0x90, 0x90, 0x90, 0x90},
-    -6
+    GOODS_SIZE_CHECK_PATTERN,
+    GOODS_SIZE_CHECK_ORIGINAL,
+    GOODS_SIZE_CHECK_PATCHED,
+    -6, {}, SectionHint::Text
 };
 
+inline constexpr uint8_t FFXV_TP_001_PATTERN[]  = {0x41, 0xB0, 0x01, 0xBA, 0x23, 0x00, 0x00, 0x00};
+inline constexpr uint8_t FFXV_TP_001_PATCHED[]  = {0x83, 0xFE, 0x01, 0x73, 0x17};
+inline constexpr uint8_t FFXV_TP_002_PATTERN[]  = {0x41, 0xB0, 0x01, 0xBA, 0x22, 0x00, 0x00, 0x00, 0x48, 0x8B, 0xCB};
+inline constexpr uint8_t FFXV_TP_002_PATCHED[]  = {0x83, 0xFE, 0x02, 0x73, 0x17};
+inline constexpr uint8_t FFXV_TP_003_PATTERN[]  = {0x41, 0xB0, 0x01, 0xBA, 0x21, 0x00, 0x00, 0x00};
+inline constexpr uint8_t FFXV_TP_003_PATCHED[]  = {0x83, 0xFE, 0x03, 0x73, 0x21};
+inline constexpr uint8_t FFXV_TP_JE17_ORIGINAL[] = {0x48, 0x85, 0xC0, 0x74, 0x17};  // test rax,rax; je +17 (TP_001, TP_002)
+inline constexpr uint8_t FFXV_TP_JE21_ORIGINAL[] = {0x48, 0x85, 0xC0, 0x74, 0x21};  // test rax,rax; je +21 (TP_003)
+
 inline Patch FFXV_TP_001 = {
     "Kooky Chocobo",
     "Unlocks Kooky Chocobo companion",
-    {0x41, 0xB0, 0x01, 0xBA, 0x23, 0x00, 0x00, 0x00},
-    {0x48, 0x85, 0xC0, 0x74, 0x17},
-    {0x83, 0xFE, 0x01, 0x73, 0x17},
-    -5
+    FFXV_TP_001_PATTERN,
+    FFXV_TP_JE17_ORIGINAL,
+    FFXV_TP_001_PATCHED,
+    -5, {}, SectionHint::Text
 };
 
 inline Patch FFXV_TP_002 = {
     "10,000 Gil",
     "Unlocks 10,000 Gil bonus",
-    {0x41, 0xB0, 0x01, 0xBA, 0x22, 0x00, 0x00, 0x00, 0x48, 0x8B, 0xCB},
-    {0x48, 0x85, 0xC0, 0x74, 0x17},
-    {0x83, 0xFE, 0x02, 0x73, 0x17},
-    -5
+    FFXV_TP_002_PATTERN,
+    FFXV_TP_JE17_ORIGINAL,
+    FFXV_TP_002_PATCHED,
+    -5, {}, SectionHint::Text
 };
 
 inline Patch FFXV_TP_003 = {
     "100 AP",
     "Unlocks 100 AP bonus",
-    {0x41, 0xB0, 0x01, 0xBA, 0x21, 0x00, 0x00, 0x00},
-    {0x48, 0x85, 0xC0, 0x74, 0x21},
-    {0x83, 0xFE, 0x03, 0x73, 0x21},
-    -5
+    FFXV_TP_003_PATTERN,
+    FFXV_TP_JE21_ORIGINAL,
+    FFXV_TP_003_PATCHED,
+    -5, {}, SectionHint::Text
 };
 
+inline constexpr uint8_t CHECK_ITERATIONS_PATTERN[]  = {0xFF, 0xC6, 0x48, 0x8D, 0x4D, 0x20};
+inline constexpr uint8_t CHECK_ITERATIONS_ORIGINAL[] = {0xFF, 0xC6, 0x48, 0x8D, 0x4D, 0x20};
+inline constexpr uint8_t CHECK_ITERATIONS_PATCHED[]  = {0xB8, 0x03, 0x00, 0x00, 0x00, 0x90};
+
 inline Patch CHECK_ITERATIONS = {
     "Force 3 Iterations",
     "Forces the reward check loop to iterate exactly 3 times",
-    {0xFF, 0xC6, 0x48, 0x8D, 0x4D, 0x20},
-    {0xFF, 0xC6, 0x48, 0x8D, 0x4D},
-    {0xB8, 0x03, 0x00, 0x00, 0x00},
-    6
+    CHECK_ITERATIONS_PATTERN,
+    CHECK_ITERATIONS_ORIGINAL,
+    CHECK_ITERATIONS_PATCHED,
+    6, {}, SectionHint::Text
+};
+
+// ============================================================================
+// Address References
+// ============================================================================
+
+// movzx eax, byte ptr [r8+rax+disp32]  ; byte table lookup (r8 = image base)
+// mov ecx, [r8+rax*4+disp32]           ; skip/continue target table
+inline constexpr uint8_t UNLOCK_TABLE_LOOKUP_PATTERN[] = {
+    0x41, 0x0F, 0xB6, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x41, 0x8B, 0x8C, 0x80, 0x00, 0x00, 0x00, 0x00
+};
+inline constexpr uint8_t UNLOCK_TABLE_LOOKUP_MASK[] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00
+};
+
+/**
+ * Unlock table base, from the Phase 4 lookup at ffxv_s.exe+751CAC.
+ * The displacement is an RVA (the game adds its image base in r8), so the
+ * resolved address is module base + disp32.
+ */
+inline OperandReference UNLOCK_TABLE_REFERENCE = {
+    "Unlock Table Lookup",
+    UNLOCK_TABLE_LOOKUP_PATTERN,
+    UNLOCK_TABLE_LOOKUP_MASK,
+    5,                                      // disp32 of the movzx
+    9,
+    OperandKind::ImageRelative
+};
+
+// movsxd rax, ebp
+// mov ecx, [r8+rax*4+disp32]   ; jump table lookup (r8 = image base)
+// add rcx, r8
+// jmp rcx
+inline constexpr uint8_t JUMP_TABLE_LOOKUP_PATTERN[] = {
+    0x48, 0x63, 0xC5,
+    0x41, 0x8B, 0x8C, 0x80, 0x00, 0x00, 0x00, 0x00,
+    0x49, 0x03, 0xC8,
+    0xFF, 0xE1
+};
+inline constexpr uint8_t JUMP_TABLE_LOOKUP_MASK[] = {
+    0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF
+};
+
+/**
+ * Jump table base, from the Phase 6 dispatch at ffxv_s.exe+751CD5.
+ * Image-relative like the unlock table lookup.
+ */
+inline OperandReference JUMP_TABLE_REFERENCE = {
+    "Jump Table Dispatch",
+    JUMP_TABLE_LOOKUP_PATTERN,
+    JUMP_TABLE_LOOKUP_MASK,
+    7,                                      // disp32 of the mov
+    11,
+    OperandKind::ImageRelative
 };
 
 // ============================================================================
 // Collection Accessors
 // ============================================================================
 
-inline std::vector<UnlockItem*> getNormallyUnavailableItems() {
-    return {
+// Item and bundle lists are built once. UI, profiles and tools read them
+// through UnlockRegistry; only code that edits the definitions themselves
+// (signature database overlay, table rebase) walks them directly.
+
+inline const std::vector<UnlockItem*>& getNormallyUnavailableItems() {
+    static const std::vector<UnlockItem*> items = {
         &BLAZEFIRE_SABER, &NOODLE_HELMET, &KINGS_KNIGHT_STICKER,
         &KINGGLAIVES_PACK, &PARTY_PACK, &MEMORIES_KINGS_KNIGHT, &KINGS_KNIGHT_TEE
     };
+    return items;
 }
 
-inline std::vector<UnlockBundle*> getTwitchPrimeBundles() {
-    return { &WEATHERWORN_BUNDLE, &KOOKY_TEE_BUNDLE, &KOOKY_CHOCOBO_BUNDLE };
+inline const std::vector<UnlockBundle*>& getTwitchPrimeBundles() {
+    static const std::vector<UnlockBundle*> bundles = {
+        &WEATHERWORN_BUNDLE, &KOOKY_TEE_BUNDLE, &KOOKY_CHOCOBO_BUNDLE
+    };
+    return bundles;
 }
 
-inline std::vector<UnlockItem*> getSteamItems() {
-    return {
+inline const std::vector<UnlockItem*>& getSteamItems() {
+    static const std::vector<UnlockItem*> items = {
         &FASHION_COLLECTION, &HEV_SUIT, &SCIENTIST_GLASSES,
         &CROWBAR_COMRADES, &HALFLIFE_COSTUME, &CROWBAR
     };
+    return items;
 }
 
-inline std::vector<UnlockItem*> getOriginItems() {
-    return { &DECAL_SELECTION, &SIMS4_PACK };
-}
-
-inline std::vector<UnlockItem*> getMicrosoftStoreItems() {
-    return { &POWERUP_PACK };
+inline const std::vector<UnlockItem*>& getOriginItems() {
+    static const std::vector<UnlockItem*> items = { &DECAL_SELECTION, &SIMS4_PACK };
+    return items;
 }
 
-inline std::vector<UnlockItem*> getPromotionalItems() {
-    return { &INTEL_8700K, &ALIEN_SHIELD };
+inline const std::vector<UnlockItem*>& getMicrosoftStoreItems() {
+    static const std::vector<UnlockItem*> items = { &POWERUP_PACK };
+    return items;
 }
 
-inline std::vector<UnlockItem*> getAllUnlockItems() {
-    std::vector<UnlockItem*> all;
-    auto add = [&all](std::vector<UnlockItem*> items) {
-        all.insert(all.end(), items.begin(), items.end());
-    };
-    add(getNormallyUnavailableItems());
-    add(getSteamItems());
-    add(getOriginItems());
-    add(getMicrosoftStoreItems());
-    add(getPromotionalItems());
-    return all;
+inline const std::vector<UnlockItem*>& getPromotionalItems() {
+    static const std::vector<UnlockItem*> items = { &INTEL_8700K, &ALIEN_SHIELD };
+    return items;
 }
 
-/// Returns only items that can be individually toggled (not anti-tamper protected)
-inline std::vector<UnlockItem*> getSelectableItems() {
-    std::vector<UnlockItem*> items;
-    for (auto* item : getAllUnlockItems()) {
-        if (item->selectable) {
-            items.push_back(item);
+/// Every item definition, in category order
+inline const std::vector<UnlockItem*>& getAllUnlockItems() {
+    static const std::vector<UnlockItem*> all = [] {
+        std::vector<UnlockItem*> all;
+        for (const auto* items : {&getNormallyUnavailableItems(), &getSteamItems(), &getOriginItems(),
+                                  &getMicrosoftStoreItems(), &getPromotionalItems()}) {
+            all.insert(all.end(), items->begin(), items->end());
         }
-    }
-    return items;
+        return all;
+    }();
+    return all;
 }
 
 inline std::vector<Patch*> getAllPatches() {
@@ -479,6 +588,42 @@ inline std::vector<Patch*> getURLPatches() {
     return { &URL_OAUTH2_AUTHORIZE, &URL_API_BASE, &URL_BLOG };
 }
 
+/// Port the URL patches currently redirect to; changed by setRedirectPort()
+inline uint16_t activeRedirectPort = REDIRECT_PORT;
+
+/// Backing storage for regenerated URL patches, one per getURLPatches() entry.
+/// Each is sized to its URL slot on first use and rewritten in place after that.
+inline std::vector<std::vector<uint8_t>> urlPatchBuffers;
+
+/**
+ * @brief Regenerates the URL patch bytes for a new local server port
+ *
+ * Every slot is checked before any is changed, so on failure all URL patches
+ * keep their previous bytes. Only the patch data changes; rewriting a patch
+ * that is already applied in the game is up to the caller.
+ *
+ * @return false if localhost:<port> does not fit in one of the original URLs
+ */
+inline bool setRedirectPort(uint16_t port) {
+    std::vector<Patch*> patches = getURLPatches();
+    for (auto* patch : patches) {
+        size_t prefix = UrlRedirect::prefixLength(patch->original.data, patch->original.size);
+        if (prefix == 0 || UrlRedirect::localhostLength(port) > prefix) {
+            return false;
+        }
+    }
+
+    urlPatchBuffers.resize(patches.size());
+    for (size_t i = 0; i < patches.size(); ++i) {
+        std::vector<uint8_t>& buffer = urlPatchBuffers[i];
+        buffer.resize(patches[i]->original.size);
+        UrlRedirect::regenerate(patches[i]->original.data, patches[i]->original.size, port, buffer.data());
+        patches[i]->patched = buffer;
+    }
+    activeRedirectPort = port;
+    return true;
+}
+
 inline std::vector<Patch*> getTwitchPrimePatches() {
     return {
         &NOP_GOODS_ARRAY_SIZE_CHECK,
@@ -501,6 +646,23 @@ inline Patch* getUnlock1Patch() { return &UNLOCK1_BOUNDS_BYPASS; }
 inline Patch* getUnlock2Patch() { return &UNLOCK2_STEAM_BYPASS; }
 inline Patch* getUnlock3Patch() { return &UNLOCK3_DL_BYPASS; }
 
+/// Table base that item and bundle addresses currently point at. Starts at
+/// UNLOCK_TABLE_BASE and only changes through rebaseUnlockTable().
+inline uintptr_t activeUnlockTableBase = UNLOCK_TABLE_BASE;
+
+/// Moves every item and bundle address onto a table at newBase
+inline void rebaseUnlockTable(uintptr_t newBase) {
+    for (auto* item : getAllUnlockItems()) {
+        item->address = newBase + item->itemId;
+    }
+    for (auto* bundle : getTwitchPrimeBundles()) {
+        for (auto& address : bundle->addresses) {
+            address = newBase + (address - activeUnlockTableBase);
+        }
+    }
+    activeUnlockTableBase = newBase;
+}
+
 /// Returns true if item requires Platform Exclusives patch (not selectable)
 inline bool itemRequiresDLBypass(const UnlockItem* item) {
     return !item->selectable;
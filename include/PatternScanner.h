@@ -1,26 +1,75 @@
 #pragma once
 
-#include <Windows.h>
 #include <vector>
 #include <cstdint>
 #include <optional>
+#include "ByteView.h"
+#include "FuzzyMatch.h"
+#include "Patches.h"
+#include "WindowsBackend.h"
 
+// Reads go through the process's WindowsBackend; only module enumeration
+// uses the handle directly
 class PatternScanner {
 public:
     // Find a pattern in the target process memory
     // Returns the address where pattern was found, or nullopt if not found
+    // mask: optional per-byte mask, (byte & mask) == (pattern & mask); empty = exact
     static std::optional<uintptr_t> findPattern(
-        HANDLE processHandle,
+        const WindowsBackend& process,
+        uintptr_t startAddress,
+        size_t searchSize,
+        ByteView pattern,
+        ByteView mask = {}
+    );
+
+    // Find every window within maxDistance substituted bytes of a pattern
+    // Returns matches ranked by distance, at most limit (0 = all); offsets are
+    // relative to startAddress. Empty if the pattern is too long or maxDistance
+    // exceeds Fuzzy::maxUsefulDistance()
+    static std::vector<Fuzzy::Match> findPatternFuzzy(
+        const WindowsBackend& process,
+        uintptr_t startAddress,
+        size_t searchSize,
+        ByteView pattern,
+        ByteView mask,
+        unsigned maxDistance,
+        size_t limit = 0
+    );
+
+    // Find a pattern searching outward from where it is expected to start
+    // Checks hintAddress, then windows of doubling radius around it (nearest
+    // first, up to maxRadius), within [startAddress, startAddress + searchSize).
+    // Returns nullopt if nothing is found that close; the caller falls back to
+    // a full scan
+    static std::optional<uintptr_t> findPatternNear(
+        const WindowsBackend& process,
         uintptr_t startAddress,
         size_t searchSize,
-        const std::vector<uint8_t>& pattern
+        uintptr_t hintAddress,
+        ByteView pattern,
+        ByteView mask = {},
+        size_t maxRadius = NEAR_MAX_RADIUS
     );
 
+    static constexpr size_t NEAR_FIRST_RADIUS = 0x1000;    // One page either side
+    static constexpr size_t NEAR_MAX_RADIUS = 0x400000;    // 4MB either side
+
     // Find pattern in a specific module
     static std::optional<uintptr_t> findPatternInModule(
-        HANDLE processHandle,
+        const WindowsBackend& process,
         const wchar_t* moduleName,
-        const std::vector<uint8_t>& pattern
+        ByteView pattern,
+        ByteView mask = {}
+    );
+
+    // Find a reference pattern and decode the address operand in the match
+    // Returns the referenced address, or nullopt if not found or outside the module
+    static std::optional<uintptr_t> resolveReference(
+        const WindowsBackend& process,
+        uintptr_t moduleBase,
+        size_t moduleSize,
+        const Patches::OperandReference& reference
     );
 
     // Get module base address and size
@@ -34,16 +83,8 @@ public:
 private:
     // Read memory from target process
     static std::vector<uint8_t> readMemory(
-        HANDLE processHandle,
+        const WindowsBackend& process,
         uintptr_t address,
         size_t size
     );
-
-    // Pattern matching helper
-    static bool matchPattern(
-        const uint8_t* data,
-        size_t dataSize,
-        const std::vector<uint8_t>& pattern,
-        size_t offset
-    );
 };
@@ -0,0 +1,76 @@
+/**
+ * @file PeImage.h
+ * @brief Minimal PE32+ header parsing
+ *
+ * Only the fields the unlocker needs: identification data for build
+ * fingerprinting and the section table for section-aware scans. Works on any
+ * buffer that starts with the image headers (in-memory module or file), and
+ * does not depend on <Windows.h>.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Pe {
+
+constexpr uint32_t SCN_MEM_EXECUTE = 0x20000000;
+constexpr uint32_t SCN_MEM_READ    = 0x40000000;
+constexpr uint32_t SCN_MEM_WRITE   = 0x80000000;
+
+/// Headers are always contained in the first page of a mapped image
+constexpr size_t HEADER_PAGE_SIZE = 0x1000;
+
+struct Section {
+    std::string name;
+    uint32_t virtualAddress = 0;
+    uint32_t virtualSize = 0;
+    uint32_t rawOffset = 0;        ///< PointerToRawData (file layout)
+    uint32_t rawSize = 0;          ///< SizeOfRawData
+    uint32_t characteristics = 0;
+
+    bool isExecutable() const { return (characteristics & SCN_MEM_EXECUTE) != 0; }
+    bool isWritable() const { return (characteristics & SCN_MEM_WRITE) != 0; }
+    bool contains(uint32_t rva) const { return rva >= virtualAddress && rva - virtualAddress < virtualSize; }
+};
+
+struct Headers {
+    uint16_t machine = 0;
+    uint32_t timeDateStamp = 0;
+    uint32_t entryPoint = 0;       ///< RVA
+    uint64_t imageBase = 0;
+    uint32_t sizeOfImage = 0;
+    uint32_t sizeOfHeaders = 0;
+    uint32_t checkSum = 0;
+    size_t imageBaseOffset = 0;    ///< File offset of OptionalHeader.ImageBase
+    uint32_t exceptionTableRva = 0;    ///< .pdata: RUNTIME_FUNCTION per function; 0 = none
+    uint32_t exceptionTableSize = 0;
+    std::vector<Section> sections;
+
+    const Section* findSection(const std::string& name) const;
+    const Section* sectionForRva(uint32_t rva) const;
+};
+
+/**
+ * @brief Parses DOS, NT (PE32+ only) and section headers
+ * @param data Buffer starting at the DOS header
+ * @param size Bytes available (HEADER_PAGE_SIZE is always enough)
+ * @return false if the buffer is not a well-formed PE32+ image
+ */
+bool parseHeaders(const uint8_t* data, size_t size, Headers& headers);
+
+/**
+ * @brief Lays a PE file out the way the loader maps it
+ *
+ * Copies the headers and each section's raw data to its RVA; the rest of
+ * the image (uninitialised data, section padding) is zero. The result is
+ * indexed by RVA, like a module read out of the game process.
+ *
+ * @return false if the headers do not parse or a section lies outside the file
+ */
+bool mapImage(const uint8_t* file, size_t fileSize, std::vector<uint8_t>& image);
+
+} // namespace Pe
@@ -0,0 +1,78 @@
+/**
+ * @file ProcessMemory.h
+ * @brief Live process memory on Linux, for the fake target and benchmarks
+ *
+ * The Linux platform layer: the MemoryBackend under the core, and the
+ * counterpart of the Win32 calls WindowsBackend and PatternScanner make,
+ * so attach, scan and apply can be run against the fakegame target in
+ * automated benchmarks:
+ *
+ *   OpenProcess / Toolhelp snapshot    attach(pid), attachByName(name) over /proc
+ *   EnumProcessModulesEx               modules(), from /proc/<pid>/maps
+ *   ReadProcessMemory                  read(), with process_vm_readv
+ *   VirtualProtectEx + WriteProcessMemory
+ *                                      write(), through /proc/<pid>/mem, which
+ *                                      ignores page protection like a debugger
+ *
+ * Reading and writing another process needs ptrace access to it. fakegame
+ * grants that to any process of the same user (PR_SET_PTRACER).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "ByteView.h"
+#include "MemoryBackend.h"
+
+class ProcessMemory : public MemoryBackend {
+public:
+    struct Module {
+        uint64_t base = 0;
+        uint64_t size = 0;              ///< From the first mapping to the end of the last
+        std::string name;               ///< File name; memfd: prefix and "(deleted)" removed
+    };
+
+    ProcessMemory() = default;
+    ~ProcessMemory() override;
+
+    ProcessMemory(const ProcessMemory&) = delete;
+    ProcessMemory& operator=(const ProcessMemory&) = delete;
+
+    bool attach(int pid);
+
+    /// First process whose name (comm, at most 15 characters) matches
+    bool attachByName(const std::string& name);
+    void detach();
+
+    bool isAttached() const { return m_pid > 0; }
+    int pid() const { return m_pid; }
+    std::string getLastError() const { return m_lastError; }
+
+    /// File-backed mappings grouped by file, in address order
+    std::vector<Module> modules();
+    std::optional<Module> findModule(const std::string& name);
+
+    /// @return Bytes read; stops early at the first unreadable page
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    bool write(uint64_t address, const void* data, size_t size);
+
+    /// write(); /proc/<pid>/mem is not bound by page protection
+    bool writeProtected(uintptr_t address, ByteView data) override;
+
+    /**
+     * @brief First match in [start, start + size); Scan::findPattern over read()
+     * @param mask optional per-byte mask; empty = exact
+     */
+    std::optional<uint64_t> findPattern(uint64_t start, uint64_t size, ByteView pattern, ByteView mask = {}) const;
+
+private:
+    int m_pid = 0;
+    int m_memFd = -1;                   ///< /proc/<pid>/mem, opened for writing
+    std::string m_lastError;
+
+    bool fail(const std::string& error);
+};
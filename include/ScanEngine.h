@@ -0,0 +1,84 @@
+/**
+ * @file ScanEngine.h
+ * @brief Platform-neutral pattern matching over buffers and MemoryReaders
+ *
+ * The matching half of PatternScanner, without the Win32 calls: the
+ * scanner hands findPattern a ReadProcessMemory reader, ProcessMemory a
+ * process_vm_readv one, and the benchmarks an in-memory one, so all three
+ * time the same code.
+ *
+ * A pattern is searched by its anchor, the first byte the mask fixes
+ * completely: memchr finds the anchor candidates and only those get the
+ * full masked compare. A pattern with no fully fixed byte is compared at
+ * every offset.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+#include "BuildFingerprint.h"
+#include "ByteView.h"
+#include "Patches.h"
+
+namespace Scan {
+
+/// Bytes read per call; overlapping by the pattern size minus one
+constexpr size_t CHUNK_SIZE = 0x10000;
+
+struct Pattern {
+    ByteView pattern;
+    ByteView mask;                      ///< Empty = exact
+};
+
+/**
+ * @brief (data[offset + i] & mask[i]) == (pattern[i] & mask[i]) for every i
+ * @return false if the pattern runs past size
+ */
+bool matchAt(const uint8_t* data, size_t size, ByteView pattern, ByteView mask, size_t offset);
+
+/// Index of the first byte with mask 0xFF; pattern.size if there is none
+size_t anchorIndex(ByteView pattern, ByteView mask);
+
+/// First match in data, as an offset
+std::optional<size_t> findInBuffer(const uint8_t* data, size_t size, ByteView pattern, ByteView mask = {});
+
+/**
+ * @brief First match in [start, start + size), read in CHUNK_SIZE chunks
+ *
+ * Unreadable chunks are skipped. Records reads and matching into the
+ * current ScanStats and a trace span per chunk.
+ */
+std::optional<uintptr_t> findPattern(const MemoryReader& read, uintptr_t start, size_t size, ByteView pattern,
+                                     ByteView mask = {});
+
+/**
+ * @brief First match of each pattern, reading the range once
+ *
+ * Each chunk is searched for every pattern not yet found; the scan stops
+ * when all are. Invalid patterns (empty, or a mask of another size) are
+ * never found.
+ *
+ * @return One result per pattern, in input order
+ */
+std::vector<std::optional<uintptr_t>> findPatterns(const MemoryReader& read, uintptr_t start, size_t size,
+                                                   const std::vector<Pattern>& patterns);
+
+/**
+ * @brief Address the operand of a reference match points at
+ * @param match Bytes read at matchAddress, at least up to the end of the operand
+ */
+std::optional<uintptr_t> decodeOperand(const uint8_t* match, size_t matchSize, uintptr_t matchAddress,
+                                       uintptr_t moduleBase, const Patches::OperandReference& reference);
+
+/**
+ * @brief Finds a reference pattern in the module and decodes its operand
+ * @return nullopt if not found, or if the address falls outside the module
+ *         (the pattern matched unrelated code)
+ */
+std::optional<uintptr_t> resolveReference(const MemoryReader& read, uintptr_t moduleBase, size_t moduleSize,
+                                          const Patches::OperandReference& reference);
+
+} // namespace Scan
@@ -0,0 +1,129 @@
+/**
+ * @file ScanStats.h
+ * @brief Per-lookup counters for pattern scans: reads, matching and timing
+ *
+ * A slow attach can be the read syscalls, the matching, or the module
+ * enumeration. Each pattern lookup MemoryEditor makes gets one ScanStats:
+ *
+ *   bytesRequested / bytesRead   what ReadProcessMemory was asked for and gave
+ *   readCalls / failedReads      syscalls made, and those that failed
+ *   candidates                   offsets whose first byte matched and were
+ *                                compared in full (index candidates verified)
+ *   matchedChunk                 chunk of a chunked scan that matched (ring
+ *                                of a near search)
+ *   enumerateNs / readNs / matchNs / totalNs
+ *
+ * PatternScanner and MemoryEditor record into the ScanStats installed by the
+ * innermost ScanStats::Scope on the calling thread; with no scope, records
+ * are dropped.
+ *
+ * Built with FFXV_SCAN_STATS=0 (CMake: -DENABLE_SCAN_STATS=OFF), Scope,
+ * Timer and the record functions are empty inline functions and the
+ * instrumentation compiles away.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifndef FFXV_SCAN_STATS
+#define FFXV_SCAN_STATS 1
+#endif
+
+struct ScanStats {
+    static constexpr bool ENABLED = FFXV_SCAN_STATS != 0;
+
+    std::string name;               ///< Patch or reference looked up
+    std::string method;             ///< enumerate, hint, index, near, scan, fuzzy; "none" = not found
+    uint64_t bytesRequested = 0;
+    uint64_t bytesRead = 0;
+    uint32_t readCalls = 0;
+    uint32_t failedReads = 0;
+    uint64_t candidates = 0;
+    int64_t matchedChunk = -1;      ///< Chunk, or ring of a near search; -1 = none
+    uint64_t enumerateNs = 0;
+    uint64_t readNs = 0;
+    uint64_t matchNs = 0;
+    uint64_t totalNs = 0;
+
+    /// One log line: "name: method, 1.2 ms (read 0.9, match 0.2), 3 reads ..."
+    std::string toString() const;
+
+    /// Prometheus text exposition: per-lookup gauges and summed counters
+    static std::string formatMetrics(const std::vector<ScanStats>& scans);
+
+#if FFXV_SCAN_STATS
+    /// Installs a ScanStats as the recording target until destroyed
+    class Scope {
+    public:
+        explicit Scope(ScanStats& stats) : m_previous(s_current) { s_current = &stats; }
+        ~Scope() { s_current = m_previous; }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        ScanStats* m_previous;
+    };
+
+    class Timer {
+    public:
+        uint64_t elapsedNs() const
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_start).count());
+        }
+
+    private:
+        std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+    };
+
+    static void recordRead(size_t requested, size_t read, bool ok, const Timer& timer)
+    {
+        if (!s_current) return;
+        s_current->bytesRequested += requested;
+        s_current->bytesRead += read;
+        s_current->readCalls++;
+        s_current->failedReads += ok ? 0 : 1;
+        s_current->readNs += timer.elapsedNs();
+    }
+
+    static void recordMatching(uint64_t candidates, const Timer& timer)
+    {
+        if (!s_current) return;
+        s_current->candidates += candidates;
+        s_current->matchNs += timer.elapsedNs();
+    }
+
+    /// The outermost search records last, so a near search reports its ring
+    static void recordMatchedChunk(int64_t chunk)
+    {
+        if (s_current) s_current->matchedChunk = chunk;
+    }
+
+    static void recordEnumeration(const Timer& timer)
+    {
+        if (s_current) s_current->enumerateNs += timer.elapsedNs();
+    }
+
+private:
+    inline static thread_local ScanStats* s_current = nullptr;
+#else
+    class Scope {
+    public:
+        explicit Scope(ScanStats&) {}
+    };
+
+    class Timer {
+    public:
+        uint64_t elapsedNs() const { return 0; }
+    };
+
+    static void recordRead(size_t, size_t, bool, const Timer&) {}
+    static void recordMatching(uint64_t, const Timer&) {}
+    static void recordMatchedChunk(int64_t) {}
+    static void recordEnumeration(const Timer&) {}
+#endif
+};
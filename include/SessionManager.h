@@ -0,0 +1,140 @@
+/**
+ * @file SessionManager.h
+ * @brief Several attached game instances, patched and unlocked together
+ *
+ * MemoryEditor drives one process. A test host runs several (separate Wine
+ * prefixes or user sessions), each its own target here with:
+ *
+ *   backend      its MemoryBackend, owned by the manager
+ *   site view    the shared scan results for its build, rebased onto its
+ *                own module and verified against its own memory
+ *   state        what this manager has written to it: patches, table bytes
+ *
+ * Scan results are kept per build fingerprint. The first target of a build
+ * to be prepared looks the patches up (signature database entry, then the
+ * patch's RVA hint, else one Scan::findPatterns pass for all of them plus
+ * the unlock table reference) and checks that each code patch replaces
+ * whole instructions; other targets of the same build wait for that result
+ * instead of scanning. A patch that is not found, or that would split an
+ * instruction, fails the target as MemoryEditor refuses it.
+ *
+ * prepare(), apply() and restore() fan out over the targets, one thread per
+ * target up to the configured limit, and each target's writes go out as one
+ * WriteTransaction. The manager itself is not thread-safe: call it from one
+ * thread.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "BuildFingerprint.h"
+#include "MemoryBackend.h"
+#include "Patches.h"
+#include "UnlockRegistry.h"
+
+class SignatureDatabase;
+
+class SessionManager {
+public:
+    using TargetId = uint32_t;
+
+    enum class State : uint8_t {
+        Added,          ///< Not prepared yet
+        Ready,          ///< Build identified, every patch site located
+        Applied,        ///< Last apply() succeeded
+        Restored,       ///< Last restore() succeeded
+        Failed          ///< See TargetStatus::error; prepare() again to retry
+    };
+
+    struct TargetStatus {
+        TargetId id = 0;
+        std::string name;
+        State state = State::Added;
+        uintptr_t moduleBase = 0;
+        std::optional<BuildFingerprint> build;
+        uintptr_t unlockTableBase = 0;  ///< 0 until prepared
+        size_t sitesFound = 0;          ///< Of the patches passed to prepare()
+        UnlockMask enabledMask = 0;     ///< Table bytes this manager set to 1
+        std::string error;
+    };
+
+    /// maxThreads 0 = one thread per target
+    explicit SessionManager(unsigned maxThreads = 0);
+    ~SessionManager();
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    /// Patch and table addresses for known builds; must outlive the manager
+    void setSignatureDatabase(const SignatureDatabase* database) { m_database = database; }
+
+    TargetId add(std::string name, std::unique_ptr<MemoryBackend> backend, uintptr_t moduleBase,
+                 size_t moduleSize);
+    bool remove(TargetId id);           ///< Destroys the backend; nothing is restored
+    size_t size() const { return m_targets.size(); }
+    std::vector<TargetStatus> status() const;
+
+    /**
+     * @brief Identifies each target's build and locates the patch sites and unlock table
+     * @return Targets now Ready
+     */
+    size_t prepare(const std::vector<Patches::Patch*>& patches);
+
+    /**
+     * @brief Writes the patched bytes and the table state on every prepared target
+     *
+     * Table bytes in mask are set to 1; bytes this manager set earlier that
+     * are not in mask go back to 0. Each target is one WriteTransaction.
+     * @return Targets now Applied
+     */
+    size_t apply(const std::vector<Patches::Patch*>& patches, UnlockMask mask);
+
+    /// Original bytes at every site and 0 in every table byte this manager set; @return Targets Restored
+    size_t restore(const std::vector<Patches::Patch*>& patches);
+
+    /// Module scans run, and target preparations that needed none (build already looked up)
+    size_t scansRun() const { return m_scansRun; }
+    size_t preparesShared() const { return m_preparesShared; }
+
+private:
+    /// Results for one build, as RVAs; filled once, read by every target of the build
+    struct BuildScan {
+        std::mutex mutex;
+        std::map<std::string, std::optional<uint32_t>> matchRvas;  ///< nullopt = looked up, not found
+        std::map<std::string, bool> onBoundaries;                   ///< PatchSite::onBoundaries per found patch
+        std::optional<uint32_t> unlockTableRva;                     ///< 0 = reference not found
+    };
+
+    struct Target {
+        TargetStatus status;
+        std::unique_ptr<MemoryBackend> backend;
+        size_t moduleSize = 0;
+        std::map<std::string, uintptr_t> sites;  ///< Patch name -> site (match + offset)
+    };
+
+    unsigned m_maxThreads;
+    const SignatureDatabase* m_database = nullptr;
+    TargetId m_nextId = 1;
+    std::vector<std::unique_ptr<Target>> m_targets;
+
+    std::mutex m_buildsMutex;
+    std::map<uint64_t, std::unique_ptr<BuildScan>> m_builds;
+    std::atomic<size_t> m_scansRun{0};
+    std::atomic<size_t> m_preparesShared{0};
+
+    void forEachTarget(const std::function<void(Target&)>& work);
+    BuildScan& buildScan(uint64_t fingerprint);
+    void lookUp(const Target& target, uint64_t fingerprint, BuildScan& build,
+                const std::vector<Patches::Patch*>& patches);
+    void prepareTarget(Target& target, const std::vector<Patches::Patch*>& patches);
+    void writeTarget(Target& target, const std::vector<Patches::Patch*>& patches, UnlockMask mask, bool restore);
+};
@@ -0,0 +1,307 @@
+/**
+ * @file SignatureDatabase.h
+ * @brief Versioned, memory-mapped signature database
+ *
+ * Holds the data that Patches.h otherwise compiles in: AOB patterns (with
+ * masks), patch offsets, original/patched bytes, section hints, unlock items
+ * and bundles. Shipping a new database updates signatures without a rebuild.
+ *
+ * BINARY FORMAT (.fxsd, little-endian):
+ *
+ *   FileHeader        32 bytes, magic "FXSD"
+ *   SectionEntry[]    sectionCount x 16 bytes
+ *   section payloads  4-byte aligned; located through the section table
+ *
+ * Sections are identified by tag. Readers skip tags they do not know, so new
+ * sections can be added without bumping the format version. Every record
+ * field that refers to variable-length data is an offset into the STRS
+ * (NUL-terminated strings) or BLOB (raw bytes) section.
+ *
+ * The file is validated once at load (bounds, alignment, string termination,
+ * checksum). After that, accessors hand out views straight into the mapping;
+ * nothing is copied.
+ *
+ * TEXT FORMAT (.fxs):
+ *
+ *   version 2
+ *   table_base 0x752038
+ *   item 0x00 "Blazefire Saber" "Unknown promotion" normally_unavailable
+ *   item 0x27 "FFXV Fashion Collection" "..." steam protected
+ *   bundle "Kooky Chocobo + 10,000 GIL" "..." 0x22 0x23
+ *   patch "Unlock 1 - Bounds Bypass" "Forces all items through unlock path"
+ *       section text
+ *       pattern 83 F8 33 ?? 1A
+ *       offset 3
+ *       hint 0x751CA8
+ *       original 77 1A
+ *       patched EB 1A
+ *   end
+ *   build "Steam 1.0.0" 0x0123456789ABCDEF
+ *       table_base 0x752038
+ *       jump_table 0x75206C
+ *       address "Unlock 1 - Bounds Bypass" 0x751CA5
+ *   end
+ *
+ * A build block maps a BuildFingerprint hash to the RVAs of that build. The
+ * compiler also emits an open-addressed hash index over the fingerprints so a
+ * lookup is O(1) regardless of how many builds are listed.
+ *
+ * A patch's hint is its site (match + offset) in the reference build, checked
+ * before scanning. An entry that moves a built-in patch without giving one
+ * clears the built-in hint.
+ *
+ * Byte lists accept hex bytes, "??" wildcards (pattern only) and quoted ASCII
+ * strings. '#' starts a comment. Compile with compile() or the sigdbc tool.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ByteView.h"
+#include "MappedFile.h"
+#include "Patches.h"
+
+namespace SigDb {
+
+constexpr char MAGIC[4] = {'F', 'X', 'S', 'D'};
+constexpr uint16_t FORMAT_VERSION = 1;
+constexpr uint32_t NONE = 0xFFFFFFFF;  ///< Absent offset (e.g. no mask)
+
+constexpr uint32_t makeTag(char a, char b, char c, char d) {
+    return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) |
+           (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+}
+
+constexpr uint32_t TAG_PATCHES = makeTag('P', 'T', 'C', 'H');
+constexpr uint32_t TAG_ITEMS   = makeTag('I', 'T', 'E', 'M');
+constexpr uint32_t TAG_BUNDLES = makeTag('B', 'N', 'D', 'L');
+constexpr uint32_t TAG_STRINGS = makeTag('S', 'T', 'R', 'S');
+constexpr uint32_t TAG_BLOB    = makeTag('B', 'L', 'O', 'B');
+constexpr uint32_t TAG_BUILDS  = makeTag('B', 'I', 'L', 'D');
+constexpr uint32_t TAG_BUILD_ADDRESSES = makeTag('B', 'A', 'D', 'R');
+constexpr uint32_t TAG_BUILD_INDEX     = makeTag('B', 'I', 'D', 'X');
+
+struct FileHeader {
+    char magic[4];
+    uint16_t formatVersion;
+    uint16_t sectionCount;
+    uint32_t dataVersion;      ///< Signature set revision (compared with BUILTIN_DATA_VERSION)
+    uint32_t fileSize;
+    uint32_t checksum;         ///< FNV-1a over every byte after the header
+    uint32_t unlockTableRva;   ///< 0 = use the built-in table base
+    uint32_t reserved[2];
+};
+
+struct SectionEntry {
+    uint32_t tag;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t count;
+};
+
+struct PatchRecord {
+    uint32_t name;             ///< STRS offset
+    uint32_t description;      ///< STRS offset
+    uint32_t pattern;          ///< BLOB offset
+    uint32_t mask;             ///< BLOB offset or NONE; patternLength bytes
+    uint32_t original;         ///< BLOB offset
+    uint32_t patched;          ///< BLOB offset
+    uint16_t patternLength;
+    uint16_t originalLength;
+    uint16_t patchedLength;
+    uint8_t section;           ///< Patches::SectionHint
+    uint8_t flags;
+    int32_t offset;
+    uint32_t rvaHint;          ///< Patch site in the reference build; 0 = none
+};
+
+enum ItemFlags : uint8_t {
+    ITEM_SELECTABLE = 0x01
+};
+
+struct ItemRecord {
+    uint32_t name;
+    uint32_t description;
+    uint8_t itemId;
+    uint8_t category;          ///< Patches::UnlockCategory
+    uint8_t flags;             ///< ItemFlags
+    uint8_t reserved;
+};
+
+struct BundleRecord {
+    uint32_t name;
+    uint32_t description;
+    uint32_t itemIds;          ///< BLOB offset, itemCount bytes
+    uint16_t itemCount;
+    uint16_t reserved;
+};
+
+struct BuildRecord {
+    uint32_t fingerprintLow;   ///< BuildFingerprint::hash, split to keep 4-byte alignment
+    uint32_t fingerprintHigh;
+    uint32_t name;             ///< STRS offset
+    uint32_t unlockTableRva;   ///< 0 = unknown for this build
+    uint32_t jumpTableRva;     ///< 0 = unknown for this build
+    uint32_t firstAddress;     ///< Index into BADR
+    uint32_t addressCount;
+    uint32_t reserved;
+};
+
+struct BuildAddressRecord {
+    uint32_t patchName;        ///< STRS offset; matches Patches::Patch::name
+    uint32_t rva;              ///< Pattern match RVA (before Patch::offset)
+};
+
+// BIDX: uint32_t slots[count], count is a power of two; each slot holds a
+// BILD index or NONE. Probing is linear from (fingerprint & (count - 1)).
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout is part of the file format");
+static_assert(sizeof(SectionEntry) == 16, "SectionEntry layout is part of the file format");
+static_assert(sizeof(PatchRecord) == 40, "PatchRecord layout is part of the file format");
+static_assert(sizeof(ItemRecord) == 12, "ItemRecord layout is part of the file format");
+static_assert(sizeof(BundleRecord) == 16, "BundleRecord layout is part of the file format");
+static_assert(sizeof(BuildRecord) == 32, "BuildRecord layout is part of the file format");
+static_assert(sizeof(BuildAddressRecord) == 8, "BuildAddressRecord layout is part of the file format");
+
+/// FNV-1a 32-bit, used for the file checksum
+uint32_t checksum(const uint8_t* data, size_t size);
+
+} // namespace SigDb
+
+/**
+ * @brief Read-only view of a signature database file
+ *
+ * Thread Safety: Immutable after load(); concurrent readers are safe.
+ */
+class SignatureDatabase {
+public:
+    struct PatchView {
+        std::string_view name;
+        std::string_view description;
+        ByteView pattern;
+        ByteView mask;              ///< Empty when the pattern is exact
+        ByteView original;
+        ByteView patched;
+        int32_t offset;
+        Patches::SectionHint section;
+        uint32_t rvaHint;           ///< 0 = none
+    };
+
+    struct ItemView {
+        std::string_view name;
+        std::string_view description;
+        uint8_t itemId;
+        Patches::UnlockCategory category;
+        bool selectable;
+    };
+
+    struct BundleView {
+        std::string_view name;
+        std::string_view description;
+        ByteView itemIds;
+    };
+
+    struct BuildAddressView {
+        std::string_view patchName;
+        uint32_t rva;
+    };
+
+    struct BuildView {
+        std::string_view name;
+        uint64_t fingerprint;
+        uint32_t unlockTableRva;
+        uint32_t jumpTableRva;
+        const SigDb::BuildAddressRecord* addresses;
+        size_t addressCount;
+        const SignatureDatabase* database;
+
+        BuildAddressView address(size_t index) const;
+    };
+
+    /// File name the applications look for next to the executable
+    static constexpr const char* DEFAULT_FILE = "signatures.fxsd";
+
+    SignatureDatabase() = default;
+
+    // === Loading ===
+    bool load(const std::string& path);
+    bool loadFromMemory(const uint8_t* data, size_t size);  ///< Caller keeps data alive
+    void unload();
+
+    /**
+     * @brief load() and applyToBuiltins(), unless the built-in set should win
+     *
+     * The built-in definitions stay in effect when the file is missing,
+     * fails validation, or is older than the built-in set.
+     *
+     * @return Status line for the log
+     */
+    std::string loadOverrides(const std::string& path);
+    bool isLoaded() const { return m_header != nullptr; }
+    std::string getLastError() const { return m_lastError; }
+
+    // === Contents ===
+    uint32_t dataVersion() const;
+    uint32_t unlockTableRva() const;
+    size_t patchCount() const { return m_patchCount; }
+    size_t itemCount() const { return m_itemCount; }
+    size_t bundleCount() const { return m_bundleCount; }
+    size_t buildCount() const { return m_buildCount; }
+    PatchView patch(size_t index) const;
+    ItemView item(size_t index) const;
+    BundleView bundle(size_t index) const;
+    BuildView build(size_t index) const;
+
+    /// O(1) lookup of a build by BuildFingerprint::hash
+    std::optional<BuildView> findBuild(uint64_t fingerprint) const;
+
+    /**
+     * @brief Overlays database entries onto the built-in Patches:: definitions
+     *
+     * Entries are matched by name (patches, bundles) or item ID (items).
+     * Patch byte views are re-pointed into the mapping, so the database must
+     * stay loaded for as long as the patches are in use. Entries with no
+     * built-in counterpart are left in the database only.
+     *
+     * @return Number of built-in entries that were updated
+     */
+    size_t applyToBuiltins() const;
+
+    // === Text Source Compiler ===
+    static bool compile(const std::string& source, std::vector<uint8_t>& output, std::string& error);
+
+private:
+    MappedFile m_file;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    std::string m_lastError;
+
+    const SigDb::FileHeader* m_header = nullptr;
+    const SigDb::PatchRecord* m_patches = nullptr;
+    const SigDb::ItemRecord* m_items = nullptr;
+    const SigDb::BundleRecord* m_bundles = nullptr;
+    const SigDb::BuildRecord* m_builds = nullptr;
+    const SigDb::BuildAddressRecord* m_buildAddresses = nullptr;
+    const uint32_t* m_buildIndex = nullptr;
+    size_t m_patchCount = 0;
+    size_t m_itemCount = 0;
+    size_t m_bundleCount = 0;
+    size_t m_buildCount = 0;
+    size_t m_buildAddressCount = 0;
+    size_t m_buildIndexSize = 0;
+    const char* m_strings = nullptr;
+    size_t m_stringsSize = 0;
+    const uint8_t* m_blob = nullptr;
+    size_t m_blobSize = 0;
+
+    bool validate();
+    bool fail(const std::string& error);
+    bool validString(uint32_t offset) const;
+    bool validBlob(uint32_t offset, size_t length) const;
+    std::string_view stringAt(uint32_t offset) const;
+    ByteView blobAt(uint32_t offset, size_t length) const;
+};
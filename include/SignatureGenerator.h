@@ -0,0 +1,64 @@
+/**
+ * @file SignatureGenerator.h
+ * @brief Builds the shortest unique masked signature for a code address
+ *
+ * Starting at the given RVA the generator appends one decoded instruction at
+ * a time. Bytes that change when code or data moves between builds are
+ * wildcarded:
+ *
+ *   - RIP-relative and 32-bit displacements   lea rcx,[rip+????????]
+ *   - rel32 call/jmp/jcc targets              call ????????
+ *   - 64-bit immediates and moffs (relocated) mov rax,????????????????
+ *
+ * disp8, rel8 and small immediates stay fixed; they are local to the
+ * function and make the signature far more selective. After each
+ * instruction the pattern is checked against the n-gram index, and once it
+ * is unique it is cut back byte by byte to the shortest prefix that still
+ * is. Trailing wildcards are never emitted, and every signature has at
+ * least one fixed 4-byte window, so looking it up is always an index query.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "NgramIndex.h"
+
+class SignatureGenerator {
+public:
+    static constexpr size_t DEFAULT_MAX_LENGTH = 64;
+
+    struct Signature {
+        uint32_t rva = 0;
+        std::vector<uint8_t> pattern;
+        std::vector<uint8_t> mask;        ///< 0xFF = fixed, 0x00 = wildcard
+        size_t instructions = 0;          ///< Instructions the pattern touches
+
+        /// "83 F8 33 ?? 1A", the byte list syntax of the .fxs format
+        std::string toString() const;
+    };
+
+    /// The index must have been built over the module image, indexed by RVA
+    explicit SignatureGenerator(const NgramIndex& index);
+
+    void setMaxLength(size_t maxLength) { m_maxLength = maxLength; }
+
+    /**
+     * @brief Generates the signature for the instruction at rva
+     * @return false if the bytes do not decode, or no unique signature fits
+     *         in the maximum length
+     */
+    bool generate(uint32_t rva, Signature& signature);
+
+    std::string getLastError() const { return m_lastError; }
+
+private:
+    const NgramIndex& m_index;
+    size_t m_maxLength = DEFAULT_MAX_LENGTH;
+    std::string m_lastError;
+
+    bool isUnique(const Signature& signature, size_t length) const;
+    bool fail(const std::string& error);
+};
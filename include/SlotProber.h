@@ -0,0 +1,133 @@
+/**
+ * @file SlotProber.h
+ * @brief Automated sweep over the unmapped unlock table slots
+ *
+ * Many item IDs in 0x00-0x33 have no known item (see "Unknown/Unused Item
+ * Slots" in docs/ffxv_unlock_research.md). The prober sets one candidate slot
+ * at a time, waits for the game to react, compares a set of watched memory
+ * regions against a snapshot taken just before, and puts the slot back:
+ *
+ *   round n:  read   [slot, watch 1..k]     one batched read
+ *             write  slot = probe value     one batched write
+ *             ... settle interval ...
+ *             read   [slot, watch 1..k]     one batched read
+ *             write  slot = original        one batched write
+ *
+ * Every round is recorded and the sweep can be saved as a text report.
+ * Rounds are driven by a timer, so the UI stays responsive while the game
+ * runs; the slot being probed is always restored on cancel().
+ *
+ * Watches are given as RVAs relative to the game module, so a watch list
+ * stays valid across restarts and ASLR.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QTimer>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MemoryEditor.h"
+#include "UnlockRegistry.h"
+
+class SlotProber : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr uint32_t MAX_WATCH_SIZE = 0x100000;
+    static constexpr size_t MAX_REPORTED_CHANGES = 32;  ///< Per watch and slot; the total is always counted
+
+    /// Slots with a known meaning that is not worth probing
+    static constexpr UnlockMask EXCLUDED_SLOTS = UnlockRegistry::bit(0x31);  // Episode Ardyn (paid DLC)
+
+    struct Watch {
+        std::string name;
+        uint32_t rva = 0;      ///< Relative to the game module base
+        uint32_t size = 0;
+    };
+
+    struct Config {
+        UnlockMask candidates = 0;
+        std::vector<Watch> watches;
+        int settleMs = 1500;
+        uint8_t probeValue = 0x01;
+    };
+
+    struct ByteChange {
+        uint32_t offset;       ///< Within the watch
+        uint8_t before;
+        uint8_t after;
+    };
+
+    struct WatchDiff {
+        size_t changedBytes = 0;
+        std::vector<ByteChange> changes;  ///< First MAX_REPORTED_CHANGES only
+        bool readFailed = false;
+    };
+
+    struct SlotResult {
+        uint8_t itemId = 0;
+        uint8_t originalValue = 0;
+        uint8_t valueAfterSettle = 0;  ///< The game may consume or reset the slot
+        bool slotUnreadable = false;
+        std::vector<WatchDiff> watches;  ///< Parallel to Config::watches
+    };
+
+    explicit SlotProber(MemoryEditor* editor, QObject* parent = nullptr);
+    ~SlotProber();
+
+    /// Table slots with no item or bundle behind them, minus EXCLUDED_SLOTS
+    static UnlockMask unmappedSlots(const UnlockRegistry& registry);
+
+    /**
+     * @brief Parses a watch list: "name@rva+size" entries separated by ';'
+     *
+     * Numbers are decimal or 0x-prefixed hex, e.g. "inventory@0x1A2B300+0x400".
+     */
+    static bool parseWatches(const std::string& spec, std::vector<Watch>& watches, std::string& error);
+
+    // === Sweep Control ===
+    bool start(const Config& config);
+    void cancel();
+    bool isRunning() const { return m_running; }
+
+    // === Results ===
+    const Config& config() const { return m_config; }
+    const std::vector<SlotResult>& results() const { return m_results; }
+    std::string report() const;
+    std::string getLastError() const { return m_lastError; }
+
+signals:
+    void slotProbed(int itemId, int changedBytes);
+    void finished(int slotsProbed, bool cancelled);
+    void errorOccurred(const QString& error);
+
+private slots:
+    void onSettled();
+    void onProcessDetached();
+
+private:
+    QPointer<MemoryEditor> m_editor;   ///< Checked in the destructor, where the editor may already be gone
+    QTimer m_settleTimer;
+
+    Config m_config;
+    std::vector<uint8_t> m_slots;       ///< Item IDs still to probe, in order
+    size_t m_nextSlot = 0;
+    bool m_running = false;
+    std::string m_lastError;
+
+    // Round state
+    uintptr_t m_tableBase = 0;
+    uintptr_t m_moduleBase = 0;
+    uint8_t m_slotWrite = 0;            ///< Source of the current slot write
+    std::vector<std::vector<uint8_t>> m_before;
+    std::vector<SlotResult> m_results;
+
+    void probeNext();
+    void finish(bool cancelled);
+    bool restoreSlot();
+    std::vector<MemoryEditor::MemoryRange> roundRanges(uint8_t itemId) const;
+};
@@ -0,0 +1,79 @@
+/**
+ * @file StringExtractor.h
+ * @brief Printable ASCII / UTF-16LE string extraction and URL redirect candidates
+ *
+ * The three Twitch URLs were found by hand; the game may hold more endpoints
+ * worth redirecting. extract() sweeps a data section for runs of printable
+ * characters (0x20-0x7E) as ASCII and as UTF-16LE, and urls() keeps the ones
+ * that contain a scheme://host URL.
+ *
+ * The sweep classifies 64 bytes at a time into two bitmasks, printable and
+ * zero, with SSE2 compares (plain loops elsewhere). ASCII runs are then walked
+ * from bit transition to bit transition. UTF-16LE code units are the printable
+ * bits whose next byte is zero; those are rare outside real wide strings and
+ * each one is extended with a scalar loop. Most of the work is the two
+ * compares per 16 bytes, so throughput stays near memory bandwidth.
+ *
+ * redirect() turns a URL record into the bytes of an in-place redirect patch
+ * with UrlRedirect::regenerate(), for either encoding.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Strings {
+
+constexpr size_t DEFAULT_MIN_LENGTH = 6;    ///< Characters
+
+enum class Encoding : uint8_t { Ascii, Utf16 };
+
+struct Record {
+    uint32_t rva = 0;               ///< Of the first character
+    Encoding encoding = Encoding::Ascii;
+    bool terminated = false;        ///< Followed by a NUL character
+    std::string text;               ///< UTF-16 text narrowed; all characters are ASCII
+
+    /// Bytes the string occupies in the image, excluding the terminator
+    size_t byteLength() const { return text.size() * (encoding == Encoding::Utf16 ? 2 : 1); }
+};
+
+/// "ascii" or "utf-16le"
+const char* encodingName(Encoding encoding);
+
+/**
+ * @brief Printable ASCII and UTF-16LE runs of at least minLength characters
+ * @param rva RVA (or file offset) of data[0]
+ * @return Ordered by RVA
+ */
+std::vector<Record> extract(const uint8_t* data, size_t size, uint32_t rva, size_t minLength = DEFAULT_MIN_LENGTH);
+
+/// Offset of the URL in text ("scheme://host..."), if there is one
+std::optional<size_t> findUrl(const std::string& text);
+
+/**
+ * @brief The records that contain a URL, cut to start at its scheme
+ *
+ * A run that starts with unrelated printable bytes (data just before the
+ * string) is trimmed; the terminator flag is kept.
+ */
+std::vector<Record> urls(const std::vector<Record>& records);
+
+/// Bytes of an in-place redirect of a URL record to localhost:<port>
+struct Redirect {
+    std::vector<uint8_t> original;  ///< The string, with its NUL if it has one
+    std::vector<uint8_t> patched;   ///< Same size, NUL-padded
+};
+
+/**
+ * @brief Redirect patch bytes for a URL record
+ * @return nullopt if the record has no scheme://host/ prefix or
+ *         localhost:<port> does not fit in it
+ */
+std::optional<Redirect> redirect(const Record& url, uint16_t port);
+
+} // namespace Strings
@@ -0,0 +1,33 @@
+/**
+ * @file SuffixArray.h
+ * @brief Suffix array construction by induced sorting (SA-IS)
+ *
+ * Linear time in the text length. Suffixes are ordered as if the text ended
+ * in a sentinel smaller than every byte, so a suffix that is a prefix of
+ * another sorts first.
+ *
+ * SA-IS alternates between sequential induce sweeps and steps that are
+ * independent per position; the latter (bucket histogram, comparison of
+ * neighbouring LMS substrings when naming them) are split across threads.
+ * The sweeps themselves stay sequential, as in the reference algorithm.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace SuffixArray {
+
+/// Largest text build() accepts; positions are stored as int32_t
+constexpr size_t MAX_TEXT_SIZE = 0x7FFFFFFE;
+
+/**
+ * @brief Sorts the suffixes of text[0..size)
+ * @param threads Worker threads for the per-position steps; 0 = all cores
+ * @return Start positions in suffix order; empty if size is 0 or too large
+ */
+std::vector<int32_t> build(const uint8_t* text, size_t size, unsigned threads = 0);
+
+} // namespace SuffixArray
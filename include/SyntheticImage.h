@@ -0,0 +1,58 @@
+/**
+ * @file SyntheticImage.h
+ * @brief Stand-in ffxv_s.exe module image for tests and benchmarks
+ *
+ * Builds a PE32+ image, laid out by RVA as the loader maps it, that has
+ * everything the unlocker looks for at the addresses documented for the
+ * reference build:
+ *
+ *   - Unlock 1, 2 and 3 at their RVA hints, with the Phase 4 table lookup
+ *     (0x751CAC) and the Phase 6 dispatch (0x751CD5) in between
+ *   - The unlock byte table at 0x752038 and the jump table at 0x75206C,
+ *     inside .text after the dispatch code like the game's switch tables;
+ *     every jump table entry points at one of a few handlers
+ *   - The Twitch Prime patch sites, which have no documented RVA, spread
+ *     over .text so that finding them takes a scan
+ *   - The Twitch URLs, NUL-terminated, at the start of .rdata
+ *
+ * The rest of .text is pseudo-random bytes from a fixed seed, so the image
+ * (and its build fingerprint) depends only on its size, and a scan compares
+ * about as many candidate offsets as it would in real code.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace SyntheticImage {
+
+constexpr uint32_t TEXT_RVA = 0x1000;
+constexpr uint32_t RDATA_SIZE = 0x10000;        ///< At the end of the image
+constexpr size_t MIN_SIZE = 0x800000;           ///< Room for the tables plus .rdata
+constexpr size_t DEFAULT_SIZE = 0x2000000;      ///< 32 MB
+
+/// Where a patch site (match + offset) or table was placed
+struct Site {
+    std::string name;
+    uint32_t rva;
+};
+
+struct Image {
+    std::vector<uint8_t> bytes;     ///< Indexed by RVA; bytes.size() is SizeOfImage
+    std::vector<Site> sites;
+    uint32_t textSize = 0;          ///< .text is [TEXT_RVA, TEXT_RVA + textSize)
+    uint32_t rdataRva = 0;
+};
+
+/**
+ * @brief Lays out the image
+ * @param size SizeOfImage, rounded up to a page; at least MIN_SIZE
+ * @param imageBase Written to OptionalHeader.ImageBase
+ * @return false if size is below MIN_SIZE or above 4 GB
+ */
+bool build(size_t size, uint64_t imageBase, Image& image);
+
+} // namespace SyntheticImage
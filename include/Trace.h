@@ -0,0 +1,116 @@
+/**
+ * @file Trace.h
+ * @brief Scoped trace spans, exported as Chrome trace-event JSON
+ *
+ * A Span measures the scope it lives in. While tracing is enabled, each
+ * finished span is appended to a buffer owned by the recording thread: no
+ * lock, no allocation after the thread's first event, and the exporter only
+ * reads up to the count the writer has published. While tracing is disabled,
+ * a span costs one relaxed atomic load.
+ *
+ *   Trace::setEnabled(true);
+ *   {
+ *       Trace::Span span("getModuleInfo", "attach");
+ *       ...
+ *   }
+ *   std::string json = Trace::toChromeJson();   // open in ui.perfetto.dev
+ *
+ * Span names and categories must be string literals (only the pointer is
+ * kept). Per-call text, such as a patch name or a request path, goes into
+ * the span's detail, which is copied and truncated to DETAIL_SIZE - 1.
+ *
+ * Each thread keeps at most BUFFER_EVENTS events per session; later events
+ * are counted as dropped.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Trace {
+
+constexpr size_t DETAIL_SIZE = 48;
+constexpr size_t BUFFER_EVENTS = 32768;
+
+/// Enabling starts a new session; events of earlier sessions are discarded
+void setEnabled(bool enabled);
+
+/// Name shown for the calling thread's track; must be a string literal
+void setThreadName(const char* name);
+
+/// Events of the current session as {"traceEvents": [...]}
+std::string toChromeJson();
+
+/// Events lost to full buffers in the current session
+size_t droppedEvents();
+
+namespace detail {
+
+inline std::atomic<bool> enabled{false};
+
+void record(const char* name, const char* category, std::chrono::steady_clock::time_point start,
+            const char* argName, int64_t argValue, const char* text);
+
+} // namespace detail
+
+inline bool isEnabled()
+{
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+class Span {
+public:
+    Span(const char* name, const char* category)
+        : m_name(isEnabled() ? name : nullptr), m_category(category)
+    {
+        if (m_name) {
+            m_detail[0] = '\0';
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~Span()
+    {
+        if (m_name) detail::record(m_name, m_category, m_start, m_argName, m_argValue, m_detail);
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /// False when tracing was disabled at construction; setters do nothing then
+    bool active() const { return m_name != nullptr; }
+
+    /// One numeric argument, e.g. a chunk index or a byte count
+    void setArg(const char* name, int64_t value)
+    {
+        m_argName = name;
+        m_argValue = value;
+    }
+
+    void setDetail(const char* text, size_t length)
+    {
+        if (!m_name) return;
+        if (length > DETAIL_SIZE - 1) {
+            length = DETAIL_SIZE - 1;
+            while (length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) --length;  // UTF-8 boundary
+        }
+        for (size_t i = 0; i < length; ++i) m_detail[i] = text[i];
+        m_detail[length] = '\0';
+    }
+
+    void setDetail(const std::string& text) { setDetail(text.data(), text.size()); }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    std::chrono::steady_clock::time_point m_start;
+    const char* m_argName = nullptr;
+    int64_t m_argValue = 0;
+    char m_detail[DETAIL_SIZE];     ///< Set only while active
+};
+
+} // namespace Trace
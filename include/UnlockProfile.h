@@ -0,0 +1,65 @@
+/**
+ * @file UnlockProfile.h
+ * @brief Unlock profile: what headless mode applies, and whether it stays
+ *
+ * A profile is a text file of one setting per line; '#' starts a comment
+ * and names are quoted as they appear in the UI (and the signature
+ * database, which can rename them):
+ *
+ *   item "Noodle Helmet"                  byte table entry of a selectable item
+ *   bundle "Kooky Chocobo + 10,000 GIL"   every byte of a Twitch Prime bundle
+ *   patch "Unlock 3 - DL Bypass"          code or URL patch (Patches::getAllPatches())
+ *   server on|off                         local HTTP server for the Twitch endpoints
+ *   port 443                              server port; also rewrites the URL patches
+ *   resident on|off                       keep running after applying
+ *   freeze 1000                           write back drifted bytes every n ms
+ *   wait 120                              give up if the game is not up in n s
+ *
+ * Only the server, freeze and a restarted game need the process to stay,
+ * so server and freeze are rejected without "resident on".
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Patches.h"
+#include "UnlockRegistry.h"
+
+class UnlockProfile {
+public:
+    bool load(const std::string& path);         ///< UTF-8 path
+    bool parse(const std::string& text);
+    std::string getLastError() const { return m_lastError; }
+
+    const std::vector<std::string>& itemNames() const { return m_items; }
+    const std::vector<std::string>& bundleNames() const { return m_bundles; }
+    const std::vector<std::string>& patchNames() const { return m_patches; }
+
+    bool serverEnabled() const { return m_server; }
+    uint16_t port() const { return m_port; }    ///< 0 = keep Patches::activeRedirectPort
+    bool resident() const { return m_resident; }
+    uint32_t freezeIntervalMs() const { return m_freezeMs; }  ///< 0 = no freeze
+    uint32_t waitSeconds() const { return m_waitSeconds; }    ///< 0 = wait indefinitely
+
+    /**
+     * @brief Looks the names up in the registry and the built-in patch list
+     *
+     * Protected items are rejected: their bytes do nothing without the
+     * Platform Exclusives patches, which unlock them all at once.
+     * @return false at the first name that is unknown or protected
+     */
+    bool resolve(const UnlockRegistry& registry, UnlockMask& mask, std::vector<Patches::Patch*>& patches);
+
+private:
+    std::vector<std::string> m_items;
+    std::vector<std::string> m_bundles;
+    std::vector<std::string> m_patches;
+    bool m_server = false;
+    uint16_t m_port = 0;
+    bool m_resident = false;
+    uint32_t m_freezeMs = 0;
+    uint32_t m_waitSeconds = 0;
+    std::string m_lastError;
+};
@@ -0,0 +1,112 @@
+/**
+ * @file UnlockRegistry.h
+ * @brief Structure-of-arrays view of the unlock items and bundles
+ *
+ * The byte table is indexed by item ID (0x00-0x33), so the whole table fits
+ * in one 64-bit mask: bit n stands for the byte at table base + n. Enabled
+ * state, selectability, categories and bundles are all masks, and bulk
+ * operations are mask arithmetic:
+ *
+ *   enable all selectable:   desired = enabled | selectableMask()
+ *   disable one category:    desired = enabled & ~categoryMask(Steam)
+ *   bytes to write:          enabled ^ desired
+ *
+ * Hot data (item IDs, selectable flags) lives in contiguous arrays grouped by
+ * category, so a category is an index span. Names and descriptions are kept
+ * in a separate string pool and only touched by the UI and logging.
+ *
+ * The registry is a snapshot of the Patches:: definitions; call rebuild()
+ * after they change (signature database overlay, table rebase).
+ * MemoryEditor rebuilds its registry when a database is set and on attach,
+ * so the UI and profiles read names through getUnlockRegistry().
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Patches.h"
+
+/// Bit n = unlock table byte n
+using UnlockMask = uint64_t;
+
+class UnlockRegistry {
+public:
+    static constexpr size_t MAX_TABLE_BYTES = 64;
+    static constexpr size_t TABLE_SLOTS = 0x34;  ///< Item IDs the game accepts (cmp eax,33)
+    static constexpr size_t CATEGORY_COUNT = size_t(Patches::UnlockCategory::Promotional) + 1;
+
+    struct Span {
+        uint8_t first = 0;
+        uint8_t count = 0;
+    };
+
+    static constexpr UnlockMask bit(uint8_t tableIndex) { return UnlockMask(1) << tableIndex; }
+
+    /// Snapshot the Patches:: items and bundles against the active table base
+    void rebuild();
+
+    uintptr_t tableBase() const { return m_tableBase; }
+
+    // === Items (index = position in category order) ===
+    size_t itemCount() const { return m_itemIds.size(); }
+    uint8_t itemId(size_t index) const { return m_itemIds[index]; }
+    uintptr_t itemAddress(size_t index) const { return m_tableBase + m_itemIds[index]; }
+    bool itemSelectable(size_t index) const { return (m_selectable & bit(m_itemIds[index])) != 0; }
+    std::string_view itemName(size_t index) const { return poolString(m_itemNames[index]); }
+    std::string_view itemDescription(size_t index) const { return poolString(m_itemDescriptions[index]); }
+    Patches::UnlockItem* itemDefinition(size_t index) const { return m_itemDefinitions[index]; }
+    std::optional<size_t> indexOfItem(uint8_t itemId) const;
+
+    Span categorySpan(Patches::UnlockCategory category) const { return m_categorySpans[size_t(category)]; }
+    UnlockMask categoryMask(Patches::UnlockCategory category) const { return m_categoryMasks[size_t(category)]; }
+    UnlockMask itemMask() const { return m_items; }
+    UnlockMask selectableMask() const { return m_selectable; }
+
+    // === Bundles ===
+    size_t bundleCount() const { return m_bundleMasks.size(); }
+    UnlockMask bundleMask(size_t index) const { return m_bundleMasks[index]; }
+    std::string_view bundleName(size_t index) const { return poolString(m_bundleNames[index]); }
+    std::string_view bundleDescription(size_t index) const { return poolString(m_bundleDescriptions[index]); }
+    Patches::UnlockBundle* bundleDefinition(size_t index) const { return m_bundleDefinitions[index]; }
+    UnlockMask allBundlesMask() const { return m_bundles; }
+
+    // === Conversions for the pointer-based API ===
+    UnlockMask maskOf(const std::vector<Patches::UnlockItem*>& items) const;
+    UnlockMask maskOf(const std::vector<Patches::UnlockBundle*>& bundles) const;
+    UnlockMask maskOf(const Patches::UnlockBundle& bundle) const;
+
+    // === Enabled State (bytes this tool has set to 0x01) ===
+    UnlockMask enabledMask() const { return m_enabled; }
+    void setEnabledMask(UnlockMask mask) { m_enabled = mask; }
+
+private:
+    uintptr_t m_tableBase = 0;
+
+    // Hot
+    std::vector<uint8_t> m_itemIds;
+    std::vector<UnlockMask> m_bundleMasks;
+    UnlockMask m_items = 0;
+    UnlockMask m_selectable = 0;
+    UnlockMask m_bundles = 0;
+    UnlockMask m_enabled = 0;
+    std::array<Span, CATEGORY_COUNT> m_categorySpans = {};
+    std::array<UnlockMask, CATEGORY_COUNT> m_categoryMasks = {};
+    std::array<uint8_t, MAX_TABLE_BYTES> m_indexById = {};  ///< 0xFF = no item
+
+    // Cold
+    std::string m_stringPool;
+    std::vector<uint32_t> m_itemNames;
+    std::vector<uint32_t> m_itemDescriptions;
+    std::vector<uint32_t> m_bundleNames;
+    std::vector<uint32_t> m_bundleDescriptions;
+    std::vector<Patches::UnlockItem*> m_itemDefinitions;
+    std::vector<Patches::UnlockBundle*> m_bundleDefinitions;
+
+    uint32_t addString(const std::string& text);
+    std::string_view poolString(uint32_t offset) const { return std::string_view(m_stringPool.c_str() + offset); }
+};
@@ -0,0 +1,161 @@
+/**
+ * @file UrlRedirect.h
+ * @brief Compile-time generation of in-place URL rewrite patches
+ *
+ * A URL in the game's .rdata can only be rewritten in place: the patched
+ * string must fit in the original's bytes, and whatever it does not use is
+ * padded with NUL. Given the original URL, the scheme+host prefix to replace
+ * and a port, this header builds both byte arrays as constexpr data:
+ *
+ *   original  "https://api.twitch.tv/kraken/..."
+ *   patched   "http://localhost:443/kraken/...\0"
+ *
+ * Lengths are checked with static_assert, so a port whose host does not fit
+ * (e.g. a 5-digit port against "https://api.twitch.tv/") fails to compile
+ * instead of corrupting the string that follows in memory.
+ *
+ * regenerate() does the same at runtime for a port chosen by the user, with
+ * the fit check as a return value.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace UrlRedirect {
+
+template <size_t N>
+using Bytes = std::array<uint8_t, N>;
+
+/// Whether the game string's NUL terminator is part of the match
+enum class Terminator { Excluded, Included };
+
+constexpr size_t digitCount(uint32_t value)
+{
+    size_t digits = 1;
+    while (value >= 10) {
+        value /= 10;
+        ++digits;
+    }
+    return digits;
+}
+
+/// Length of "http://localhost:<port>/"
+constexpr size_t localhostLength(uint16_t port)
+{
+    return sizeof("http://localhost:") - 1 + digitCount(port) + 1;
+}
+
+template <size_t UrlSize, size_t PrefixSize>
+constexpr bool startsWith(const char (&url)[UrlSize], const char (&prefix)[PrefixSize])
+{
+    if (PrefixSize > UrlSize) return false;
+    for (size_t i = 0; i + 1 < PrefixSize; ++i) {
+        if (url[i] != prefix[i]) return false;
+    }
+    return true;
+}
+
+/// Bytes matched in the game: the URL, optionally with its NUL
+template <Terminator Term, size_t UrlSize>
+constexpr Bytes<UrlSize - (Term == Terminator::Included ? 0 : 1)> original(const char (&url)[UrlSize])
+{
+    Bytes<UrlSize - (Term == Terminator::Included ? 0 : 1)> bytes{};
+    for (size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<uint8_t>(url[i]);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Writes "http://localhost:<port>/" + url[prefixLength..] into out, NUL-padded
+ *
+ * Shared by the compile-time and runtime generators. The caller has already
+ * checked that localhostLength(port) <= prefixLength and that the URL text
+ * fits in outLength.
+ */
+template <typename Char>
+constexpr void writeRedirect(const Char* url, size_t urlLength, size_t prefixLength,
+                             uint16_t port, uint8_t* out, size_t outLength)
+{
+    size_t n = 0;
+    for (char c : "http://localhost:") {
+        if (c) out[n++] = static_cast<uint8_t>(c);
+    }
+    uint32_t divisor = 1;
+    for (size_t i = 1; i < digitCount(port); ++i) divisor *= 10;
+    for (; divisor > 0; divisor /= 10) {
+        out[n++] = static_cast<uint8_t>('0' + (port / divisor) % 10);
+    }
+    out[n++] = '/';
+    for (size_t i = prefixLength; i < urlLength; ++i) {
+        out[n++] = static_cast<uint8_t>(url[i]);
+    }
+    while (n < outLength) out[n++] = 0x00;
+}
+
+/**
+ * @brief Replacement bytes: "http://localhost:<Port>/" + the URL past prefix, NUL-padded
+ *
+ * The prefix must actually start the URL; check that at the definition with
+ * static_assert(startsWith(url, prefix)).
+ */
+template <uint16_t Port, Terminator Term, size_t UrlSize, size_t PrefixSize>
+constexpr Bytes<UrlSize - (Term == Terminator::Included ? 0 : 1)> patched(
+    const char (&url)[UrlSize], const char (&/*prefix*/)[PrefixSize])
+{
+    constexpr size_t length = UrlSize - (Term == Terminator::Included ? 0 : 1);
+    constexpr size_t prefixLength = PrefixSize - 1;
+    constexpr size_t hostLength = localhostLength(Port);
+    static_assert(PrefixSize <= UrlSize, "Prefix is longer than the URL");
+    static_assert(hostLength <= prefixLength,
+                  "localhost:<port> does not fit in the replaced prefix; the rewrite would overflow the string");
+
+    Bytes<length> bytes{};
+    writeRedirect(url, UrlSize - 1, prefixLength, Port, bytes.data(), length);
+    return bytes;
+}
+
+// ============================================================================
+// Runtime Regeneration
+// ============================================================================
+
+/// Length of the "scheme://host/" prefix of a URL slot, or 0 if there is none
+inline size_t prefixLength(const uint8_t* url, size_t length)
+{
+    for (size_t i = 0; i + 3 <= length && url[i]; ++i) {
+        if (url[i] == ':' && url[i + 1] == '/' && url[i + 2] == '/') {
+            for (size_t j = i + 3; j < length && url[j]; ++j) {
+                if (url[j] == '/') return j + 1;
+            }
+            return 0;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Regenerates a redirect for a new port into a caller-provided buffer
+ *
+ * @param original The original URL slot as matched in the game (text, plus
+ *                 its NUL if the match includes it)
+ * @param out      original.size bytes; untouched if the function fails
+ * @return false if the slot has no scheme://host/ prefix or localhost:<port>
+ *         does not fit in it
+ */
+inline bool regenerate(const uint8_t* original, size_t originalSize, uint16_t port, uint8_t* out)
+{
+    size_t prefix = prefixLength(original, originalSize);
+    if (prefix == 0 || localhostLength(port) > prefix) {
+        return false;
+    }
+
+    size_t textLength = 0;
+    while (textLength < originalSize && original[textLength]) ++textLength;
+    writeRedirect(original, textLength, prefix, port, out, originalSize);
+    return true;
+}
+
+} // namespace UrlRedirect
@@ -0,0 +1,47 @@
+/**
+ * @file WindowsBackend.h
+ * @brief Process memory access on Windows; the MemoryBackend under MemoryEditor
+ *
+ * Owns the process handle. Reads are ReadProcessMemory; protected writes
+ * make the range PAGE_EXECUTE_READWRITE, write, and put the old protection
+ * back whether or not the write succeeded. PatternScanner scans through
+ * this backend and takes handle() only to enumerate modules.
+ */
+
+#pragma once
+
+#include <Windows.h>
+#include <cstddef>
+#include <cstdint>
+#include "MemoryBackend.h"
+
+class WindowsBackend : public MemoryBackend {
+public:
+    WindowsBackend() = default;
+    ~WindowsBackend() override;
+
+    WindowsBackend(const WindowsBackend&) = delete;
+    WindowsBackend& operator=(const WindowsBackend&) = delete;
+
+    /// OpenProcess with VM read/write/operation and query rights; closes any open handle first
+    bool open(DWORD processId);
+    void close();
+
+    bool isOpen() const { return m_handle != nullptr; }
+    bool isRunning() const;             ///< Open and not exited
+    HANDLE handle() const { return m_handle; }
+    DWORD processId() const { return m_processId; }
+    DWORD lastError() const { return m_lastError; }  ///< GetLastError() of the failed call
+
+    size_t read(uintptr_t address, void* buffer, size_t size) const override;
+    bool writeProtected(uintptr_t address, ByteView data) override;
+
+    /// WriteProcessMemory as is; fails on pages that are not writable
+    bool write(uintptr_t address, ByteView data);
+    bool protect(uintptr_t address, size_t size, DWORD newProtection, DWORD& oldProtection);
+
+private:
+    HANDLE m_handle = nullptr;
+    DWORD m_processId = 0;
+    DWORD m_lastError = 0;
+};
@@ -0,0 +1,67 @@
+/**
+ * @file WriteTransaction.h
+ * @brief Coalesces many small writes into few protected writes
+ *
+ * Applying a profile is dozens of patch sites and unlock-table bytes, each
+ * of which would otherwise cost a protect / write / restore round trip.
+ * Writes are collected, sorted, and those less than the merge gap apart
+ * are joined into one run; the bytes between them are read first and
+ * written back unchanged. Only use this for regions the game does not
+ * write to concurrently (code, read-only data, the unlock table).
+ *
+ * Where writes overlap, the one added last wins.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "BuildFingerprint.h"
+#include "ByteView.h"
+
+class MemoryBackend;
+
+class WriteTransaction {
+public:
+    /// Writes at most this far apart share a run
+    static constexpr size_t DEFAULT_MERGE_GAP = 0x1000;
+
+    struct Run {
+        uintptr_t address = 0;
+        std::vector<uint8_t> bytes;     ///< Empty if a gap could not be read
+        size_t writes = 0;              ///< Writes merged into the run
+    };
+
+    explicit WriteTransaction(size_t mergeGap = DEFAULT_MERGE_GAP) : m_mergeGap(mergeGap) {}
+
+    /// Copies data; the view need not outlive the call
+    void add(uintptr_t address, ByteView data);
+    void clear() { m_writes.clear(); m_data.clear(); }
+
+    bool empty() const { return m_writes.empty(); }
+    size_t size() const { return m_writes.size(); }
+
+    /**
+     * @brief The writes merged into runs, in address order
+     * @param read Fills the gaps of runs with more than one write
+     */
+    std::vector<Run> plan(const MemoryReader& read) const;
+
+    /**
+     * @brief Plans against the backend and writes every run
+     * @return false if any run failed; the others are still written
+     */
+    bool commit(MemoryBackend& backend) const;
+
+private:
+    struct Write {
+        uintptr_t address;
+        size_t offset;                  ///< Into m_data
+        size_t size;
+    };
+
+    size_t m_mergeGap;
+    std::vector<Write> m_writes;
+    std::vector<uint8_t> m_data;
+};
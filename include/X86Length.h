@@ -0,0 +1,80 @@
+/**
+ * @file X86Length.h
+ * @brief Table-driven x86-64 instruction length decoder
+ *
+ * Code patches replace bytes in place, so a patch has to start and end on
+ * instruction boundaries; a patch that splits an instruction leaves the CPU
+ * executing the tail of it as new code. This decoder only works out how
+ * long each instruction is (prefixes, opcode map, ModRM/SIB, displacement,
+ * immediate), which is enough to find the boundaries, and costs a few table
+ * lookups per instruction.
+ *
+ * Covers the 64-bit mode legacy, REX, VEX, EVEX and XOP encodings. Opcodes that
+ * are invalid in 64-bit mode decode as length 0.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace X86 {
+
+/// Architectural maximum; longer encodings are rejected
+constexpr size_t MAX_INSTRUCTION_LENGTH = 15;
+
+/**
+ * @brief Where the variable fields of a decoded instruction sit
+ *
+ * Offsets are from the first byte of the instruction; a size of 0 means the
+ * field is absent. Enough to mask out the parts of an encoding that change
+ * when code or data moves between builds.
+ */
+struct Instruction {
+    uint8_t length = 0;
+    uint8_t displacementOffset = 0;
+    uint8_t displacementSize = 0;      ///< 1 or 4
+    uint8_t immediateOffset = 0;
+    uint8_t immediateSize = 0;         ///< Sum of all immediates (enter has two)
+    bool ripRelative = false;          ///< Displacement is relative to the next instruction
+    bool relativeBranch = false;       ///< Immediate is a rel8/rel32 branch target
+};
+
+/**
+ * @brief Decodes the layout of the instruction at code
+ * @return false if the bytes are invalid in 64-bit mode or the instruction
+ *         runs past size
+ */
+bool decode(const uint8_t* code, size_t size, Instruction& instruction);
+
+/**
+ * @brief Length of the instruction at code
+ * @return 0 if the bytes are invalid in 64-bit mode or the instruction runs
+ *         past size
+ */
+inline size_t instructionLength(const uint8_t* code, size_t size)
+{
+    Instruction instruction;
+    return decode(code, size, instruction) ? instruction.length : 0;
+}
+
+/**
+ * @brief Checks that each position is an instruction boundary
+ *
+ * Decodes forward from code[0], which must itself be a boundary, until the
+ * last position is reached. A position equal to the end of a decoded
+ * instruction counts as a boundary.
+ *
+ * @return false if a position falls inside an instruction, or decoding
+ *         fails before the last position
+ */
+bool onBoundaries(const uint8_t* code, size_t size, std::initializer_list<size_t> positions);
+
+/// True if code[0..size) is a whole number of instructions
+inline bool isWholeInstructions(const uint8_t* code, size_t size)
+{
+    return onBoundaries(code, size, {size});
+}
+
+} // namespace X86
@@ -0,0 +1,100 @@
+/**
+ * @file XrefIndex.h
+ * @brief Code references into an address range (RIP-relative, rel32, imm64)
+ *
+ * Finding the code that reads the unlock table, the jump table or a SKU
+ * string means finding every instruction in the executable sections whose
+ * operand resolves into that data. x86-64 code reaches data in three ways:
+ *
+ *   Data      RIP-relative disp32        mov al,[rip+disp32]   lea rcx,[rip+disp32]
+ *   Branch    rel32 call/jmp/jcc         call rel32
+ *   Absolute  imm64 / moffs64            mov rax,imm64 (relocated)
+ *
+ * Two ways to answer a query:
+ *
+ * Xref::scan() for one-off queries. A branch-free pass over every offset of
+ * the code treats the 4 bytes there as a disp32 (and the 8 bytes as an
+ * imm64) and keeps the offsets that would land in the target range; the
+ * compiler vectorizes it, and for a narrow range almost nothing survives.
+ * Each survivor is then confirmed by decoding from RESYNC_WINDOW bytes
+ * before it: x86 decoding resynchronises on the true instruction boundaries
+ * within a few instructions, so the survivor has to be the disp32/imm64 field
+ * of a real instruction, not bytes that happen to look like one.
+ *
+ * XrefIndex for repeated queries. One linear sweep over each executable
+ * section records every reference, sorted by target, so a query is a binary
+ * search. Both sweeps skip a byte where decoding fails, so data embedded in
+ * code costs a few bytes of sync, not the rest of the section.
+ *
+ * The image is indexed by RVA (a module snapshot, or a file laid out with
+ * Pe::mapImage).
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "PeImage.h"
+
+namespace Xref {
+
+/// Bytes decoded before a scan() candidate to land on instruction boundaries
+constexpr uint32_t RESYNC_WINDOW = 64;
+
+enum class Kind : uint8_t {
+    Data,       ///< RIP-relative memory operand
+    Branch,     ///< rel32 call/jmp/jcc
+    Absolute    ///< 64-bit immediate or moffs holding a VA in the image
+};
+
+struct Reference {
+    uint32_t from = 0;      ///< RVA of the referencing instruction
+    uint32_t target = 0;    ///< RVA it resolves to
+    Kind kind = Kind::Data;
+};
+
+/// "data", "branch" or "absolute"
+const char* kindName(Kind kind);
+
+/// Where the code is: the image plus the executable sections to search
+struct Image {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    uint64_t imageBase = 0;             ///< Preferred base for Absolute operands
+    std::vector<Pe::Section> code;      ///< Executable sections
+
+    /// Image laid out by RVA; takes the executable sections from its headers
+    bool open(const uint8_t* image, size_t imageSize);
+};
+
+/// The reference made by the instruction starting at rva, if it makes one
+bool referenceAt(const Image& image, uint32_t rva, Reference& reference);
+
+/**
+ * @brief References into [targetBegin, targetEnd) without building an index
+ * @return Ordered by referencing RVA
+ */
+std::vector<Reference> scan(const Image& image, uint32_t targetBegin, uint32_t targetEnd);
+
+} // namespace Xref
+
+class XrefIndex {
+public:
+    /// Sweeps every executable section once
+    void build(const Xref::Image& image);
+    void clear() { m_references.clear(); }
+    bool isBuilt() const { return !m_references.empty(); }
+
+    /// Every reference found, ordered by target
+    size_t count() const { return m_references.size(); }
+
+    /**
+     * @brief References into [targetBegin, targetEnd)
+     * @return Ordered by referencing RVA
+     */
+    std::vector<Xref::Reference> referencesTo(uint32_t targetBegin, uint32_t targetEnd) const;
+
+private:
+    std::vector<Xref::Reference> m_references;
+};
@@ -0,0 +1,476 @@
+/**
+ * @file BuildDiff.cpp
+ * @brief Aligns two builds of an executable and maps addresses between them
+ */
+
+#include "BuildDiff.h"
+#include "Parallel.h"
+#include "PeImage.h"
+#include "X86Length.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t RUNTIME_FUNCTION_SIZE = 12;    ///< BeginAddress, EndAddress, UnwindData
+
+/// Confidence factors on top of the function match score
+constexpr double NORMALISED_ONLY = 0.9;         ///< Aligned, but raw bytes differ
+constexpr double INTERPOLATED = 0.5;            ///< Offset from the nearest aligned instruction
+constexpr double UNALIGNED = 0.25;              ///< Same offset into the function
+constexpr double SINGLE_REFERENCE = 0.8;        ///< Data address backed by one reference
+constexpr double NEARBY_REFERENCE = 0.5;        ///< Data address only referenced around, not at
+
+constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+constexpr uint64_t ROLLING_BASE = 0x9E3779B97F4A7C15ULL;
+
+uint64_t fnv1a(uint64_t hash, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+/// Instruction bytes with the fields that change when code or data moves zeroed
+void normalise(const uint8_t* code, const X86::Instruction& instruction, uint8_t* out)
+{
+    std::memcpy(out, code, instruction.length);
+    if (instruction.displacementSize == 4) {
+        std::memset(out + instruction.displacementOffset, 0, 4);
+    }
+    if ((instruction.relativeBranch && instruction.immediateSize == 4) || instruction.immediateSize == 8) {
+        std::memset(out + instruction.immediateOffset, 0, instruction.immediateSize);
+    }
+}
+
+} // namespace
+
+const char* BuildDiff::methodName(Method method)
+{
+    switch (method) {
+    case Method::Identical:  return "identical";
+    case Method::Anchors:    return "anchors";
+    case Method::Neighbours: return "neighbours";
+    case Method::References: return "references";
+    }
+    return "";
+}
+
+bool BuildDiff::fail(const std::string& error)
+{
+    m_lastError = error;
+    return false;
+}
+
+bool BuildDiff::build(const uint8_t* oldImage, size_t oldSize, const uint8_t* newImage, size_t newSize,
+                      unsigned threads)
+{
+    auto start = std::chrono::steady_clock::now();
+    m_stats = Stats();
+    m_stats.threads = Parallel::threadCount(threads);
+    m_matches.clear();
+
+    if (!loadFunctions(m_old, oldImage, oldSize, m_stats.threads)) return fail("Old build: " + m_lastError);
+    if (!loadFunctions(m_new, newImage, newSize, m_stats.threads)) return fail("New build: " + m_lastError);
+    m_oldReferences.build(m_old.image);
+
+    m_matches.assign(m_old.functions.size(), Match());
+    matchIdentical();
+    matchAnchors(m_stats.threads);
+    matchNeighbours();
+
+    Parallel::forRanges(m_matches.size(), m_stats.threads, [this](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; ++i) align(i);
+    });
+
+    m_stats.oldFunctions = m_old.functions.size();
+    m_stats.newFunctions = m_new.functions.size();
+    for (size_t i = 0; i < m_matches.size(); ++i) {
+        m_stats.oldInstructions += m_old.functions[i].instructions.size();
+        if (m_matches[i].newFunction == UINT32_MAX) continue;
+        switch (m_matches[i].method) {
+        case Method::Identical:  ++m_stats.identical; break;
+        case Method::Anchors:    ++m_stats.anchored; break;
+        case Method::Neighbours: ++m_stats.neighbours; break;
+        case Method::References: break;
+        }
+        for (int32_t j : m_matches[i].alignment) m_stats.alignedInstructions += j >= 0;
+    }
+    m_stats.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+bool BuildDiff::loadFunctions(Side& side, const uint8_t* image, size_t size, unsigned threads)
+{
+    side.functions.clear();
+    Pe::Headers headers;
+    if (!side.image.open(image, size) || !Pe::parseHeaders(image, size, headers)) {
+        return fail("not a PE32+ image");
+    }
+    if (headers.exceptionTableRva == 0 || headers.exceptionTableRva >= size ||
+        size - headers.exceptionTableRva < headers.exceptionTableSize) {
+        return fail("no exception table to take functions from");
+    }
+
+    const uint8_t* table = image + headers.exceptionTableRva;
+    for (size_t i = 0; i + RUNTIME_FUNCTION_SIZE <= headers.exceptionTableSize; i += RUNTIME_FUNCTION_SIZE) {
+        Function function;
+        std::memcpy(&function.begin, table + i, 4);
+        std::memcpy(&function.end, table + i + 4, 4);
+        if (function.begin < function.end && function.end <= size) {
+            side.functions.push_back(std::move(function));
+        }
+    }
+    std::sort(side.functions.begin(), side.functions.end(),
+              [](const Function& a, const Function& b) { return a.begin < b.begin; });
+    side.functions.erase(std::unique(side.functions.begin(), side.functions.end(),
+                                     [](const Function& a, const Function& b) { return a.begin == b.begin; }),
+                         side.functions.end());
+
+    Parallel::forRanges(side.functions.size(), threads, [&](size_t first, size_t last, unsigned) {
+        uint8_t normalised[X86::MAX_INSTRUCTION_LENGTH];
+        std::vector<uint64_t> rolling;
+        for (size_t f = first; f < last; ++f) {
+            Function& function = side.functions[f];
+            function.hash = FNV_OFFSET;
+            for (uint32_t rva = function.begin; rva < function.end;) {
+                X86::Instruction instruction;
+                if (!X86::decode(image + rva, function.end - rva, instruction)) {
+                    instruction = X86::Instruction();
+                    instruction.length = 1;     // Data or padding; hashed as is
+                }
+                normalise(image + rva, instruction, normalised);
+                uint32_t hash = static_cast<uint32_t>(fnv1a(FNV_OFFSET ^ instruction.length, normalised, instruction.length));
+                function.instructions.push_back({rva - function.begin, hash});
+                function.hash = (function.hash ^ hash) * FNV_PRIME;
+                rva += instruction.length;
+            }
+
+            // Rolling hash over ANCHOR_INSTRUCTIONS instruction hashes, winnowed
+            const auto& instructions = function.instructions;
+            rolling.clear();
+            if (instructions.size() < ANCHOR_INSTRUCTIONS) {
+                function.anchors.assign(1, function.hash);
+                continue;
+            }
+            uint64_t power = 1;
+            for (size_t i = 1; i < ANCHOR_INSTRUCTIONS; ++i) power *= ROLLING_BASE;
+            uint64_t value = 0;
+            for (size_t i = 0; i < instructions.size(); ++i) {
+                if (i >= ANCHOR_INSTRUCTIONS) value -= instructions[i - ANCHOR_INSTRUCTIONS].hash * power;
+                value = value * ROLLING_BASE + instructions[i].hash;
+                if (i + 1 >= ANCHOR_INSTRUCTIONS) rolling.push_back(value);
+            }
+            for (size_t i = 0; i < rolling.size(); ++i) {
+                size_t windowEnd = std::min(rolling.size(), i + ANCHOR_WINDOW);
+                function.anchors.push_back(*std::min_element(rolling.begin() + i, rolling.begin() + windowEnd));
+                if (windowEnd == rolling.size()) break;
+            }
+            std::sort(function.anchors.begin(), function.anchors.end());
+            function.anchors.erase(std::unique(function.anchors.begin(), function.anchors.end()), function.anchors.end());
+        }
+    });
+    return true;
+}
+
+void BuildDiff::matchIdentical()
+{
+    // hash -> (occurrences, function index)
+    auto countHashes = [](const std::vector<Function>& functions) {
+        std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> counts;
+        counts.reserve(functions.size());
+        for (uint32_t i = 0; i < functions.size(); ++i) {
+            auto& entry = counts[functions[i].hash];
+            entry.first++;
+            entry.second = i;
+        }
+        return counts;
+    };
+    auto oldCounts = countHashes(m_old.functions);
+    auto newCounts = countHashes(m_new.functions);
+
+    for (uint32_t i = 0; i < m_old.functions.size(); ++i) {
+        auto found = newCounts.find(m_old.functions[i].hash);
+        if (found == newCounts.end() || found->second.first != 1 || oldCounts[m_old.functions[i].hash].first != 1) {
+            continue;
+        }
+        m_matches[i].newFunction = found->second.second;
+        m_matches[i].score = 1.0;
+        m_matches[i].method = Method::Identical;
+    }
+}
+
+void BuildDiff::matchAnchors(unsigned threads)
+{
+    std::vector<bool> taken(m_new.functions.size(), false);
+    for (const Match& match : m_matches) {
+        if (match.newFunction != UINT32_MAX) taken[match.newFunction] = true;
+    }
+
+    // Anchor -> the one new function holding it; UINT32_MAX if several do
+    std::unordered_map<uint64_t, uint32_t> owners;
+    for (uint32_t i = 0; i < m_new.functions.size(); ++i) {
+        for (uint64_t anchor : m_new.functions[i].anchors) {
+            auto [entry, inserted] = owners.emplace(anchor, i);
+            if (!inserted && entry->second != i) entry->second = UINT32_MAX;
+        }
+    }
+
+    struct Proposal {
+        uint32_t oldFunction;
+        uint32_t newFunction;
+        double score;
+    };
+    std::vector<std::vector<Proposal>> proposals(threads);
+
+    Parallel::forRanges(m_old.functions.size(), threads, [&](size_t first, size_t last, unsigned thread) {
+        std::vector<uint32_t> votes;
+        for (size_t i = first; i < last; ++i) {
+            if (m_matches[i].newFunction != UINT32_MAX) continue;
+            const Function& function = m_old.functions[i];
+
+            votes.clear();
+            for (uint64_t anchor : function.anchors) {
+                auto owner = owners.find(anchor);
+                if (owner != owners.end() && owner->second != UINT32_MAX && !taken[owner->second]) {
+                    votes.push_back(owner->second);
+                }
+            }
+            if (votes.empty()) continue;
+            std::sort(votes.begin(), votes.end());
+
+            uint32_t best = votes[0];
+            size_t bestCount = 0;
+            for (size_t run = 0; run < votes.size();) {
+                size_t next = run;
+                while (next < votes.size() && votes[next] == votes[run]) ++next;
+                if (next - run > bestCount) {
+                    bestCount = next - run;
+                    best = votes[run];
+                }
+                run = next;
+            }
+
+            double score = 2.0 * bestCount / (function.anchors.size() + m_new.functions[best].anchors.size());
+            if (score >= MIN_ANCHOR_SCORE) {
+                proposals[thread].push_back({static_cast<uint32_t>(i), best, std::min(score, 1.0)});
+            }
+        }
+    });
+
+    // Best scores claim their new function first
+    std::vector<Proposal> all;
+    for (auto& list : proposals) all.insert(all.end(), list.begin(), list.end());
+    std::sort(all.begin(), all.end(), [](const Proposal& a, const Proposal& b) { return a.score > b.score; });
+    for (const Proposal& proposal : all) {
+        if (taken[proposal.newFunction]) continue;
+        taken[proposal.newFunction] = true;
+        m_matches[proposal.oldFunction].newFunction = proposal.newFunction;
+        m_matches[proposal.oldFunction].score = proposal.score;
+        m_matches[proposal.oldFunction].method = Method::Anchors;
+    }
+}
+
+void BuildDiff::matchNeighbours()
+{
+    std::vector<bool> taken(m_new.functions.size(), false);
+    for (const Match& match : m_matches) {
+        if (match.newFunction != UINT32_MAX) taken[match.newFunction] = true;
+    }
+
+    // Between two consecutive matched functions, one unmatched function on
+    // each side is taken to be the same function
+    size_t previous = SIZE_MAX;
+    for (size_t i = 0; i < m_matches.size(); ++i) {
+        if (m_matches[i].newFunction == UINT32_MAX || m_matches[i].method == Method::Neighbours) continue;
+        if (previous != SIZE_MAX && i - previous == 2) {
+            uint32_t newPrevious = m_matches[previous].newFunction;
+            uint32_t newCurrent = m_matches[i].newFunction;
+            if (newCurrent == newPrevious + 2 && !taken[newPrevious + 1]) {
+                const Function& oldFunction = m_old.functions[previous + 1];
+                const Function& newFunction = m_new.functions[newPrevious + 1];
+                double oldSize = oldFunction.end - oldFunction.begin;
+                double newSize = newFunction.end - newFunction.begin;
+                taken[newPrevious + 1] = true;
+                m_matches[previous + 1].newFunction = newPrevious + 1;
+                m_matches[previous + 1].score = 0.5 * std::min(oldSize, newSize) / std::max(oldSize, newSize);
+                m_matches[previous + 1].method = Method::Neighbours;
+            }
+        }
+        previous = i;
+    }
+}
+
+void BuildDiff::align(size_t oldFunction)
+{
+    Match& match = m_matches[oldFunction];
+    if (match.newFunction == UINT32_MAX) return;
+
+    const auto& a = m_old.functions[oldFunction].instructions;
+    const auto& b = m_new.functions[match.newFunction].instructions;
+    match.alignment.assign(a.size(), -1);
+
+    // Common prefix and suffix, then the LCS of what is left
+    size_t prefix = 0;
+    while (prefix < a.size() && prefix < b.size() && a[prefix].hash == b[prefix].hash) {
+        match.alignment[prefix] = static_cast<int32_t>(prefix);
+        ++prefix;
+    }
+    size_t suffix = 0;
+    while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+           a[a.size() - 1 - suffix].hash == b[b.size() - 1 - suffix].hash) {
+        match.alignment[a.size() - 1 - suffix] = static_cast<int32_t>(b.size() - 1 - suffix);
+        ++suffix;
+    }
+
+    size_t n = a.size() - prefix - suffix;
+    size_t m = b.size() - prefix - suffix;
+    if (n == 0 || m == 0 || (n + 1) * (m + 1) > MAX_ALIGNMENT_CELLS) return;
+
+    // lengths[i][j] = LCS of a[prefix + i..] and b[prefix + j..]
+    std::vector<uint32_t> lengths((n + 1) * (m + 1), 0);
+    auto at = [&](size_t i, size_t j) -> uint32_t& { return lengths[i * (m + 1) + j]; };
+    for (size_t i = n; i-- > 0;) {
+        for (size_t j = m; j-- > 0;) {
+            at(i, j) = a[prefix + i].hash == b[prefix + j].hash ? at(i + 1, j + 1) + 1
+                                                                : std::max(at(i + 1, j), at(i, j + 1));
+        }
+    }
+    for (size_t i = 0, j = 0; i < n && j < m;) {
+        if (a[prefix + i].hash == b[prefix + j].hash) {
+            match.alignment[prefix + i] = static_cast<int32_t>(prefix + j);
+            ++i;
+            ++j;
+        } else if (at(i + 1, j) >= at(i, j + 1)) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+}
+
+const BuildDiff::Function* BuildDiff::findFunction(const Side& side, uint32_t rva, size_t* index) const
+{
+    auto it = std::upper_bound(side.functions.begin(), side.functions.end(), rva,
+                               [](uint32_t value, const Function& function) { return value < function.begin; });
+    if (it == side.functions.begin()) return nullptr;
+    --it;
+    if (rva >= it->end) return nullptr;
+    if (index) *index = static_cast<size_t>(it - side.functions.begin());
+    return &*it;
+}
+
+std::optional<BuildDiff::Mapping> BuildDiff::mapCode(uint32_t oldRva) const
+{
+    size_t index;
+    const Function* function = findFunction(m_old, oldRva, &index);
+    if (!function || m_matches[index].newFunction == UINT32_MAX) return std::nullopt;
+
+    const Match& match = m_matches[index];
+    const Function& target = m_new.functions[match.newFunction];
+    const auto& instructions = function->instructions;
+    uint32_t offset = oldRva - function->begin;
+
+    auto it = std::upper_bound(instructions.begin(), instructions.end(), offset,
+                               [](uint32_t value, const Instruction& instruction) { return value < instruction.offset; });
+    size_t i = static_cast<size_t>(it - instructions.begin()) - 1;
+
+    Mapping mapping;
+    mapping.oldRva = oldRva;
+    mapping.method = match.method;
+    mapping.confidence = match.score;
+
+    auto newStart = [&](size_t oldIndex) {
+        return target.begin + target.instructions[match.alignment[oldIndex]].offset;
+    };
+    if (match.alignment[i] >= 0) {
+        uint32_t oldStart = function->begin + instructions[i].offset;
+        uint32_t oldEnd = i + 1 < instructions.size() ? function->begin + instructions[i + 1].offset : function->end;
+        uint32_t start = newStart(i);
+        mapping.newRva = start + (oldRva - oldStart);
+        size_t length = oldEnd - oldStart;
+        bool sameBytes = start + length <= m_new.image.size &&
+                         std::memcmp(m_old.image.data + oldStart, m_new.image.data + start, length) == 0;
+        if (!sameBytes) mapping.confidence *= NORMALISED_ONLY;
+        return mapping;
+    }
+
+    // Nearest aligned instruction before, else after; else the same offset
+    mapping.interpolated = true;
+    for (size_t k = i; k-- > 0;) {
+        if (match.alignment[k] >= 0) {
+            mapping.newRva = newStart(k) + (oldRva - function->begin - instructions[k].offset);
+            mapping.confidence *= INTERPOLATED;
+            return mapping;
+        }
+    }
+    for (size_t k = i + 1; k < instructions.size(); ++k) {
+        if (match.alignment[k] >= 0) {
+            mapping.newRva = newStart(k) - (function->begin + instructions[k].offset - oldRva);
+            mapping.confidence *= INTERPOLATED;
+            return mapping;
+        }
+    }
+    mapping.newRva = target.begin + std::min(offset, target.end - target.begin - 1);
+    mapping.confidence *= UNALIGNED;
+    return mapping;
+}
+
+std::optional<BuildDiff::Mapping> BuildDiff::mapData(uint32_t oldRva) const
+{
+    uint32_t low = oldRva - std::min(oldRva, DATA_REFERENCE_WINDOW);
+    std::vector<Xref::Reference> references = m_oldReferences.referencesTo(low, oldRva + DATA_REFERENCE_WINDOW + 1);
+
+    // References to the address itself decide when there are any; otherwise
+    // the nearest ones vote, as a neighbouring item may have moved separately
+    bool exact = std::any_of(references.begin(), references.end(),
+                             [oldRva](const Xref::Reference& reference) { return reference.target == oldRva; });
+
+    // Candidate new address -> (summed weight, supporting references)
+    std::map<uint32_t, std::pair<double, size_t>> votes;
+    double total = 0;
+    for (const Xref::Reference& reference : references) {
+        if (exact && reference.target != oldRva) continue;
+        auto code = mapCode(reference.from);
+        if (!code || code->interpolated) continue;
+
+        Xref::Reference moved;
+        if (!Xref::referenceAt(m_new.image, code->newRva, moved) || moved.kind != reference.kind) continue;
+
+        int64_t candidate = int64_t(moved.target) + (int64_t(oldRva) - reference.target);
+        if (candidate < 0 || uint64_t(candidate) >= m_new.image.size) continue;
+
+        uint32_t distance = reference.target > oldRva ? reference.target - oldRva : oldRva - reference.target;
+        double weight = code->confidence * (1.0 - double(distance) / (DATA_REFERENCE_WINDOW + 1));
+        auto& vote = votes[static_cast<uint32_t>(candidate)];
+        vote.first += weight;
+        vote.second++;
+        total += weight;
+    }
+    if (votes.empty() || total <= 0) return std::nullopt;
+
+    auto best = std::max_element(votes.begin(), votes.end(),
+                                 [](const auto& a, const auto& b) { return a.second.first < b.second.first; });
+    Mapping mapping;
+    mapping.oldRva = oldRva;
+    mapping.newRva = best->first;
+    mapping.method = Method::References;
+    mapping.confidence = best->second.first / total * (best->second.first / best->second.second);
+    if (!exact) mapping.confidence *= NEARBY_REFERENCE;
+    if (best->second.second == 1) mapping.confidence *= SINGLE_REFERENCE;
+    return mapping;
+}
+
+std::optional<BuildDiff::Mapping> BuildDiff::map(uint32_t oldRva) const
+{
+    for (const Pe::Section& section : m_old.image.code) {
+        if (section.contains(oldRva)) return mapCode(oldRva);
+    }
+    return mapData(oldRva);
+}
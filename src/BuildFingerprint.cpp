@@ -0,0 +1,78 @@
+/**
+ * @file BuildFingerprint.cpp
+ * @brief PE header and sampled-page build fingerprint
+ */
+
+#include "BuildFingerprint.h"
+#include "PeImage.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t FNV64_OFFSET = 0xCBF29CE484222325ull;
+constexpr uint64_t FNV64_PRIME = 0x00000100000001B3ull;
+constexpr size_t PAGE_SIZE = 0x1000;
+constexpr size_t MAX_SAMPLED_SECTIONS = 8;
+
+void hashBytes(uint64_t& hash, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= FNV64_PRIME;
+    }
+}
+
+void hashPage(uint64_t& hash, const MemoryReader& read, uintptr_t address, std::vector<uint8_t>& page)
+{
+    // Unreadable pages still contribute (as zeros) so the sample positions stay fixed
+    size_t got = read(address, page.data(), PAGE_SIZE);
+    if (got < PAGE_SIZE) {
+        std::memset(page.data() + got, 0, PAGE_SIZE - got);
+    }
+    hashBytes(hash, page.data(), PAGE_SIZE);
+}
+
+} // namespace
+
+std::string BuildFingerprint::toString() const
+{
+    char text[17];
+    std::snprintf(text, sizeof(text), "%016llX", static_cast<unsigned long long>(hash));
+    return text;
+}
+
+std::optional<BuildFingerprint> BuildFingerprint::compute(const MemoryReader& read, uintptr_t moduleBase)
+{
+    std::vector<uint8_t> page(PAGE_SIZE);
+    if (read(moduleBase, page.data(), PAGE_SIZE) != PAGE_SIZE) {
+        return std::nullopt;
+    }
+
+    Pe::Headers headers;
+    if (!Pe::parseHeaders(page.data(), page.size(), headers)) {
+        return std::nullopt;
+    }
+
+    std::memset(page.data() + headers.imageBaseOffset, 0, sizeof(uint64_t));
+
+    uint64_t hash = FNV64_OFFSET;
+    hashBytes(hash, page.data(), page.size());
+
+    hashPage(hash, read, moduleBase + (headers.entryPoint & ~(PAGE_SIZE - 1)), page);
+
+    size_t sampled = 0;
+    for (const auto& section : headers.sections) {
+        if (section.isWritable() || section.virtualSize == 0) continue;
+        if (++sampled > MAX_SAMPLED_SECTIONS) break;
+        hashPage(hash, read, moduleBase + section.virtualAddress, page);
+    }
+
+    BuildFingerprint fingerprint;
+    fingerprint.hash = hash;
+    fingerprint.timeDateStamp = headers.timeDateStamp;
+    fingerprint.sizeOfImage = headers.sizeOfImage;
+    return fingerprint;
+}
@@ -0,0 +1,321 @@
+/**
+ * @file FmIndex.cpp
+ * @brief FM-index over a module image or memory dump
+ */
+
+#include "FmIndex.h"
+#include "Parallel.h"
+#include "SuffixArray.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+size_t popcount64(uint64_t value)
+{
+    value = value - ((value >> 1) & 0x5555555555555555ull);
+    value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return static_cast<size_t>((value * 0x0101010101010101ull) >> 56);
+}
+
+constexpr size_t ALPHABET = 256;
+
+} // namespace
+
+bool FmIndex::fail(const std::string& error)
+{
+    clear();
+    m_lastError = error;
+    return false;
+}
+
+void FmIndex::clear()
+{
+    m_bwt = std::vector<uint8_t>();
+    m_primary = 0;
+    m_first = {};
+    m_superblocks = std::vector<uint32_t>();
+    m_blocks = std::vector<uint16_t>();
+    m_sampleMarks = std::vector<uint64_t>();
+    m_markRanks = std::vector<uint32_t>();
+    m_samples = std::vector<uint32_t>();
+}
+
+size_t FmIndex::memoryUsage() const
+{
+    return m_bwt.size() + m_superblocks.size() * sizeof(uint32_t) + m_blocks.size() * sizeof(uint16_t) +
+           m_sampleMarks.size() * sizeof(uint64_t) + m_markRanks.size() * sizeof(uint32_t) +
+           m_samples.size() * sizeof(uint32_t);
+}
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+bool FmIndex::build(const uint8_t* text, size_t size, unsigned threads, BuildStats* stats)
+{
+    clear();
+    if (!text || size == 0 || size > SuffixArray::MAX_TEXT_SIZE) {
+        return fail("Text size out of range");
+    }
+    threads = Parallel::threadCount(threads);
+    BuildStats local;
+    BuildStats& timing = stats ? *stats : local;
+    timing.threads = threads;
+
+    auto start = Clock::now();
+    std::vector<int32_t> sa = SuffixArray::build(text, size, threads);
+    if (sa.size() != size) return fail("Suffix sort failed");
+    timing.suffixSortMs = millisecondsSince(start);
+
+    // Row 0 is the sentinel suffix; rows 1..size follow the suffix array
+    size_t rows = size + 1;
+    auto position = [&](size_t row) -> uint32_t {
+        return row == 0 ? static_cast<uint32_t>(size) : static_cast<uint32_t>(sa[row - 1]);
+    };
+
+    // Whole 64-bit mark words per thread, so no two threads write the same word
+    start = Clock::now();
+    m_bwt.resize(rows);
+    m_sampleMarks.assign((rows + 63) / 64, 0);
+    Parallel::forRanges(m_sampleMarks.size(), threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t row = begin * 64; row < std::min(rows, end * 64); ++row) {
+            uint32_t p = position(row);
+            if (p == 0) {
+                m_primary = static_cast<uint32_t>(row);
+                m_bwt[row] = 0;
+            } else {
+                m_bwt[row] = text[p - 1];
+            }
+            if (p % SAMPLE_RATE == 0) m_sampleMarks[row >> 6] |= uint64_t(1) << (row & 63);
+        }
+    });
+    timing.bwtMs = millisecondsSince(start);
+
+    start = Clock::now();
+    buildRankTables(threads);
+    timing.rankMs = millisecondsSince(start);
+
+    start = Clock::now();
+    buildMarkRanks();
+    m_samples.resize(m_markRanks.back());
+    Parallel::forRanges(m_sampleMarks.size(), threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t row = begin * 64; row < std::min(rows, end * 64); ++row) {
+            if (isMarked(row)) m_samples[markRank(row)] = position(row);
+        }
+    });
+    timing.sampleMs = millisecondsSince(start);
+    return true;
+}
+
+/**
+ * @brief Superblock and block counts, and the C array, from the BWT
+ *
+ * Each thread counts whole superblocks; only the running totals across
+ * superblocks are summed afterwards.
+ */
+void FmIndex::buildRankTables(unsigned threads)
+{
+    size_t rows = m_bwt.size();
+    size_t superblockCount = rows / SUPERBLOCK_SIZE + 1;
+    size_t blockCount = rows / BLOCK_SIZE + 1;
+    constexpr size_t BLOCKS_PER_SUPERBLOCK = SUPERBLOCK_SIZE / BLOCK_SIZE;
+
+    m_superblocks.assign(superblockCount * ALPHABET, 0);
+    m_blocks.assign(blockCount * ALPHABET, 0);
+    std::vector<uint32_t> totals(superblockCount * ALPHABET, 0);
+
+    Parallel::forRanges(superblockCount, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t superblock = begin; superblock < end; ++superblock) {
+            uint32_t* running = totals.data() + superblock * ALPHABET;
+            size_t firstBlock = superblock * BLOCKS_PER_SUPERBLOCK;
+            size_t lastBlock = std::min(blockCount, firstBlock + BLOCKS_PER_SUPERBLOCK);
+            for (size_t block = firstBlock; block < lastBlock; ++block) {
+                std::copy(running, running + ALPHABET, m_blocks.begin() + block * ALPHABET);
+                size_t rowEnd = std::min(rows, (block + 1) * BLOCK_SIZE);
+                for (size_t row = block * BLOCK_SIZE; row < rowEnd; ++row) {
+                    if (row != m_primary) ++running[m_bwt[row]];
+                }
+            }
+        }
+    });
+
+    std::array<uint64_t, ALPHABET> sums = {};
+    for (size_t superblock = 0; superblock < superblockCount; ++superblock) {
+        for (size_t c = 0; c < ALPHABET; ++c) {
+            m_superblocks[superblock * ALPHABET + c] = static_cast<uint32_t>(sums[c]);
+            sums[c] += totals[superblock * ALPHABET + c];
+        }
+    }
+
+    m_first[0] = 1;  // The sentinel suffix sorts first
+    for (size_t c = 0; c < ALPHABET; ++c) {
+        m_first[c + 1] = m_first[c] + static_cast<uint32_t>(sums[c]);
+    }
+}
+
+void FmIndex::buildMarkRanks()
+{
+    m_markRanks.assign(m_sampleMarks.size() + 1, 0);
+    for (size_t word = 0; word < m_sampleMarks.size(); ++word) {
+        m_markRanks[word + 1] = m_markRanks[word] + static_cast<uint32_t>(popcount64(m_sampleMarks[word]));
+    }
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+/// Occurrences of c in bwt[0..row), not counting the sentinel
+size_t FmIndex::rank(uint8_t c, size_t row) const
+{
+    size_t block = row / BLOCK_SIZE;
+    size_t result = m_superblocks[(row / SUPERBLOCK_SIZE) * ALPHABET + c] + m_blocks[block * ALPHABET + c];
+
+    const uint8_t* p = m_bwt.data() + block * BLOCK_SIZE;
+    const uint8_t* end = m_bwt.data() + row;
+    for (; p < end; ++p) {
+        result += (*p == c);
+    }
+    if (c == 0 && m_primary >= block * BLOCK_SIZE && m_primary < row) --result;
+    return result;
+}
+
+size_t FmIndex::markRank(size_t row) const
+{
+    uint64_t below = (uint64_t(1) << (row & 63)) - 1;
+    return m_markRanks[row >> 6] + popcount64(m_sampleMarks[row >> 6] & below);
+}
+
+/// Backward search: rows [low, high) are the suffixes that start with pattern
+bool FmIndex::findRange(ByteView pattern, size_t& low, size_t& high) const
+{
+    if (!isBuilt() || pattern.empty()) return false;
+
+    low = 0;
+    high = m_bwt.size();
+    for (size_t i = pattern.size; i-- > 0;) {
+        uint8_t c = pattern[i];
+        low = m_first[c] + rank(c, low);
+        high = m_first[c] + rank(c, high);
+        if (low >= high) return false;
+    }
+    return true;
+}
+
+size_t FmIndex::count(ByteView pattern) const
+{
+    size_t low = 0;
+    size_t high = 0;
+    return findRange(pattern, low, high) ? high - low : 0;
+}
+
+std::vector<uint32_t> FmIndex::locate(ByteView pattern, size_t limit) const
+{
+    std::vector<uint32_t> positions;
+    size_t low = 0;
+    size_t high = 0;
+    if (!findRange(pattern, low, high)) return positions;
+    if (limit && high - low > limit) high = low + limit;
+
+    positions.reserve(high - low);
+    for (size_t row = low; row < high; ++row) {
+        // LF-walk to the nearest sampled row; each step moves one byte back in the text
+        size_t r = row;
+        uint32_t steps = 0;
+        while (!isMarked(r) && steps < SAMPLE_RATE) {
+            uint8_t c = m_bwt[r];
+            r = m_first[c] + rank(c, r);
+            ++steps;
+        }
+        if (isMarked(r)) positions.push_back(m_samples[markRank(r)] + steps);  // Else the file was damaged
+    }
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+// ============================================================================
+// Persistence
+// ============================================================================
+
+bool FmIndex::save(const std::string& path) const
+{
+    if (!isBuilt()) return false;
+
+    Fm::FileHeader header = {};
+    std::memcpy(header.magic, Fm::MAGIC, sizeof(header.magic));
+    header.formatVersion = Fm::FORMAT_VERSION;
+    header.sampleRate = SAMPLE_RATE;
+    header.textSize = static_cast<uint32_t>(textSize());
+    header.primary = m_primary;
+    header.sampleCount = static_cast<uint32_t>(m_samples.size());
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(m_bwt.data()), m_bwt.size());
+    output.write(reinterpret_cast<const char*>(m_sampleMarks.data()), m_sampleMarks.size() * sizeof(uint64_t));
+    output.write(reinterpret_cast<const char*>(m_samples.data()), m_samples.size() * sizeof(uint32_t));
+    output.close();
+    if (!output) {
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool FmIndex::load(const std::string& path, unsigned threads)
+{
+    clear();
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    if (!input) return fail("Cannot open " + path);
+    uint64_t fileSize = static_cast<uint64_t>(input.tellg());
+    input.seekg(0);
+
+    Fm::FileHeader header;
+    if (fileSize < sizeof(header) || !input.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return fail("Index file truncated");
+    }
+    if (std::memcmp(header.magic, Fm::MAGIC, sizeof(header.magic)) != 0 ||
+        header.formatVersion != Fm::FORMAT_VERSION || header.sampleRate != SAMPLE_RATE) {
+        return fail("Not a compatible index file");
+    }
+
+    uint64_t rows = uint64_t(header.textSize) + 1;
+    uint64_t words = (rows + 63) / 64;
+    if (header.textSize == 0 || header.primary >= rows || header.sampleCount != header.textSize / SAMPLE_RATE + 1 ||
+        fileSize != sizeof(header) + rows + words * sizeof(uint64_t) + uint64_t(header.sampleCount) * sizeof(uint32_t)) {
+        return fail("Index file size does not match its header");
+    }
+
+    m_bwt.resize(rows);
+    m_sampleMarks.resize(words);
+    m_samples.resize(header.sampleCount);
+    input.read(reinterpret_cast<char*>(m_bwt.data()), m_bwt.size());
+    input.read(reinterpret_cast<char*>(m_sampleMarks.data()), m_sampleMarks.size() * sizeof(uint64_t));
+    input.read(reinterpret_cast<char*>(m_samples.data()), m_samples.size() * sizeof(uint32_t));
+    if (!input) return fail("Index file truncated");
+
+    // Everything a query indexes with must be consistent, or a damaged file could read out of bounds
+    m_primary = header.primary;
+    buildMarkRanks();
+    if (m_markRanks.back() != m_samples.size() || !isMarked(m_primary)) {
+        return fail("Index sample marks are corrupt");
+    }
+    buildRankTables(Parallel::threadCount(threads));
+    if (m_first[ALPHABET] != rows) {
+        return fail("Index BWT is corrupt");
+    }
+    return true;
+}
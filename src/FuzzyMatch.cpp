@@ -0,0 +1,152 @@
+/**
+ * @file FuzzyMatch.cpp
+ * @brief Shift-Or search within k substituted bytes
+ */
+
+#include "FuzzyMatch.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace Fuzzy {
+
+namespace {
+
+bool byteMatches(uint8_t actual, uint8_t expected, uint8_t mask)
+{
+    return (actual & mask) == (expected & mask);
+}
+
+uint8_t maskAt(ByteView mask, size_t index)
+{
+    return mask.empty() ? 0xFF : mask[index];
+}
+
+Match compare(const uint8_t* window, size_t offset, ByteView pattern, ByteView mask)
+{
+    Match match;
+    match.offset = offset;
+    for (size_t i = 0; i < pattern.size; ++i) {
+        if (!byteMatches(window[i], pattern[i], maskAt(mask, i))) {
+            match.differences.push_back({static_cast<uint8_t>(i), pattern[i], window[i]});
+        }
+    }
+    match.distance = static_cast<unsigned>(match.differences.size());
+    return match;
+}
+
+} // namespace
+
+std::string Match::describe() const
+{
+    std::string text;
+    char part[24];
+    for (const Difference& difference : differences) {
+        std::snprintf(part, sizeof(part), "%s+%u %02X->%02X", text.empty() ? "" : ", ",
+                      difference.offset, difference.expected, difference.actual);
+        text += part;
+    }
+    return text;
+}
+
+unsigned maxUsefulDistance(ByteView pattern, ByteView mask)
+{
+    size_t fixed = pattern.size;
+    if (!mask.empty()) {
+        fixed = static_cast<size_t>(std::count_if(mask.begin(), mask.end(), [](uint8_t m) { return m != 0; }));
+    }
+    return static_cast<unsigned>(std::min<size_t>(MAX_DISTANCE, fixed / 2));
+}
+
+std::vector<Match> search(const uint8_t* data, size_t size, ByteView pattern, ByteView mask, unsigned maxDistance)
+{
+    std::vector<Match> matches;
+    const size_t length = pattern.size;
+    if (length == 0 || length > MAX_PATTERN_LENGTH || size < length) return matches;
+    if (!mask.empty() && mask.size != length) return matches;
+    if (maxDistance > maxUsefulDistance(pattern, mask)) return matches;
+
+    // Bit i of byteMask[c] is set when c does not match pattern byte i
+    std::array<uint64_t, 256> byteMask;
+    for (unsigned c = 0; c < 256; ++c) {
+        uint64_t bits = 0;
+        for (size_t i = 0; i < length; ++i) {
+            if (!byteMatches(static_cast<uint8_t>(c), pattern[i], maskAt(mask, i))) {
+                bits |= uint64_t(1) << i;
+            }
+        }
+        byteMask[c] = bits;
+    }
+    const uint64_t accept = uint64_t(1) << (length - 1);
+
+    // Lane l owns the windows starting in [l * segment, (l + 1) * segment) and
+    // reads length - 1 bytes past that so its last windows complete
+    const size_t windows = size - length + 1;
+    const size_t segment = (windows + LANES - 1) / LANES;
+    const size_t steps = segment + length - 1;
+    const size_t lastLaneStart = (LANES - 1) * segment;
+    const size_t uncheckedSteps = size > lastLaneStart ? std::min(steps, size - lastLaneStart) : 0;
+
+    uint64_t state[MAX_DISTANCE + 1][LANES];
+    for (unsigned d = 0; d <= maxDistance; ++d) {
+        std::fill(std::begin(state[d]), std::end(state[d]), ~uint64_t(0));
+    }
+
+    auto resolve = [&](size_t step) {
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            if (state[maxDistance][lane] & accept) continue;
+            size_t laneStart = lane * segment;
+            size_t end = laneStart + step;
+            if (step + 1 < length || end >= size) continue;
+            size_t start = end + 1 - length;
+            if (start >= std::min(laneStart + segment, windows)) continue;
+            matches.push_back(compare(data + start, start, pattern, mask));
+        }
+    };
+
+    for (size_t step = 0; step < steps; ++step) {
+        uint64_t bytes[LANES];
+        if (step < uncheckedSteps) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                bytes[lane] = byteMask[data[lane * segment + step]];
+            }
+        } else {
+            // Past the end of the data; these lanes own no further windows
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                size_t position = lane * segment + step;
+                bytes[lane] = position < size ? byteMask[data[position]] : ~uint64_t(0);
+            }
+        }
+
+        uint64_t hits = 0;
+        for (size_t lane = 0; lane < LANES; ++lane) {
+            uint64_t previous = state[0][lane];
+            uint64_t current = (previous << 1) | bytes[lane];
+            state[0][lane] = current;
+            for (unsigned d = 1; d <= maxDistance; ++d) {
+                uint64_t next = ((state[d][lane] << 1) | bytes[lane]) & (previous << 1);
+                previous = state[d][lane];
+                state[d][lane] = next;
+                current = next;
+            }
+            hits |= ~current & accept;
+        }
+        if (hits) resolve(step);
+    }
+
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) { return a.offset < b.offset; });
+    return matches;
+}
+
+void rank(std::vector<Match>& matches, size_t limit)
+{
+    std::stable_sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.offset < b.offset;
+    });
+    if (limit != 0 && matches.size() > limit) {
+        matches.resize(limit);
+    }
+}
+
+} // namespace Fuzzy
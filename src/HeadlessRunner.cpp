@@ -0,0 +1,279 @@
+/**
+ * @file HeadlessRunner.cpp
+ * @brief Profile-driven unlocker without a window
+ */
+
+#include "HeadlessRunner.h"
+#include "ScanStats.h"
+#include "Trace.h"
+#include "UnlockRegistry.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtAlgorithms>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+namespace {
+
+/// Milliseconds since this process was created, loader and Qt start-up included
+qint64 msSinceProcessStart()
+{
+    FILETIME creation, exited, kernel, user, now;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exited, &kernel, &user)) {
+        return -1;
+    }
+    GetSystemTimeAsFileTime(&now);
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<qint64>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    return (ticks(now) - ticks(creation)) / 10000;  // 100 ns units
+}
+
+} // namespace
+
+// ============================================================================
+// Construction / Destruction
+// ============================================================================
+
+HeadlessRunner::HeadlessRunner(QObject* parent)
+    : QObject(parent)
+    , m_memoryEditor(new MemoryEditor(this))
+    , m_httpServer(new HttpServer(this))
+    , m_pollTimer(new QTimer(this))
+    , m_freezeTimer(new QTimer(this))
+{
+    Trace::setThreadName("main");
+
+    m_pollTimer->setInterval(WAIT_POLL_MS);
+    connect(m_pollTimer, &QTimer::timeout, this, &HeadlessRunner::pollForProcess);
+    connect(m_freezeTimer, &QTimer::timeout, this, &HeadlessRunner::onFreezeTick);
+
+    connect(m_memoryEditor, &MemoryEditor::errorOccurred, this, [this](const QString& error) {
+        log("[ERROR] " + error);
+    });
+    connect(m_memoryEditor, &MemoryEditor::buildIdentified, this,
+            [this](const QString& fingerprint, const QString& buildName) {
+        log(buildName.isEmpty() ? QString("Unknown game build %1, locating patches by scan").arg(fingerprint)
+                                : QString("Game build %1 (%2)").arg(buildName, fingerprint));
+    });
+    connect(m_memoryEditor, &MemoryEditor::patternScanned, this, [this](const QString& summary) {
+        log(summary);
+    });
+
+    connect(m_httpServer, &HttpServer::serverStarted, this, [this](quint16 port) {
+        log(QString("HTTP server started on port %1").arg(port));
+    });
+    connect(m_httpServer, &HttpServer::requestReceived, this, [this](const QString& method, const QString& path) {
+        log(QString("%1 %2").arg(method, path));
+    });
+    connect(m_httpServer, &HttpServer::errorOccurred, this, [this](const QString& error) {
+        log("[ERROR] " + error);
+    });
+    m_httpServer->setMetricsProvider([this] {
+        return QByteArray::fromStdString(ScanStats::formatMetrics(m_memoryEditor->getScanStats()));
+    });
+}
+
+HeadlessRunner::~HeadlessRunner()
+{
+    stopWatchingForExit();
+}
+
+// ============================================================================
+// Start-up
+// ============================================================================
+
+void HeadlessRunner::start(const QString& profilePath)
+{
+    QString databasePath = QCoreApplication::applicationDirPath() + "/" + SignatureDatabase::DEFAULT_FILE;
+    log(QString::fromStdString(m_signatureDatabase.loadOverrides(databasePath.toUtf8().toStdString())));
+    m_memoryEditor->setSignatureDatabase(&m_signatureDatabase);
+
+    QString indexDirectory = QCoreApplication::applicationDirPath() + "/" + PATTERN_INDEX_DIRECTORY;
+    if (QFileInfo(indexDirectory).isDir()) {
+        m_memoryEditor->setPatternIndexDirectory(indexDirectory.toUtf8().toStdString());
+    }
+
+    if (!loadProfile(profilePath)) {
+        finish(ProfileError);
+        return;
+    }
+
+    if (m_profile.serverEnabled() && !m_httpServer->start(Patches::activeRedirectPort)) {
+        finish(ServerFailed);
+        return;
+    }
+
+    m_setupMs = msSinceProcessStart();
+    log("Waiting for ffxv_s.exe...");
+    m_waitTimer.start();
+    pollForProcess();
+    if (!m_memoryEditor->isAttached()) {
+        m_pollTimer->start();
+    }
+}
+
+/**
+ * @brief Reads the profile and resolves its names against this build's definitions
+ *
+ * Runs after the signature database is applied, since it can rename items
+ * and patches. A profile port is set before anything is patched, so the
+ * URL patches are generated for it.
+ */
+bool HeadlessRunner::loadProfile(const QString& profilePath)
+{
+    if (!m_profile.load(profilePath.toUtf8().toStdString())) {
+        log(QString("[ERROR] Profile %1: %2").arg(profilePath, QString::fromStdString(m_profile.getLastError())));
+        return false;
+    }
+
+    if (!m_profile.resolve(m_memoryEditor->getUnlockRegistry(), m_mask, m_patches)) {
+        log(QString("[ERROR] Profile %1: %2").arg(profilePath, QString::fromStdString(m_profile.getLastError())));
+        return false;
+    }
+
+    if (m_profile.port() != 0 && !Patches::setRedirectPort(m_profile.port())) {
+        log(QString("[ERROR] Port %1 does not fit in the game's Twitch URLs").arg(m_profile.port()));
+        return false;
+    }
+
+    log(QString("Profile %1: %2 patches, %3 table bytes, server %4, %5")
+            .arg(QFileInfo(profilePath).fileName())
+            .arg(m_patches.size())
+            .arg(qPopulationCount(m_mask))
+            .arg(m_profile.serverEnabled() ? QString("on port %1").arg(Patches::activeRedirectPort) : "off")
+            .arg(m_profile.resident() ? "resident" : "apply once"));
+    return true;
+}
+
+// ============================================================================
+// Process Lifetime
+// ============================================================================
+
+void HeadlessRunner::pollForProcess()
+{
+    QElapsedTimer attachTimer;
+    attachTimer.start();
+    if (m_memoryEditor->attachToProcess(TARGET_PROCESS)) {
+        m_pollTimer->stop();
+        qint64 attachMs = attachTimer.elapsed();
+        qint64 waitedMs = m_waitTimer.elapsed() - attachMs;
+        log(QString("Attached to ffxv_s.exe (PID: %1)").arg(m_memoryEditor->getProcessId()));
+        onAttached(waitedMs, attachMs);
+        return;
+    }
+
+    // Only the first wait has a deadline; a resident runner waits for restarts indefinitely
+    if (m_firstApply && m_profile.waitSeconds() != 0 &&
+        m_waitTimer.elapsed() >= qint64(m_profile.waitSeconds()) * 1000) {
+        log(QString("[ERROR] ffxv_s.exe did not start within %1 s").arg(m_profile.waitSeconds()));
+        finish(WaitTimedOut);
+    }
+}
+
+void HeadlessRunner::onAttached(qint64 waitedMs, qint64 attachMs)
+{
+    watchForExit();
+
+    QElapsedTimer applyTimer;
+    applyTimer.start();
+    size_t rewritten = 0;
+    if (!m_memoryEditor->applyProfile(m_patches, m_mask, rewritten)) {
+        log("[ERROR] Profile not applied");
+        finish(ApplyFailed);
+        return;
+    }
+    qint64 applyMs = applyTimer.elapsed();
+
+    if (m_firstApply) {
+        log(QString("Ready %1 ms after start (start-up %2 ms, waiting for the game %3 ms, "
+                    "attach %4 ms, apply %5 ms, %6 writes)")
+                .arg(msSinceProcessStart()).arg(m_setupMs).arg(waitedMs).arg(attachMs).arg(applyMs).arg(rewritten));
+        m_firstApply = false;
+    } else {
+        log(QString("Profile applied again in %1 ms (%2 writes)").arg(applyMs).arg(rewritten));
+    }
+
+    if (!m_profile.resident()) {
+        finish(Success);
+        return;
+    }
+    if (m_profile.freezeIntervalMs() != 0) {
+        m_freezeTimer->start(static_cast<int>(std::min<uint32_t>(m_profile.freezeIntervalMs(), INT_MAX)));
+    }
+}
+
+void HeadlessRunner::onProcessExited()
+{
+    stopWatchingForExit();
+    m_freezeTimer->stop();
+    m_memoryEditor->detach();
+    if (!m_profile.resident()) return;
+
+    // The next instance starts from unpatched code
+    for (auto* patch : m_patches) {
+        patch->enabled = false;
+    }
+    log("ffxv_s.exe exited, waiting for it to start again...");
+    m_waitTimer.start();
+    m_pollTimer->start();
+}
+
+void HeadlessRunner::onFreezeTick()
+{
+    if (!m_memoryEditor->isAttached()) return;  // The exit notification follows
+
+    size_t rewritten = 0;
+    if (m_memoryEditor->applyProfile(m_patches, m_mask, rewritten) && rewritten != 0) {
+        log(QString("Freeze: wrote back %1 sites").arg(rewritten));
+    }
+}
+
+/**
+ * @brief Waits on a handle of the game's own, so exit is an event and not a poll
+ *
+ * Without one (OpenProcess denied SYNCHRONIZE), a resident runner does not
+ * notice the game restarting; everything else still works.
+ */
+void HeadlessRunner::watchForExit()
+{
+    stopWatchingForExit();
+    m_exitHandle = OpenProcess(SYNCHRONIZE, FALSE, m_memoryEditor->getProcessId());
+    if (!m_exitHandle) {
+        log(QString("[ERROR] Cannot wait for ffxv_s.exe to exit (error %1)").arg(GetLastError()));
+        return;
+    }
+    m_exitNotifier = new QWinEventNotifier(m_exitHandle, this);
+    connect(m_exitNotifier, &QWinEventNotifier::activated, this, &HeadlessRunner::onProcessExited);
+}
+
+void HeadlessRunner::stopWatchingForExit()
+{
+    delete m_exitNotifier;
+    m_exitNotifier = nullptr;
+    if (m_exitHandle) {
+        CloseHandle(m_exitHandle);
+        m_exitHandle = nullptr;
+    }
+}
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+/// Queued, so a failure in start() still ends the event loop main() enters next
+void HeadlessRunner::finish(int exitCode)
+{
+    m_pollTimer->stop();
+    m_freezeTimer->stop();
+    QMetaObject::invokeMethod(this, [this, exitCode] { emit finished(exitCode); }, Qt::QueuedConnection);
+}
+
+void HeadlessRunner::log(const QString& message)
+{
+    QString timestamp = QDateTime::currentDateTime().toString("hh:mm:ss");
+    std::fprintf(stdout, "[%s] %s\n", timestamp.toUtf8().constData(), message.toUtf8().constData());
+    std::fflush(stdout);
+}
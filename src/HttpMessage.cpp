@@ -0,0 +1,150 @@
+/**
+ * @file HttpMessage.cpp
+ * @brief HTTP/1.1 request parsing and response formatting without Qt
+ */
+
+#include "HttpMessage.h"
+
+namespace {
+
+std::string_view trim(std::string_view text)
+{
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r')) text.remove_suffix(1);
+    return text;
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char x = a[i] >= 'A' && a[i] <= 'Z' ? char(a[i] + 32) : a[i];
+        char y = b[i] >= 'A' && b[i] <= 'Z' ? char(b[i] + 32) : b[i];
+        if (x != y) return false;
+    }
+    return true;
+}
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+namespace Http {
+
+std::string Request::header(std::string_view name) const
+{
+    for (const auto& [key, value] : headers) {
+        if (equalsIgnoreCase(key, name)) return value;
+    }
+    return {};
+}
+
+bool parseRequest(std::string_view raw, Request& request)
+{
+    request = Request();
+
+    // "GET /path?query HTTP/1.1"
+    size_t lineEnd = raw.find("\r\n");
+    std::string_view line = raw.substr(0, lineEnd);
+    size_t methodEnd = line.find(' ');
+    if (methodEnd == std::string_view::npos || methodEnd == 0) {
+        return false;
+    }
+    size_t targetEnd = line.find(' ', methodEnd + 1);
+    std::string_view target = line.substr(methodEnd + 1, targetEnd == std::string_view::npos
+                                                             ? std::string_view::npos
+                                                             : targetEnd - methodEnd - 1);
+    if (target.empty()) {
+        return false;
+    }
+
+    request.method = line.substr(0, methodEnd);
+    size_t queryStart = target.find('?');
+    request.path = target.substr(0, queryStart);
+    if (queryStart != std::string_view::npos) {
+        request.query = target.substr(queryStart + 1);
+    }
+
+    // Headers up to the empty line; lines without a colon are skipped
+    while (lineEnd != std::string_view::npos) {
+        size_t start = lineEnd + 2;
+        lineEnd = raw.find("\r\n", start);
+        line = raw.substr(start, lineEnd == std::string_view::npos ? std::string_view::npos : lineEnd - start);
+        if (line.empty()) break;
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) continue;
+        request.headers.emplace_back(trim(line.substr(0, colon)), trim(line.substr(colon + 1)));
+    }
+    return true;
+}
+
+std::map<std::string, std::string> parseQuery(std::string_view query)
+{
+    std::map<std::string, std::string> params;
+    while (!query.empty()) {
+        size_t end = query.find('&');
+        std::string_view pair = query.substr(0, end);
+        query = end == std::string_view::npos ? std::string_view() : query.substr(end + 1);
+        if (pair.empty()) continue;
+
+        size_t equals = pair.find('=');
+        if (equals == std::string_view::npos) {
+            params[urlDecode(pair)] = "";
+        } else {
+            params[urlDecode(pair.substr(0, equals))] = urlDecode(pair.substr(equals + 1));
+        }
+    }
+    return params;
+}
+
+std::string urlDecode(std::string_view text)
+{
+    std::string decoded;
+    decoded.reserve(text.size());
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+            decoded += static_cast<char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+            i += 2;
+        } else {
+            decoded += text[i];
+        }
+    }
+    return decoded;
+}
+
+std::string formatResponse(int status, std::string_view statusText, std::string_view body,
+                           std::string_view contentType)
+{
+    std::string response;
+    response.reserve(128 + body.size());
+    response += "HTTP/1.1 ";
+    response += std::to_string(status);
+    response += ' ';
+    response += statusText;
+    response += "\r\nContent-Type: ";
+    response += contentType;
+    response += "\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\nConnection: close\r\n\r\n";
+    response += body;
+    return response;
+}
+
+const std::string* ResponseCache::find(const std::string& key) const
+{
+    auto it = m_responses.find(key);
+    return it == m_responses.end() ? nullptr : &it->second;
+}
+
+const std::string& ResponseCache::store(const std::string& key, std::string response)
+{
+    return m_responses[key] = std::move(response);
+}
+
+} // namespace Http
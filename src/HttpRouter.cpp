@@ -0,0 +1,45 @@
+/**
+ * @file HttpRouter.cpp
+ * @brief Method and path dispatch for the local HTTP server
+ */
+
+#include "HttpRouter.h"
+
+namespace Http {
+
+std::string redirectResponse(std::string_view location)
+{
+    std::string response = "HTTP/1.1 302 Found\r\nLocation: ";
+    response += location;
+    response += "\r\nConnection: close\r\n\r\n";
+    return response;
+}
+
+void Router::add(const std::string& method, const std::string& path, Handler handler)
+{
+    m_routes[{method, path}] = std::move(handler);
+}
+
+void Router::remove(const std::string& method, const std::string& path)
+{
+    m_routes.erase({method, path});
+}
+
+bool Router::contains(const std::string& method, const std::string& path) const
+{
+    return m_routes.count({method, path}) != 0;
+}
+
+std::string Router::route(const Request& request) const
+{
+    auto it = m_routes.find(std::make_pair(request.method, request.path));
+    if (it != m_routes.end()) {
+        return it->second(request);
+    }
+    if (m_fallback) {
+        return m_fallback(request);
+    }
+    return formatResponse(404, "Not Found", "Not found", "text/plain");
+}
+
+} // namespace Http
@@ -7,14 +7,17 @@
  * 2. Providing a fake goods/entitlement API response
  * 3. Serving cached blog/promotional pages from embedded resources
  *
- * The game's Twitch URLs are patched to point to localhost:443, and this
- * server responds with the appropriate content to simulate a successful
- * Twitch Prime linkage.
+ * The game's Twitch URLs are patched to point to localhost on the redirect
+ * port (Patches::activeRedirectPort, set from the UI or a profile), and this
+ * server, started on that same port, responds with the appropriate content
+ * to simulate a successful Twitch Prime linkage.
  *
  * All static files are served from Qt embedded resources (:/wwwroot).
  */
 
 #include "HttpServer.h"
+#include "Trace.h"
+#include <map>
 #include <QFile>
 #include <QFileInfo>
 #include <QDateTime>
@@ -43,6 +46,15 @@ namespace {
         {"ttf",  "font/ttf"},
         {"eot",  "application/vnd.ms-fontobject"}
     };
+
+    const std::string GOODS_PATH = "/kraken/commerce/user/goods";
+
+    std::string textResponse(int statusCode, const char* statusText, const QByteArray& body,
+                             const QString& contentType = "text/html")
+    {
+        return Http::formatResponse(statusCode, statusText, std::string_view(body.constData(), body.size()),
+                                    contentType.toStdString());
+    }
 }
 
 // ============================================================================
@@ -57,6 +69,7 @@ HttpServer::HttpServer(QObject* parent)
 
     // Serve from Qt embedded resources
     m_webRoot = ":/wwwroot";
+    addRoutes();
 }
 
 HttpServer::~HttpServer()
@@ -113,6 +126,16 @@ QString HttpServer::webRoot() const
     return m_webRoot;
 }
 
+void HttpServer::setMetricsProvider(std::function<QByteArray()> provider)
+{
+    m_metricsProvider = std::move(provider);
+    if (m_metricsProvider) {
+        m_router.add("GET", "/metrics", [this](const Http::Request&) { return handleMetrics(); });
+    } else {
+        m_router.remove("GET", "/metrics");
+    }
+}
+
 // ============================================================================
 // Connection Handling
 // ============================================================================
@@ -149,52 +172,40 @@ void HttpServer::onDisconnected()
 
 void HttpServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
 {
-    QString requestStr = QString::fromUtf8(request);
-    QStringList lines = requestStr.split("\r\n");
+    Trace::Span span("HTTP request", "http");
 
-    if (lines.isEmpty()) {
-        sendResponse(socket, 400, "Bad Request", "Invalid request");
+    Http::Request parsed;
+    if (!Http::parseRequest(std::string_view(request.constData(), static_cast<size_t>(request.size())), parsed)) {
+        writeResponse(socket, textResponse(400, "Bad Request", "Invalid request line"));
         return;
     }
 
-    // Parse: "GET /path HTTP/1.1"
-    QStringList requestLine = lines[0].split(' ');
-    if (requestLine.size() < 2) {
-        sendResponse(socket, 400, "Bad Request", "Invalid request line");
-        return;
+    if (span.active()) {
+        span.setDetail(parsed.method + ' ' + parsed.path);
     }
+    emit requestReceived(QString::fromStdString(parsed.method), QString::fromStdString(parsed.path));
 
-    QString method = requestLine[0];
-    QString fullPath = requestLine[1];
-
-    // Separate path and query string
-    QString path = fullPath;
-    QString queryString;
-    int queryIndex = fullPath.indexOf('?');
-    if (queryIndex != -1) {
-        path = fullPath.left(queryIndex);
-        queryString = fullPath.mid(queryIndex + 1);
-    }
+    writeResponse(socket, m_router.route(parsed));
+}
 
-    QMap<QString, QString> headers = parseHeaders(lines.mid(1));
-    emit requestReceived(method, path);
+void HttpServer::addRoutes()
+{
+    m_router.add("GET", "/kraken/oauth2/authorize",
+                 [this](const Http::Request& request) { return handleOAuth2Authorize(request); });
+    m_router.add("GET", "/login", [this](const Http::Request&) { return handleLogin(); });
+    m_router.add("GET", "/twitch-prime-members-get-your-own-kooky-chocobo-more-in-final-fantasy-xv-windows-edition-87d04c6ae217",
+                 [this](const Http::Request&) { return handleBlog(); });
+    m_router.add("POST", GOODS_PATH, [this](const Http::Request&) { return handleGoodsRequest(); });
+    m_router.setFallback([this](const Http::Request& request) {
+        return handleStaticFile(QString::fromStdString(request.path));
+    });
+}
 
-    // Route to appropriate handler
-    if (path == "/kraken/oauth2/authorize" && method == "GET") {
-        handleOAuth2Authorize(socket, parseQueryString(queryString), headers);
-    }
-    else if (path == "/login" && method == "GET") {
-        handleLogin(socket);
-    }
-    else if (path == "/twitch-prime-members-get-your-own-kooky-chocobo-more-in-final-fantasy-xv-windows-edition-87d04c6ae217" && method == "GET") {
-        handleBlog(socket);
-    }
-    else if (path == "/kraken/commerce/user/goods" && method == "POST") {
-        handleGoodsRequest(socket);
-    }
-    else {
-        handleStaticFile(socket, path);
-    }
+void HttpServer::writeResponse(QTcpSocket* socket, const std::string& response)
+{
+    socket->write(response.data(), static_cast<qint64>(response.size()));
+    socket->flush();
+    socket->disconnectFromHost();
 }
 
 // ============================================================================
@@ -207,21 +218,19 @@ void HttpServer::handleRequest(QTcpSocket* socket, const QByteArray& request)
  * FFXV expects to be redirected to Twitch's OAuth2 flow. We intercept this
  * and redirect to our local login page which will simulate a successful auth.
  */
-void HttpServer::handleOAuth2Authorize(QTcpSocket* socket,
-                                        const QMap<QString, QString>& params,
-                                        const QMap<QString, QString>& headers)
+std::string HttpServer::handleOAuth2Authorize(const Http::Request& request)
 {
-    if (!params.contains("client_id") || !params.contains("response_type")) {
-        sendResponse(socket, 400, "Bad Request", "Missing required parameters");
-        return;
+    std::map<std::string, std::string> params = Http::parseQuery(request.query);
+    if (!params.count("client_id") || !params.count("response_type")) {
+        return textResponse(400, "Bad Request", "Missing required parameters");
     }
 
-    QString clientId = params["client_id"];
+    QString clientId = QString::fromStdString(params["client_id"]);
 
     // Build redirect URL with original params encoded
     QStringList paramList;
-    for (auto it = params.begin(); it != params.end(); ++it) {
-        paramList << it.key() + "=" + it.value();
+    for (const auto& [key, value] : params) {
+        paramList << QString::fromStdString(key) + "=" + QString::fromStdString(value);
     }
     QString redirectParams = QUrl::toPercentEncoding(paramList.join("&"));
 
@@ -231,35 +240,39 @@ void HttpServer::handleOAuth2Authorize(QTcpSocket* socket,
                            .arg(redirectParams);
 
     // curl/API clients get HTML link, browsers get redirect
-    QString userAgent = headers.value("User-Agent", "");
-    QString accept = headers.value("Accept", "");
+    QString userAgent = QString::fromStdString(request.header("User-Agent"));
+    QString accept = QString::fromStdString(request.header("Accept"));
 
     if (userAgent.contains("curl") || accept.contains("application/json")) {
         QString html = QString("<a href=\"%1\">Found</a>").arg(loginUrl.toHtmlEscaped());
-        sendResponse(socket, 200, "OK", html.toUtf8(), "text/html");
-    } else {
-        sendRedirect(socket, loginUrl);
+        return textResponse(200, "OK", html.toUtf8(), "text/html");
     }
+    return Http::redirectResponse(loginUrl.toStdString());
 }
 
-void HttpServer::handleLogin(QTcpSocket* socket)
+std::string HttpServer::handleLogin()
 {
-    sendFile(socket, m_webRoot + "/login.html");
+    return fileResponse(m_webRoot + "/login.html");
 }
 
-void HttpServer::handleBlog(QTcpSocket* socket)
+std::string HttpServer::handleBlog()
 {
-    sendFile(socket, m_webRoot + "/twitch-prime-members-get-your-own-kooky-chocobo-more-in-final-fantasy-xv-windows-edition-87d04c6ae217.html");
+    return fileResponse(m_webRoot + "/twitch-prime-members-get-your-own-kooky-chocobo-more-in-final-fantasy-xv-windows-edition-87d04c6ae217.html");
 }
 
 /**
  * @brief Returns fake Twitch Prime goods/entitlements
  *
  * FFXV queries this endpoint to check which Twitch Prime items the user owns.
- * We return all three SKUs to unlock all Twitch Prime content.
+ * We return all three SKUs to unlock all Twitch Prime content. The response
+ * never changes, so it is serialised once.
  */
-void HttpServer::handleGoodsRequest(QTcpSocket* socket)
+std::string HttpServer::handleGoodsRequest()
 {
+    if (const std::string* cached = m_responseCache.find(GOODS_PATH)) {
+        return *cached;
+    }
+
     QJsonObject response;
     QJsonArray goods;
 
@@ -270,15 +283,25 @@ void HttpServer::handleGoodsRequest(QTcpSocket* socket)
 
     response["goods"] = goods;
 
-    QJsonDocument doc(response);
-    sendResponse(socket, 200, "OK", doc.toJson(QJsonDocument::Compact), "application/json");
+    QByteArray body = QJsonDocument(response).toJson(QJsonDocument::Compact);
+    return m_responseCache.store(GOODS_PATH, textResponse(200, "OK", body, "application/json"));
+}
+
+/**
+ * @brief Scan statistics in Prometheus text format
+ *
+ * Not a game endpoint; only routed when a metrics provider is set.
+ */
+std::string HttpServer::handleMetrics()
+{
+    return textResponse(200, "OK", m_metricsProvider(), "text/plain; version=0.0.4");
 }
 
 // ============================================================================
 // Static File Serving
 // ============================================================================
 
-void HttpServer::handleStaticFile(QTcpSocket* socket, const QString& path)
+std::string HttpServer::handleStaticFile(const QString& path)
 {
     QString filePath = m_webRoot + path;
 
@@ -289,68 +312,40 @@ void HttpServer::handleStaticFile(QTcpSocket* socket, const QString& path)
 
     // Prevent directory traversal attacks
     if (path.contains("..")) {
-        sendResponse(socket, 403, "Forbidden", "Access denied");
-        return;
+        return textResponse(403, "Forbidden", "Access denied");
     }
 
-    sendFile(socket, filePath);
+    return fileResponse(filePath);
 }
 
-void HttpServer::sendFile(QTcpSocket* socket, const QString& filePath)
+/**
+ * @brief A file as a response; embedded resources are read and serialised once
+ */
+std::string HttpServer::fileResponse(const QString& filePath)
 {
+    bool embedded = filePath.startsWith(":/");
+    std::string key = filePath.toStdString();
+    if (embedded) {
+        if (const std::string* cached = m_responseCache.find(key)) {
+            return *cached;
+        }
+    }
+
     QFile file(filePath);
 
     if (!file.exists()) {
-        sendResponse(socket, 404, "Not Found", "File not found: " + filePath.toUtf8());
-        return;
+        return textResponse(404, "Not Found", "File not found: " + filePath.toUtf8());
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
-        sendResponse(socket, 500, "Internal Server Error", "Cannot read file");
-        return;
+        return textResponse(500, "Internal Server Error", "Cannot read file");
     }
 
     QByteArray content = file.readAll();
     file.close();
 
-    QString mimeType = getMimeType(filePath);
-    sendResponse(socket, 200, "OK", content, mimeType);
-}
-
-// ============================================================================
-// Response Helpers
-// ============================================================================
-
-void HttpServer::sendResponse(QTcpSocket* socket, int statusCode, const QString& statusText,
-                               const QByteArray& body, const QString& contentType)
-{
-    QString response = QString("HTTP/1.1 %1 %2\r\n"
-                               "Content-Type: %3\r\n"
-                               "Content-Length: %4\r\n"
-                               "Connection: close\r\n"
-                               "\r\n")
-                           .arg(statusCode)
-                           .arg(statusText)
-                           .arg(contentType)
-                           .arg(body.size());
-
-    socket->write(response.toUtf8());
-    socket->write(body);
-    socket->flush();
-    socket->disconnectFromHost();
-}
-
-void HttpServer::sendRedirect(QTcpSocket* socket, const QString& location)
-{
-    QString response = QString("HTTP/1.1 302 Found\r\n"
-                               "Location: %1\r\n"
-                               "Connection: close\r\n"
-                               "\r\n")
-                           .arg(location);
-
-    socket->write(response.toUtf8());
-    socket->flush();
-    socket->disconnectFromHost();
+    std::string response = textResponse(200, "OK", content, getMimeType(filePath));
+    return embedded ? m_responseCache.store(key, std::move(response)) : response;
 }
 
 // ============================================================================
@@ -363,45 +358,3 @@ QString HttpServer::getMimeType(const QString& filePath)
     QString ext = fileInfo.suffix().toLower();
     return MIME_TYPES.value(ext, "application/octet-stream");
 }
-
-QMap<QString, QString> HttpServer::parseQueryString(const QString& query)
-{
-    QMap<QString, QString> params;
-
-    QStringList pairs = query.split('&', Qt::SkipEmptyParts);
-    for (const QString& pair : pairs) {
-        int eqIndex = pair.indexOf('=');
-        if (eqIndex != -1) {
-            QString key = urlDecode(pair.left(eqIndex));
-            QString value = urlDecode(pair.mid(eqIndex + 1));
-            params[key] = value;
-        } else {
-            params[urlDecode(pair)] = "";
-        }
-    }
-
-    return params;
-}
-
-QMap<QString, QString> HttpServer::parseHeaders(const QStringList& headerLines)
-{
-    QMap<QString, QString> headers;
-
-    for (const QString& line : headerLines) {
-        if (line.isEmpty()) break;  // Empty line marks end of headers
-
-        int colonIndex = line.indexOf(':');
-        if (colonIndex != -1) {
-            QString key = line.left(colonIndex).trimmed();
-            QString value = line.mid(colonIndex + 1).trimmed();
-            headers[key] = value;
-        }
-    }
-
-    return headers;
-}
-
-QString HttpServer::urlDecode(const QString& input)
-{
-    return QUrl::fromPercentEncoding(input.toUtf8());
-}
@@ -0,0 +1,159 @@
+/**
+ * @file JumpTable.cpp
+ * @brief The Phase 6 dispatch table: reading, retargeting and rolling back
+ */
+
+#include "JumpTable.h"
+#include "Patches.h"
+
+#include <algorithm>
+
+void JumpTable::reset(uintptr_t tableBase, uintptr_t moduleBase)
+{
+    m_base = tableBase;
+    m_moduleBase = moduleBase;
+    m_original.clear();
+    m_written.clear();
+    m_journal.clear();
+}
+
+std::vector<JumpTable::Entry> JumpTable::read(const MemoryBackend& backend) const
+{
+    std::vector<Entry> entries;
+    std::vector<uint32_t> offsets;
+    if (!readOffsets(backend, offsets)) return entries;
+
+    entries.reserve(offsets.size());
+    for (size_t i = 0; i < offsets.size(); ++i) {
+        Entry entry;
+        entry.itemId = static_cast<uint8_t>(Patches::JUMP_TABLE_FIRST_ITEM + i);
+        entry.address = m_base + i * sizeof(uint32_t);
+        entry.offset = offsets[i];
+        entry.target = m_moduleBase + offsets[i];
+        entry.originalOffset = m_original.empty() ? offsets[i] : m_original[i];
+        entries.push_back(entry);
+    }
+    return entries;
+}
+
+bool JumpTable::retarget(MemoryBackend& backend, const std::vector<Retarget>& changes, size_t& changed)
+{
+    changed = 0;
+    std::vector<uint32_t> current;
+    if (!readOffsets(backend, current)) {
+        m_lastError = "Failed to read jump table";
+        return false;
+    }
+    if (!m_written.empty() && current != m_written) {
+        m_lastError = "Jump table was modified outside this tool";
+        return false;
+    }
+    const std::vector<uint32_t>& original = m_original.empty() ? current : m_original;
+
+    std::vector<uint32_t> desired = current;
+    for (const auto& change : changes) {
+        size_t index = change.itemId - Patches::JUMP_TABLE_FIRST_ITEM;
+        if (change.itemId < Patches::JUMP_TABLE_FIRST_ITEM || index >= Patches::JUMP_TABLE_ENTRIES) {
+            m_lastError = "Item has no jump table entry: " + std::to_string(change.itemId);
+            return false;
+        }
+        uintptr_t offset = change.target - m_moduleBase;
+        if (change.target < m_moduleBase ||
+            std::find(original.begin(), original.end(), offset) == original.end()) {
+            m_lastError = "Jump target is not an existing item handler";
+            return false;
+        }
+        desired[index] = static_cast<uint32_t>(offset);
+    }
+
+    std::vector<Change> transaction;
+    for (size_t i = 0; i < desired.size(); ++i) {
+        if (desired[i] != current[i]) transaction.push_back({i, current[i], desired[i]});
+    }
+    if (transaction.empty()) return true;
+
+    if (!writeOffsets(backend, desired, transaction.front().index, transaction.back().index)) {
+        m_lastError = "Failed to write jump table";
+        return false;
+    }
+
+    if (m_original.empty()) m_original = current;
+    m_written = desired;
+    changed = transaction.size();
+    m_journal.push_back(std::move(transaction));
+    return true;
+}
+
+bool JumpTable::rollback(MemoryBackend& backend, size_t& changed)
+{
+    changed = 0;
+    if (m_journal.empty()) {
+        m_lastError = "No jump table changes to roll back";
+        return false;
+    }
+
+    std::vector<uint32_t> current;
+    if (!readOffsets(backend, current) || current != m_written) {
+        m_lastError = "Jump table was modified outside this tool";
+        return false;
+    }
+
+    const std::vector<Change>& transaction = m_journal.back();
+    std::vector<uint32_t> desired = current;
+    for (const auto& change : transaction) {
+        desired[change.index] = change.before;
+    }
+    if (!writeOffsets(backend, desired, transaction.front().index, transaction.back().index)) {
+        m_lastError = "Failed to write jump table";
+        return false;
+    }
+
+    changed = transaction.size();
+    m_journal.pop_back();
+    m_written = desired;
+    return true;
+}
+
+bool JumpTable::restore(MemoryBackend& backend, size_t& changed)
+{
+    changed = 0;
+    if (m_journal.empty()) return true;
+
+    // Entries this tool never changed are left alone, so the write only
+    // spans the ones it did
+    size_t first = m_original.size();
+    size_t last = 0;
+    for (size_t i = 0; i < m_original.size(); ++i) {
+        if (m_original[i] != m_written[i]) {
+            first = std::min(first, i);
+            last = i;
+            ++changed;
+        }
+    }
+    if (first <= last && !writeOffsets(backend, m_original, first, last)) {
+        m_lastError = "Failed to restore jump table";
+        changed = 0;
+        return false;
+    }
+
+    m_written = m_original;
+    m_journal.clear();
+    return true;
+}
+
+bool JumpTable::readOffsets(const MemoryBackend& backend, std::vector<uint32_t>& offsets) const
+{
+    if (m_base == 0) return false;
+
+    constexpr size_t TABLE_BYTES = Patches::JUMP_TABLE_ENTRIES * sizeof(uint32_t);
+    offsets.resize(Patches::JUMP_TABLE_ENTRIES);
+    return backend.read(m_base, offsets.data(), TABLE_BYTES) == TABLE_BYTES;
+}
+
+/// Writes entries first..last (inclusive) of offsets in a single protected write
+bool JumpTable::writeOffsets(MemoryBackend& backend, const std::vector<uint32_t>& offsets, size_t first, size_t last)
+{
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(offsets.data());
+    return backend.writeProtected(m_base + first * sizeof(uint32_t),
+                                  ByteView(bytes + first * sizeof(uint32_t), (last - first + 1) * sizeof(uint32_t)));
+}
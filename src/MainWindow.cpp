@@ -19,6 +19,7 @@
  */
 
 #include "MainWindow.h"
+#include "Trace.h"
 #include <QApplication>
 #include <QStyle>
 #include <QDateTime>
@@ -26,6 +27,21 @@
 #include <QCloseEvent>
 #include <QIcon>
 #include <QScrollArea>
+#include <QFileInfo>
+#include <QFileDialog>
+#include <QInputDialog>
+#include <QSaveFile>
+#include <QtAlgorithms>
+
+namespace {
+
+/// Registry names and descriptions are UTF-8 views into its string pool
+QString toQString(std::string_view text)
+{
+    return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+}
+
+} // namespace
 
 // ============================================================================
 // Construction / Destruction
@@ -35,8 +51,20 @@ MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , m_memoryEditor(new MemoryEditor(this))
     , m_httpServer(new HttpServer(this))
+    , m_slotProber(new SlotProber(m_memoryEditor, this))
     , m_processCheckTimer(new QTimer(this))
 {
+    Trace::setThreadName("main");
+
+    // Database overrides must be applied before the UI reads item names
+    QString signatureStatus = loadSignatureDatabase();
+    m_memoryEditor->setSignatureDatabase(&m_signatureDatabase);
+
+    QString indexDirectory = QCoreApplication::applicationDirPath() + "/" + PATTERN_INDEX_DIRECTORY;
+    if (QFileInfo(indexDirectory).isDir()) {
+        m_memoryEditor->setPatternIndexDirectory(indexDirectory.toUtf8().toStdString());
+    }
+
     setupUI();
     setupConnections();
     setupSystemTray();
@@ -47,9 +75,29 @@ MainWindow::MainWindow(QWidget* parent)
 
     updateStatus();
     log("FFXV Unlocker initialized");
+    log(signatureStatus);
+}
+
+MainWindow::~MainWindow()
+{
+    // Children are destroyed in creation order, so the editor would detach
+    // before the prober could put its slot back
+    stopProbeForExit();
 }
 
-MainWindow::~MainWindow() = default;
+/**
+ * @brief Loads signatures.fxsd from the application directory, if present
+ *
+ * See SignatureDatabase::loadOverrides() for when the built-in definitions
+ * in Patches.h stay in effect.
+ *
+ * @return Status line for the log
+ */
+QString MainWindow::loadSignatureDatabase()
+{
+    QString path = QCoreApplication::applicationDirPath() + "/" + SignatureDatabase::DEFAULT_FILE;
+    return QString::fromStdString(m_signatureDatabase.loadOverrides(path.toUtf8().toStdString()));
+}
 
 // ============================================================================
 // UI Setup
@@ -82,8 +130,18 @@ void MainWindow::setupUI()
     m_attachButton = new QPushButton("Attach", this);
     m_detachButton = new QPushButton("Detach", this);
     m_detachButton->setEnabled(false);
+    m_probeButton = new QPushButton("Probe Slots...", this);
+    m_probeButton->setToolTip("Sets each unmapped unlock table slot in turn,\n"
+                              "records what changes in watched memory, and restores it.");
+    m_probeButton->setEnabled(false);
     buttonLayout->addWidget(m_attachButton);
     buttonLayout->addWidget(m_detachButton);
+    m_traceButton = new QPushButton("Record Trace", this);
+    m_traceButton->setToolTip("Records attach, scan, write and HTTP request spans\n"
+                              "until clicked again, then saves them as a Chrome trace\n"
+                              "for ui.perfetto.dev or chrome://tracing.");
+    buttonLayout->addWidget(m_probeButton);
+    buttonLayout->addWidget(m_traceButton);
     buttonLayout->addStretch();
 
     statusLeftLayout->addWidget(m_processStatusLabel);
@@ -99,11 +157,20 @@ void MainWindow::setupUI()
     urlLayout->setSpacing(2);
     urlLayout->setContentsMargins(6, 6, 6, 6);
 
-    m_serverCheck = new QCheckBox("Enable HTTP Server (port 443)", urlGroup);
+    m_serverCheck = new QCheckBox("Enable HTTP Server on port", urlGroup);
+    m_portSpin = new QSpinBox(urlGroup);
+    m_portSpin->setRange(1, 65535);
+    m_portSpin->setValue(Patches::activeRedirectPort);
+    m_portSpin->setToolTip("The localhost URL has to fit in the original Twitch URLs,\nso ports above 9999 are rejected.");
     m_urlRedirectCheck = new QCheckBox("Redirect Twitch URLs to localhost", urlGroup);
     m_urlRedirectCheck->setEnabled(false);
 
-    urlLayout->addWidget(m_serverCheck);
+    auto* serverLayout = new QHBoxLayout();
+    serverLayout->addWidget(m_serverCheck);
+    serverLayout->addWidget(m_portSpin);
+    serverLayout->addStretch();
+
+    urlLayout->addLayout(serverLayout);
     urlLayout->addWidget(m_urlRedirectCheck);
 
     statusMainLayout->addLayout(statusLeftLayout, 1);
@@ -129,7 +196,7 @@ void MainWindow::setupUI()
     std::vector<QCheckBox*> normallyUnavailableChecks;
     scrollLayout->addWidget(createUnlockCategoryGroup(
         "Normally Unavailable",
-        Patches::getNormallyUnavailableItems(),
+        Patches::UnlockCategory::NormallyUnavailable,
         m_normallyUnavailableAllCheck,
         normallyUnavailableChecks));
 
@@ -137,7 +204,7 @@ void MainWindow::setupUI()
     std::vector<QCheckBox*> originChecks;
     scrollLayout->addWidget(createUnlockCategoryGroup(
         "Origin Exclusives",
-        Patches::getOriginItems(),
+        Patches::UnlockCategory::Origin,
         m_originAllCheck,
         originChecks));
 
@@ -145,7 +212,7 @@ void MainWindow::setupUI()
     std::vector<QCheckBox*> msStoreChecks;
     scrollLayout->addWidget(createUnlockCategoryGroup(
         "Microsoft (UWP) Store Exclusive",
-        Patches::getMicrosoftStoreItems(),
+        Patches::UnlockCategory::MicrosoftStore,
         m_msStoreAllCheck,
         msStoreChecks));
 
@@ -182,10 +249,12 @@ void MainWindow::setupUI()
     twitchIndentLayout->setContentsMargins(20, 0, 0, 0);
     twitchIndentLayout->setSpacing(1);
 
-    for (auto* bundle : Patches::getTwitchPrimeBundles()) {
-        auto* check = new QCheckBox(QString::fromStdString(bundle->name), twitchIndent);
+    const UnlockRegistry& registry = m_memoryEditor->getUnlockRegistry();
+    for (size_t i = 0; i < registry.bundleCount(); ++i) {
+        Patches::UnlockBundle* bundle = registry.bundleDefinition(i);
+        auto* check = new QCheckBox(toQString(registry.bundleName(i)), twitchIndent);
         check->setEnabled(false);
-        check->setToolTip(QString::fromStdString(bundle->description));
+        check->setToolTip(toQString(registry.bundleDescription(i)));
         check->setProperty("unlockBundle", QVariant::fromValue(reinterpret_cast<quintptr>(bundle)));
         twitchIndentLayout->addWidget(check);
         m_bundleCheckboxes[bundle] = check;
@@ -203,7 +272,7 @@ void MainWindow::setupUI()
     std::vector<QCheckBox*> steamChecks;
     scrollLayout->addWidget(createUnlockCategoryGroup(
         "Steam Exclusives",
-        Patches::getSteamItems(),
+        Patches::UnlockCategory::Steam,
         m_steamAllCheck,
         steamChecks,
         true,   // disableCategoryCheck: cannot individually select
@@ -213,7 +282,7 @@ void MainWindow::setupUI()
     std::vector<QCheckBox*> promotionalChecks;
     scrollLayout->addWidget(createUnlockCategoryGroup(
         "Promotional Items",
-        Patches::getPromotionalItems(),
+        Patches::UnlockCategory::Promotional,
         m_promotionalAllCheck,
         promotionalChecks,
         true,   // disableCategoryCheck
@@ -311,7 +380,7 @@ void MainWindow::setupUI()
 
 QGroupBox* MainWindow::createUnlockCategoryGroup(
     const QString& title,
-    std::vector<Patches::UnlockItem*> items,
+    Patches::UnlockCategory category,
     QCheckBox*& allCheck,
     std::vector<QCheckBox*>& itemChecks,
     bool disableCategoryCheck,
@@ -358,18 +427,23 @@ QGroupBox* MainWindow::createUnlockCategoryGroup(
     indentLayout->setContentsMargins(20, 0, 0, 0);
     indentLayout->setSpacing(1);
 
-    for (auto* item : items) {
-        auto* check = new QCheckBox(QString::fromStdString(item->name), indentWidget);
+    const UnlockRegistry& registry = m_memoryEditor->getUnlockRegistry();
+    UnlockRegistry::Span span = registry.categorySpan(category);
+    for (size_t i = span.first; i < size_t(span.first) + span.count; ++i) {
+        Patches::UnlockItem* item = registry.itemDefinition(i);
+        bool selectable = registry.itemSelectable(i);
+        QString description = toQString(registry.itemDescription(i));
+        auto* check = new QCheckBox(toQString(registry.itemName(i)), indentWidget);
         check->setEnabled(false);
-        check->setToolTip(QString::fromStdString(item->description));
+        check->setToolTip(description);
         check->setProperty("unlockItem", QVariant::fromValue(reinterpret_cast<quintptr>(item)));
         check->setProperty("categoryCheck", QVariant::fromValue(reinterpret_cast<quintptr>(allCheck)));
-        check->setProperty("selectable", item->selectable);
+        check->setProperty("selectable", selectable);
 
-        if (!item->selectable) {
+        if (!selectable) {
             // Anti-tamper protected: visual indication and extended tooltip
             check->setStyleSheet("QCheckBox { color: gray; }");
-            check->setToolTip(QString::fromStdString(item->description) +
+            check->setToolTip(description +
                 "\n\nThis item cannot be individually selected due to FFXV's anti-tamper protection.\n"
                 "Use 'Unlock All Platform Exclusives' option instead.");
         }
@@ -409,11 +483,19 @@ void MainWindow::setupConnections()
     // Process management
     connect(m_attachButton, &QPushButton::clicked, this, &MainWindow::onAttachClicked);
     connect(m_detachButton, &QPushButton::clicked, this, &MainWindow::onDetachClicked);
+    connect(m_probeButton, &QPushButton::clicked, this, &MainWindow::onProbeClicked);
+    connect(m_traceButton, &QPushButton::clicked, this, &MainWindow::onTraceClicked);
     connect(m_processCheckTimer, &QTimer::timeout, this, &MainWindow::checkForProcess);
 
     // Memory editor signals
     connect(m_memoryEditor, &MemoryEditor::processAttached, this, &MainWindow::onProcessAttached);
     connect(m_memoryEditor, &MemoryEditor::processDetached, this, &MainWindow::onProcessDetached);
+    connect(m_memoryEditor, &MemoryEditor::buildIdentified, this, &MainWindow::onBuildIdentified);
+    connect(m_memoryEditor, &MemoryEditor::unlockTableResolved, this, &MainWindow::onUnlockTableResolved);
+    connect(m_memoryEditor, &MemoryEditor::patternIndexReady, this, &MainWindow::onPatternIndexReady);
+    connect(m_memoryEditor, &MemoryEditor::jumpTableRetargeted, this, &MainWindow::onJumpTableRetargeted);
+    connect(m_memoryEditor, &MemoryEditor::patchCandidatesFound, this, &MainWindow::onPatchCandidatesFound);
+    connect(m_memoryEditor, &MemoryEditor::patternScanned, this, &MainWindow::onPatternScanned);
     connect(m_memoryEditor, &MemoryEditor::patchApplied, this, &MainWindow::onPatchApplied);
     connect(m_memoryEditor, &MemoryEditor::patchRemoved, this, &MainWindow::onPatchRemoved);
     connect(m_memoryEditor, &MemoryEditor::unlockEnabled, this, &MainWindow::onUnlockEnabled);
@@ -427,10 +509,20 @@ void MainWindow::setupConnections()
     connect(m_httpServer, &HttpServer::serverStopped, this, &MainWindow::onServerStopped);
     connect(m_httpServer, &HttpServer::requestReceived, this, &MainWindow::onRequestReceived);
     connect(m_httpServer, &HttpServer::errorOccurred, this, &MainWindow::onError);
+    m_httpServer->setMetricsProvider([this] {
+        return QByteArray::fromStdString(ScanStats::formatMetrics(m_memoryEditor->getScanStats()));
+    });
+
+    // Slot prober signals
+    connect(m_slotProber, &SlotProber::slotProbed, this, &MainWindow::onSlotProbed);
+    connect(m_slotProber, &SlotProber::finished, this, &MainWindow::onProbeFinished);
+    connect(m_slotProber, &SlotProber::errorOccurred, this, &MainWindow::onError);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &MainWindow::stopProbeForExit);
 
     // URL redirect toggles
     connect(m_serverCheck, &QCheckBox::toggled, this, &MainWindow::onServerToggled);
     connect(m_urlRedirectCheck, &QCheckBox::toggled, this, &MainWindow::onURLRedirectToggled);
+    connect(m_portSpin, &QSpinBox::editingFinished, this, &MainWindow::onRedirectPortChanged);
 
     // Master unlock all
     connect(m_unlockAllCheck, &QCheckBox::toggled, this, &MainWindow::onUnlockAllToggled);
@@ -500,12 +592,11 @@ void MainWindow::onDetachClicked()
 
     m_autoAttach = false;  // Disable auto-attach until Attach is clicked again
 
-    // Clean up: disable all active unlocks and patches before detaching
-    auto allItems = Patches::getAllUnlockItems();
-    m_memoryEditor->disableAllUnlocks(allItems);
-
-    auto bundles = Patches::getTwitchPrimeBundles();
-    m_memoryEditor->disableAllBundles(bundles);
+    // Clean up: put back any probed slot, then disable all active unlocks
+    // and patches before detaching
+    m_slotProber->cancel();
+    m_memoryEditor->restoreJumpTable();
+    m_memoryEditor->applyUnlockMask(0);
 
     auto urlPatches = Patches::getURLPatches();
     m_memoryEditor->removeAllPatches(urlPatches);
@@ -515,6 +606,83 @@ void MainWindow::onDetachClicked()
     m_memoryEditor->detach();
 }
 
+/**
+ * @brief Starts or cancels a sweep over the unmapped unlock table slots
+ *
+ * Watches are entered as "name@rva+size" (RVA relative to ffxv_s.exe). The
+ * report is offered for saving when the sweep ends.
+ */
+void MainWindow::onProbeClicked()
+{
+    if (m_slotProber->isRunning()) {
+        m_slotProber->cancel();
+        return;
+    }
+
+    bool accepted = false;
+    QString spec = QInputDialog::getText(this, "Probe Unused Slots",
+        "Memory to watch while each slot is set, as name@rva+size\n"
+        "separated by ';' (RVA relative to the game module).\n"
+        "Leave empty to only record whether the game resets the slot.",
+        QLineEdit::Normal, m_probeWatchSpec, &accepted);
+    if (!accepted) return;
+
+    SlotProber::Config config;
+    std::string error;
+    if (!SlotProber::parseWatches(spec.toStdString(), config.watches, error)) {
+        log(QString("[ERROR] %1").arg(QString::fromStdString(error)));
+        return;
+    }
+    m_probeWatchSpec = spec;
+
+    config.candidates = SlotProber::unmappedSlots(m_memoryEditor->getUnlockRegistry());
+    if (m_slotProber->start(config)) {
+        log(QString("Probing %1 unmapped slots (%2 ms each)")
+            .arg(qPopulationCount(m_slotProber->config().candidates)).arg(config.settleMs));
+        m_probeButton->setText("Cancel Probe");
+    }
+}
+
+/// Puts back the slot being probed while the editor is still attached; no report dialog on the way out
+void MainWindow::stopProbeForExit()
+{
+    disconnect(m_slotProber, &SlotProber::finished, this, &MainWindow::onProbeFinished);
+    m_slotProber->cancel();
+}
+
+/**
+ * @brief Starts tracing, or stops it and saves the trace
+ */
+void MainWindow::onTraceClicked()
+{
+    if (!Trace::isEnabled()) {
+        Trace::setEnabled(true);
+        m_traceButton->setText("Save Trace...");
+        log("Tracing started");
+        return;
+    }
+
+    Trace::setEnabled(false);
+    m_traceButton->setText("Record Trace");
+    size_t dropped = Trace::droppedEvents();
+    if (dropped > 0) {
+        log(QString("Trace buffers were full; %1 spans dropped").arg(dropped));
+    }
+
+    QString path = QFileDialog::getSaveFileName(this, "Save Trace",
+        "ffxv_trace.json", "Chrome trace (*.json)");
+    if (path.isEmpty()) return;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QByteArray::fromStdString(Trace::toChromeJson())) < 0 ||
+        !file.commit()) {
+        log(QString("[ERROR] Failed to save trace: %1").arg(file.errorString()));
+        return;
+    }
+    log(QString("Trace saved to %1").arg(path));
+}
+
 void MainWindow::checkForProcess()
 {
     bool wasAttached = m_memoryEditor->isAttached();
@@ -535,7 +703,7 @@ void MainWindow::checkForProcess()
 void MainWindow::onServerToggled(bool checked)
 {
     if (checked) {
-        if (m_httpServer->start(443)) {
+        if (m_httpServer->start(Patches::activeRedirectPort)) {
             m_urlRedirectCheck->setEnabled(m_memoryEditor->isAttached());
         } else {
             m_serverCheck->setChecked(false);
@@ -559,6 +727,32 @@ void MainWindow::onURLRedirectToggled(bool checked)
     }
 }
 
+void MainWindow::onRedirectPortChanged()
+{
+    quint16 port = static_cast<quint16>(m_portSpin->value());
+    if (port == Patches::activeRedirectPort) return;
+
+    // Regenerates the URL patch bytes in place; fails without changing anything
+    if (!Patches::setRedirectPort(port)) {
+        log(QString("[ERROR] Port %1 does not fit in the game's Twitch URLs").arg(port));
+        m_portSpin->setValue(Patches::activeRedirectPort);
+        return;
+    }
+    log(QString("Redirect port set to %1").arg(port));
+
+    if (m_httpServer->isRunning() && !m_httpServer->start(port)) {
+        // Unchecking stops the server and removes the URL patches
+        m_serverCheck->setChecked(false);
+        return;
+    }
+
+    // Already-applied URL patches get the new port in one batched write
+    if (m_urlRedirectCheck->isChecked() && m_memoryEditor->isAttached()) {
+        auto urlPatches = Patches::getURLPatches();
+        m_memoryEditor->rewriteAppliedPatches(urlPatches);
+    }
+}
+
 // ============================================================================
 // Unlock Control Handlers
 // ============================================================================
@@ -573,16 +767,10 @@ void MainWindow::onUnlockAllToggled(bool checked)
     for (auto* bundleCheck : m_allBundleChecks) bundleCheck->blockSignals(true);
 
     // Only operate on selectable items (non-selectable require Platform Exclusives)
-    auto selectableItems = Patches::getSelectableItems();
-    auto allBundles = Patches::getTwitchPrimeBundles();
-
-    if (checked) {
-        m_memoryEditor->enableAllUnlocks(selectableItems);
-        m_memoryEditor->enableAllBundles(allBundles);
-    } else {
-        m_memoryEditor->disableAllUnlocks(selectableItems);
-        m_memoryEditor->disableAllBundles(allBundles);
-    }
+    const UnlockRegistry& registry = m_memoryEditor->getUnlockRegistry();
+    UnlockMask mask = registry.selectableMask() | registry.allBundlesMask();
+    UnlockMask enabled = m_memoryEditor->getUnlockMask();
+    m_memoryEditor->applyUnlockMask(checked ? (enabled | mask) : (enabled & ~mask));
 
     // Update UI to reflect new state (only enabled checkboxes)
     for (auto* catCheck : m_allCategoryChecks) {
@@ -612,39 +800,32 @@ void MainWindow::onCategoryToggled(bool checked)
     auto* sender = qobject_cast<QCheckBox*>(QObject::sender());
     if (!sender) return;
 
-    // Map sender to category items
-    std::vector<Patches::UnlockItem*> items;
+    // Map sender to category
+    Patches::UnlockCategory category;
     if (sender == m_normallyUnavailableAllCheck) {
-        items = Patches::getNormallyUnavailableItems();
+        category = Patches::UnlockCategory::NormallyUnavailable;
     } else if (sender == m_steamAllCheck) {
-        items = Patches::getSteamItems();
+        category = Patches::UnlockCategory::Steam;
     } else if (sender == m_originAllCheck) {
-        items = Patches::getOriginItems();
+        category = Patches::UnlockCategory::Origin;
     } else if (sender == m_msStoreAllCheck) {
-        items = Patches::getMicrosoftStoreItems();
+        category = Patches::UnlockCategory::MicrosoftStore;
     } else if (sender == m_promotionalAllCheck) {
-        items = Patches::getPromotionalItems();
-    }
-
-    if (items.empty()) return;
-
-    // Filter to selectable items only
-    std::vector<Patches::UnlockItem*> selectableItems;
-    for (auto* item : items) {
-        if (item->selectable) {
-            selectableItems.push_back(item);
-        }
-    }
-
-    // Apply changes to memory
-    if (checked) {
-        m_memoryEditor->enableAllUnlocks(selectableItems);
+        category = Patches::UnlockCategory::Promotional;
     } else {
-        m_memoryEditor->disableAllUnlocks(selectableItems);
+        return;
     }
 
+    // Apply changes to memory (selectable items only)
+    const UnlockRegistry& registry = m_memoryEditor->getUnlockRegistry();
+    UnlockMask mask = registry.categoryMask(category) & registry.selectableMask();
+    UnlockMask enabled = m_memoryEditor->getUnlockMask();
+    m_memoryEditor->applyUnlockMask(checked ? (enabled | mask) : (enabled & ~mask));
+
     // Update individual checkboxes
-    for (auto* item : items) {
+    UnlockRegistry::Span span = registry.categorySpan(category);
+    for (size_t i = span.first; i < size_t(span.first) + span.count; ++i) {
+        Patches::UnlockItem* item = registry.itemDefinition(i);
         auto it = m_unlockCheckboxes.find(item);
         if (it != m_unlockCheckboxes.end() && item->selectable) {
             it->second->blockSignals(true);
@@ -730,7 +911,7 @@ void MainWindow::onBundleToggled(bool checked)
             "These items can also be unlocked using the Twitch URL Redirect feature, "
             "which simulates the original Twitch Prime login flow.\n\n"
             "To use the web-based method:\n"
-            "1. Enable the HTTP Server (port 443)\n"
+            "1. Enable the HTTP Server (port " + QString::number(Patches::activeRedirectPort) + ")\n"
             "2. Enable \"Redirect Twitch URLs to localhost\"\n"
             "3. Access the Twitch Prime menu in-game\n\n"
             "The direct memory unlock you're using now works immediately, "
@@ -769,29 +950,22 @@ void MainWindow::onTwitchPrimeCategoryToggled(bool checked)
             "These items can also be unlocked using the Twitch URL Redirect feature, "
             "which simulates the original Twitch Prime login flow.\n\n"
             "To use the web-based method:\n"
-            "1. Enable the HTTP Server (port 443)\n"
+            "1. Enable the HTTP Server (port " + QString::number(Patches::activeRedirectPort) + ")\n"
             "2. Enable \"Redirect Twitch URLs to localhost\"\n"
             "3. Access the Twitch Prime menu in-game\n\n"
             "The direct memory unlock you're using now works immediately, "
             "but the web-based method provides a more authentic experience.");
     }
 
-    auto bundles = Patches::getTwitchPrimeBundles();
-
-    if (checked) {
-        m_memoryEditor->enableAllBundles(bundles);
-    } else {
-        m_memoryEditor->disableAllBundles(bundles);
-    }
+    UnlockMask mask = m_memoryEditor->getUnlockRegistry().allBundlesMask();
+    UnlockMask enabled = m_memoryEditor->getUnlockMask();
+    m_memoryEditor->applyUnlockMask(checked ? (enabled | mask) : (enabled & ~mask));
 
     // Update individual bundle checkboxes
-    for (auto* bundle : bundles) {
-        auto it = m_bundleCheckboxes.find(bundle);
-        if (it != m_bundleCheckboxes.end()) {
-            it->second->blockSignals(true);
-            it->second->setChecked(checked);
-            it->second->blockSignals(false);
-        }
+    for (auto& [bundle, checkbox] : m_bundleCheckboxes) {
+        checkbox->blockSignals(true);
+        checkbox->setChecked(checked);
+        checkbox->blockSignals(false);
     }
 
     updateMasterUnlockCheckbox();
@@ -818,10 +992,7 @@ void MainWindow::onUnlockWithoutWorkshopToggled(bool checked)
         for (auto& [bundle, checkbox] : m_bundleCheckboxes) disableAndUncheckControl(checkbox);
 
         // Clear any active byte table unlocks
-        auto allItems = Patches::getAllUnlockItems();
-        m_memoryEditor->disableAllUnlocks(allItems);
-        auto allBundles = Patches::getTwitchPrimeBundles();
-        m_memoryEditor->disableAllBundles(allBundles);
+        m_memoryEditor->applyUnlockMask(0);
 
         applyUnlockAllExclusives(false);  // Unlock 3 only
     } else {
@@ -849,10 +1020,7 @@ void MainWindow::onUnlockWithWorkshopToggled(bool checked)
         for (auto& [bundle, checkbox] : m_bundleCheckboxes) disableAndUncheckControl(checkbox);
 
         // Clear any active byte table unlocks
-        auto allItems = Patches::getAllUnlockItems();
-        m_memoryEditor->disableAllUnlocks(allItems);
-        auto allBundles = Patches::getTwitchPrimeBundles();
-        m_memoryEditor->disableAllBundles(allBundles);
+        m_memoryEditor->applyUnlockMask(0);
 
         applyUnlockAllExclusives(true);  // Unlock 1 + Unlock 2
     } else {
@@ -964,7 +1132,7 @@ void MainWindow::restoreUnlockControlStates()
 // Event Handlers
 // ============================================================================
 
-void MainWindow::onProcessAttached(const QString& name, DWORD pid)
+void MainWindow::onProcessAttached(const QString& name, uint32_t pid)
 {
     log(QString("Attached to %1 (PID: %2)").arg(name).arg(pid));
     updateStatus();
@@ -974,6 +1142,52 @@ void MainWindow::onProcessAttached(const QString& name, DWORD pid)
 
     m_attachButton->setEnabled(false);
     m_detachButton->setEnabled(true);
+    m_probeButton->setEnabled(true);
+}
+
+void MainWindow::onBuildIdentified(const QString& fingerprint, const QString& buildName)
+{
+    if (buildName.isEmpty()) {
+        log(QString("Unknown game build %1, locating patches by scan").arg(fingerprint));
+    } else {
+        log(QString("Game build: %1 (%2)").arg(buildName, fingerprint));
+    }
+}
+
+void MainWindow::onUnlockTableResolved(quint64 address, bool fromSignature)
+{
+    log(QString("Unlock table at 0x%1%2")
+        .arg(address, 0, 16)
+        .arg(fromSignature ? "" : " (signature not found, using default offset)"));
+}
+
+void MainWindow::onPatternIndexReady(const QString& path, bool built, qint64 elapsedMs)
+{
+    log(QString("Pattern index %1 in %2 ms: %3")
+        .arg(built ? "built" : "loaded").arg(elapsedMs).arg(QFileInfo(path).fileName()));
+}
+
+void MainWindow::onJumpTableRetargeted(int changedEntries, int journalSize)
+{
+    log(QString("Jump table: %1 entries changed (%2 changes to roll back)")
+        .arg(changedEntries).arg(journalSize));
+}
+
+void MainWindow::onPatchCandidatesFound(const QString& name, const QStringList& candidates)
+{
+    if (candidates.isEmpty()) {
+        log(QString("No near matches for %1").arg(name));
+        return;
+    }
+    log(QString("Near matches for %1 (not applied):").arg(name));
+    for (const QString& candidate : candidates) {
+        log("  " + candidate);
+    }
+}
+
+void MainWindow::onPatternScanned(const QString& summary)
+{
+    log("Scan " + summary);
 }
 
 void MainWindow::onProcessDetached()
@@ -1027,6 +1241,7 @@ void MainWindow::onProcessDetached()
 
     m_attachButton->setEnabled(true);
     m_detachButton->setEnabled(false);
+    m_probeButton->setEnabled(false);
 }
 
 void MainWindow::setUnlocksEnabled(bool enabled)
@@ -1097,6 +1312,32 @@ void MainWindow::onRequestReceived(const QString& method, const QString& path)
     log(QString("[HTTP] %1 %2").arg(method).arg(path));
 }
 
+void MainWindow::onSlotProbed(int itemId, int changedBytes)
+{
+    log(QString("[PROBE] Slot 0x%1: %2 bytes changed")
+        .arg(itemId, 2, 16, QChar('0')).arg(changedBytes));
+}
+
+void MainWindow::onProbeFinished(int slotsProbed, bool cancelled)
+{
+    m_probeButton->setText("Probe Slots...");
+    log(QString("Slot probe %1 after %2 slots").arg(cancelled ? "cancelled" : "finished").arg(slotsProbed));
+    if (slotsProbed == 0) return;
+
+    QString path = QFileDialog::getSaveFileName(this, "Save Probe Report",
+        "slot_probe.txt", "Text files (*.txt)");
+    if (path.isEmpty()) return;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) ||
+        file.write(QByteArray::fromStdString(m_slotProber->report())) < 0 ||
+        !file.commit()) {
+        log(QString("[ERROR] Failed to save probe report: %1").arg(file.errorString()));
+        return;
+    }
+    log(QString("Probe report saved to %1").arg(path));
+}
+
 void MainWindow::onError(const QString& error)
 {
     log(QString("[ERROR] %1").arg(error));
@@ -0,0 +1,42 @@
+/**
+ * @file MemoryBackend.cpp
+ * @brief In-memory backend for benchmarks and offline checks
+ */
+
+#include "MemoryBackend.h"
+
+#include <algorithm>
+#include <cstring>
+
+size_t InMemoryBackend::read(uintptr_t address, void* buffer, size_t size) const
+{
+    ++m_readCalls;
+    spend(READ_SYSCALLS);
+    if (address < m_base || address - m_base >= m_bytes.size()) {
+        return 0;
+    }
+    size_t offset = address - m_base;
+    size = std::min(size, m_bytes.size() - offset);
+    std::memcpy(buffer, m_bytes.data() + offset, size);
+    return size;
+}
+
+bool InMemoryBackend::writeProtected(uintptr_t address, ByteView data)
+{
+    ++m_writeCalls;
+    spend(WRITE_SYSCALLS);
+    if (address < m_base || address - m_base > m_bytes.size() || data.size > m_bytes.size() - (address - m_base)) {
+        return false;
+    }
+    std::copy(data.begin(), data.end(), m_bytes.begin() + (address - m_base));
+    m_bytesWritten += data.size;
+    return true;
+}
+
+void InMemoryBackend::spend(uint64_t syscalls) const
+{
+    if (m_syscallCost.count() == 0) return;
+    auto until = std::chrono::steady_clock::now() + m_syscallCost * static_cast<int64_t>(syscalls);
+    while (std::chrono::steady_clock::now() < until) {
+    }
+}
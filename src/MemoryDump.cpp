@@ -0,0 +1,373 @@
+/**
+ * @file MemoryDump.cpp
+ * @brief Offline view of process memory from a minidump or raw dump file
+ */
+
+#include "MemoryDump.h"
+#include "ScanEngine.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+template <typename T>
+T readField(const uint8_t* data, size_t offset)
+{
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+constexpr uint32_t MINIDUMP_SIGNATURE = 0x504D444D;    // "MDMP"
+constexpr size_t HEADER_SIZE = 32;
+constexpr size_t DIRECTORY_ENTRY_SIZE = 12;            // StreamType, DataSize, Rva
+
+constexpr uint32_t MODULE_LIST_STREAM = 4;
+constexpr uint32_t MEMORY_LIST_STREAM = 5;
+constexpr uint32_t MEMORY64_LIST_STREAM = 9;
+
+constexpr size_t MODULE_SIZE = 108;                    // MINIDUMP_MODULE
+constexpr size_t MEMORY_DESCRIPTOR_SIZE = 16;          // Start, DataSize (32), Rva
+constexpr size_t MEMORY_DESCRIPTOR64_SIZE = 16;        // Start, DataSize (64)
+
+bool fits(size_t fileSize, uint64_t offset, uint64_t size)
+{
+    return offset <= fileSize && size <= fileSize - offset;
+}
+
+/// MINIDUMP_STRING (byte length + UTF-16LE) as UTF-8
+std::string readString(const uint8_t* data, size_t fileSize, uint32_t rva)
+{
+    if (!fits(fileSize, rva, 4)) return {};
+    uint32_t length = readField<uint32_t>(data, rva);
+    if (!fits(fileSize, uint64_t(rva) + 4, length)) return {};
+
+    std::string out;
+    for (size_t i = 0; i + 1 < length; i += 2) {
+        uint32_t c = readField<uint16_t>(data, rva + 4 + i);
+        if (c >= 0xD800 && c < 0xDC00 && i + 3 < length) {
+            uint32_t low = readField<uint16_t>(data, rva + 6 + i);
+            if (low >= 0xDC00 && low < 0xE000) {
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                i += 2;
+            }
+        }
+        if (c < 0x80) {
+            out += static_cast<char>(c);
+        } else if (c < 0x800) {
+            out += static_cast<char>(0xC0 | (c >> 6));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            out += static_cast<char>(0xE0 | (c >> 12));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (c >> 18));
+            out += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+    return out;
+}
+
+std::string lowerFileName(const std::string& path)
+{
+    size_t slash = path.find_last_of("\\/");
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    std::transform(name.begin(), name.end(), name.begin(),
+                   [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; });
+    return name;
+}
+
+/**
+ * @brief Calls found(offset) for each match wholly inside data, in order
+ * @return false if found() asked to stop
+ */
+template <typename Found>
+bool scanBuffer(const uint8_t* data, size_t size, ByteView pattern, ByteView mask, Found&& found)
+{
+    for (size_t offset = 0; offset < size;) {
+        std::optional<size_t> match = Scan::findInBuffer(data + offset, size - offset, pattern, mask);
+        if (!match) break;
+        if (!found(offset + *match)) return false;
+        offset += *match + 1;
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Opening
+// ============================================================================
+
+bool MemoryDump::open(const std::string& path, uint64_t rawBase)
+{
+    close();
+    if (!m_file.open(path)) return fail(m_file.getLastError());
+
+    if (m_file.size() >= HEADER_SIZE && readField<uint32_t>(m_file.data(), 0) == MINIDUMP_SIGNATURE) {
+        m_format = Format::Minidump;
+        if (!parseMinidump()) {
+            std::string error = m_lastError;
+            close();
+            return fail(path + ": " + error);
+        }
+    } else {
+        m_format = Format::Raw;
+        addRegion(rawBase, m_file.size(), m_file.data());
+    }
+    normaliseRegions();
+    return true;
+}
+
+void MemoryDump::close()
+{
+    m_file.close();
+    m_format = Format::Raw;
+    m_regions.clear();
+    m_modules.clear();
+}
+
+bool MemoryDump::parseMinidump()
+{
+    const uint8_t* data = m_file.data();
+    size_t size = m_file.size();
+
+    uint32_t streamCount = readField<uint32_t>(data, 8);
+    uint32_t directory = readField<uint32_t>(data, 12);
+    if (!fits(size, directory, uint64_t(streamCount) * DIRECTORY_ENTRY_SIZE)) {
+        return fail("stream directory outside the file");
+    }
+
+    bool memoryFound = false;
+    for (uint32_t i = 0; i < streamCount; ++i) {
+        size_t entry = directory + size_t(i) * DIRECTORY_ENTRY_SIZE;
+        uint32_t type = readField<uint32_t>(data, entry);
+        uint32_t streamSize = readField<uint32_t>(data, entry + 4);
+        uint32_t rva = readField<uint32_t>(data, entry + 8);
+        if (!fits(size, rva, streamSize)) return fail("stream " + std::to_string(type) + " outside the file");
+
+        if (type == MEMORY_LIST_STREAM && streamSize >= 4) {
+            uint32_t count = readField<uint32_t>(data, rva);
+            if (uint64_t(count) * MEMORY_DESCRIPTOR_SIZE > streamSize - 4) return fail("truncated memory list");
+            for (uint32_t j = 0; j < count; ++j) {
+                size_t descriptor = rva + 4 + size_t(j) * MEMORY_DESCRIPTOR_SIZE;
+                uint64_t address = readField<uint64_t>(data, descriptor);
+                uint32_t length = readField<uint32_t>(data, descriptor + 8);
+                uint32_t offset = readField<uint32_t>(data, descriptor + 12);
+                if (!fits(size, offset, length)) return fail("memory range outside the file");
+                addRegion(address, length, data + offset);
+            }
+            memoryFound = true;
+        } else if (type == MEMORY64_LIST_STREAM && streamSize >= 16) {
+            uint64_t count = readField<uint64_t>(data, rva);
+            uint64_t offset = readField<uint64_t>(data, rva + 8);
+            if (count > (streamSize - 16) / MEMORY_DESCRIPTOR64_SIZE) return fail("truncated memory64 list");
+            // Full dumps store the ranges back to back from one base offset
+            for (uint64_t j = 0; j < count; ++j) {
+                size_t descriptor = rva + 16 + size_t(j) * MEMORY_DESCRIPTOR64_SIZE;
+                uint64_t address = readField<uint64_t>(data, descriptor);
+                uint64_t length = readField<uint64_t>(data, descriptor + 8);
+                if (!fits(size, offset, length)) return fail("memory64 range outside the file");
+                addRegion(address, length, data + offset);
+                offset += length;
+            }
+            memoryFound = true;
+        } else if (type == MODULE_LIST_STREAM && streamSize >= 4) {
+            uint32_t count = readField<uint32_t>(data, rva);
+            if (uint64_t(count) * MODULE_SIZE > streamSize - 4) return fail("truncated module list");
+            for (uint32_t j = 0; j < count; ++j) {
+                size_t module = rva + 4 + size_t(j) * MODULE_SIZE;
+                Module entry;
+                entry.base = readField<uint64_t>(data, module);
+                entry.size = readField<uint32_t>(data, module + 8);
+                entry.name = readString(data, size, readField<uint32_t>(data, module + 20));
+                m_modules.push_back(std::move(entry));
+            }
+        }
+    }
+    if (!memoryFound) return fail("no memory list stream (dump written without memory)");
+    return true;
+}
+
+void MemoryDump::addRegion(uint64_t address, uint64_t size, const uint8_t* data)
+{
+    if (size == 0) return;
+    m_regions.push_back({address, size, data});
+}
+
+/**
+ * @brief Sorts regions, drops overlaps, merges runs contiguous in memory and file
+ *
+ * A dump with both memory streams can list a range twice; the first one
+ * sorted (the lower start) wins.
+ */
+void MemoryDump::normaliseRegions()
+{
+    std::stable_sort(m_regions.begin(), m_regions.end(),
+                     [](const Region& a, const Region& b) { return a.address < b.address; });
+
+    std::vector<Region> merged;
+    for (Region region : m_regions) {
+        if (!merged.empty()) {
+            Region& last = merged.back();
+            uint64_t lastEnd = last.address + last.size;
+            if (region.address < lastEnd) {
+                uint64_t overlap = lastEnd - region.address;
+                if (overlap >= region.size) continue;
+                region.address += overlap;
+                region.data += overlap;
+                region.size -= overlap;
+            }
+            if (region.address == lastEnd && region.data == last.data + last.size) {
+                last.size += region.size;
+                continue;
+            }
+        }
+        merged.push_back(region);
+    }
+    m_regions = std::move(merged);
+}
+
+// ============================================================================
+// Access
+// ============================================================================
+
+uint64_t MemoryDump::totalSize() const
+{
+    uint64_t total = 0;
+    for (const Region& region : m_regions) total += region.size;
+    return total;
+}
+
+const MemoryDump::Module* MemoryDump::findModule(const std::string& name) const
+{
+    std::string wanted = lowerFileName(name);
+    for (const Module& module : m_modules) {
+        if (lowerFileName(module.name) == wanted) return &module;
+    }
+    return nullptr;
+}
+
+const uint8_t* MemoryDump::view(uint64_t address, size_t size) const
+{
+    auto next = std::upper_bound(m_regions.begin(), m_regions.end(), address,
+                                 [](uint64_t value, const Region& region) { return value < region.address; });
+    if (next == m_regions.begin()) return nullptr;
+    const Region& region = *(next - 1);
+    uint64_t offset = address - region.address;
+    if (offset >= region.size || size > region.size - offset) return nullptr;
+    return region.data + offset;
+}
+
+size_t MemoryDump::read(uint64_t address, void* buffer, size_t size) const
+{
+    uint8_t* out = static_cast<uint8_t*>(buffer);
+    size_t done = 0;
+    auto next = std::upper_bound(m_regions.begin(), m_regions.end(), address,
+                                 [](uint64_t value, const Region& region) { return value < region.address; });
+    if (next == m_regions.begin()) return 0;
+    for (auto it = next - 1; it != m_regions.end() && done < size; ++it) {
+        uint64_t at = address + done;
+        if (at < it->address || at - it->address >= it->size) break;
+        uint64_t offset = at - it->address;
+        size_t length = static_cast<size_t>(std::min<uint64_t>(size - done, it->size - offset));
+        std::memcpy(out + done, it->data + offset, length);
+        done += length;
+    }
+    return done;
+}
+
+MemoryReader MemoryDump::reader() const
+{
+    return [this](uintptr_t address, void* buffer, size_t size) { return read(address, buffer, size); };
+}
+
+// ============================================================================
+// Search
+// ============================================================================
+
+/**
+ * @brief Calls search(data, size, address) over the dump within [start, start + size)
+ *
+ * Each region is passed as a view. Where the next region follows in memory
+ * but is stored elsewhere, the last window - 1 bytes of one and the first
+ * window - 1 bytes of the other are passed as a small stitched copy, so a
+ * window crossing the boundary is seen exactly once. search() returns false
+ * to stop.
+ */
+template <typename Search>
+void MemoryDump::forEachSpan(uint64_t start, uint64_t size, size_t window, Search&& search) const
+{
+    uint64_t end = size > UINT64_MAX - start ? UINT64_MAX : start + size;
+    auto it = std::upper_bound(m_regions.begin(), m_regions.end(), start,
+                               [](uint64_t value, const Region& region) { return value < region.address; });
+    if (it != m_regions.begin()) --it;
+
+    std::vector<uint8_t> stitch;
+    for (; it != m_regions.end() && it->address < end; ++it) {
+        uint64_t regionEnd = it->address + it->size;
+        uint64_t begin = std::max(start, it->address);
+        uint64_t stop = std::min(end, regionEnd);
+        if (begin >= stop) continue;
+        if (!search(it->data + (begin - it->address), static_cast<size_t>(stop - begin), begin)) return;
+
+        auto next = it + 1;
+        if (window < 2 || stop != regionEnd || next == m_regions.end() || next->address != regionEnd) continue;
+        size_t tail = static_cast<size_t>(std::min<uint64_t>(window - 1, stop - begin));
+        size_t head = static_cast<size_t>(std::min<uint64_t>({window - 1, next->size, end - regionEnd}));
+        stitch.assign(it->data + (stop - tail - it->address), it->data + it->size);
+        stitch.insert(stitch.end(), next->data, next->data + head);
+        if (!search(stitch.data(), stitch.size(), stop - tail)) return;
+    }
+}
+
+std::optional<uint64_t> MemoryDump::findPattern(uint64_t start, uint64_t size, ByteView pattern, ByteView mask) const
+{
+    std::vector<uint64_t> matches = findAll(start, size, pattern, mask, 1);
+    if (matches.empty()) return std::nullopt;
+    return matches.front();
+}
+
+std::vector<uint64_t> MemoryDump::findAll(uint64_t start, uint64_t size, ByteView pattern, ByteView mask,
+                                          size_t limit) const
+{
+    std::vector<uint64_t> matches;
+    if (pattern.empty() || (!mask.empty() && mask.size != pattern.size)) return matches;
+
+    forEachSpan(start, size, pattern.size, [&](const uint8_t* data, size_t length, uint64_t address) {
+        return scanBuffer(data, length, pattern, mask, [&](size_t offset) {
+            matches.push_back(address + offset);
+            return limit == 0 || matches.size() < limit;
+        });
+    });
+    return matches;
+}
+
+std::vector<Fuzzy::Match> MemoryDump::findPatternFuzzy(uint64_t start, uint64_t size, ByteView pattern,
+                                                       ByteView mask, unsigned maxDistance, size_t limit) const
+{
+    std::vector<Fuzzy::Match> matches;
+    if (pattern.empty() || pattern.size > Fuzzy::MAX_PATTERN_LENGTH) return matches;
+    if (!mask.empty() && mask.size != pattern.size) return matches;
+
+    forEachSpan(start, size, pattern.size, [&](const uint8_t* data, size_t length, uint64_t address) {
+        for (Fuzzy::Match& match : Fuzzy::search(data, length, pattern, mask, maxDistance)) {
+            match.offset += address - start;
+            matches.push_back(std::move(match));
+        }
+        return true;
+    });
+
+    Fuzzy::rank(matches, limit);
+    return matches;
+}
+
+bool MemoryDump::fail(const std::string& error)
+{
+    m_lastError = error;
+    return false;
+}
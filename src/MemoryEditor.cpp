@@ -15,12 +15,55 @@
  * Pattern Caching:
  * Found patterns are cached by name to avoid repeated scans. Cache is cleared
  * on detach to ensure fresh scans on next attach (in case game memory changed).
+ * Addresses are also kept per build (as RVAs, keyed by fingerprint) for the
+ * lifetime of the editor; together with the signature database's per-build
+ * entries they seed the cache at attach time, so a game restart or a known
+ * build needs no scan either.
+ *
+ * Pattern Index:
+ * Optional. Patterns not found through the caches are looked up in an n-gram
+ * index of the module and only the candidates are read back and checked. The
+ * index is built from a one-off snapshot of the module and saved per build,
+ * so later attaches just map the file. When no candidate verifies, the
+ * pattern is not in the module and nothing else is searched; a pattern with
+ * no fixed 4-byte window goes through the near search and scan instead.
+ *
+ * Broken Signatures:
+ * When a patch pattern is not found at all, the module is searched again for
+ * windows within a couple of substituted bytes, and the closest few are
+ * reported with the bytes that differ. They are never patched automatically.
+ *
+ * Scan Statistics:
+ * Every lookup that reaches the process (module enumeration, pattern and
+ * reference scans, near-match searches) runs under a ScanStats::Scope. The
+ * latest result per name is kept until the next attach and logged as it
+ * completes. Built without FFXV_SCAN_STATS, none of this is compiled in.
  */
 
 #include "MemoryEditor.h"
+#include "PatchSite.h"
 #include "PatternScanner.h"
+#include "ScanStats.h"
+#include "Trace.h"
+#include "SignatureDatabase.h"
+#include "WriteTransaction.h"
+#include <Windows.h>
 #include <TlHelp32.h>
 #include <Psapi.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+/// Batched reads and writes merge ranges at most this far apart
+constexpr uintptr_t BATCH_MERGE_GAP = WriteTransaction::DEFAULT_MERGE_GAP;
+
+/// Fuzzy candidates reported when a patch pattern is not found
+constexpr unsigned CANDIDATE_MAX_DISTANCE = 2;
+constexpr size_t CANDIDATE_LIMIT = 5;
+
+} // namespace
 
 // ============================================================================
 // Construction / Destruction
@@ -29,6 +72,7 @@
 MemoryEditor::MemoryEditor(QObject* parent)
     : QObject(parent)
 {
+    m_registry.rebuild();
 }
 
 MemoryEditor::~MemoryEditor()
@@ -42,58 +86,59 @@ MemoryEditor::~MemoryEditor()
 
 bool MemoryEditor::attachToProcess(const std::wstring& processName)
 {
-    if (m_processHandle) {
+    Trace::Span span("attachToProcess", "attach");
+
+    if (m_process.isOpen()) {
         detach();
     }
 
-    DWORD pid = findProcessByName(processName);
+    uint32_t pid = findProcessByName(processName);
     if (pid == 0) {
         m_lastError = "Process not found: " + std::string(processName.begin(), processName.end());
         return false;
     }
 
-    m_processHandle = OpenProcess(
-        PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_VM_OPERATION | PROCESS_QUERY_INFORMATION,
-        FALSE,
-        pid
-    );
-
-    if (!m_processHandle) {
-        m_lastError = "Failed to open process. Run as administrator? Error: " + std::to_string(GetLastError());
+    if (!m_process.open(pid)) {
+        m_lastError = "Failed to open process. Run as administrator? Error: " + std::to_string(m_process.lastError());
         emit errorOccurred(QString::fromStdString(m_lastError));
         return false;
     }
 
-    m_processId = pid;
     m_processName = processName;
     m_patternCache.clear();
+    m_scanStats.clear();
 
     emit processAttached(QString::fromStdWString(processName), pid);
+    identifyBuild();
+    m_registry.rebuild();
+    m_registry.setEnabledMask(0);
     return true;
 }
 
 void MemoryEditor::detach()
 {
-    if (m_processHandle) {
-        CloseHandle(m_processHandle);
-        m_processHandle = nullptr;
-        m_processId = 0;
+    if (m_process.isOpen()) {
+        m_process.close();
         m_processName.clear();
         m_patternCache.clear();
+        m_moduleBase = 0;
+        m_moduleSize = 0;
+        m_buildFingerprint.reset();
+        m_patternIndex.clear();
+        m_registry.setEnabledMask(0);
+        m_jumpTable.reset();
+        if (m_restoreTableBase) {
+            Patches::rebaseUnlockTable(m_restoreTableBase);
+            m_restoreTableBase = 0;
+        }
         emit processDetached();
     }
 }
 
 bool MemoryEditor::isAttached() const
 {
-    if (!m_processHandle) return false;
-
     // Verify process is still running
-    DWORD exitCode;
-    if (GetExitCodeProcess(m_processHandle, &exitCode)) {
-        return exitCode == STILL_ACTIVE;
-    }
-    return false;
+    return m_process.isRunning();
 }
 
 std::wstring MemoryEditor::getProcessName() const
@@ -101,9 +146,222 @@ std::wstring MemoryEditor::getProcessName() const
     return m_processName;
 }
 
-DWORD MemoryEditor::getProcessId() const
+uint32_t MemoryEditor::getProcessId() const
+{
+    return m_process.processId();
+}
+
+uintptr_t MemoryEditor::getModuleBase() const
+{
+    return m_moduleBase;
+}
+
+// ============================================================================
+// Build Identification
+// ============================================================================
+
+void MemoryEditor::setSignatureDatabase(const SignatureDatabase* database)
+{
+    m_signatureDatabase = database;
+
+    // The database's overrides are already on the Patches:: definitions
+    UnlockMask enabled = m_registry.enabledMask();
+    m_registry.rebuild();
+    m_registry.setEnabledMask(enabled);
+}
+
+std::optional<BuildFingerprint> MemoryEditor::getBuildFingerprint() const
+{
+    return m_buildFingerprint;
+}
+
+void MemoryEditor::setPatternIndexDirectory(const std::string& directory)
+{
+    m_patternIndexDirectory = directory;
+}
+
+/**
+ * @brief Maps the index saved for this build, or builds and saves one
+ *
+ * Building reads the whole module once; the snapshot is dropped afterwards,
+ * since candidates are checked against live memory anyway.
+ */
+void MemoryEditor::loadPatternIndex()
+{
+    if (m_patternIndexDirectory.empty() || !m_buildFingerprint || m_moduleSize == 0) return;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string path = m_patternIndexDirectory + "/" + m_buildFingerprint->toString() + ".fxng";
+    bool built = false;
+    if (!m_patternIndex.load(path, m_buildFingerprint->hash, m_moduleSize)) {
+        std::vector<uint8_t> image = snapshotModule();
+        if (image.empty() || !m_patternIndex.build(image.data(), image.size())) return;
+        m_patternIndex.setImage(nullptr);
+        m_patternIndex.save(path, m_buildFingerprint->hash);  // Unsaved, it still serves this session
+        built = true;
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    emit patternIndexReady(QString::fromStdString(path), built, elapsed.count());
+}
+
+/// Whole module, read in chunks; pages that cannot be read are left zero
+std::vector<uint8_t> MemoryEditor::snapshotModule()
+{
+    constexpr size_t CHUNK_SIZE = 0x10000;
+    std::vector<uint8_t> image(m_moduleSize, 0);
+    for (size_t offset = 0; offset < m_moduleSize; offset += CHUNK_SIZE) {
+        m_process.read(m_moduleBase + offset, image.data() + offset, std::min(CHUNK_SIZE, m_moduleSize - offset));
+    }
+    return image;
+}
+
+/**
+ * @brief Fingerprints the game module, seeds the pattern cache and locates the unlock table
+ *
+ * Patch addresses come from the signature database for listed builds, or
+ * from earlier scans of the same build this session. Every address is
+ * checked against its pattern before it is cached, so a wrong or stale entry
+ * costs one scan rather than a write to the wrong bytes. Failure here is
+ * never fatal; patches just fall back to scanning.
+ */
+void MemoryEditor::identifyBuild()
+{
+    Trace::Span span("identifyBuild", "attach");
+
+    ScanStats enumeration;
+    bool found = false;
+    {
+        ScanStats::Scope scope(enumeration);
+        ScanStats::Timer timer;
+        found = PatternScanner::getModuleInfo(m_process.handle(), L"ffxv_s.exe", m_moduleBase, m_moduleSize);
+        enumeration.totalNs = timer.elapsedNs();
+    }
+    enumeration.name = "ffxv_s.exe module";
+    enumeration.method = found ? "enumerate" : "none";
+    recordScan(std::move(enumeration));
+    if (!found) {
+        return;
+    }
+
+    m_buildFingerprint = BuildFingerprint::compute(m_process.reader(), m_moduleBase);
+
+    std::optional<SignatureDatabase::BuildView> build;
+    ResolvedBuild* resolved = nullptr;
+    if (m_buildFingerprint) {
+        if (m_signatureDatabase) {
+            build = m_signatureDatabase->findBuild(m_buildFingerprint->hash);
+        }
+        resolved = &m_buildCache[m_buildFingerprint->hash];
+    }
+
+    for (auto* patch : Patches::getAllPatches()) {
+        uint32_t rva = 0;
+        for (size_t i = 0; build && i < build->addressCount; ++i) {
+            auto entry = build->address(i);
+            if (entry.patchName == patch->name) {
+                rva = entry.rva;
+                break;
+            }
+        }
+        if (rva == 0 && resolved) {
+            auto it = resolved->patchRvas.find(patch->name);
+            if (it != resolved->patchRvas.end()) rva = it->second;
+        }
+        if (rva != 0 && PatchSite::matches(statsReader(), m_moduleBase + rva, *patch)) {
+            m_patternCache[patch->name] = m_moduleBase + rva;
+        }
+    }
+
+    if (m_buildFingerprint) {
+        QString fingerprint = QString::fromStdString(m_buildFingerprint->toString());
+        emit buildIdentified(fingerprint, build
+            ? QString::fromUtf8(build->name.data(), static_cast<int>(build->name.size()))
+            : QString());
+    }
+
+    loadPatternIndex();
+
+    resolveUnlockTable(build ? build->unlockTableRva : 0, resolved);
+    resolveJumpTable(build ? build->jumpTableRva : 0, resolved);
+}
+
+/**
+ * @brief RVA of a table: database entry, then the session cache, then the code reference
+ * @return 0 if none of them produced an address
+ */
+uint32_t MemoryEditor::resolveTableRva(uint32_t databaseRva, uint32_t cachedRva,
+                                       const Patches::OperandReference& reference)
+{
+    if (databaseRva != 0) return databaseRva;
+    if (cachedRva != 0) return cachedRva;
+
+    Trace::Span span("resolveReference", "scan");
+    span.setDetail(reference.name);
+
+    ScanStats stats;
+    std::optional<uintptr_t> table;
+    {
+        ScanStats::Scope scope(stats);
+        ScanStats::Timer timer;
+        table = PatternScanner::resolveReference(m_process, m_moduleBase, m_moduleSize, reference);
+        stats.totalNs = timer.elapsedNs();
+    }
+    stats.name = reference.name;
+    stats.method = table.has_value() ? "scan" : "none";
+    recordScan(std::move(stats));
+
+    return table.has_value() ? static_cast<uint32_t>(table.value() - m_moduleBase) : 0;
+}
+
+/**
+ * @brief Points every item and bundle address at this process's unlock table
+ *
+ * Sources, in order: the database entry for the build, the result cached for
+ * the build earlier this session, then the table reference in the unlock
+ * loop. If all fail the configured base is only shifted by the module's load
+ * offset, which is still right for a relocated copy of the known build.
+ */
+void MemoryEditor::resolveUnlockTable(uint32_t databaseRva, ResolvedBuild* resolved)
+{
+    uint32_t tableRva = resolveTableRva(databaseRva, resolved ? resolved->unlockTableRva : 0,
+                                        Patches::UNLOCK_TABLE_REFERENCE);
+    uintptr_t tableBase = tableRva
+        ? m_moduleBase + tableRva
+        : Patches::activeUnlockTableBase - Patches::DEFAULT_IMAGE_BASE + m_moduleBase;
+    if (tableRva && resolved) {
+        resolved->unlockTableRva = tableRva;
+    }
+
+    if (tableBase != Patches::activeUnlockTableBase) {
+        m_restoreTableBase = Patches::activeUnlockTableBase;
+        Patches::rebaseUnlockTable(tableBase);
+    }
+    emit unlockTableResolved(static_cast<quint64>(tableBase), tableRva != 0);
+}
+
+/// Same sources as the unlock table; the jump table is not shared with Patches::
+void MemoryEditor::resolveJumpTable(uint32_t databaseRva, ResolvedBuild* resolved)
 {
-    return m_processId;
+    uint32_t tableRva = resolveTableRva(databaseRva, resolved ? resolved->jumpTableRva : 0,
+                                        Patches::JUMP_TABLE_REFERENCE);
+    if (tableRva && resolved) {
+        resolved->jumpTableRva = tableRva;
+    }
+    m_jumpTable.reset(tableRva
+        ? m_moduleBase + tableRva
+        : Patches::JUMP_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE + m_moduleBase, m_moduleBase);
+}
+
+/// m_process.reader() with every read counted in the current ScanStats scope
+MemoryReader MemoryEditor::statsReader()
+{
+    return [this](uintptr_t address, void* buffer, size_t size) {
+        ScanStats::Timer timer;
+        size_t bytesRead = m_process.read(address, buffer, size);
+        ScanStats::recordRead(size, bytesRead, bytesRead != 0, timer);
+        return bytesRead;
+    };
 }
 
 std::string MemoryEditor::getLastError() const
@@ -127,6 +385,13 @@ bool MemoryEditor::applyPatch(Patches::Patch& patch)
     if (address == 0) {
         m_lastError = "Pattern not found: " + patch.name;
         emit errorOccurred(QString::fromStdString(m_lastError));
+        reportPatchCandidates(patch);
+        return false;
+    }
+
+    if (!PatchSite::onBoundaries(statsReader(), address, patch)) {
+        m_lastError = "Patch does not fall on instruction boundaries: " + patch.name;
+        emit errorOccurred(QString::fromStdString(m_lastError));
         return false;
     }
 
@@ -212,6 +477,98 @@ bool MemoryEditor::isPatchApplied(const Patches::Patch& patch) const
     return patch.enabled;
 }
 
+std::vector<MemoryEditor::PatchCandidate> MemoryEditor::findPatchCandidates(
+    const Patches::Patch& patch, unsigned maxDistance, size_t limit)
+{
+    std::vector<PatchCandidate> candidates;
+    if (!isAttached() || !m_moduleBase) return candidates;
+
+    maxDistance = std::min(maxDistance, Fuzzy::maxUsefulDistance(patch.pattern, patch.mask));
+    ScanStats stats;
+    std::vector<Fuzzy::Match> matches;
+    {
+        ScanStats::Scope scope(stats);
+        ScanStats::Timer timer;
+        matches = PatternScanner::findPatternFuzzy(
+            m_process, m_moduleBase, m_moduleSize, patch.pattern, patch.mask, maxDistance, limit);
+        stats.totalNs = timer.elapsedNs();
+    }
+    stats.name = patch.name + " (near matches)";
+    stats.method = "fuzzy";
+    recordScan(std::move(stats));
+
+    for (const Fuzzy::Match& match : matches) {
+        candidates.push_back({m_moduleBase + match.offset, match.distance, match.describe()});
+    }
+    return candidates;
+}
+
+const std::vector<ScanStats>& MemoryEditor::getScanStats() const
+{
+    return m_scanStats;
+}
+
+/**
+ * @brief Keeps the latest lookup per name and logs it
+ *
+ * Compiled out with the rest of the instrumentation.
+ */
+void MemoryEditor::recordScan(ScanStats stats)
+{
+    if constexpr (ScanStats::ENABLED) {
+        auto it = std::find_if(m_scanStats.begin(), m_scanStats.end(),
+                               [&stats](const ScanStats& scan) { return scan.name == stats.name; });
+        QString summary = QString::fromStdString(stats.toString());
+        if (it != m_scanStats.end()) {
+            *it = std::move(stats);
+        } else {
+            m_scanStats.push_back(std::move(stats));
+        }
+        emit patternScanned(summary);
+    }
+}
+
+void MemoryEditor::reportPatchCandidates(const Patches::Patch& patch)
+{
+    QStringList lines;
+    for (const PatchCandidate& candidate : findPatchCandidates(patch, CANDIDATE_MAX_DISTANCE, CANDIDATE_LIMIT)) {
+        lines << QString("RVA 0x%1, distance %2: %3")
+                     .arg(static_cast<quint64>(candidate.address - m_moduleBase), 0, 16)
+                     .arg(candidate.distance)
+                     .arg(QString::fromStdString(candidate.differences));
+    }
+    emit patchCandidatesFound(QString::fromStdString(patch.name), lines);
+}
+
+bool MemoryEditor::rewriteAppliedPatches(std::vector<Patches::Patch*>& patches)
+{
+    if (!isAttached()) {
+        m_lastError = "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+
+    std::vector<std::pair<uintptr_t, ByteView>> writes;
+    for (auto* patch : patches) {
+        if (!patch->enabled) continue;
+
+        uintptr_t address = findPatternAddress(*patch);
+        if (address == 0) {
+            m_lastError = "Cannot find patch location: " + patch->name;
+            emit errorOccurred(QString::fromStdString(m_lastError));
+            return false;
+        }
+        writes.emplace_back(address + patch->offset, patch->patched);
+    }
+
+    if (!writeBatch(std::move(writes))) {
+        m_lastError = "Failed to rewrite applied patches";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    return true;
+}
+
 // ============================================================================
 // Direct Memory Unlock Operations (Byte Table)
 // ============================================================================
@@ -231,6 +588,7 @@ bool MemoryEditor::enableUnlock(Patches::UnlockItem& item)
     }
 
     item.enabled = true;
+    m_registry.setEnabledMask(m_registry.enabledMask() | UnlockRegistry::bit(item.itemId));
     emit unlockEnabled(QString::fromStdString(item.name));
     return true;
 }
@@ -250,6 +608,7 @@ bool MemoryEditor::disableUnlock(Patches::UnlockItem& item)
     }
 
     item.enabled = false;
+    m_registry.setEnabledMask(m_registry.enabledMask() & ~UnlockRegistry::bit(item.itemId));
     emit unlockDisabled(QString::fromStdString(item.name));
     return true;
 }
@@ -261,24 +620,12 @@ bool MemoryEditor::toggleUnlock(Patches::UnlockItem& item)
 
 bool MemoryEditor::enableAllUnlocks(std::vector<Patches::UnlockItem*>& items)
 {
-    bool allSuccess = true;
-    for (auto* item : items) {
-        if (!item->enabled && !enableUnlock(*item)) {
-            allSuccess = false;
-        }
-    }
-    return allSuccess;
+    return applyUnlockMask(m_registry.enabledMask() | m_registry.maskOf(items));
 }
 
 bool MemoryEditor::disableAllUnlocks(std::vector<Patches::UnlockItem*>& items)
 {
-    bool allSuccess = true;
-    for (auto* item : items) {
-        if (item->enabled && !disableUnlock(*item)) {
-            allSuccess = false;
-        }
-    }
-    return allSuccess;
+    return applyUnlockMask(m_registry.enabledMask() & ~m_registry.maskOf(items));
 }
 
 bool MemoryEditor::isUnlockEnabled(const Patches::UnlockItem& item) const
@@ -307,6 +654,7 @@ bool MemoryEditor::enableBundle(Patches::UnlockBundle& bundle)
 
     if (allSuccess) {
         bundle.enabled = true;
+        m_registry.setEnabledMask(m_registry.enabledMask() | m_registry.maskOf(bundle));
         emit bundleEnabled(QString::fromStdString(bundle.name));
     } else {
         m_lastError = "Failed to enable bundle (partial): " + bundle.name;
@@ -333,6 +681,7 @@ bool MemoryEditor::disableBundle(Patches::UnlockBundle& bundle)
 
     if (allSuccess) {
         bundle.enabled = false;
+        m_registry.setEnabledMask(m_registry.enabledMask() & ~m_registry.maskOf(bundle));
         emit bundleDisabled(QString::fromStdString(bundle.name));
     } else {
         m_lastError = "Failed to disable bundle (partial): " + bundle.name;
@@ -349,24 +698,12 @@ bool MemoryEditor::toggleBundle(Patches::UnlockBundle& bundle)
 
 bool MemoryEditor::enableAllBundles(std::vector<Patches::UnlockBundle*>& bundles)
 {
-    bool allSuccess = true;
-    for (auto* bundle : bundles) {
-        if (!bundle->enabled && !enableBundle(*bundle)) {
-            allSuccess = false;
-        }
-    }
-    return allSuccess;
+    return applyUnlockMask(m_registry.enabledMask() | m_registry.maskOf(bundles));
 }
 
 bool MemoryEditor::disableAllBundles(std::vector<Patches::UnlockBundle*>& bundles)
 {
-    bool allSuccess = true;
-    for (auto* bundle : bundles) {
-        if (bundle->enabled && !disableBundle(*bundle)) {
-            allSuccess = false;
-        }
-    }
-    return allSuccess;
+    return applyUnlockMask(m_registry.enabledMask() & ~m_registry.maskOf(bundles));
 }
 
 bool MemoryEditor::isBundleEnabled(const Patches::UnlockBundle& bundle) const
@@ -375,32 +712,235 @@ bool MemoryEditor::isBundleEnabled(const Patches::UnlockBundle& bundle) const
 }
 
 // ============================================================================
-// Low-Level Memory Operations
+// Mask-Based Byte Table Access
 // ============================================================================
 
-bool MemoryEditor::writeByte(uintptr_t address, uint8_t value)
+bool MemoryEditor::applyUnlockMask(UnlockMask desired)
 {
-    if (!isAttached()) return false;
+    if (!isAttached()) {
+        m_lastError = "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+
+    UnlockMask previous = m_registry.enabledMask();
+    UnlockMask changed = previous ^ desired;
+    if (changed == 0) return true;
+
+    // Read-modify-write the span between the lowest and highest changed byte,
+    // so bytes in between that we do not own keep their current value
+    size_t first = 0;
+    while (!(changed & UnlockRegistry::bit(uint8_t(first)))) ++first;
+    size_t last = UnlockRegistry::MAX_TABLE_BYTES - 1;
+    while (!(changed & UnlockRegistry::bit(uint8_t(last)))) --last;
+
+    uintptr_t start = m_registry.tableBase() + first;
+    size_t length = last - first + 1;
+    std::vector<uint8_t> bytes = readMemory(start, length);
+    if (bytes.size() != length) {
+        m_lastError = "Failed to read unlock table";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    for (size_t i = first; i <= last; ++i) {
+        UnlockMask bit = UnlockRegistry::bit(uint8_t(i));
+        if (changed & bit) bytes[i - first] = (desired & bit) ? 0x01 : 0x00;
+    }
+    if (!writeProtectedMemory(start, bytes)) {
+        m_lastError = "Failed to write unlock table";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    updateEnabledMask(desired);
+    return true;
+}
+
+UnlockMask MemoryEditor::getUnlockMask() const
+{
+    return m_registry.enabledMask();
+}
+
+const UnlockRegistry& MemoryEditor::getUnlockRegistry() const
+{
+    return m_registry;
+}
+
+/**
+ * @brief Records desired as the enabled mask; flags and signals follow the changed bits
+ */
+void MemoryEditor::updateEnabledMask(UnlockMask desired)
+{
+    UnlockMask changed = m_registry.enabledMask() ^ desired;
+    m_registry.setEnabledMask(desired);
+
+    for (size_t i = 0; i < m_registry.itemCount(); ++i) {
+        UnlockMask bit = UnlockRegistry::bit(m_registry.itemId(i));
+        if (!(changed & bit)) continue;
+
+        Patches::UnlockItem* item = m_registry.itemDefinition(i);
+        item->enabled = (desired & bit) != 0;
+        QString name = QString::fromUtf8(m_registry.itemName(i).data(), static_cast<int>(m_registry.itemName(i).size()));
+        if (item->enabled) {
+            emit unlockEnabled(name);
+        } else {
+            emit unlockDisabled(name);
+        }
+    }
+    for (size_t i = 0; i < m_registry.bundleCount(); ++i) {
+        UnlockMask mask = m_registry.bundleMask(i);
+        Patches::UnlockBundle* bundle = m_registry.bundleDefinition(i);
+        bool enabled = mask != 0 && (desired & mask) == mask;
+        if (!(changed & mask) || bundle->enabled == enabled) continue;
+
+        bundle->enabled = enabled;
+        QString name = QString::fromUtf8(m_registry.bundleName(i).data(), static_cast<int>(m_registry.bundleName(i).size()));
+        if (enabled) {
+            emit bundleEnabled(name);
+        } else {
+            emit bundleDisabled(name);
+        }
+    }
+}
+
+// ============================================================================
+// Profiles
+// ============================================================================
+
+bool MemoryEditor::applyProfile(std::vector<Patches::Patch*>& patches, UnlockMask mask, size_t& rewritten)
+{
+    rewritten = 0;
+    if (!isAttached()) {
+        m_lastError = "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+
+    Trace::Span span("applyProfile", "write");
+
+    std::vector<MemoryRange> ranges;
+    std::vector<ByteView> wanted;
+    for (auto* patch : patches) {
+        uintptr_t address = findPatternAddress(*patch);
+        if (address == 0) {
+            m_lastError = "Pattern not found: " + patch->name;
+            emit errorOccurred(QString::fromStdString(m_lastError));
+            reportPatchCandidates(*patch);
+            return false;
+        }
+        // Checked once; a freeze tick is then one batched read
+        if (!patch->enabled && !PatchSite::onBoundaries(statsReader(), address, *patch)) {
+            m_lastError = "Patch does not fall on instruction boundaries: " + patch->name;
+            emit errorOccurred(QString::fromStdString(m_lastError));
+            return false;
+        }
+        ranges.push_back({address + patch->offset, patch->patched.size});
+        wanted.push_back(patch->patched);
+    }
+
+    static constexpr uint8_t UNLOCKED[] = {0x01};
+    static constexpr uint8_t LOCKED[] = {0x00};
+    UnlockMask owned = mask | m_registry.enabledMask();
+    for (size_t i = 0; i < UnlockRegistry::MAX_TABLE_BYTES; ++i) {
+        UnlockMask bit = UnlockRegistry::bit(uint8_t(i));
+        if (!(owned & bit)) continue;
+        ranges.push_back({m_registry.tableBase() + i, 1});
+        wanted.push_back((mask & bit) ? ByteView(UNLOCKED) : ByteView(LOCKED));
+    }
+
+    std::vector<std::vector<uint8_t>> current = readBatch(ranges);
+    std::vector<std::pair<uintptr_t, ByteView>> writes;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        if (current[i].size() != wanted[i].size ||
+            !std::equal(wanted[i].begin(), wanted[i].end(), current[i].begin())) {
+            writes.emplace_back(ranges[i].address, wanted[i]);
+        }
+    }
+    span.setArg("writes", static_cast<int64_t>(writes.size()));
+
+    if (!writes.empty() && !writeBatch(writes)) {
+        m_lastError = "Failed to write profile";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    rewritten = writes.size();
+
+    for (auto* patch : patches) {
+        if (patch->enabled) continue;
+        patch->enabled = true;
+        emit patchApplied(QString::fromStdString(patch->name));
+    }
+    updateEnabledMask(mask);
+    return true;
+}
+
+// ============================================================================
+// Jump Table (Phase 6 Dispatch)
+// ============================================================================
+
+std::vector<MemoryEditor::JumpTableEntry> MemoryEditor::readJumpTable()
+{
+    if (!isAttached()) return {};
+    return m_jumpTable.read(m_process);
+}
+
+bool MemoryEditor::retargetJumpTable(const std::vector<JumpTableRetarget>& changes)
+{
+    size_t changed = 0;
+    if (!isAttached() || !m_jumpTable.retarget(m_process, changes, changed)) {
+        m_lastError = isAttached() ? m_jumpTable.getLastError() : "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    if (changed != 0) {
+        emit jumpTableRetargeted(static_cast<int>(changed), static_cast<int>(m_jumpTable.journalSize()));
+    }
+    return true;
+}
 
-    DWORD oldProtection;
-    if (!setMemoryProtection(address, 1, PAGE_EXECUTE_READWRITE, oldProtection)) {
+bool MemoryEditor::rollbackJumpTable()
+{
+    size_t changed = 0;
+    if (!isAttached() || !m_jumpTable.rollback(m_process, changed)) {
+        m_lastError = isAttached() ? m_jumpTable.getLastError() : "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
         return false;
     }
+    emit jumpTableRetargeted(static_cast<int>(changed), static_cast<int>(m_jumpTable.journalSize()));
+    return true;
+}
+
+bool MemoryEditor::restoreJumpTable()
+{
+    if (m_jumpTable.journalSize() == 0) return true;
 
-    SIZE_T bytesWritten;
-    bool success = WriteProcessMemory(
-        m_processHandle,
-        reinterpret_cast<LPVOID>(address),
-        &value,
-        1,
-        &bytesWritten
-    ) && bytesWritten == 1;
+    size_t changed = 0;
+    if (!isAttached() || !m_jumpTable.restore(m_process, changed)) {
+        m_lastError = isAttached() ? m_jumpTable.getLastError() : "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    emit jumpTableRetargeted(static_cast<int>(changed), 0);
+    return true;
+}
+
+size_t MemoryEditor::getJumpTableJournalSize() const
+{
+    return m_jumpTable.journalSize();
+}
+
+uintptr_t MemoryEditor::getJumpTableBase() const
+{
+    return m_jumpTable.base();
+}
 
-    // Always restore protection, even if write failed
-    DWORD temp;
-    setMemoryProtection(address, 1, oldProtection, temp);
+// ============================================================================
+// Low-Level Memory Operations
+// ============================================================================
 
-    return success;
+bool MemoryEditor::writeByte(uintptr_t address, uint8_t value)
+{
+    if (!isAttached()) return false;
+    return m_process.writeProtected(address, ByteView(&value, 1));
 }
 
 uint8_t MemoryEditor::readByte(uintptr_t address)
@@ -408,54 +948,99 @@ uint8_t MemoryEditor::readByte(uintptr_t address)
     if (!isAttached()) return 0;
 
     uint8_t value = 0;
-    SIZE_T bytesRead;
-    ReadProcessMemory(
-        m_processHandle,
-        reinterpret_cast<LPCVOID>(address),
-        &value,
-        1,
-        &bytesRead
-    );
+    m_process.read(address, &value, 1);
     return value;
 }
 
-bool MemoryEditor::writeMemory(uintptr_t address, const std::vector<uint8_t>& data)
+std::vector<uint8_t> MemoryEditor::readMemory(uintptr_t address, size_t size)
 {
-    SIZE_T bytesWritten;
-    return WriteProcessMemory(
-        m_processHandle,
-        reinterpret_cast<LPVOID>(address),
-        data.data(),
-        data.size(),
-        &bytesWritten
-    ) && bytesWritten == data.size();
+    std::vector<uint8_t> buffer(size);
+
+    ScanStats::Timer timer;
+    size_t bytesRead = m_process.read(address, buffer.data(), size);
+    ScanStats::recordRead(size, bytesRead, bytesRead != 0, timer);
+    buffer.resize(bytesRead);
+
+    return buffer;
 }
 
-std::vector<uint8_t> MemoryEditor::readMemory(uintptr_t address, size_t size)
+/**
+ * @brief Reads several ranges, merging neighbours into one ReadProcessMemory call
+ *
+ * A merged run that cannot be read as a whole (e.g. an unmapped page in a
+ * gap) falls back to reading its ranges one by one.
+ *
+ * @return One buffer per range, in input order; shorter than requested (or
+ *         empty) where the range could not be read
+ */
+std::vector<std::vector<uint8_t>> MemoryEditor::readBatch(const std::vector<MemoryRange>& ranges)
 {
-    std::vector<uint8_t> buffer(size);
-    SIZE_T bytesRead;
-
-    if (ReadProcessMemory(
-            m_processHandle,
-            reinterpret_cast<LPCVOID>(address),
-            buffer.data(),
-            size,
-            &bytesRead)) {
-        buffer.resize(bytesRead);
-    } else {
-        buffer.clear();
+    std::vector<std::vector<uint8_t>> results(ranges.size());
+    if (!m_process.isOpen()) return results;
+
+    std::vector<size_t> order(ranges.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::sort(order.begin(), order.end(),
+              [&](size_t a, size_t b) { return ranges[a].address < ranges[b].address; });
+
+    size_t first = 0;
+    while (first < order.size()) {
+        uintptr_t start = ranges[order[first]].address;
+        uintptr_t end = start + ranges[order[first]].size;
+        size_t last = first + 1;
+        while (last < order.size() && ranges[order[last]].address <= end + BATCH_MERGE_GAP) {
+            end = std::max(end, ranges[order[last]].address + ranges[order[last]].size);
+            ++last;
+        }
+
+        std::vector<uint8_t> run = readMemory(start, end - start);
+        for (size_t i = first; i < last; ++i) {
+            const MemoryRange& range = ranges[order[i]];
+            if (run.size() == end - start) {
+                auto from = run.begin() + (range.address - start);
+                results[order[i]].assign(from, from + range.size);
+            } else {
+                results[order[i]] = readMemory(range.address, range.size);
+            }
+        }
+        first = last;
     }
+    return results;
+}
 
-    return buffer;
+/**
+ * @brief Writes several ranges, merging neighbours into one protected write
+ *
+ * See WriteTransaction: ranges less than BATCH_MERGE_GAP apart are joined and
+ * the bytes between them written back unchanged. Only use this for regions
+ * the game does not write to concurrently (code, read-only data, the unlock
+ * table).
+ */
+bool MemoryEditor::writeBatch(std::vector<std::pair<uintptr_t, ByteView>> writes)
+{
+    Trace::Span span("writeBatch", "write");
+    span.setArg("writes", static_cast<int64_t>(writes.size()));
+
+    WriteTransaction transaction(BATCH_MERGE_GAP);
+    for (const auto& [address, data] : writes) {
+        transaction.add(address, data);
+    }
+
+    bool allSuccess = true;
+    for (const WriteTransaction::Run& run : transaction.plan(m_process.reader())) {
+        allSuccess &= !run.bytes.empty() && writeProtectedMemory(run.address, run.bytes);
+    }
+    return allSuccess;
 }
 
 // ============================================================================
 // Internal Helpers
 // ============================================================================
 
-DWORD MemoryEditor::findProcessByName(const std::wstring& processName)
+uint32_t MemoryEditor::findProcessByName(const std::wstring& processName)
 {
+    Trace::Span span("findProcessByName", "attach");
+
     HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (snapshot == INVALID_HANDLE_VALUE) {
         m_lastError = "Failed to create process snapshot";
@@ -488,45 +1073,108 @@ uintptr_t MemoryEditor::findPatternAddress(const Patches::Patch& patch)
         return it->second;
     }
 
-    // Scan for pattern in main game module
-    auto result = PatternScanner::findPatternInModule(
-        m_processHandle,
-        L"ffxv_s.exe",
-        patch.pattern
-    );
+    Trace::Span span("findPattern", "scan");
+    span.setDetail(patch.name);
+
+    ScanStats stats;
+    std::optional<uintptr_t> result;
+    {
+        ScanStats::Scope scope(stats);
+        ScanStats::Timer timer;
+        result = locatePattern(patch, stats.method);
+        stats.totalNs = timer.elapsedNs();
+    }
+    stats.name = patch.name;
+    recordScan(std::move(stats));
 
     if (result.has_value()) {
         m_patternCache[patch.name] = result.value();
+        if (m_buildFingerprint && m_moduleBase) {
+            m_buildCache[m_buildFingerprint->hash].patchRvas[patch.name] =
+                static_cast<uint32_t>(result.value() - m_moduleBase);
+        }
         return result.value();
     }
 
     return 0;
 }
 
-bool MemoryEditor::writeProtectedMemory(uintptr_t address, const std::vector<uint8_t>& data)
+/**
+ * @brief Hint, index, near search, then full scan
+ * @param method Set to the step that found the pattern, or "none"
+ */
+std::optional<uintptr_t> MemoryEditor::locatePattern(const Patches::Patch& patch, std::string& method)
 {
-    DWORD oldProtection;
-    if (!setMemoryProtection(address, data.size(), PAGE_EXECUTE_READWRITE, oldProtection)) {
-        m_lastError = "Failed to change memory protection";
-        return false;
+    // The site where the reference build has it: one small read when the
+    // build is unchanged
+    MemoryReader read = statsReader();
+    if (auto site = PatchSite::atHint(read, m_moduleBase, patch)) {
+        method = "hint";
+        return site;
     }
+    std::optional<uintptr_t> hint;
+    if (patch.rvaHint != 0 && m_moduleBase) {
+        hint = m_moduleBase + patch.rvaHint - patch.offset;
+    }
+
+    if (m_patternIndex.isBuilt()) {
+        if (auto candidates = m_patternIndex.candidates(patch.pattern, patch.mask)) {
+            ScanStats::Timer timer;
+            uint64_t verified = 0;
+            for (uint32_t rva : *candidates) {
+                ++verified;
+                if (PatchSite::matches(read, m_moduleBase + rva, patch)) {
+                    ScanStats::recordMatching(verified, timer);
+                    method = "index";
+                    return m_moduleBase + rva;
+                }
+            }
+            ScanStats::recordMatching(verified, timer);
 
-    bool success = writeMemory(address, data);
+            // The index holds every position the pattern can start at, so
+            // neither search below could find anything else
+            method = "none";
+            return std::nullopt;
+        }
+    }
 
-    // Always restore protection
-    DWORD temp;
-    setMemoryProtection(address, data.size(), oldProtection, temp);
+    // A slightly shifted build, or a pattern the index cannot look up:
+    // search outward from the hint before the full scan
+    if (hint.has_value()) {
+        auto result = PatternScanner::findPatternNear(
+            m_process,
+            m_moduleBase,
+            m_moduleSize,
+            hint.value(),
+            patch.pattern,
+            patch.mask
+        );
+        if (result.has_value()) {
+            method = "near";
+            return result;
+        }
+    }
 
-    return success;
+    // Scan the main game module, already located on attach
+    auto result = PatternScanner::findPattern(
+        m_process,
+        m_moduleBase,
+        m_moduleSize,
+        patch.pattern,
+        patch.mask
+    );
+    method = result.has_value() ? "scan" : "none";
+    return result;
 }
 
-bool MemoryEditor::setMemoryProtection(uintptr_t address, size_t size, DWORD newProtection, DWORD& oldProtection)
+bool MemoryEditor::writeProtectedMemory(uintptr_t address, ByteView data)
 {
-    return VirtualProtectEx(
-        m_processHandle,
-        reinterpret_cast<LPVOID>(address),
-        size,
-        newProtection,
-        &oldProtection
-    );
+    Trace::Span span("writeProtectedMemory", "write");
+    span.setArg("bytes", static_cast<int64_t>(data.size));
+
+    if (!m_process.writeProtected(address, data)) {
+        m_lastError = "Failed to write memory. Error: " + std::to_string(m_process.lastError());
+        return false;
+    }
+    return true;
 }
@@ -0,0 +1,329 @@
+/**
+ * @file NgramIndex.cpp
+ * @brief 4-byte n-gram index over a module image
+ */
+
+#include "NgramIndex.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+size_t varintSize(uint32_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+uint8_t* writeVarint(uint8_t* out, uint32_t value)
+{
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+/// Walks one posting list; positions come out ascending
+class PostingCursor {
+public:
+    PostingCursor(const uint8_t* begin, const uint8_t* end) : m_p(begin), m_end(end) { next(); }
+
+    bool valid() const { return m_valid; }
+    uint32_t value() const { return m_value; }
+
+    void next()
+    {
+        uint32_t gap = 0;
+        for (unsigned shift = 0; m_p < m_end && shift < 32; shift += 7) {
+            uint8_t byte = *m_p++;
+            gap |= uint32_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                m_value += gap;
+                return;
+            }
+        }
+        m_valid = false;  // End of list, or a truncated/over-long varint in a damaged file
+    }
+
+private:
+    const uint8_t* m_p;
+    const uint8_t* m_end;
+    uint32_t m_value = 0;
+    bool m_valid = true;
+};
+
+} // namespace
+
+uint32_t NgramIndex::bucketOf(const uint8_t* gram)
+{
+    uint32_t value;
+    std::memcpy(&value, gram, sizeof(value));
+    return (value * 0x9E3779B1u) >> (32 - BUCKET_BITS);  // Fibonacci hashing
+}
+
+bool NgramIndex::fail(const std::string& error)
+{
+    clear();
+    m_lastError = error;
+    return false;
+}
+
+bool NgramIndex::build(const uint8_t* image, size_t size)
+{
+    clear();
+    if (!image || size < GRAM_SIZE || size > std::numeric_limits<uint32_t>::max()) {
+        return fail("Image size out of range");
+    }
+
+    size_t positions = size - GRAM_SIZE + 1;
+    std::vector<uint32_t> previous(BUCKET_COUNT, 0);
+
+    // Sizing pass: bytes each bucket's gap list will take
+    std::vector<uint64_t> bytes(BUCKET_COUNT + 1, 0);
+    for (size_t i = 0; i < positions; ++i) {
+        uint32_t bucket = bucketOf(image + i);
+        bytes[bucket + 1] += varintSize(static_cast<uint32_t>(i) - previous[bucket]);
+        previous[bucket] = static_cast<uint32_t>(i);
+    }
+    for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+        bytes[b + 1] += bytes[b];
+    }
+    if (bytes[BUCKET_COUNT] > std::numeric_limits<uint32_t>::max()) {
+        return fail("Posting lists exceed 4 GB");
+    }
+
+    // Encoding pass in image order keeps each list ascending
+    m_ownedOffsets.assign(bytes.begin(), bytes.end());
+    m_ownedPostings.resize(bytes[BUCKET_COUNT]);
+    std::vector<uint8_t*> cursor(BUCKET_COUNT);
+    for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+        cursor[b] = m_ownedPostings.data() + m_ownedOffsets[b];
+    }
+    std::fill(previous.begin(), previous.end(), 0);
+    for (size_t i = 0; i < positions; ++i) {
+        uint32_t bucket = bucketOf(image + i);
+        cursor[bucket] = writeVarint(cursor[bucket], static_cast<uint32_t>(i) - previous[bucket]);
+        previous[bucket] = static_cast<uint32_t>(i);
+    }
+
+    m_image = image;
+    m_size = size;
+    m_bucketOffsets = m_ownedOffsets.data();
+    m_postings = m_ownedPostings.data();
+    m_postingsSize = m_ownedPostings.size();
+    m_positionCount = positions;
+    return true;
+}
+
+void NgramIndex::clear()
+{
+    m_image = nullptr;
+    m_size = 0;
+    m_bucketOffsets = nullptr;
+    m_postings = nullptr;
+    m_postingsSize = 0;
+    m_positionCount = 0;
+    m_ownedOffsets = std::vector<uint32_t>();
+    m_ownedPostings = std::vector<uint8_t>();
+    m_file.close();
+}
+
+// ============================================================================
+// Persistence
+// ============================================================================
+
+bool NgramIndex::save(const std::string& path, uint64_t fingerprint) const
+{
+    if (!isBuilt()) return false;
+
+    Ngram::FileHeader header = {};
+    std::memcpy(header.magic, Ngram::MAGIC, sizeof(header.magic));
+    header.formatVersion = Ngram::FORMAT_VERSION;
+    header.gramSize = static_cast<uint8_t>(GRAM_SIZE);
+    header.bucketBits = static_cast<uint8_t>(BUCKET_BITS);
+    header.fingerprintLow = static_cast<uint32_t>(fingerprint);
+    header.fingerprintHigh = static_cast<uint32_t>(fingerprint >> 32);
+    header.imageSize = static_cast<uint32_t>(m_size);
+    header.postingsSize = static_cast<uint32_t>(m_postingsSize);
+    header.positionCount = static_cast<uint32_t>(m_positionCount);
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(m_bucketOffsets), (BUCKET_COUNT + 1) * sizeof(uint32_t));
+    output.write(reinterpret_cast<const char*>(m_postings), m_postingsSize);
+    output.close();
+    if (!output) {
+        std::remove(path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool NgramIndex::load(const std::string& path, uint64_t fingerprint, size_t imageSize, const uint8_t* image)
+{
+    clear();
+    MappedFile file;
+    if (!file.open(path)) {
+        return fail(file.getLastError());
+    }
+
+    constexpr size_t TABLE_SIZE = (BUCKET_COUNT + 1) * sizeof(uint32_t);
+    if (file.size() < sizeof(Ngram::FileHeader) + TABLE_SIZE) {
+        return fail("Index file truncated");
+    }
+
+    Ngram::FileHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    uint64_t fileFingerprint = (uint64_t(header.fingerprintHigh) << 32) | header.fingerprintLow;
+    if (std::memcmp(header.magic, Ngram::MAGIC, sizeof(header.magic)) != 0 ||
+        header.formatVersion != Ngram::FORMAT_VERSION ||
+        header.gramSize != GRAM_SIZE || header.bucketBits != BUCKET_BITS) {
+        return fail("Not a compatible index file");
+    }
+    if (fileFingerprint != fingerprint || header.imageSize != imageSize) {
+        return fail("Index was built for another build");
+    }
+    if (file.size() - sizeof(header) - TABLE_SIZE != header.postingsSize) {
+        return fail("Index file size does not match its header");
+    }
+
+    // Offsets must be monotonic and end exactly at the end of the postings
+    const auto* offsets = reinterpret_cast<const uint32_t*>(file.data() + sizeof(header));
+    if (offsets[0] != 0 || offsets[BUCKET_COUNT] != header.postingsSize) {
+        return fail("Index bucket table is corrupt");
+    }
+    for (size_t b = 0; b < BUCKET_COUNT; ++b) {
+        if (offsets[b + 1] < offsets[b]) return fail("Index bucket table is corrupt");
+    }
+
+    m_file = std::move(file);
+    m_image = image;
+    m_size = imageSize;
+    m_bucketOffsets = offsets;
+    m_postings = m_file.data() + sizeof(header) + TABLE_SIZE;
+    m_postingsSize = header.postingsSize;
+    m_positionCount = header.positionCount;
+    return true;
+}
+
+// ============================================================================
+// Queries
+// ============================================================================
+
+std::vector<uint32_t> NgramIndex::decodeBucket(uint32_t bucket) const
+{
+    std::vector<uint32_t> positions;
+    for (PostingCursor cursor(m_postings + m_bucketOffsets[bucket], m_postings + m_bucketOffsets[bucket + 1]);
+         cursor.valid(); cursor.next()) {
+        positions.push_back(cursor.value());
+    }
+    return positions;
+}
+
+bool NgramIndex::matchAt(size_t offset, ByteView pattern, ByteView mask) const
+{
+    if (offset + pattern.size > m_size) return false;
+
+    const uint8_t* data = m_image + offset;
+    if (mask.empty()) {
+        return std::memcmp(data, pattern.data, pattern.size) == 0;
+    }
+    for (size_t i = 0; i < pattern.size; ++i) {
+        if ((data[i] & mask[i]) != (pattern[i] & mask[i])) return false;
+    }
+    return true;
+}
+
+std::optional<std::vector<uint32_t>> NgramIndex::candidates(ByteView pattern, ByteView mask) const
+{
+    if (!isBuilt() || pattern.size < GRAM_SIZE) return std::nullopt;
+    if (!mask.empty() && mask.size != pattern.size) return std::nullopt;
+
+    struct Window {
+        uint32_t offset;
+        uint32_t bucket;
+        uint32_t bytes;    ///< Encoded list size, a cheap stand-in for its length
+    };
+    std::vector<Window> windows;
+    for (size_t i = 0; i + GRAM_SIZE <= pattern.size; ++i) {
+        bool fixed = mask.empty() || (mask[i] == 0xFF && mask[i + 1] == 0xFF &&
+                                      mask[i + 2] == 0xFF && mask[i + 3] == 0xFF);
+        if (!fixed) continue;
+
+        uint32_t bucket = bucketOf(pattern.data + i);
+        windows.push_back({static_cast<uint32_t>(i), bucket, m_bucketOffsets[bucket + 1] - m_bucketOffsets[bucket]});
+    }
+    if (windows.empty()) return std::nullopt;
+    std::stable_sort(windows.begin(), windows.end(),
+                     [](const Window& a, const Window& b) { return a.bytes < b.bytes; });
+
+    // Starts from the rarest list
+    std::vector<uint32_t> starts;
+    for (uint32_t position : decodeBucket(windows[0].bucket)) {
+        if (position >= windows[0].offset && position - windows[0].offset + pattern.size <= m_size) {
+            starts.push_back(position - windows[0].offset);
+        }
+    }
+
+    // Each further list keeps the starts s with s + offset in it. A list much
+    // longer than the surviving starts costs more to decode than verifying them.
+    size_t lists = std::min(windows.size(), MAX_INTERSECTED_LISTS);
+    for (size_t k = 1; k < lists && starts.size() > 1; ++k) {
+        const Window& window = windows[k];
+        if (window.bytes > starts.size() * 64) break;
+
+        PostingCursor cursor(m_postings + m_bucketOffsets[window.bucket],
+                             m_postings + m_bucketOffsets[window.bucket + 1]);
+        size_t kept = 0;
+        for (uint32_t start : starts) {
+            uint64_t target = uint64_t(start) + window.offset;
+            while (cursor.valid() && cursor.value() < target) cursor.next();
+            if (!cursor.valid()) break;
+            if (cursor.value() == target) starts[kept++] = start;
+        }
+        starts.resize(kept);
+    }
+    return starts;
+}
+
+std::vector<uint32_t> NgramIndex::find(ByteView pattern, ByteView mask, size_t limit) const
+{
+    std::vector<uint32_t> matches;
+    if (!isBuilt() || !m_image || pattern.empty() || pattern.size > m_size) return matches;
+    if (!mask.empty() && mask.size != pattern.size) return matches;
+
+    auto starts = candidates(pattern, mask);
+    if (!starts) {
+        // Nothing to look up; scan the image
+        for (size_t i = 0; i + pattern.size <= m_size; ++i) {
+            if (matchAt(i, pattern, mask)) {
+                matches.push_back(static_cast<uint32_t>(i));
+                if (limit && matches.size() == limit) break;
+            }
+        }
+        return matches;
+    }
+
+    for (uint32_t start : *starts) {
+        if (matchAt(start, pattern, mask)) {
+            matches.push_back(start);
+            if (limit && matches.size() == limit) break;
+        }
+    }
+    return matches;
+}
+
+size_t NgramIndex::count(ByteView pattern, ByteView mask, size_t limit) const
+{
+    return find(pattern, mask, limit).size();
+}
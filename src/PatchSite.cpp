@@ -0,0 +1,55 @@
+/**
+ * @file PatchSite.cpp
+ * @brief Checks on a located patch site, through any MemoryReader
+ */
+
+#include "PatchSite.h"
+#include "ScanEngine.h"
+#include "X86Length.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace PatchSite {
+
+bool matches(const MemoryReader& read, uintptr_t match, const Patches::Patch& patch)
+{
+    std::vector<uint8_t> actual(patch.pattern.size);
+    if (read(match, actual.data(), actual.size()) != actual.size()) return false;
+    if (Scan::matchAt(actual.data(), actual.size(), patch.pattern, patch.mask, 0)) return true;
+
+    if (patch.offset < 0 || size_t(patch.offset) + patch.patched.size > actual.size()) return false;
+    std::vector<uint8_t> expected = patch.pattern.toVector();
+    std::copy(patch.patched.begin(), patch.patched.end(), expected.begin() + patch.offset);
+    return Scan::matchAt(actual.data(), actual.size(), expected, patch.mask, 0);
+}
+
+std::optional<uintptr_t> atHint(const MemoryReader& read, uintptr_t moduleBase, const Patches::Patch& patch)
+{
+    if (patch.rvaHint == 0 || moduleBase == 0) return std::nullopt;
+    uintptr_t match = moduleBase + patch.rvaHint - patch.offset;
+    if (!matches(read, match, patch)) return std::nullopt;
+    return match;
+}
+
+bool onBoundaries(const MemoryReader& read, uintptr_t match, const Patches::Patch& patch)
+{
+    if (patch.section != Patches::SectionHint::Text) return true;
+    if (!X86::isWholeInstructions(patch.patched.data, patch.patched.size)) return false;
+
+    ptrdiff_t first = std::min<ptrdiff_t>(patch.offset, 0);
+    ptrdiff_t last = std::max<ptrdiff_t>(ptrdiff_t(patch.pattern.size), patch.offset + ptrdiff_t(patch.patched.size));
+    std::vector<uint8_t> code(size_t(last - first));
+    if (read(match + first, code.data(), code.size()) != code.size()) return false;
+
+    // Decoding starts at whichever comes first, the patch or the match
+    size_t patchStart = size_t(patch.offset - first);
+    auto site = code.begin() + patchStart;
+    if (patch.original.size == patch.patched.size && std::equal(patch.patched.begin(), patch.patched.end(), site)) {
+        std::copy(patch.original.begin(), patch.original.end(), site);
+    }
+    return X86::onBoundaries(code.data(), code.size(),
+                             {size_t(-first), patchStart, patchStart + patch.patched.size});
+}
+
+} // namespace PatchSite
@@ -1,38 +1,147 @@
 #include "PatternScanner.h"
+#include "ScanEngine.h"
+#include "ScanStats.h"
+#include "Trace.h"
 #include <Psapi.h>
 #include <algorithm>
+#include <cstring>
 
 std::optional<uintptr_t> PatternScanner::findPattern(
-    HANDLE processHandle,
+    const WindowsBackend& process,
     uintptr_t startAddress,
     size_t searchSize,
-    const std::vector<uint8_t>& pattern)
+    ByteView pattern,
+    ByteView mask)
 {
-    if (!processHandle || pattern.empty()) {
+    if (!process.isOpen()) {
         return std::nullopt;
     }
 
-    // Read memory in chunks to avoid large allocations
-    constexpr size_t CHUNK_SIZE = 0x10000; // 64KB chunks
-    std::vector<uint8_t> buffer(CHUNK_SIZE + pattern.size());
+    return Scan::findPattern(process.reader(), startAddress, searchSize, pattern, mask);
+}
+
+std::vector<Fuzzy::Match> PatternScanner::findPatternFuzzy(
+    const WindowsBackend& process,
+    uintptr_t startAddress,
+    size_t searchSize,
+    ByteView pattern,
+    ByteView mask,
+    unsigned maxDistance,
+    size_t limit)
+{
+    std::vector<Fuzzy::Match> matches;
+    if (!process.isOpen() || pattern.empty() || pattern.size > Fuzzy::MAX_PATTERN_LENGTH) {
+        return matches;
+    }
+    if (!mask.empty() && mask.size != pattern.size) {
+        return matches;
+    }
+
+    // Larger chunks than findPattern, as each search rebuilds its byte table.
+    // A chunk keeps only the windows starting inside it, so the overlap does
+    // not report a match twice
+    constexpr size_t CHUNK_SIZE = 0x100000; // 1MB chunks
+    std::vector<uint8_t> buffer(CHUNK_SIZE + pattern.size - 1);
 
     for (size_t offset = 0; offset < searchSize; offset += CHUNK_SIZE) {
-        size_t bytesToRead = std::min(CHUNK_SIZE + pattern.size(), searchSize - offset);
-
-        SIZE_T bytesRead = 0;
-        if (!ReadProcessMemory(processHandle,
-                               reinterpret_cast<LPCVOID>(startAddress + offset),
-                               buffer.data(),
-                               bytesToRead,
-                               &bytesRead)) {
+        Trace::Span span("fuzzy chunk", "scan");
+        span.setArg("chunk", static_cast<int64_t>(offset / CHUNK_SIZE));
+        size_t bytesToRead = std::min(CHUNK_SIZE + pattern.size - 1, searchSize - offset);
+
+        ScanStats::Timer readTimer;
+        size_t bytesRead = process.read(startAddress + offset, buffer.data(), bytesToRead);
+        ScanStats::recordRead(bytesToRead, bytesRead, bytesRead != 0, readTimer);
+        if (bytesRead == 0) {
             continue; // Skip unreadable regions
         }
 
-        // Search for pattern in this chunk
-        for (size_t i = 0; i + pattern.size() <= bytesRead; ++i) {
-            if (matchPattern(buffer.data(), bytesRead, pattern, i)) {
-                return startAddress + offset + i;
+        ScanStats::Timer matchTimer;
+        size_t found = matches.size();
+        for (Fuzzy::Match& match : Fuzzy::search(buffer.data(), bytesRead, pattern, mask, maxDistance)) {
+            if (match.offset >= CHUNK_SIZE) break;
+            match.offset += offset;
+            matches.push_back(std::move(match));
+        }
+        ScanStats::recordMatching(matches.size() - found, matchTimer);
+        if (found == 0 && !matches.empty()) {
+            ScanStats::recordMatchedChunk(static_cast<int64_t>(offset / CHUNK_SIZE));
+        }
+    }
+
+    Fuzzy::rank(matches, limit);
+    return matches;
+}
+
+std::optional<uintptr_t> PatternScanner::findPatternNear(
+    const WindowsBackend& process,
+    uintptr_t startAddress,
+    size_t searchSize,
+    uintptr_t hintAddress,
+    ByteView pattern,
+    ByteView mask,
+    size_t maxRadius)
+{
+    if (!process.isOpen() || pattern.empty() || searchSize < pattern.size) {
+        return std::nullopt;
+    }
+    if (!mask.empty() && mask.size != pattern.size) {
+        return std::nullopt;
+    }
+
+    // Match starts are kept within [first, last]
+    uintptr_t first = startAddress;
+    uintptr_t last = startAddress + searchSize - pattern.size;
+    if (hintAddress < first || hintAddress > last) {
+        return std::nullopt;
+    }
+
+    // Unchanged build: one read of the pattern size
+    std::vector<uint8_t> bytes = readMemory(process, hintAddress, pattern.size);
+    if (Scan::matchAt(bytes.data(), bytes.size(), pattern, mask, 0)) {
+        return hintAddress;
+    }
+
+    // Each round covers the match starts in [hint - radius, hint - inner) and
+    // [hint + inner, hint + radius), where inner is the previous radius. The
+    // match nearest the hint in a round wins; the left side is read with the
+    // pattern overlapping into the inner window so no start is missed
+    int64_t round = 0;
+    for (size_t inner = 0, radius = NEAR_FIRST_RADIUS; inner < maxRadius; inner = radius, radius *= 2, ++round) {
+        Trace::Span span("near ring", "scan");
+        span.setArg("ring", round);
+        radius = std::min(radius, maxRadius);
+        std::optional<uintptr_t> left, right;
+
+        if (hintAddress - first > inner) {
+            uintptr_t begin = hintAddress - std::min<uintptr_t>(radius, hintAddress - first);
+            uintptr_t end = hintAddress - inner;  // Exclusive, in match starts
+            bytes = readMemory(process, begin, end - begin + pattern.size - 1);
+            ScanStats::Timer matchTimer;
+            for (size_t i = end - begin; i-- > 0;) {
+                if (Scan::matchAt(bytes.data(), bytes.size(), pattern, mask, i)) {
+                    left = begin + i;
+                    break;
+                }
             }
+            ScanStats::recordMatching(0, matchTimer);
+        }
+        if (last - hintAddress > inner) {
+            uintptr_t begin = hintAddress + inner + 1;
+            uintptr_t end = hintAddress + std::min<uintptr_t>(radius, last - hintAddress) + 1;
+            right = findPattern(process, begin, end - begin + pattern.size - 1, pattern, mask);
+        }
+
+        if (left || right) {
+            ScanStats::recordMatchedChunk(round);
+        }
+        if (left && right) {
+            return hintAddress - *left <= *right - hintAddress ? left : right;
+        }
+        if (left || right) {
+            return left ? left : right;
+        }
+        if (hintAddress - first <= radius && last - hintAddress <= radius) {
+            break;  // Whole range covered
         }
     }
 
@@ -40,18 +149,31 @@ std::optional<uintptr_t> PatternScanner::findPattern(
 }
 
 std::optional<uintptr_t> PatternScanner::findPatternInModule(
-    HANDLE processHandle,
+    const WindowsBackend& process,
     const wchar_t* moduleName,
-    const std::vector<uint8_t>& pattern)
+    ByteView pattern,
+    ByteView mask)
 {
     uintptr_t baseAddress = 0;
     size_t moduleSize = 0;
 
-    if (!getModuleInfo(processHandle, moduleName, baseAddress, moduleSize)) {
+    if (!getModuleInfo(process.handle(), moduleName, baseAddress, moduleSize)) {
         return std::nullopt;
     }
 
-    return findPattern(processHandle, baseAddress, moduleSize, pattern);
+    return findPattern(process, baseAddress, moduleSize, pattern, mask);
+}
+
+std::optional<uintptr_t> PatternScanner::resolveReference(
+    const WindowsBackend& process,
+    uintptr_t moduleBase,
+    size_t moduleSize,
+    const Patches::OperandReference& reference)
+{
+    if (!process.isOpen()) {
+        return std::nullopt;
+    }
+    return Scan::resolveReference(process.reader(), moduleBase, moduleSize, reference);
 }
 
 bool PatternScanner::getModuleInfo(
@@ -60,10 +182,13 @@ bool PatternScanner::getModuleInfo(
     uintptr_t& baseAddress,
     size_t& moduleSize)
 {
+    Trace::Span span("getModuleInfo", "attach");
+    ScanStats::Timer timer;
     HMODULE modules[1024];
     DWORD cbNeeded;
 
     if (!EnumProcessModulesEx(processHandle, modules, sizeof(modules), &cbNeeded, LIST_MODULES_ALL)) {
+        ScanStats::recordEnumeration(timer);
         return false;
     }
 
@@ -77,51 +202,28 @@ bool PatternScanner::getModuleInfo(
                 if (GetModuleInformation(processHandle, modules[i], &modInfo, sizeof(modInfo))) {
                     baseAddress = reinterpret_cast<uintptr_t>(modInfo.lpBaseOfDll);
                     moduleSize = modInfo.SizeOfImage;
+                    ScanStats::recordEnumeration(timer);
                     return true;
                 }
             }
         }
     }
 
+    ScanStats::recordEnumeration(timer);
     return false;
 }
 
 std::vector<uint8_t> PatternScanner::readMemory(
-    HANDLE processHandle,
+    const WindowsBackend& process,
     uintptr_t address,
     size_t size)
 {
     std::vector<uint8_t> buffer(size);
-    SIZE_T bytesRead = 0;
-
-    if (ReadProcessMemory(processHandle,
-                          reinterpret_cast<LPCVOID>(address),
-                          buffer.data(),
-                          size,
-                          &bytesRead)) {
-        buffer.resize(bytesRead);
-    } else {
-        buffer.clear();
-    }
 
-    return buffer;
-}
+    ScanStats::Timer timer;
+    size_t bytesRead = process.read(address, buffer.data(), size);
+    ScanStats::recordRead(size, bytesRead, bytesRead != 0, timer);
+    buffer.resize(bytesRead);
 
-bool PatternScanner::matchPattern(
-    const uint8_t* data,
-    size_t dataSize,
-    const std::vector<uint8_t>& pattern,
-    size_t offset)
-{
-    if (offset + pattern.size() > dataSize) {
-        return false;
-    }
-
-    for (size_t i = 0; i < pattern.size(); ++i) {
-        if (data[offset + i] != pattern[i]) {
-            return false;
-        }
-    }
-
-    return true;
+    return buffer;
 }
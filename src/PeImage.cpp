@@ -0,0 +1,136 @@
+/**
+ * @file PeImage.cpp
+ * @brief Minimal PE32+ header parsing
+ */
+
+#include "PeImage.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+template <typename T>
+T readField(const uint8_t* data, size_t offset)
+{
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+
+constexpr uint16_t DOS_MAGIC = 0x5A4D;          // "MZ"
+constexpr uint32_t NT_SIGNATURE = 0x00004550;   // "PE\0\0"
+constexpr uint16_t PE32PLUS_MAGIC = 0x020B;
+constexpr size_t FILE_HEADER_SIZE = 20;
+constexpr size_t SECTION_HEADER_SIZE = 40;
+
+} // namespace
+
+namespace Pe {
+
+bool parseHeaders(const uint8_t* data, size_t size, Headers& headers)
+{
+    if (!data || size < 0x40 || readField<uint16_t>(data, 0) != DOS_MAGIC) {
+        return false;
+    }
+
+    uint32_t ntOffset = readField<uint32_t>(data, 0x3C);
+    if (ntOffset > size || size - ntOffset < 4 + FILE_HEADER_SIZE ||
+        readField<uint32_t>(data, ntOffset) != NT_SIGNATURE) {
+        return false;
+    }
+
+    size_t fileHeader = ntOffset + 4;
+    headers.machine = readField<uint16_t>(data, fileHeader + 0);
+    uint16_t sectionCount = readField<uint16_t>(data, fileHeader + 2);
+    headers.timeDateStamp = readField<uint32_t>(data, fileHeader + 4);
+    uint16_t optionalSize = readField<uint16_t>(data, fileHeader + 16);
+
+    size_t optional = fileHeader + FILE_HEADER_SIZE;
+    if (optionalSize < 72 || size - optional < optionalSize ||
+        readField<uint16_t>(data, optional) != PE32PLUS_MAGIC) {
+        return false;
+    }
+
+    headers.entryPoint = readField<uint32_t>(data, optional + 16);
+    headers.imageBaseOffset = optional + 24;
+    headers.imageBase = readField<uint64_t>(data, optional + 24);
+    headers.sizeOfImage = readField<uint32_t>(data, optional + 56);
+    headers.sizeOfHeaders = readField<uint32_t>(data, optional + 60);
+    headers.checkSum = readField<uint32_t>(data, optional + 64);
+
+    // Data directories follow NumberOfRvaAndSizes; entry 3 is the exception table
+    constexpr size_t DATA_DIRECTORIES = 112;
+    constexpr uint32_t EXCEPTION_DIRECTORY = 3;
+    uint32_t directoryCount = optionalSize >= DATA_DIRECTORIES ? readField<uint32_t>(data, optional + 108) : 0;
+    headers.exceptionTableRva = 0;
+    headers.exceptionTableSize = 0;
+    if (directoryCount > EXCEPTION_DIRECTORY &&
+        optionalSize >= DATA_DIRECTORIES + (EXCEPTION_DIRECTORY + 1) * 8) {
+        headers.exceptionTableRva = readField<uint32_t>(data, optional + DATA_DIRECTORIES + EXCEPTION_DIRECTORY * 8);
+        headers.exceptionTableSize = readField<uint32_t>(data, optional + DATA_DIRECTORIES + EXCEPTION_DIRECTORY * 8 + 4);
+    }
+
+    size_t sectionTable = optional + optionalSize;
+    if (sectionTable > size || (size - sectionTable) / SECTION_HEADER_SIZE < sectionCount) {
+        return false;
+    }
+
+    headers.sections.clear();
+    headers.sections.reserve(sectionCount);
+    for (uint16_t i = 0; i < sectionCount; ++i) {
+        const uint8_t* entry = data + sectionTable + i * SECTION_HEADER_SIZE;
+        Section section;
+        section.name.assign(reinterpret_cast<const char*>(entry), strnlen(reinterpret_cast<const char*>(entry), 8));
+        section.virtualSize = readField<uint32_t>(entry, 8);
+        section.virtualAddress = readField<uint32_t>(entry, 12);
+        section.rawSize = readField<uint32_t>(entry, 16);
+        section.rawOffset = readField<uint32_t>(entry, 20);
+        section.characteristics = readField<uint32_t>(entry, 36);
+        headers.sections.push_back(std::move(section));
+    }
+
+    return true;
+}
+
+bool mapImage(const uint8_t* file, size_t fileSize, std::vector<uint8_t>& image)
+{
+    Headers headers;
+    if (!parseHeaders(file, fileSize, headers) || headers.sizeOfHeaders > fileSize ||
+        headers.sizeOfHeaders > headers.sizeOfImage) {
+        return false;
+    }
+
+    image.assign(headers.sizeOfImage, 0);
+    std::memcpy(image.data(), file, headers.sizeOfHeaders);
+
+    for (const auto& section : headers.sections) {
+        // The loader maps at most VirtualSize bytes; the tail of the raw data is file alignment padding
+        size_t length = std::min<size_t>(section.rawSize, section.virtualSize ? section.virtualSize : section.rawSize);
+        if (length == 0) continue;
+        if (section.rawOffset > fileSize || fileSize - section.rawOffset < length ||
+            section.virtualAddress > image.size() || image.size() - section.virtualAddress < length) {
+            return false;
+        }
+        std::memcpy(image.data() + section.virtualAddress, file + section.rawOffset, length);
+    }
+    return true;
+}
+
+const Section* Headers::findSection(const std::string& name) const
+{
+    for (const auto& section : sections) {
+        if (section.name == name) return &section;
+    }
+    return nullptr;
+}
+
+const Section* Headers::sectionForRva(uint32_t rva) const
+{
+    for (const auto& section : sections) {
+        if (section.contains(rva)) return &section;
+    }
+    return nullptr;
+}
+
+} // namespace Pe
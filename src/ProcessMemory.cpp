@@ -0,0 +1,183 @@
+/**
+ * @file ProcessMemory.cpp
+ * @brief Live process memory on Linux via /proc and process_vm_readv
+ */
+
+#include "ProcessMemory.h"
+#include "ScanEngine.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <fstream>
+#include <sstream>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t PAGE_SIZE = 0x1000;
+
+std::string readLine(const std::string& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+/// "/memfd:ffxv_s.exe (deleted)" -> "ffxv_s.exe"
+std::string moduleName(std::string path)
+{
+    const std::string deleted = " (deleted)";
+    if (path.size() > deleted.size() && path.compare(path.size() - deleted.size(), deleted.size(), deleted) == 0) {
+        path.resize(path.size() - deleted.size());
+    }
+    size_t slash = path.find_last_of('/');
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+    if (name.compare(0, 6, "memfd:") == 0) name.erase(0, 6);
+    return name;
+}
+
+} // namespace
+
+ProcessMemory::~ProcessMemory()
+{
+    detach();
+}
+
+bool ProcessMemory::attach(int pid)
+{
+    detach();
+    std::string path = "/proc/" + std::to_string(pid) + "/mem";
+    m_memFd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (m_memFd < 0) {
+        return fail("Cannot open " + path + ": " + std::strerror(errno));
+    }
+    m_pid = pid;
+    return true;
+}
+
+bool ProcessMemory::attachByName(const std::string& name)
+{
+    DIR* proc = opendir("/proc");
+    if (!proc) {
+        return fail("Cannot list /proc");
+    }
+    int found = 0;
+    while (dirent* entry = readdir(proc)) {
+        int pid = std::atoi(entry->d_name);
+        if (pid <= 0) continue;
+        if (readLine("/proc/" + std::to_string(pid) + "/comm") == name.substr(0, 15)) {
+            found = pid;
+            break;
+        }
+    }
+    closedir(proc);
+    if (!found) {
+        return fail("Process not found: " + name);
+    }
+    return attach(found);
+}
+
+void ProcessMemory::detach()
+{
+    if (m_memFd >= 0) ::close(m_memFd);
+    m_memFd = -1;
+    m_pid = 0;
+}
+
+std::vector<ProcessMemory::Module> ProcessMemory::modules()
+{
+    std::vector<Module> modules;
+    std::ifstream maps("/proc/" + std::to_string(m_pid) + "/maps");
+    if (!maps) {
+        fail("Cannot read the memory map of process " + std::to_string(m_pid));
+        return modules;
+    }
+
+    // address perms offset dev inode path; mappings of one file are adjacent
+    std::string line;
+    while (std::getline(maps, line)) {
+        std::istringstream fields(line);
+        std::string range, perms, offset, device, path;
+        unsigned long inode = 0;
+        fields >> range >> perms >> offset >> device >> inode;
+        std::getline(fields >> std::ws, path);
+        if (inode == 0 || path.empty()) continue;
+
+        size_t dash = range.find('-');
+        uint64_t begin = std::stoull(range.substr(0, dash), nullptr, 16);
+        uint64_t end = std::stoull(range.substr(dash + 1), nullptr, 16);
+        std::string name = moduleName(path);
+        if (!modules.empty() && modules.back().name == name) {
+            modules.back().size = end - modules.back().base;
+        } else {
+            modules.push_back({begin, end - begin, name});
+        }
+    }
+    return modules;
+}
+
+std::optional<ProcessMemory::Module> ProcessMemory::findModule(const std::string& name)
+{
+    for (const Module& module : modules()) {
+        if (module.name == name) return module;
+    }
+    return std::nullopt;
+}
+
+size_t ProcessMemory::read(uintptr_t address, void* buffer, size_t size) const
+{
+    if (m_pid <= 0 || size == 0) return 0;
+    iovec local = {buffer, size};
+    iovec remote = {reinterpret_cast<void*>(address), size};
+    ssize_t got = process_vm_readv(m_pid, &local, 1, &remote, 1, 0);
+    if (got == static_cast<ssize_t>(size)) return size;
+
+    // A partial read stops at the first bad page; retry page by page up to it
+    size_t done = got > 0 ? size_t(got) : 0;
+    while (done < size) {
+        size_t step = std::min(size - done, PAGE_SIZE - (address + done) % PAGE_SIZE);
+        local = {static_cast<uint8_t*>(buffer) + done, step};
+        remote = {reinterpret_cast<void*>(address + done), step};
+        if (process_vm_readv(m_pid, &local, 1, &remote, 1, 0) != static_cast<ssize_t>(step)) break;
+        done += step;
+    }
+    return done;
+}
+
+bool ProcessMemory::write(uint64_t address, const void* data, size_t size)
+{
+    if (m_memFd < 0) {
+        return fail("Not attached");
+    }
+    ssize_t written = pwrite(m_memFd, data, size, static_cast<off_t>(address));
+    if (written != static_cast<ssize_t>(size)) {
+        char where[32];
+        std::snprintf(where, sizeof(where), "0x%llX", static_cast<unsigned long long>(address));
+        return fail(std::string("Write failed at ") + where + ": " + std::strerror(errno));
+    }
+    return true;
+}
+
+bool ProcessMemory::writeProtected(uintptr_t address, ByteView data)
+{
+    return write(address, data.data, data.size);
+}
+
+std::optional<uint64_t> ProcessMemory::findPattern(uint64_t start, uint64_t size, ByteView pattern,
+                                                   ByteView mask) const
+{
+    return Scan::findPattern(reader(), static_cast<uintptr_t>(start), static_cast<size_t>(size), pattern, mask);
+}
+
+bool ProcessMemory::fail(const std::string& error)
+{
+    m_lastError = error;
+    return false;
+}
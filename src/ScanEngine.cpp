@@ -0,0 +1,227 @@
+/**
+ * @file ScanEngine.cpp
+ * @brief Platform-neutral pattern matching over buffers and MemoryReaders
+ */
+
+#include "ScanEngine.h"
+#include "ScanStats.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+bool isValid(ByteView pattern, ByteView mask)
+{
+    return !pattern.empty() && (mask.empty() || mask.size == pattern.size);
+}
+
+/// First match at or after offset 0; counts the offsets compared in full
+std::optional<size_t> search(const uint8_t* data, size_t size, ByteView pattern, ByteView mask, size_t anchor,
+                             uint64_t& candidates)
+{
+    if (size < pattern.size) {
+        return std::nullopt;
+    }
+    size_t starts = size - pattern.size + 1;
+
+    if (anchor == pattern.size) {
+        for (size_t i = 0; i < starts; ++i) {
+            ++candidates;
+            if (Scan::matchAt(data, size, pattern, mask, i)) return i;
+        }
+        return std::nullopt;
+    }
+
+    const uint8_t value = pattern[anchor];
+    const uint8_t* from = data + anchor;
+    const uint8_t* end = from + starts;
+    while (from < end) {
+        auto hit = static_cast<const uint8_t*>(std::memchr(from, value, static_cast<size_t>(end - from)));
+        if (!hit) break;
+        size_t i = static_cast<size_t>(hit - data) - anchor;
+        ++candidates;
+        if (Scan::matchAt(data, size, pattern, mask, i)) return i;
+        from = hit + 1;
+    }
+    return std::nullopt;
+}
+
+} // namespace
+
+namespace Scan {
+
+bool matchAt(const uint8_t* data, size_t size, ByteView pattern, ByteView mask, size_t offset)
+{
+    if (offset > size || pattern.size > size - offset) {
+        return false;
+    }
+
+    const uint8_t* at = data + offset;
+    if (mask.empty()) {
+        return std::memcmp(at, pattern.data, pattern.size) == 0;
+    }
+    for (size_t i = 0; i < pattern.size; ++i) {
+        if ((at[i] & mask[i]) != (pattern[i] & mask[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t anchorIndex(ByteView pattern, ByteView mask)
+{
+    if (mask.empty()) {
+        return 0;
+    }
+    for (size_t i = 0; i < pattern.size; ++i) {
+        if (mask[i] == 0xFF) return i;
+    }
+    return pattern.size;
+}
+
+std::optional<size_t> findInBuffer(const uint8_t* data, size_t size, ByteView pattern, ByteView mask)
+{
+    if (!isValid(pattern, mask)) {
+        return std::nullopt;
+    }
+    uint64_t candidates = 0;
+    return search(data, size, pattern, mask, anchorIndex(pattern, mask), candidates);
+}
+
+std::optional<uintptr_t> findPattern(const MemoryReader& read, uintptr_t start, size_t size, ByteView pattern,
+                                     ByteView mask)
+{
+    if (!isValid(pattern, mask)) {
+        return std::nullopt;
+    }
+
+    size_t anchor = anchorIndex(pattern, mask);
+    std::vector<uint8_t> buffer(CHUNK_SIZE + pattern.size - 1);
+
+    for (size_t offset = 0; offset < size; offset += CHUNK_SIZE) {
+        Trace::Span span("scan chunk", "scan");
+        span.setArg("chunk", static_cast<int64_t>(offset / CHUNK_SIZE));
+        size_t bytesToRead = std::min(buffer.size(), size - offset);
+
+        ScanStats::Timer readTimer;
+        size_t bytesRead = read(start + offset, buffer.data(), bytesToRead);
+        ScanStats::recordRead(bytesToRead, bytesRead, bytesRead != 0, readTimer);
+        if (bytesRead < pattern.size) {
+            continue; // Skip unreadable regions
+        }
+
+        ScanStats::Timer matchTimer;
+        uint64_t candidates = 0;
+        std::optional<size_t> match = search(buffer.data(), bytesRead, pattern, mask, anchor, candidates);
+        ScanStats::recordMatching(candidates, matchTimer);
+        if (match) {
+            ScanStats::recordMatchedChunk(static_cast<int64_t>(offset / CHUNK_SIZE));
+            return start + offset + *match;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::vector<std::optional<uintptr_t>> findPatterns(const MemoryReader& read, uintptr_t start, size_t size,
+                                                   const std::vector<Pattern>& patterns)
+{
+    std::vector<std::optional<uintptr_t>> results(patterns.size());
+    std::vector<size_t> pending;
+    std::vector<size_t> anchors(patterns.size());
+    size_t longest = 0;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        if (!isValid(patterns[i].pattern, patterns[i].mask)) continue;
+        pending.push_back(i);
+        anchors[i] = anchorIndex(patterns[i].pattern, patterns[i].mask);
+        longest = std::max(longest, patterns[i].pattern.size);
+    }
+    if (pending.empty()) {
+        return results;
+    }
+
+    // A match of a shorter pattern in the overlap is still its first: every
+    // earlier start in the chunk was compared
+    std::vector<uint8_t> buffer(CHUNK_SIZE + longest - 1);
+    for (size_t offset = 0; offset < size && !pending.empty(); offset += CHUNK_SIZE) {
+        Trace::Span span("scan chunk", "scan");
+        span.setArg("chunk", static_cast<int64_t>(offset / CHUNK_SIZE));
+        size_t bytesToRead = std::min(buffer.size(), size - offset);
+
+        ScanStats::Timer readTimer;
+        size_t bytesRead = read(start + offset, buffer.data(), bytesToRead);
+        ScanStats::recordRead(bytesToRead, bytesRead, bytesRead != 0, readTimer);
+        if (bytesRead == 0) {
+            continue;
+        }
+
+        ScanStats::Timer matchTimer;
+        uint64_t candidates = 0;
+        auto found = [&](size_t index) {
+            const Pattern& p = patterns[index];
+            auto match = search(buffer.data(), bytesRead, p.pattern, p.mask, anchors[index], candidates);
+            if (match) results[index] = start + offset + *match;
+            return match.has_value();
+        };
+        pending.erase(std::remove_if(pending.begin(), pending.end(), found), pending.end());
+        ScanStats::recordMatching(candidates, matchTimer);
+    }
+
+    return results;
+}
+
+std::optional<uintptr_t> decodeOperand(const uint8_t* match, size_t matchSize, uintptr_t matchAddress,
+                                       uintptr_t moduleBase, const Patches::OperandReference& reference)
+{
+    size_t operandSize = reference.kind == Patches::OperandKind::Absolute64 ? 8 : 4;
+    if (reference.operandOffset < 0 || size_t(reference.operandOffset) + operandSize > matchSize) {
+        return std::nullopt;
+    }
+
+    const uint8_t* operand = match + reference.operandOffset;
+    switch (reference.kind) {
+    case Patches::OperandKind::RipRelative: {
+        int32_t displacement;
+        std::memcpy(&displacement, operand, sizeof(displacement));
+        return matchAddress + reference.instructionEnd + static_cast<intptr_t>(displacement);
+    }
+    case Patches::OperandKind::ImageRelative: {
+        uint32_t rva;
+        std::memcpy(&rva, operand, sizeof(rva));
+        return moduleBase + rva;
+    }
+    case Patches::OperandKind::Absolute32: {
+        uint32_t address;
+        std::memcpy(&address, operand, sizeof(address));
+        return address;
+    }
+    case Patches::OperandKind::Absolute64: {
+        uint64_t address;
+        std::memcpy(&address, operand, sizeof(address));
+        return static_cast<uintptr_t>(address);
+    }
+    }
+    return std::nullopt;
+}
+
+std::optional<uintptr_t> resolveReference(const MemoryReader& read, uintptr_t moduleBase, size_t moduleSize,
+                                          const Patches::OperandReference& reference)
+{
+    auto match = findPattern(read, moduleBase, moduleSize, reference.pattern, reference.mask);
+    if (!match.has_value()) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> bytes(reference.pattern.size);
+    bytes.resize(read(match.value(), bytes.data(), bytes.size()));
+    auto target = decodeOperand(bytes.data(), bytes.size(), match.value(), moduleBase, reference);
+
+    if (!target.has_value() || target.value() < moduleBase || target.value() - moduleBase >= moduleSize) {
+        return std::nullopt;
+    }
+    return target;
+}
+
+} // namespace Scan
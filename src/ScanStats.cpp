@@ -0,0 +1,115 @@
+/**
+ * @file ScanStats.cpp
+ * @brief Log line and Prometheus text formatting for pattern scan counters
+ */
+
+#include "ScanStats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+double toMs(uint64_t ns)
+{
+    return ns / 1e6;
+}
+
+/// Prometheus label value: backslash, quote and newline escaped
+std::string labelValue(const std::string& text)
+{
+    std::string out;
+    for (char c : text) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') {
+            out += "\\n";
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+} // namespace
+
+std::string ScanStats::toString() const
+{
+    char line[512];
+    int length = std::snprintf(line, sizeof(line),
+                               "%s: %s, %.2f ms (enumerate %.2f, read %.2f, match %.2f), "
+                               "%u reads (%u failed), %llu/%llu bytes, %llu candidates",
+                               name.c_str(), method.c_str(), toMs(totalNs), toMs(enumerateNs), toMs(readNs),
+                               toMs(matchNs), readCalls, failedReads,
+                               static_cast<unsigned long long>(bytesRead),
+                               static_cast<unsigned long long>(bytesRequested),
+                               static_cast<unsigned long long>(candidates));
+    std::string out(line, length < 0 ? 0 : std::min<size_t>(length, sizeof(line) - 1));
+    if (matchedChunk >= 0) out += ", chunk " + std::to_string(matchedChunk);
+    return out;
+}
+
+std::string ScanStats::formatMetrics(const std::vector<ScanStats>& scans)
+{
+    struct Metric {
+        const char* name;
+        const char* help;
+        double (*value)(const ScanStats&);
+    };
+    static const Metric METRICS[] = {
+        {"ffxv_scan_seconds", "Wall time of the last lookup",
+         [](const ScanStats& s) { return s.totalNs / 1e9; }},
+        {"ffxv_scan_enumerate_seconds", "Module enumeration time of the last lookup",
+         [](const ScanStats& s) { return s.enumerateNs / 1e9; }},
+        {"ffxv_scan_read_seconds", "Time in ReadProcessMemory during the last lookup",
+         [](const ScanStats& s) { return s.readNs / 1e9; }},
+        {"ffxv_scan_match_seconds", "Time matching during the last lookup",
+         [](const ScanStats& s) { return s.matchNs / 1e9; }},
+        {"ffxv_scan_read_calls", "ReadProcessMemory calls of the last lookup",
+         [](const ScanStats& s) { return double(s.readCalls); }},
+        {"ffxv_scan_failed_reads", "Failed ReadProcessMemory calls of the last lookup",
+         [](const ScanStats& s) { return double(s.failedReads); }},
+        {"ffxv_scan_bytes_requested", "Bytes requested from the process in the last lookup",
+         [](const ScanStats& s) { return double(s.bytesRequested); }},
+        {"ffxv_scan_bytes_read", "Bytes read from the process in the last lookup",
+         [](const ScanStats& s) { return double(s.bytesRead); }},
+        {"ffxv_scan_candidates", "Offsets compared in full in the last lookup",
+         [](const ScanStats& s) { return double(s.candidates); }},
+        {"ffxv_scan_matched_chunk", "Chunk of the first match in the last lookup; -1 = none",
+         [](const ScanStats& s) { return double(s.matchedChunk); }},
+    };
+
+    std::string out;
+    char value[64];
+    for (const Metric& metric : METRICS) {
+        out += std::string("# HELP ") + metric.name + " " + metric.help + "\n";
+        out += std::string("# TYPE ") + metric.name + " gauge\n";
+        for (const ScanStats& scan : scans) {
+            std::snprintf(value, sizeof(value), "%.9g", metric.value(scan));
+            out += std::string(metric.name) + "{name=\"" + labelValue(scan.name) + "\",method=\"" +
+                   labelValue(scan.method) + "\"} " + value + "\n";
+        }
+    }
+
+    // Totals across the lookups since attach
+    ScanStats total;
+    for (const ScanStats& scan : scans) {
+        total.totalNs += scan.totalNs;
+        total.readNs += scan.readNs;
+        total.matchNs += scan.matchNs;
+        total.readCalls += scan.readCalls;
+        total.bytesRead += scan.bytesRead;
+    }
+    auto addTotal = [&out, &value](const char* name, const char* help, double number) {
+        std::snprintf(value, sizeof(value), "%.9g", number);
+        out += std::string("# HELP ") + name + " " + help + "\n";
+        out += std::string("# TYPE ") + name + " gauge\n";
+        out += std::string(name) + " " + value + "\n";
+    };
+    addTotal("ffxv_scans", "Lookups since attach", double(scans.size()));
+    addTotal("ffxv_scans_seconds", "Wall time of the lookups since attach", total.totalNs / 1e9);
+    addTotal("ffxv_scans_read_seconds", "Read time of the lookups since attach", total.readNs / 1e9);
+    addTotal("ffxv_scans_match_seconds", "Match time of the lookups since attach", total.matchNs / 1e9);
+    addTotal("ffxv_scans_read_calls", "Read calls of the lookups since attach", double(total.readCalls));
+    addTotal("ffxv_scans_bytes_read", "Bytes read by the lookups since attach", double(total.bytesRead));
+    return out;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file SessionManager.cpp
+ * @brief Several attached game instances, patched and unlocked together
+ */
+
+#include "SessionManager.h"
+#include "PatchSite.h"
+#include "ScanEngine.h"
+#include "SignatureDatabase.h"
+#include "Trace.h"
+#include "WriteTransaction.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+constexpr uint8_t UNLOCKED[] = {0x01};
+constexpr uint8_t LOCKED[] = {0x00};
+
+} // namespace
+
+SessionManager::SessionManager(unsigned maxThreads)
+    : m_maxThreads(maxThreads)
+{
+}
+
+SessionManager::~SessionManager() = default;
+
+// ============================================================================
+// Targets
+// ============================================================================
+
+SessionManager::TargetId SessionManager::add(std::string name, std::unique_ptr<MemoryBackend> backend,
+                                             uintptr_t moduleBase, size_t moduleSize)
+{
+    auto target = std::make_unique<Target>();
+    target->status.id = m_nextId++;
+    target->status.name = std::move(name);
+    target->status.moduleBase = moduleBase;
+    target->backend = std::move(backend);
+    target->moduleSize = moduleSize;
+    m_targets.push_back(std::move(target));
+    return m_targets.back()->status.id;
+}
+
+bool SessionManager::remove(TargetId id)
+{
+    auto it = std::find_if(m_targets.begin(), m_targets.end(),
+                           [id](const std::unique_ptr<Target>& target) { return target->status.id == id; });
+    if (it == m_targets.end()) return false;
+    m_targets.erase(it);
+    return true;
+}
+
+std::vector<SessionManager::TargetStatus> SessionManager::status() const
+{
+    std::vector<TargetStatus> result;
+    result.reserve(m_targets.size());
+    for (const auto& target : m_targets) {
+        result.push_back(target->status);
+    }
+    return result;
+}
+
+// ============================================================================
+// Batch Operations
+// ============================================================================
+
+size_t SessionManager::prepare(const std::vector<Patches::Patch*>& patches)
+{
+    Trace::Span span("prepareTargets", "attach");
+    forEachTarget([&](Target& target) { prepareTarget(target, patches); });
+    return std::count_if(m_targets.begin(), m_targets.end(),
+                         [](const std::unique_ptr<Target>& target) { return target->status.state == State::Ready; });
+}
+
+size_t SessionManager::apply(const std::vector<Patches::Patch*>& patches, UnlockMask mask)
+{
+    Trace::Span span("applyTargets", "write");
+    forEachTarget([&](Target& target) { writeTarget(target, patches, mask, false); });
+    return std::count_if(m_targets.begin(), m_targets.end(),
+                         [](const std::unique_ptr<Target>& target) { return target->status.state == State::Applied; });
+}
+
+size_t SessionManager::restore(const std::vector<Patches::Patch*>& patches)
+{
+    Trace::Span span("restoreTargets", "write");
+    forEachTarget([&](Target& target) { writeTarget(target, patches, 0, true); });
+    return std::count_if(m_targets.begin(), m_targets.end(),
+                         [](const std::unique_ptr<Target>& target) { return target->status.state == State::Restored; });
+}
+
+/// Targets are handed out one at a time, so a slow one does not hold up a whole share
+void SessionManager::forEachTarget(const std::function<void(Target&)>& work)
+{
+    size_t count = m_targets.size();
+    size_t threads = m_maxThreads == 0 ? count : std::min<size_t>(count, m_maxThreads);
+    std::atomic<size_t> next{0};
+    auto run = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            work(*m_targets[i]);
+        }
+    };
+    if (threads <= 1) {
+        run();
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&run] {
+            Trace::setThreadName("session");
+            run();
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// ============================================================================
+// Per-Target Work
+// ============================================================================
+
+SessionManager::BuildScan& SessionManager::buildScan(uint64_t fingerprint)
+{
+    std::lock_guard<std::mutex> lock(m_buildsMutex);
+    std::unique_ptr<BuildScan>& build = m_builds[fingerprint];
+    if (!build) build = std::make_unique<BuildScan>();
+    return *build;
+}
+
+void SessionManager::prepareTarget(Target& target, const std::vector<Patches::Patch*>& patches)
+{
+    Trace::Span span("prepareTarget", "attach");
+    span.setDetail(target.status.name);
+
+    TargetStatus& status = target.status;
+    uintptr_t base = status.moduleBase;
+    MemoryReader read = target.backend->reader();
+    target.sites.clear();
+    status.sitesFound = 0;
+    status.error.clear();
+
+    status.build = BuildFingerprint::compute(read, base);
+    if (!status.build) {
+        status.state = State::Failed;
+        status.error = "Cannot read the module headers";
+        return;
+    }
+
+    // Copied out so the verification reads below run without the build lock
+    std::map<std::string, std::optional<uint32_t>> matchRvas;
+    std::map<std::string, bool> onBoundaries;
+    uint32_t tableRva = 0;
+    {
+        BuildScan& build = buildScan(status.build->hash);
+        std::lock_guard<std::mutex> lock(build.mutex);
+        lookUp(target, status.build->hash, build, patches);
+        matchRvas = build.matchRvas;
+        onBoundaries = build.onBoundaries;
+        tableRva = build.unlockTableRva.value_or(0);
+    }
+
+    status.unlockTableBase = tableRva
+        ? base + tableRva
+        : base + (Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+
+    for (const Patches::Patch* patch : patches) {
+        const std::optional<uint32_t>& rva = matchRvas[patch->name];
+        if (!rva || !PatchSite::matches(read, base + *rva, *patch)) {
+            if (status.error.empty()) status.error = "Pattern not found: " + patch->name;
+            continue;
+        }
+        if (!onBoundaries[patch->name]) {
+            if (status.error.empty()) status.error = "Patch does not fall on instruction boundaries: " + patch->name;
+            continue;
+        }
+        target.sites[patch->name] = base + *rva + patch->offset;
+        ++status.sitesFound;
+    }
+    status.state = status.sitesFound == patches.size() ? State::Ready : State::Failed;
+}
+
+/**
+ * @brief Fills in whatever the build has not looked up yet; called under the build's lock
+ *
+ * Database entries and RVA hints are checked against this target before
+ * they are kept. Everything else is one Scan::findPatterns pass over the
+ * module. Each patch found is then checked for instruction boundaries, once
+ * for the build.
+ */
+void SessionManager::lookUp(const Target& target, uint64_t fingerprint, BuildScan& build,
+                            const std::vector<Patches::Patch*>& patches)
+{
+    std::vector<const Patches::Patch*> missing;
+    for (const Patches::Patch* patch : patches) {
+        if (!build.matchRvas.count(patch->name)) missing.push_back(patch);
+    }
+    if (missing.empty() && build.unlockTableRva) {
+        ++m_preparesShared;
+        return;
+    }
+
+    uintptr_t base = target.status.moduleBase;
+    MemoryReader read = target.backend->reader();
+
+    std::optional<SignatureDatabase::BuildView> entry;
+    if (m_database) entry = m_database->findBuild(fingerprint);
+    if (entry) {
+        for (const Patches::Patch* patch : missing) {
+            for (size_t i = 0; i < entry->addressCount; ++i) {
+                auto address = entry->address(i);
+                if (address.patchName == patch->name && PatchSite::matches(read, base + address.rva, *patch)) {
+                    build.matchRvas[patch->name] = address.rva;
+                    break;
+                }
+            }
+        }
+        if (!build.unlockTableRva && entry->unlockTableRva) {
+            build.unlockTableRva = entry->unlockTableRva;
+        }
+    }
+
+    // The reference build's site; also finds a site still patched from an
+    // earlier session, which the scan would miss
+    for (const Patches::Patch* patch : missing) {
+        if (build.matchRvas.count(patch->name)) continue;
+        if (auto match = PatchSite::atHint(read, base, *patch)) {
+            build.matchRvas[patch->name] = static_cast<uint32_t>(*match - base);
+        }
+    }
+
+    std::vector<Scan::Pattern> patterns;
+    std::vector<const Patches::Patch*> scanned;
+    for (const Patches::Patch* patch : missing) {
+        if (build.matchRvas.count(patch->name)) continue;
+        patterns.push_back({patch->pattern, patch->mask});
+        scanned.push_back(patch);
+    }
+    const Patches::OperandReference& reference = Patches::UNLOCK_TABLE_REFERENCE;
+    bool scanTable = !build.unlockTableRva;
+    if (scanTable) {
+        patterns.push_back({reference.pattern, reference.mask});
+    }
+    if (!patterns.empty()) {
+        ++m_scansRun;
+        std::vector<std::optional<uintptr_t>> matches =
+            Scan::findPatterns(read, base, target.moduleSize, patterns);
+        for (size_t i = 0; i < scanned.size(); ++i) {
+            build.matchRvas[scanned[i]->name] = matches[i]
+                ? std::optional<uint32_t>(static_cast<uint32_t>(*matches[i] - base))
+                : std::nullopt;
+        }
+
+        if (scanTable) {
+            build.unlockTableRva = 0;
+            if (const std::optional<uintptr_t>& match = matches.back()) {
+                std::vector<uint8_t> bytes(reference.pattern.size);
+                bytes.resize(read(*match, bytes.data(), bytes.size()));
+                auto table = Scan::decodeOperand(bytes.data(), bytes.size(), *match, base, reference);
+                if (table && *table >= base && *table - base < target.moduleSize) {
+                    build.unlockTableRva = static_cast<uint32_t>(*table - base);
+                }
+            }
+        }
+    }
+
+    for (const Patches::Patch* patch : missing) {
+        const std::optional<uint32_t>& rva = build.matchRvas[patch->name];
+        if (rva) build.onBoundaries[patch->name] = PatchSite::onBoundaries(read, base + *rva, *patch);
+    }
+}
+
+void SessionManager::writeTarget(Target& target, const std::vector<Patches::Patch*>& patches, UnlockMask mask,
+                                 bool restore)
+{
+    TargetStatus& status = target.status;
+    if (status.state == State::Added || status.state == State::Failed) return;
+
+    Trace::Span span(restore ? "restoreTarget" : "applyTarget", "write");
+    span.setDetail(status.name);
+
+    WriteTransaction transaction;
+    for (const Patches::Patch* patch : patches) {
+        auto site = target.sites.find(patch->name);
+        if (site == target.sites.end()) {
+            status.state = State::Failed;
+            status.error = "Not prepared: " + patch->name;
+            return;
+        }
+        transaction.add(site->second, restore ? patch->original : patch->patched);
+    }
+
+    UnlockMask owned = mask | status.enabledMask;
+    for (size_t i = 0; i < UnlockRegistry::MAX_TABLE_BYTES; ++i) {
+        UnlockMask bit = UnlockRegistry::bit(uint8_t(i));
+        if (!(owned & bit)) continue;
+        transaction.add(status.unlockTableBase + i, (mask & bit) ? ByteView(UNLOCKED) : ByteView(LOCKED));
+    }
+
+    if (!transaction.commit(*target.backend)) {
+        status.state = State::Failed;
+        status.error = restore ? "Failed to restore" : "Failed to write";
+        return;
+    }
+    status.enabledMask = mask;
+    status.state = restore ? State::Restored : State::Applied;
+}
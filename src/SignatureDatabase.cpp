@@ -0,0 +1,926 @@
+/**
+ * @file SignatureDatabase.cpp
+ * @brief Signature database loader, validator and text compiler
+ *
+ * Validation is strict and happens once: a file that passes can be read
+ * through raw record pointers without any further bounds checks. A file that
+ * fails is rejected as a whole and the caller keeps the built-in set; there is
+ * no partial load.
+ */
+
+#include "SignatureDatabase.h"
+
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <sstream>
+
+using namespace SigDb;
+
+uint32_t SigDb::checksum(const uint8_t* data, size_t size)
+{
+    uint32_t hash = 0x811C9DC5u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x01000193u;
+    }
+    return hash;
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+bool SignatureDatabase::load(const std::string& path)
+{
+    unload();
+
+    if (!m_file.open(path)) {
+        return fail(m_file.getLastError());
+    }
+
+    m_data = m_file.data();
+    m_size = m_file.size();
+    if (!validate()) {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+std::string SignatureDatabase::loadOverrides(const std::string& path)
+{
+    std::error_code error;
+    if (!std::filesystem::exists(std::filesystem::u8path(path), error)) {
+        return "Using built-in signatures (v" + std::to_string(Patches::BUILTIN_DATA_VERSION) + ")";
+    }
+
+    if (!load(path)) {
+        return "[ERROR] Signature database rejected, using built-in set: " + m_lastError;
+    }
+
+    if (dataVersion() < Patches::BUILTIN_DATA_VERSION) {
+        uint32_t staleVersion = dataVersion();
+        unload();
+        return "Signature database v" + std::to_string(staleVersion) + " is older than built-in v" +
+               std::to_string(Patches::BUILTIN_DATA_VERSION) + ", ignored";
+    }
+
+    size_t applied = applyToBuiltins();
+    return "Loaded signature database v" + std::to_string(dataVersion()) + " (" + std::to_string(applied) +
+           " entries applied)";
+}
+
+bool SignatureDatabase::loadFromMemory(const uint8_t* data, size_t size)
+{
+    unload();
+
+    m_data = data;
+    m_size = size;
+    return validate();
+}
+
+void SignatureDatabase::unload()
+{
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_patches = nullptr;
+    m_items = nullptr;
+    m_bundles = nullptr;
+    m_builds = nullptr;
+    m_buildAddresses = nullptr;
+    m_buildIndex = nullptr;
+    m_patchCount = m_itemCount = m_bundleCount = 0;
+    m_buildCount = m_buildAddressCount = m_buildIndexSize = 0;
+    m_strings = nullptr;
+    m_stringsSize = 0;
+    m_blob = nullptr;
+    m_blobSize = 0;
+}
+
+bool SignatureDatabase::fail(const std::string& error)
+{
+    m_lastError = error;
+    m_header = nullptr;
+    return false;
+}
+
+// ============================================================================
+// Validation
+// ============================================================================
+
+bool SignatureDatabase::validate()
+{
+    if (m_size < sizeof(FileHeader) || (reinterpret_cast<uintptr_t>(m_data) & 3) != 0) {
+        return fail("Signature database truncated or misaligned");
+    }
+
+    const auto* header = reinterpret_cast<const FileHeader*>(m_data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        return fail("Not a signature database (bad magic)");
+    }
+    if (header->formatVersion != FORMAT_VERSION) {
+        return fail("Unsupported signature database format version " +
+                    std::to_string(header->formatVersion));
+    }
+    if (header->fileSize != m_size) {
+        return fail("Signature database size mismatch (header says " +
+                    std::to_string(header->fileSize) + ", file is " + std::to_string(m_size) + ")");
+    }
+
+    size_t tableEnd = sizeof(FileHeader) + size_t(header->sectionCount) * sizeof(SectionEntry);
+    if (tableEnd > m_size) {
+        return fail("Signature database section table out of bounds");
+    }
+    if (checksum(m_data + sizeof(FileHeader), m_size - sizeof(FileHeader)) != header->checksum) {
+        return fail("Signature database checksum mismatch");
+    }
+
+    // Resolve known sections; unknown tags are skipped for forward compatibility
+    const auto* sections = reinterpret_cast<const SectionEntry*>(m_data + sizeof(FileHeader));
+    for (uint16_t i = 0; i < header->sectionCount; ++i) {
+        const SectionEntry& section = sections[i];
+        if (section.offset < tableEnd || size_t(section.offset) + section.size > m_size ||
+            (section.offset & 3) != 0) {
+            return fail("Signature database section " + std::to_string(i) + " out of bounds");
+        }
+
+        const uint8_t* payload = m_data + section.offset;
+        auto checkRecords = [&](size_t recordSize) {
+            return size_t(section.count) * recordSize == section.size;
+        };
+
+        if (section.tag == TAG_PATCHES) {
+            if (!checkRecords(sizeof(PatchRecord))) return fail("Malformed patch section");
+            m_patches = reinterpret_cast<const PatchRecord*>(payload);
+            m_patchCount = section.count;
+        } else if (section.tag == TAG_ITEMS) {
+            if (!checkRecords(sizeof(ItemRecord))) return fail("Malformed item section");
+            m_items = reinterpret_cast<const ItemRecord*>(payload);
+            m_itemCount = section.count;
+        } else if (section.tag == TAG_BUNDLES) {
+            if (!checkRecords(sizeof(BundleRecord))) return fail("Malformed bundle section");
+            m_bundles = reinterpret_cast<const BundleRecord*>(payload);
+            m_bundleCount = section.count;
+        } else if (section.tag == TAG_BUILDS) {
+            if (!checkRecords(sizeof(BuildRecord))) return fail("Malformed build section");
+            m_builds = reinterpret_cast<const BuildRecord*>(payload);
+            m_buildCount = section.count;
+        } else if (section.tag == TAG_BUILD_ADDRESSES) {
+            if (!checkRecords(sizeof(BuildAddressRecord))) return fail("Malformed build address section");
+            m_buildAddresses = reinterpret_cast<const BuildAddressRecord*>(payload);
+            m_buildAddressCount = section.count;
+        } else if (section.tag == TAG_BUILD_INDEX) {
+            // Slot count must be a power of two for the masked probe
+            if (!checkRecords(sizeof(uint32_t)) || (section.count & (section.count - 1)) != 0) {
+                return fail("Malformed build index section");
+            }
+            m_buildIndex = reinterpret_cast<const uint32_t*>(payload);
+            m_buildIndexSize = section.count;
+        } else if (section.tag == TAG_STRINGS) {
+            m_strings = reinterpret_cast<const char*>(payload);
+            m_stringsSize = section.size;
+        } else if (section.tag == TAG_BLOB) {
+            m_blob = payload;
+            m_blobSize = section.size;
+        }
+    }
+
+    // Every reference must land inside its pool
+    for (size_t i = 0; i < m_patchCount; ++i) {
+        const PatchRecord& p = m_patches[i];
+        if (!validString(p.name) || !validString(p.description) ||
+            p.patternLength == 0 || !validBlob(p.pattern, p.patternLength) ||
+            (p.mask != NONE && !validBlob(p.mask, p.patternLength)) ||
+            !validBlob(p.original, p.originalLength) ||
+            !validBlob(p.patched, p.patchedLength) || p.originalLength != p.patchedLength ||
+            p.section > uint8_t(Patches::SectionHint::Data)) {
+            return fail("Invalid patch record " + std::to_string(i));
+        }
+    }
+    for (size_t i = 0; i < m_itemCount; ++i) {
+        const ItemRecord& item = m_items[i];
+        if (!validString(item.name) || !validString(item.description) ||
+            item.category > uint8_t(Patches::UnlockCategory::Promotional)) {
+            return fail("Invalid item record " + std::to_string(i));
+        }
+    }
+    for (size_t i = 0; i < m_bundleCount; ++i) {
+        const BundleRecord& bundle = m_bundles[i];
+        if (!validString(bundle.name) || !validString(bundle.description) ||
+            !validBlob(bundle.itemIds, bundle.itemCount)) {
+            return fail("Invalid bundle record " + std::to_string(i));
+        }
+    }
+    for (size_t i = 0; i < m_buildCount; ++i) {
+        const BuildRecord& build = m_builds[i];
+        if (!validString(build.name) || build.firstAddress > m_buildAddressCount ||
+            build.addressCount > m_buildAddressCount - build.firstAddress) {
+            return fail("Invalid build record " + std::to_string(i));
+        }
+    }
+    for (size_t i = 0; i < m_buildAddressCount; ++i) {
+        if (!validString(m_buildAddresses[i].patchName)) {
+            return fail("Invalid build address record " + std::to_string(i));
+        }
+    }
+    if (m_buildCount > 0) {
+        // At least one empty slot, or a miss would probe forever
+        if (m_buildIndexSize <= m_buildCount) return fail("Build index missing or too small");
+        for (size_t i = 0; i < m_buildIndexSize; ++i) {
+            if (m_buildIndex[i] != NONE && m_buildIndex[i] >= m_buildCount) {
+                return fail("Invalid build index slot " + std::to_string(i));
+            }
+        }
+    }
+
+    m_header = header;
+    m_lastError.clear();
+    return true;
+}
+
+bool SignatureDatabase::validString(uint32_t offset) const
+{
+    return offset < m_stringsSize &&
+           std::memchr(m_strings + offset, '\0', m_stringsSize - offset) != nullptr;
+}
+
+bool SignatureDatabase::validBlob(uint32_t offset, size_t length) const
+{
+    if (length == 0) return true;
+    return offset <= m_blobSize && length <= m_blobSize - offset;
+}
+
+// ============================================================================
+// Accessors
+// ============================================================================
+
+std::string_view SignatureDatabase::stringAt(uint32_t offset) const
+{
+    return std::string_view(m_strings + offset);
+}
+
+ByteView SignatureDatabase::blobAt(uint32_t offset, size_t length) const
+{
+    if (length == 0) return {};
+    return ByteView(m_blob + offset, length);
+}
+
+uint32_t SignatureDatabase::dataVersion() const
+{
+    return m_header ? m_header->dataVersion : 0;
+}
+
+uint32_t SignatureDatabase::unlockTableRva() const
+{
+    return m_header ? m_header->unlockTableRva : 0;
+}
+
+SignatureDatabase::PatchView SignatureDatabase::patch(size_t index) const
+{
+    const PatchRecord& p = m_patches[index];
+    return {
+        stringAt(p.name),
+        stringAt(p.description),
+        blobAt(p.pattern, p.patternLength),
+        p.mask == NONE ? ByteView() : blobAt(p.mask, p.patternLength),
+        blobAt(p.original, p.originalLength),
+        blobAt(p.patched, p.patchedLength),
+        p.offset,
+        static_cast<Patches::SectionHint>(p.section),
+        p.rvaHint
+    };
+}
+
+SignatureDatabase::ItemView SignatureDatabase::item(size_t index) const
+{
+    const ItemRecord& item = m_items[index];
+    return {
+        stringAt(item.name),
+        stringAt(item.description),
+        item.itemId,
+        static_cast<Patches::UnlockCategory>(item.category),
+        (item.flags & ITEM_SELECTABLE) != 0
+    };
+}
+
+SignatureDatabase::BundleView SignatureDatabase::bundle(size_t index) const
+{
+    const BundleRecord& bundle = m_bundles[index];
+    return {
+        stringAt(bundle.name),
+        stringAt(bundle.description),
+        blobAt(bundle.itemIds, bundle.itemCount)
+    };
+}
+
+SignatureDatabase::BuildView SignatureDatabase::build(size_t index) const
+{
+    const BuildRecord& build = m_builds[index];
+    return {
+        stringAt(build.name),
+        (uint64_t(build.fingerprintHigh) << 32) | build.fingerprintLow,
+        build.unlockTableRva,
+        build.jumpTableRva,
+        m_buildAddresses + build.firstAddress,
+        build.addressCount,
+        this
+    };
+}
+
+SignatureDatabase::BuildAddressView SignatureDatabase::BuildView::address(size_t index) const
+{
+    return { database->stringAt(addresses[index].patchName), addresses[index].rva };
+}
+
+std::optional<SignatureDatabase::BuildView> SignatureDatabase::findBuild(uint64_t fingerprint) const
+{
+    if (!isLoaded() || m_buildCount == 0) return std::nullopt;
+
+    size_t mask = m_buildIndexSize - 1;
+    for (size_t slot = size_t(fingerprint) & mask;; slot = (slot + 1) & mask) {
+        uint32_t index = m_buildIndex[slot];
+        if (index == NONE) return std::nullopt;
+        const BuildRecord& build = m_builds[index];
+        if (build.fingerprintLow == uint32_t(fingerprint) &&
+            build.fingerprintHigh == uint32_t(fingerprint >> 32)) {
+            return this->build(index);
+        }
+    }
+}
+
+// ============================================================================
+// Built-in Overlay
+// ============================================================================
+
+size_t SignatureDatabase::applyToBuiltins() const
+{
+    if (!isLoaded()) return 0;
+
+    size_t applied = 0;
+    if (unlockTableRva()) {
+        Patches::rebaseUnlockTable(Patches::DEFAULT_IMAGE_BASE + unlockTableRva());
+    }
+    uintptr_t tableBase = Patches::activeUnlockTableBase;
+
+    for (auto* builtin : Patches::getAllPatches()) {
+        for (size_t i = 0; i < m_patchCount; ++i) {
+            PatchView p = patch(i);
+            if (p.name != builtin->name) continue;
+
+            // The built-in hint is for the built-in pattern and offset; a
+            // moved entry without a hint of its own is located by scan
+            bool moved = p.offset != builtin->offset || p.pattern.size != builtin->pattern.size ||
+                         !std::equal(p.pattern.begin(), p.pattern.end(), builtin->pattern.begin());
+            if (p.rvaHint != 0) {
+                builtin->rvaHint = p.rvaHint;
+            } else if (moved) {
+                builtin->rvaHint = 0;
+            }
+
+            builtin->description = std::string(p.description);
+            builtin->pattern = p.pattern;
+            builtin->mask = p.mask;
+            builtin->original = p.original;
+            builtin->patched = p.patched;
+            builtin->offset = p.offset;
+            builtin->section = p.section;
+            ++applied;
+            break;
+        }
+    }
+
+    for (auto* builtin : Patches::getAllUnlockItems()) {
+        for (size_t i = 0; i < m_itemCount; ++i) {
+            ItemView item = this->item(i);
+            if (item.itemId != builtin->itemId) continue;
+
+            builtin->name = std::string(item.name);
+            builtin->description = std::string(item.description);
+            builtin->selectable = item.selectable;
+            ++applied;
+            break;
+        }
+    }
+
+    for (auto* builtin : Patches::getTwitchPrimeBundles()) {
+        for (size_t i = 0; i < m_bundleCount; ++i) {
+            BundleView bundle = this->bundle(i);
+            if (bundle.name != builtin->name) continue;
+
+            builtin->description = std::string(bundle.description);
+            builtin->addresses.clear();
+            for (uint8_t itemId : bundle.itemIds) {
+                builtin->addresses.push_back(tableBase + itemId);
+            }
+            ++applied;
+            break;
+        }
+    }
+
+    return applied;
+}
+
+// ============================================================================
+// Text Source Compiler
+// ============================================================================
+
+namespace {
+
+struct Token {
+    std::string text;
+    bool quoted = false;
+};
+
+struct SourcePatch {
+    std::string name, description;
+    std::vector<uint8_t> pattern, mask, original, patched;
+    bool hasMask = false;
+    int32_t offset = 0;
+    uint32_t rvaHint = 0;
+    uint8_t section = uint8_t(Patches::SectionHint::Any);
+};
+
+struct SourceItem {
+    std::string name, description;
+    uint8_t itemId = 0, category = 0, flags = ITEM_SELECTABLE;
+};
+
+struct SourceBundle {
+    std::string name, description;
+    std::vector<uint8_t> itemIds;
+};
+
+struct SourceBuild {
+    std::string name;
+    uint64_t fingerprint = 0;
+    uint32_t unlockTableRva = 0;
+    uint32_t jumpTableRva = 0;
+    std::vector<std::pair<std::string, uint32_t>> addresses;
+};
+
+bool tokenize(const std::string& line, std::vector<Token>& tokens, std::string& error)
+{
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        char c = line[i];
+        if (c == ' ' || c == '\t' || c == '\r') { ++i; continue; }
+        if (c == '#') break;
+
+        Token token;
+        if (c == '"') {
+            token.quoted = true;
+            ++i;
+            bool closed = false;
+            while (i < line.size()) {
+                char ch = line[i++];
+                if (ch == '"') { closed = true; break; }
+                if (ch == '\\' && i < line.size()) ch = line[i++];
+                token.text += ch;
+            }
+            if (!closed) {
+                error = "unterminated string";
+                return false;
+            }
+        } else {
+            while (i < line.size() && line[i] != ' ' && line[i] != '\t' &&
+                   line[i] != '\r' && line[i] != '#') {
+                token.text += line[i++];
+            }
+        }
+        tokens.push_back(std::move(token));
+    }
+    return true;
+}
+
+bool parseInteger(const Token& token, int64_t& value)
+{
+    if (token.quoted || token.text.empty()) return false;
+    try {
+        size_t consumed = 0;
+        const std::string& t = token.text;
+        bool negative = t[0] == '-';
+        std::string digits = negative ? t.substr(1) : t;
+        int base = 10;
+        if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+            digits = digits.substr(2);
+            base = 16;
+        }
+        value = std::stoll(digits, &consumed, base);
+        if (consumed != digits.size()) return false;
+        if (negative) value = -value;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool parseBytes(const std::vector<Token>& tokens, size_t first, bool allowWildcards,
+                std::vector<uint8_t>& bytes, std::vector<uint8_t>& mask, std::string& error)
+{
+    for (size_t i = first; i < tokens.size(); ++i) {
+        const Token& token = tokens[i];
+        if (token.quoted) {
+            for (char c : token.text) {
+                bytes.push_back(static_cast<uint8_t>(c));
+                mask.push_back(0xFF);
+            }
+        } else if (token.text == "??" || token.text == "?") {
+            if (!allowWildcards) {
+                error = "wildcards are only allowed in patterns";
+                return false;
+            }
+            bytes.push_back(0x00);
+            mask.push_back(0x00);
+        } else {
+            std::string hex = token.text;
+            if (hex.size() == 4 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) {
+                hex = hex.substr(2);
+            }
+            if (hex.size() != 2 || !isxdigit(uint8_t(hex[0])) || !isxdigit(uint8_t(hex[1]))) {
+                error = "invalid byte '" + token.text + "'";
+                return false;
+            }
+            bytes.push_back(static_cast<uint8_t>(std::stoul(hex, nullptr, 16)));
+            mask.push_back(0xFF);
+        }
+    }
+    return true;
+}
+
+bool parseCategory(const std::string& text, uint8_t& category)
+{
+    static const std::map<std::string, Patches::UnlockCategory> names = {
+        {"normally_unavailable", Patches::UnlockCategory::NormallyUnavailable},
+        {"twitch_prime",         Patches::UnlockCategory::TwitchPrime},
+        {"steam",                Patches::UnlockCategory::Steam},
+        {"origin",               Patches::UnlockCategory::Origin},
+        {"microsoft_store",      Patches::UnlockCategory::MicrosoftStore},
+        {"promotional",          Patches::UnlockCategory::Promotional}
+    };
+    auto it = names.find(text);
+    if (it == names.end()) return false;
+    category = static_cast<uint8_t>(it->second);
+    return true;
+}
+
+bool parseSection(const std::string& text, uint8_t& section)
+{
+    static const std::map<std::string, Patches::SectionHint> names = {
+        {"any",   Patches::SectionHint::Any},
+        {"text",  Patches::SectionHint::Text},
+        {"rdata", Patches::SectionHint::RData},
+        {"data",  Patches::SectionHint::Data}
+    };
+    auto it = names.find(text);
+    if (it == names.end()) return false;
+    section = static_cast<uint8_t>(it->second);
+    return true;
+}
+
+/// Accumulates the STRS and BLOB pools, deduplicating identical entries
+class PoolBuilder {
+public:
+    uint32_t addString(const std::string& text) {
+        auto it = m_stringIndex.find(text);
+        if (it != m_stringIndex.end()) return it->second;
+        uint32_t offset = static_cast<uint32_t>(m_strings.size());
+        m_strings.insert(m_strings.end(), text.begin(), text.end());
+        m_strings.push_back('\0');
+        m_stringIndex.emplace(text, offset);
+        return offset;
+    }
+
+    uint32_t addBlob(const std::vector<uint8_t>& bytes) {
+        if (bytes.empty()) return 0;
+        auto it = m_blobIndex.find(bytes);
+        if (it != m_blobIndex.end()) return it->second;
+        uint32_t offset = static_cast<uint32_t>(m_blob.size());
+        m_blob.insert(m_blob.end(), bytes.begin(), bytes.end());
+        m_blobIndex.emplace(bytes, offset);
+        return offset;
+    }
+
+    const std::vector<char>& strings() const { return m_strings; }
+    const std::vector<uint8_t>& blob() const { return m_blob; }
+
+private:
+    std::vector<char> m_strings;
+    std::vector<uint8_t> m_blob;
+    std::map<std::string, uint32_t> m_stringIndex;
+    std::map<std::vector<uint8_t>, uint32_t> m_blobIndex;
+};
+
+void appendAligned(std::vector<uint8_t>& out, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    out.insert(out.end(), bytes, bytes + size);
+    while (out.size() % 4 != 0) out.push_back(0);
+}
+
+} // namespace
+
+bool SignatureDatabase::compile(const std::string& source, std::vector<uint8_t>& output, std::string& error)
+{
+    uint32_t dataVersion = 0;
+    uint32_t tableRva = 0;
+    std::vector<SourcePatch> patches;
+    std::vector<SourceItem> items;
+    std::vector<SourceBundle> bundles;
+    std::vector<SourceBuild> builds;
+    SourcePatch* current = nullptr;
+    SourceBuild* currentBuild = nullptr;
+
+    std::istringstream stream(source);
+    std::string line;
+    std::vector<Token> tokens;
+    int lineNumber = 0;
+
+    auto lineError = [&](const std::string& message) {
+        error = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    while (std::getline(stream, line)) {
+        ++lineNumber;
+        std::string tokenError;
+        if (!tokenize(line, tokens, tokenError)) return lineError(tokenError);
+        if (tokens.empty()) continue;
+
+        const std::string& keyword = tokens[0].text;
+        int64_t value = 0;
+
+        if (current) {
+            // Inside a patch block
+            if (keyword == "end") {
+                if (current->pattern.empty() || current->original.empty() || current->patched.empty()) {
+                    return lineError("patch '" + current->name + "' needs pattern, original and patched");
+                }
+                if (current->original.size() != current->patched.size()) {
+                    return lineError("patch '" + current->name + "' original and patched differ in length");
+                }
+                current = nullptr;
+            } else if (keyword == "pattern") {
+                current->pattern.clear();
+                current->mask.clear();
+                if (!parseBytes(tokens, 1, true, current->pattern, current->mask, tokenError)) {
+                    return lineError(tokenError);
+                }
+                current->hasMask = false;
+                for (uint8_t m : current->mask) current->hasMask |= (m != 0xFF);
+            } else if (keyword == "original" || keyword == "patched") {
+                std::vector<uint8_t>& target = keyword == "original" ? current->original : current->patched;
+                std::vector<uint8_t> unusedMask;
+                target.clear();
+                if (!parseBytes(tokens, 1, false, target, unusedMask, tokenError)) {
+                    return lineError(tokenError);
+                }
+            } else if (keyword == "offset") {
+                if (tokens.size() != 2 || !parseInteger(tokens[1], value) ||
+                    value < INT32_MIN || value > INT32_MAX) {
+                    return lineError("expected: offset <integer>");
+                }
+                current->offset = static_cast<int32_t>(value);
+            } else if (keyword == "hint") {
+                if (tokens.size() != 2 || !parseInteger(tokens[1], value) || value < 0 || value > UINT32_MAX) {
+                    return lineError("expected: hint <rva>");
+                }
+                current->rvaHint = static_cast<uint32_t>(value);
+            } else if (keyword == "section") {
+                if (tokens.size() != 2 || !parseSection(tokens[1].text, current->section)) {
+                    return lineError("expected: section any|text|rdata|data");
+                }
+            } else {
+                return lineError("unknown patch field '" + keyword + "'");
+            }
+            continue;
+        }
+
+        if (currentBuild) {
+            // Inside a build block
+            if (keyword == "end") {
+                currentBuild = nullptr;
+            } else if (keyword == "table_base" || keyword == "jump_table") {
+                if (tokens.size() != 2 || !parseInteger(tokens[1], value) || value < 0 || value > UINT32_MAX) {
+                    return lineError("expected: " + keyword + " <rva>");
+                }
+                (keyword == "table_base" ? currentBuild->unlockTableRva : currentBuild->jumpTableRva) =
+                    static_cast<uint32_t>(value);
+            } else if (keyword == "address") {
+                if (tokens.size() != 3 || !tokens[1].quoted || !parseInteger(tokens[2], value) ||
+                    value < 0 || value > UINT32_MAX) {
+                    return lineError("expected: address \"patch name\" <rva>");
+                }
+                currentBuild->addresses.emplace_back(tokens[1].text, static_cast<uint32_t>(value));
+            } else {
+                return lineError("unknown build field '" + keyword + "'");
+            }
+            continue;
+        }
+
+        if (keyword == "version") {
+            if (tokens.size() != 2 || !parseInteger(tokens[1], value) || value < 0 || value > UINT32_MAX) {
+                return lineError("expected: version <integer>");
+            }
+            dataVersion = static_cast<uint32_t>(value);
+        } else if (keyword == "table_base") {
+            if (tokens.size() != 2 || !parseInteger(tokens[1], value) || value < 0 || value > UINT32_MAX) {
+                return lineError("expected: table_base <rva>");
+            }
+            tableRva = static_cast<uint32_t>(value);
+        } else if (keyword == "item") {
+            SourceItem item;
+            if (tokens.size() < 5 || tokens.size() > 6 || !parseInteger(tokens[1], value) ||
+                value < 0 || value > 0xFF || !tokens[2].quoted || !tokens[3].quoted) {
+                return lineError("expected: item <id> \"name\" \"description\" <category> [protected]");
+            }
+            item.itemId = static_cast<uint8_t>(value);
+            item.name = tokens[2].text;
+            item.description = tokens[3].text;
+            if (!parseCategory(tokens[4].text, item.category)) {
+                return lineError("unknown category '" + tokens[4].text + "'");
+            }
+            if (tokens.size() == 6) {
+                if (tokens[5].text != "protected") return lineError("unknown item flag '" + tokens[5].text + "'");
+                item.flags &= ~ITEM_SELECTABLE;
+            }
+            for (const auto& existing : items) {
+                if (existing.itemId == item.itemId) return lineError("duplicate item id");
+            }
+            items.push_back(std::move(item));
+        } else if (keyword == "bundle") {
+            SourceBundle bundle;
+            if (tokens.size() < 4 || !tokens[1].quoted || !tokens[2].quoted) {
+                return lineError("expected: bundle \"name\" \"description\" <id>...");
+            }
+            bundle.name = tokens[1].text;
+            bundle.description = tokens[2].text;
+            for (size_t i = 3; i < tokens.size(); ++i) {
+                if (!parseInteger(tokens[i], value) || value < 0 || value > 0xFF) {
+                    return lineError("invalid item id '" + tokens[i].text + "'");
+                }
+                bundle.itemIds.push_back(static_cast<uint8_t>(value));
+            }
+            bundles.push_back(std::move(bundle));
+        } else if (keyword == "patch") {
+            if (tokens.size() != 3 || !tokens[1].quoted || !tokens[2].quoted) {
+                return lineError("expected: patch \"name\" \"description\"");
+            }
+            for (const auto& existing : patches) {
+                if (existing.name == tokens[1].text) return lineError("duplicate patch name");
+            }
+            patches.emplace_back();
+            current = &patches.back();
+            current->name = tokens[1].text;
+            current->description = tokens[2].text;
+        } else if (keyword == "build") {
+            // Fingerprints are full 64-bit values, beyond parseInteger's signed range
+            uint64_t fingerprint = 0;
+            size_t consumed = 0;
+            bool valid = tokens.size() == 3 && tokens[1].quoted && !tokens[2].quoted &&
+                         tokens[2].text.size() > 2 && tokens[2].text[0] == '0' && tokens[2].text[1] == 'x';
+            try {
+                if (valid) fingerprint = std::stoull(tokens[2].text.substr(2), &consumed, 16);
+            } catch (...) {
+                valid = false;
+            }
+            if (!valid || consumed != tokens[2].text.size() - 2) {
+                return lineError("expected: build \"name\" 0x<fingerprint>");
+            }
+            for (const auto& existing : builds) {
+                if (existing.fingerprint == fingerprint) return lineError("duplicate build fingerprint");
+            }
+            builds.emplace_back();
+            currentBuild = &builds.back();
+            currentBuild->name = tokens[1].text;
+            currentBuild->fingerprint = fingerprint;
+        } else {
+            return lineError("unknown keyword '" + keyword + "'");
+        }
+    }
+
+    if (current) {
+        error = "unterminated patch '" + current->name + "' (missing 'end')";
+        return false;
+    }
+    if (currentBuild) {
+        error = "unterminated build '" + currentBuild->name + "' (missing 'end')";
+        return false;
+    }
+
+    // --- Serialize ---
+    PoolBuilder pools;
+    std::vector<PatchRecord> patchRecords;
+    std::vector<ItemRecord> itemRecords;
+    std::vector<BundleRecord> bundleRecords;
+
+    for (const auto& p : patches) {
+        if (p.pattern.size() > 0xFFFF || p.original.size() > 0xFFFF || p.patched.size() > 0xFFFF) {
+            error = "patch '" + p.name + "' exceeds 65535 bytes";
+            return false;
+        }
+        PatchRecord record = {};
+        record.name = pools.addString(p.name);
+        record.description = pools.addString(p.description);
+        record.pattern = pools.addBlob(p.pattern);
+        record.mask = p.hasMask ? pools.addBlob(p.mask) : NONE;
+        record.original = pools.addBlob(p.original);
+        record.patched = pools.addBlob(p.patched);
+        record.patternLength = static_cast<uint16_t>(p.pattern.size());
+        record.originalLength = static_cast<uint16_t>(p.original.size());
+        record.patchedLength = static_cast<uint16_t>(p.patched.size());
+        record.section = p.section;
+        record.offset = p.offset;
+        record.rvaHint = p.rvaHint;
+        patchRecords.push_back(record);
+    }
+    for (const auto& item : items) {
+        ItemRecord record = {};
+        record.name = pools.addString(item.name);
+        record.description = pools.addString(item.description);
+        record.itemId = item.itemId;
+        record.category = item.category;
+        record.flags = item.flags;
+        itemRecords.push_back(record);
+    }
+    for (const auto& bundle : bundles) {
+        BundleRecord record = {};
+        record.name = pools.addString(bundle.name);
+        record.description = pools.addString(bundle.description);
+        record.itemIds = pools.addBlob(bundle.itemIds);
+        record.itemCount = static_cast<uint16_t>(bundle.itemIds.size());
+        bundleRecords.push_back(record);
+    }
+
+    std::vector<BuildRecord> buildRecords;
+    std::vector<BuildAddressRecord> addressRecords;
+    for (const auto& build : builds) {
+        BuildRecord record = {};
+        record.fingerprintLow = static_cast<uint32_t>(build.fingerprint);
+        record.fingerprintHigh = static_cast<uint32_t>(build.fingerprint >> 32);
+        record.name = pools.addString(build.name);
+        record.unlockTableRva = build.unlockTableRva;
+        record.jumpTableRva = build.jumpTableRva;
+        record.firstAddress = static_cast<uint32_t>(addressRecords.size());
+        record.addressCount = static_cast<uint32_t>(build.addresses.size());
+        for (const auto& [patchName, rva] : build.addresses) {
+            addressRecords.push_back({pools.addString(patchName), rva});
+        }
+        buildRecords.push_back(record);
+    }
+
+    // Open-addressed index, load factor <= 0.5
+    std::vector<uint32_t> buildIndex;
+    if (!buildRecords.empty()) {
+        size_t slots = 2;
+        while (slots < buildRecords.size() * 2) slots <<= 1;
+        buildIndex.assign(slots, NONE);
+        for (size_t i = 0; i < builds.size(); ++i) {
+            size_t slot = size_t(builds[i].fingerprint) & (slots - 1);
+            while (buildIndex[slot] != NONE) slot = (slot + 1) & (slots - 1);
+            buildIndex[slot] = static_cast<uint32_t>(i);
+        }
+    }
+
+    struct Payload { uint32_t tag; const void* data; size_t size; size_t count; };
+    const Payload payloads[] = {
+        {TAG_PATCHES, patchRecords.data(), patchRecords.size() * sizeof(PatchRecord), patchRecords.size()},
+        {TAG_ITEMS, itemRecords.data(), itemRecords.size() * sizeof(ItemRecord), itemRecords.size()},
+        {TAG_BUNDLES, bundleRecords.data(), bundleRecords.size() * sizeof(BundleRecord), bundleRecords.size()},
+        {TAG_BUILDS, buildRecords.data(), buildRecords.size() * sizeof(BuildRecord), buildRecords.size()},
+        {TAG_BUILD_ADDRESSES, addressRecords.data(), addressRecords.size() * sizeof(BuildAddressRecord), addressRecords.size()},
+        {TAG_BUILD_INDEX, buildIndex.data(), buildIndex.size() * sizeof(uint32_t), buildIndex.size()},
+        {TAG_STRINGS, pools.strings().data(), pools.strings().size(), 0},
+        {TAG_BLOB, pools.blob().data(), pools.blob().size(), 0}
+    };
+    constexpr size_t sectionCount = sizeof(payloads) / sizeof(payloads[0]);
+
+    output.assign(sizeof(FileHeader) + sectionCount * sizeof(SectionEntry), 0);
+    std::vector<SectionEntry> entries;
+    for (const auto& payload : payloads) {
+        SectionEntry entry = {};
+        entry.tag = payload.tag;
+        entry.offset = static_cast<uint32_t>(output.size());
+        entry.size = static_cast<uint32_t>(payload.size);
+        entry.count = static_cast<uint32_t>(payload.count);
+        entries.push_back(entry);
+        appendAligned(output, payload.data, payload.size);
+    }
+    std::memcpy(output.data() + sizeof(FileHeader), entries.data(), entries.size() * sizeof(SectionEntry));
+
+    FileHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.formatVersion = FORMAT_VERSION;
+    header.sectionCount = static_cast<uint16_t>(sectionCount);
+    header.dataVersion = dataVersion;
+    header.fileSize = static_cast<uint32_t>(output.size());
+    header.unlockTableRva = tableRva;
+    header.checksum = checksum(output.data() + sizeof(FileHeader), output.size() - sizeof(FileHeader));
+    std::memcpy(output.data(), &header, sizeof(header));
+
+    return true;
+}
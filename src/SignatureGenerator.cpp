@@ -0,0 +1,115 @@
+/**
+ * @file SignatureGenerator.cpp
+ * @brief Builds the shortest unique masked signature for a code address
+ */
+
+#include "SignatureGenerator.h"
+#include "X86Length.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+
+std::string hex(uint64_t value)
+{
+    char text[24];
+    std::snprintf(text, sizeof(text), "0x%llX", static_cast<unsigned long long>(value));
+    return text;
+}
+
+void wildcard(std::vector<uint8_t>& mask, size_t first, size_t count)
+{
+    std::fill(mask.begin() + first, mask.begin() + first + count, 0x00);
+}
+
+} // namespace
+
+std::string SignatureGenerator::Signature::toString() const
+{
+    std::string text;
+    text.reserve(pattern.size() * 3);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char byte[4];
+        if (mask[i] == 0x00) {
+            std::snprintf(byte, sizeof(byte), "??");
+        } else {
+            std::snprintf(byte, sizeof(byte), "%02X", pattern[i]);
+        }
+        if (i) text += ' ';
+        text += byte;
+    }
+    return text;
+}
+
+SignatureGenerator::SignatureGenerator(const NgramIndex& index)
+    : m_index(index)
+{
+}
+
+bool SignatureGenerator::fail(const std::string& error)
+{
+    m_lastError = error;
+    return false;
+}
+
+bool SignatureGenerator::isUnique(const Signature& signature, size_t length) const
+{
+    // Without a fixed 4-byte window the lookup is a full scan; keep extending instead
+    size_t fixedRun = 0;
+    for (size_t i = 0; i < length && fixedRun < NgramIndex::GRAM_SIZE; ++i) {
+        fixedRun = signature.mask[i] ? fixedRun + 1 : 0;
+    }
+    if (fixedRun < NgramIndex::GRAM_SIZE) return false;
+
+    ByteView pattern(signature.pattern.data(), length);
+    ByteView mask(signature.mask.data(), length);
+    return m_index.count(pattern, mask, 2) == 1;
+}
+
+bool SignatureGenerator::generate(uint32_t rva, Signature& signature)
+{
+    signature = Signature();
+    signature.rva = rva;
+    if (!m_index.isBuilt() || rva >= m_index.imageSize()) {
+        return fail("RVA " + hex(rva) + " is outside the indexed image");
+    }
+
+    const uint8_t* code = m_index.image() + rva;
+    size_t available = m_index.imageSize() - rva;
+
+    size_t offset = 0;
+    while (offset < m_maxLength) {
+        X86::Instruction instruction;
+        if (!X86::decode(code + offset, available - offset, instruction)) {
+            return fail("No valid instruction at RVA " + hex(rva + offset));
+        }
+
+        size_t start = offset;
+        signature.pattern.insert(signature.pattern.end(), code + start, code + start + instruction.length);
+        signature.mask.resize(signature.pattern.size(), 0xFF);
+        if (instruction.displacementSize == 4) {
+            wildcard(signature.mask, start + instruction.displacementOffset, 4);
+        }
+        if ((instruction.relativeBranch && instruction.immediateSize == 4) || instruction.immediateSize == 8) {
+            wildcard(signature.mask, start + instruction.immediateOffset, instruction.immediateSize);
+        }
+        offset += instruction.length;
+        ++signature.instructions;
+
+        size_t end = std::min(offset, m_maxLength);
+        if (!isUnique(signature, end)) continue;
+
+        // Everything before this instruction was ambiguous, so only its bytes can be cut
+        for (size_t length = start + 1; length <= end; ++length) {
+            if (signature.mask[length - 1] == 0x00) continue;
+            if (isUnique(signature, length)) {
+                signature.pattern.resize(length);
+                signature.mask.resize(length);
+                return true;
+            }
+        }
+    }
+
+    return fail("No unique signature at RVA " + hex(rva) + " within " + std::to_string(m_maxLength) + " bytes");
+}
@@ -0,0 +1,340 @@
+/**
+ * @file SlotProber.cpp
+ * @brief Automated sweep over the unmapped unlock table slots
+ */
+
+#include "SlotProber.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+
+std::string hex(uint64_t value, int width)
+{
+    char text[24];
+    std::snprintf(text, sizeof(text), "0x%0*llX", width, static_cast<unsigned long long>(value));
+    return text;
+}
+
+std::string trim(const std::string& text)
+{
+    size_t first = text.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return {};
+    size_t last = text.find_last_not_of(" \t\r\n");
+    return text.substr(first, last - first + 1);
+}
+
+/// Decimal or 0x-prefixed hex; the whole string must be consumed
+bool parseNumber(const std::string& text, uint32_t& value)
+{
+    std::string digits = trim(text);
+    int base = 10;
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        digits = digits.substr(2);
+        base = 16;
+    }
+    if (digits.empty()) return false;
+
+    char* end = nullptr;
+    unsigned long long parsed = std::strtoull(digits.c_str(), &end, base);
+    if (*end != '\0' || parsed > 0xFFFFFFFFull) return false;
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Construction / Destruction
+// ============================================================================
+
+SlotProber::SlotProber(MemoryEditor* editor, QObject* parent)
+    : QObject(parent)
+    , m_editor(editor)
+{
+    m_settleTimer.setSingleShot(true);
+    connect(&m_settleTimer, &QTimer::timeout, this, &SlotProber::onSettled);
+    connect(editor, &MemoryEditor::processDetached, this, &SlotProber::onProcessDetached);
+}
+
+SlotProber::~SlotProber()
+{
+    // Last resort: owners should cancel() while the editor is still attached
+    // (a sibling editor created first is destroyed first and has detached)
+    if (m_settleTimer.isActive() && m_editor && m_editor->isAttached()) {
+        m_settleTimer.stop();
+        restoreSlot();
+    }
+}
+
+// ============================================================================
+// Configuration
+// ============================================================================
+
+UnlockMask SlotProber::unmappedSlots(const UnlockRegistry& registry)
+{
+    UnlockMask table = (UnlockMask(1) << UnlockRegistry::TABLE_SLOTS) - 1;
+    return table & ~registry.itemMask() & ~registry.allBundlesMask() & ~EXCLUDED_SLOTS;
+}
+
+bool SlotProber::parseWatches(const std::string& spec, std::vector<Watch>& watches, std::string& error)
+{
+    watches.clear();
+
+    size_t position = 0;
+    while (position <= spec.size()) {
+        size_t separator = spec.find(';', position);
+        if (separator == std::string::npos) separator = spec.size();
+        std::string entry = trim(spec.substr(position, separator - position));
+        position = separator + 1;
+        if (entry.empty()) continue;
+
+        size_t at = entry.find('@');
+        size_t plus = entry.find('+', at == std::string::npos ? 0 : at);
+        if (at == std::string::npos || plus == std::string::npos) {
+            error = "Expected name@rva+size: " + entry;
+            return false;
+        }
+
+        Watch watch;
+        watch.name = trim(entry.substr(0, at));
+        if (watch.name.empty()) {
+            error = "Watch has no name: " + entry;
+            return false;
+        }
+        if (!parseNumber(entry.substr(at + 1, plus - at - 1), watch.rva) ||
+            !parseNumber(entry.substr(plus + 1), watch.size)) {
+            error = "Invalid number in watch: " + entry;
+            return false;
+        }
+        if (watch.size == 0 || watch.size > MAX_WATCH_SIZE) {
+            error = "Watch size must be 1 to " + hex(MAX_WATCH_SIZE, 0) + " bytes: " + entry;
+            return false;
+        }
+        watches.push_back(watch);
+    }
+    return true;
+}
+
+// ============================================================================
+// Sweep Control
+// ============================================================================
+
+bool SlotProber::start(const Config& config)
+{
+    if (m_running) {
+        m_lastError = "A probe sweep is already running";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    if (!m_editor->isAttached() || m_editor->getModuleBase() == 0) {
+        m_lastError = "Not attached to process";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+
+    const UnlockRegistry& registry = m_editor->getUnlockRegistry();
+
+    // Known items are never probed: their bytes belong to the enabled mask
+    m_config = config;
+    m_config.candidates &= unmappedSlots(registry);
+    if (m_config.candidates == 0) {
+        m_lastError = "No unmapped slots among the candidates";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        return false;
+    }
+    if (m_config.settleMs < 0) m_config.settleMs = 0;
+
+    m_tableBase = registry.tableBase();
+    m_moduleBase = m_editor->getModuleBase();
+
+    m_slots.clear();
+    for (uint8_t itemId = 0; itemId < UnlockRegistry::TABLE_SLOTS; ++itemId) {
+        if (m_config.candidates & UnlockRegistry::bit(itemId)) m_slots.push_back(itemId);
+    }
+    m_nextSlot = 0;
+    m_results.clear();
+    m_results.reserve(m_slots.size());
+    m_running = true;
+
+    probeNext();
+    return true;
+}
+
+void SlotProber::cancel()
+{
+    if (!m_running) return;
+
+    if (m_settleTimer.isActive()) {
+        m_settleTimer.stop();
+        if (!restoreSlot()) {
+            m_lastError = "Failed to restore slot " + hex(m_slots[m_nextSlot], 2);
+            emit errorOccurred(QString::fromStdString(m_lastError));
+        }
+    }
+    finish(true);
+}
+
+// ============================================================================
+// Probe Rounds
+// ============================================================================
+
+/// Range 0 is the slot itself, followed by one range per watch
+std::vector<MemoryEditor::MemoryRange> SlotProber::roundRanges(uint8_t itemId) const
+{
+    std::vector<MemoryEditor::MemoryRange> ranges;
+    ranges.reserve(m_config.watches.size() + 1);
+    ranges.push_back({m_tableBase + itemId, 1});
+    for (const auto& watch : m_config.watches) {
+        ranges.push_back({m_moduleBase + watch.rva, watch.size});
+    }
+    return ranges;
+}
+
+void SlotProber::probeNext()
+{
+    while (m_nextSlot < m_slots.size()) {
+        uint8_t itemId = m_slots[m_nextSlot];
+
+        m_before = m_editor->readBatch(roundRanges(itemId));
+        if (m_before[0].size() == 1) {
+            m_slotWrite = m_config.probeValue;
+            if (m_editor->writeBatch({{m_tableBase + itemId, ByteView(&m_slotWrite, 1)}})) {
+                m_settleTimer.start(m_config.settleMs);
+                return;
+            }
+        }
+
+        // Slot could not be read or set; record it and move on
+        SlotResult result;
+        result.itemId = itemId;
+        result.slotUnreadable = true;
+        m_results.push_back(result);
+        emit slotProbed(itemId, 0);
+        ++m_nextSlot;
+    }
+    finish(false);
+}
+
+void SlotProber::onSettled()
+{
+    uint8_t itemId = m_slots[m_nextSlot];
+    std::vector<std::vector<uint8_t>> after = m_editor->readBatch(roundRanges(itemId));
+
+    if (!restoreSlot()) {
+        m_lastError = "Failed to restore slot " + hex(itemId, 2) + ", sweep stopped";
+        emit errorOccurred(QString::fromStdString(m_lastError));
+        finish(true);
+        return;
+    }
+
+    SlotResult result;
+    result.itemId = itemId;
+    result.originalValue = m_before[0][0];
+    result.valueAfterSettle = after[0].size() == 1 ? after[0][0] : m_config.probeValue;
+
+    size_t totalChanged = 0;
+    result.watches.resize(m_config.watches.size());
+    for (size_t w = 0; w < m_config.watches.size(); ++w) {
+        const std::vector<uint8_t>& before = m_before[w + 1];
+        const std::vector<uint8_t>& now = after[w + 1];
+        WatchDiff& diff = result.watches[w];
+        if (before.size() != m_config.watches[w].size || now.size() != before.size()) {
+            diff.readFailed = true;
+            continue;
+        }
+        for (size_t i = 0; i < before.size(); ++i) {
+            if (before[i] == now[i]) continue;
+            if (diff.changes.size() < MAX_REPORTED_CHANGES) {
+                diff.changes.push_back({static_cast<uint32_t>(i), before[i], now[i]});
+            }
+            ++diff.changedBytes;
+        }
+        totalChanged += diff.changedBytes;
+    }
+
+    m_results.push_back(std::move(result));
+    emit slotProbed(itemId, static_cast<int>(totalChanged));
+
+    ++m_nextSlot;
+    probeNext();
+}
+
+bool SlotProber::restoreSlot()
+{
+    if (m_before.empty() || m_before[0].size() != 1) return false;
+
+    m_slotWrite = m_before[0][0];
+    return m_editor->writeBatch({{m_tableBase + m_slots[m_nextSlot], ByteView(&m_slotWrite, 1)}});
+}
+
+void SlotProber::onProcessDetached()
+{
+    // The handle is gone, so there is nothing to restore
+    if (!m_running) return;
+    m_settleTimer.stop();
+    finish(true);
+}
+
+void SlotProber::finish(bool cancelled)
+{
+    m_running = false;
+    m_before.clear();
+    emit finished(static_cast<int>(m_results.size()), cancelled);
+}
+
+// ============================================================================
+// Report
+// ============================================================================
+
+std::string SlotProber::report() const
+{
+    std::string text = "FFXV unlock table slot probe\n";
+    if (auto fingerprint = m_editor->getBuildFingerprint()) {
+        text += "Build:        " + fingerprint->toString() + "\n";
+    }
+    text += "Table base:   " + hex(m_tableBase, 0) + "\n";
+    text += "Module base:  " + hex(m_moduleBase, 0) + "\n";
+    text += "Probe value:  " + hex(m_config.probeValue, 2) + "\n";
+    text += "Settle:       " + std::to_string(m_config.settleMs) + " ms\n";
+    text += "Watches:\n";
+    for (const auto& watch : m_config.watches) {
+        text += "  " + watch.name + "  rva " + hex(watch.rva, 0) + "  size " + hex(watch.size, 0) + "\n";
+    }
+    text += "Slots probed: " + std::to_string(m_results.size()) + "\n\n";
+
+    for (const auto& result : m_results) {
+        text += "slot " + hex(result.itemId, 2) + "  @" + hex(m_tableBase + result.itemId, 0);
+        if (result.slotUnreadable) {
+            text += "  could not be read or written\n";
+            continue;
+        }
+        text += "  was " + hex(result.originalValue, 2) +
+                "  after settle " + hex(result.valueAfterSettle, 2) + "\n";
+
+        bool anyChange = result.valueAfterSettle != m_config.probeValue;
+        for (size_t w = 0; w < result.watches.size(); ++w) {
+            const WatchDiff& diff = result.watches[w];
+            const std::string& name = m_config.watches[w].name;
+            if (diff.readFailed) {
+                text += "  " + name + ": read failed\n";
+                continue;
+            }
+            if (diff.changedBytes == 0) continue;
+
+            anyChange = true;
+            text += "  " + name + ": " + std::to_string(diff.changedBytes) + " bytes changed\n";
+            for (const auto& change : diff.changes) {
+                text += "    +" + hex(change.offset, 4) + "  " + hex(change.before, 2) +
+                        " -> " + hex(change.after, 2) + "\n";
+            }
+            if (diff.changedBytes > diff.changes.size()) {
+                text += "    ...\n";
+            }
+        }
+        if (!anyChange) {
+            text += "  no change\n";
+        }
+    }
+    return text;
+}
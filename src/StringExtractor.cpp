@@ -0,0 +1,255 @@
+/**
+ * @file StringExtractor.cpp
+ * @brief Printable ASCII / UTF-16LE string extraction and URL redirect candidates
+ */
+
+#include "StringExtractor.h"
+#include "UrlRedirect.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define STRINGS_SSE2 1
+#endif
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace Strings {
+
+namespace {
+
+constexpr size_t BLOCK_SIZE = 64;   ///< Bytes per classification mask
+
+/// Longest first, so "https" wins over "http" and "wss" over "ws"
+constexpr const char* KNOWN_SCHEMES[] = {"https", "http", "wss", "ws", "ftp"};
+
+bool isPrintable(uint8_t c)
+{
+    return c >= 0x20 && c <= 0x7E;
+}
+
+/// Bit i of printable/zero describes p[i]; bits at or past count are clear
+void classify(const uint8_t* p, size_t count, uint64_t& printable, uint64_t& zero)
+{
+    printable = 0;
+    zero = 0;
+#ifdef STRINGS_SSE2
+    if (count == BLOCK_SIZE) {
+        // c + 0x60 maps 0x20..0x7E onto -128..-34 as signed bytes, and
+        // every other byte above that
+        const __m128i bias = _mm_set1_epi8(0x60);
+        const __m128i limit = _mm_set1_epi8(-33);
+        const __m128i nul = _mm_setzero_si128();
+        for (size_t i = 0; i < BLOCK_SIZE; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            uint32_t isText = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(bytes, bias), limit)));
+            uint32_t isZero = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, nul)));
+            printable |= uint64_t(isText) << i;
+            zero |= uint64_t(isZero) << i;
+        }
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i) {
+        printable |= uint64_t(isPrintable(p[i])) << i;
+        zero |= uint64_t(p[i] == 0) << i;
+    }
+}
+
+unsigned lowestBit(uint64_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+bool isSchemeChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '+' || c == '-' || c == '.';
+}
+
+bool isHostChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '-' || c == '.' || c == '_' || c == '%' || c == ':';
+}
+
+std::vector<uint8_t> widen(const std::vector<uint8_t>& narrow)
+{
+    std::vector<uint8_t> wide;
+    wide.reserve(narrow.size() * 2);
+    for (uint8_t c : narrow) {
+        wide.push_back(c);
+        wide.push_back(0);
+    }
+    return wide;
+}
+
+} // namespace
+
+const char* encodingName(Encoding encoding)
+{
+    return encoding == Encoding::Utf16 ? "utf-16le" : "ascii";
+}
+
+std::vector<Record> extract(const uint8_t* data, size_t size, uint32_t rva, size_t minLength)
+{
+    std::vector<Record> records;
+    if (!data || minLength == 0) return records;
+
+    bool inRun = false;
+    size_t runStart = 0;
+    size_t wideEnd = 0;     // UTF-16 code units before this were already consumed
+
+    auto emitAscii = [&](size_t end) {
+        if (end - runStart < minLength) return;
+        Record record;
+        record.rva = static_cast<uint32_t>(rva + runStart);
+        record.encoding = Encoding::Ascii;
+        record.terminated = end < size && data[end] == 0;
+        record.text.assign(reinterpret_cast<const char*>(data + runStart), end - runStart);
+        records.push_back(std::move(record));
+    };
+
+    // Runs of printable bytes shorter than this are dropped by the mask test
+    // alone; longer minimums are checked when the run ends
+    const size_t maskedLength = std::min(minLength, BLOCK_SIZE);
+
+    uint64_t printable, zero;
+    classify(data, std::min(BLOCK_SIZE, size), printable, zero);
+    uint64_t previousTop = 0;   // Printable bit of the byte before the block
+
+    for (size_t base = 0; base < size; base += BLOCK_SIZE) {
+        size_t count = std::min(BLOCK_SIZE, size - base);
+        uint64_t nextPrintable = 0, nextZero = 0;
+        if (base + BLOCK_SIZE < size) {
+            classify(data + base + BLOCK_SIZE, std::min(BLOCK_SIZE, size - base - BLOCK_SIZE), nextPrintable, nextZero);
+        }
+
+        // ASCII: bit i of longRuns is set when maskedLength printable bytes start at i
+        uint64_t longRuns = printable;
+        for (size_t k = 1; k < maskedLength && longRuns; ++k) {
+            longRuns &= (printable >> k) | (nextPrintable << (BLOCK_SIZE - k));
+        }
+        uint64_t runStarts = longRuns & ~((printable << 1) | previousTop);
+        uint64_t nonPrintable = ~printable;
+        if (count < BLOCK_SIZE) nonPrintable &= (uint64_t(1) << count) - 1;
+
+        for (;;) {
+            if (inRun) {
+                uint64_t ends = nonPrintable & ~uint64_t(0) << (runStart > base ? runStart - base : 0);
+                if (!ends) break;
+                unsigned end = lowestBit(ends);
+                emitAscii(base + end);
+                inRun = false;
+                runStarts &= ~uint64_t(0) << end;
+            } else {
+                if (!runStarts) break;
+                runStart = base + lowestBit(runStarts);
+                inRun = true;
+            }
+        }
+        previousTop = printable >> (BLOCK_SIZE - 1);
+
+        // UTF-16LE: a printable byte followed by a zero byte starts or continues a string
+        uint64_t units = printable & ((zero >> 1) | (nextZero << (BLOCK_SIZE - 1)));
+        while (units) {
+            size_t start = base + lowestBit(units);
+            units &= units - 1;
+            if (start < wideEnd) continue;
+
+            size_t end = start;
+            while (end + 1 < size && isPrintable(data[end]) && data[end + 1] == 0) end += 2;
+            wideEnd = end;
+            if ((end - start) / 2 < minLength) continue;
+
+            Record record;
+            record.rva = static_cast<uint32_t>(rva + start);
+            record.encoding = Encoding::Utf16;
+            record.terminated = end + 1 < size && data[end] == 0 && data[end + 1] == 0;
+            for (size_t i = start; i < end; i += 2) record.text += static_cast<char>(data[i]);
+            records.push_back(std::move(record));
+        }
+
+        printable = nextPrintable;
+        zero = nextZero;
+    }
+    if (inRun) emitAscii(size);
+
+    std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.rva != b.rva ? a.rva < b.rva : a.encoding < b.encoding;
+    });
+    return records;
+}
+
+std::optional<size_t> findUrl(const std::string& text)
+{
+    for (size_t separator = text.find("://"); separator != std::string::npos;
+         separator = text.find("://", separator + 1)) {
+        size_t start = separator;
+        while (start > 0 && isSchemeChar(text[start - 1])) --start;
+        while (start < separator && !std::isalpha(static_cast<unsigned char>(text[start]))) ++start;
+        if (separator - start < 2) continue;
+
+        // Letters of the data just before the string run into the scheme
+        // ("Xhttps://"); cut back to a known scheme where one ends the run
+        for (const char* scheme : KNOWN_SCHEMES) {
+            size_t length = std::strlen(scheme);
+            if (separator - start > length && text.compare(separator - length, length, scheme) == 0) {
+                start = separator - length;
+                break;
+            }
+        }
+
+        size_t hostEnd = separator + 3;
+        while (hostEnd < text.size() && isHostChar(text[hostEnd])) ++hostEnd;
+        std::string host = text.substr(separator + 3, hostEnd - separator - 3);
+        if (host.find('.') != std::string::npos || host.compare(0, 9, "localhost") == 0) {
+            return start;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<Record> urls(const std::vector<Record>& records)
+{
+    std::vector<Record> found;
+    for (const Record& record : records) {
+        auto offset = findUrl(record.text);
+        if (!offset) continue;
+
+        Record url = record;
+        url.rva += static_cast<uint32_t>(*offset * (record.encoding == Encoding::Utf16 ? 2 : 1));
+        url.text.erase(0, *offset);
+        found.push_back(std::move(url));
+    }
+    return found;
+}
+
+std::optional<Redirect> redirect(const Record& url, uint16_t port)
+{
+    std::vector<uint8_t> original(url.text.begin(), url.text.end());
+    if (url.terminated) original.push_back(0);
+
+    std::vector<uint8_t> patched(original.size());
+    if (!UrlRedirect::regenerate(original.data(), original.size(), port, patched.data())) {
+        return std::nullopt;
+    }
+
+    if (url.encoding == Encoding::Utf16) {
+        return Redirect{widen(original), widen(patched)};
+    }
+    return Redirect{std::move(original), std::move(patched)};
+}
+
+} // namespace Strings
@@ -0,0 +1,161 @@
+/**
+ * @file SuffixArray.cpp
+ * @brief Suffix array construction by induced sorting (SA-IS)
+ */
+
+#include "SuffixArray.h"
+#include "Parallel.h"
+
+#include <algorithm>
+
+namespace {
+
+using Buckets = std::vector<int32_t>;
+
+/// Bucket starts for L-type (sumL) and S-type (sumS) suffixes of each symbol
+template <typename T>
+void countBuckets(const T* s, int32_t n, int32_t upper, const std::vector<bool>& ls,
+                  unsigned threads, Buckets& sumL, Buckets& sumS)
+{
+    sumL.assign(upper + 1, 0);
+    sumS.assign(upper + 1, 0);
+
+    // Per-thread histograms only pay off while they are small next to the text
+    if (threads > 1 && size_t(upper + 1) * threads > size_t(n)) threads = 1;
+
+    std::vector<Buckets> localL(threads, Buckets(upper + 1, 0));
+    std::vector<Buckets> localS(threads, Buckets(upper + 1, 0));
+    Parallel::forRanges(n, threads, [&](size_t begin, size_t end, unsigned thread) {
+        Buckets& l = localL[thread];
+        Buckets& t = localS[thread];
+        for (size_t i = begin; i < end; ++i) {
+            if (!ls[i]) {
+                ++t[s[i]];
+            } else if (s[i] < upper) {
+                ++l[s[i] + 1];
+            }
+        }
+    });
+    for (unsigned t = 0; t < threads; ++t) {
+        for (int32_t c = 0; c <= upper; ++c) {
+            sumL[c] += localL[t][c];
+            sumS[c] += localS[t][c];
+        }
+    }
+
+    for (int32_t c = 0; c <= upper; ++c) {
+        sumS[c] += sumL[c];
+        if (c < upper) sumL[c + 1] += sumS[c];
+    }
+}
+
+template <typename T>
+void induce(const T* s, int32_t n, const std::vector<bool>& ls, const std::vector<int32_t>& lms,
+            const Buckets& sumL, const Buckets& sumS, std::vector<int32_t>& sa)
+{
+    std::fill(sa.begin(), sa.end(), -1);
+    Buckets buffer(sumS);
+    for (int32_t d : lms) {
+        if (d == n) continue;
+        sa[buffer[s[d]]++] = d;
+    }
+
+    // L-type suffixes left to right, then S-type right to left
+    buffer = sumL;
+    sa[buffer[s[n - 1]]++] = n - 1;
+    for (int32_t i = 0; i < n; ++i) {
+        int32_t v = sa[i];
+        if (v >= 1 && !ls[v - 1]) sa[buffer[s[v - 1]]++] = v - 1;
+    }
+    buffer = sumL;
+    for (int32_t i = n - 1; i >= 0; --i) {
+        int32_t v = sa[i];
+        if (v >= 1 && ls[v - 1]) sa[--buffer[s[v - 1] + 1]] = v - 1;
+    }
+}
+
+/// s[i] in [0, upper]; no sentinel in the input
+template <typename T>
+std::vector<int32_t> sais(const T* s, int32_t n, int32_t upper, unsigned threads)
+{
+    if (n == 0) return {};
+    if (n == 1) return {0};
+    if (n == 2) return s[0] < s[1] ? std::vector<int32_t>{0, 1} : std::vector<int32_t>{1, 0};
+
+    std::vector<int32_t> sa(n);
+    std::vector<bool> ls(n, false);  // true = S-type
+    for (int32_t i = n - 2; i >= 0; --i) {
+        ls[i] = (s[i] == s[i + 1]) ? ls[i + 1] : (s[i] < s[i + 1]);
+    }
+
+    Buckets sumL, sumS;
+    countBuckets(s, n, upper, ls, threads, sumL, sumS);
+
+    std::vector<int32_t> lmsMap(n + 1, -1);
+    std::vector<int32_t> lms;
+    for (int32_t i = 1; i < n; ++i) {
+        if (!ls[i - 1] && ls[i]) {
+            lmsMap[i] = static_cast<int32_t>(lms.size());
+            lms.push_back(i);
+        }
+    }
+    int32_t m = static_cast<int32_t>(lms.size());
+
+    induce(s, n, ls, lms, sumL, sumS, sa);
+    if (m == 0) return sa;
+
+    std::vector<int32_t> sortedLms;
+    sortedLms.reserve(m);
+    for (int32_t v : sa) {
+        if (lmsMap[v] != -1) sortedLms.push_back(v);
+    }
+
+    // Neighbouring LMS substrings are compared independently; naming them is a prefix sum
+    std::vector<uint8_t> differs(m, 0);
+    Parallel::forRanges(m > 0 ? m - 1 : 0, threads, [&](size_t begin, size_t end, unsigned) {
+        for (size_t k = begin + 1; k < end + 1; ++k) {
+            int32_t l = sortedLms[k - 1];
+            int32_t r = sortedLms[k];
+            int32_t endL = (lmsMap[l] + 1 < m) ? lms[lmsMap[l] + 1] : n;
+            int32_t endR = (lmsMap[r] + 1 < m) ? lms[lmsMap[r] + 1] : n;
+            bool same = endL - l == endR - r;
+            if (same) {
+                while (l < endL && s[l] == s[r]) {
+                    ++l;
+                    ++r;
+                }
+                if (l == n || s[l] != s[r]) same = false;
+            }
+            differs[k] = !same;
+        }
+    });
+
+    std::vector<int32_t> reduced(m);
+    int32_t name = 0;
+    reduced[lmsMap[sortedLms[0]]] = 0;
+    for (int32_t k = 1; k < m; ++k) {
+        name += differs[k];
+        reduced[lmsMap[sortedLms[k]]] = name;
+    }
+    lmsMap = std::vector<int32_t>();
+    differs = std::vector<uint8_t>();
+
+    std::vector<int32_t> reducedSa = sais(reduced.data(), m, name, threads);
+    for (int32_t k = 0; k < m; ++k) {
+        sortedLms[k] = lms[reducedSa[k]];
+    }
+    induce(s, n, ls, sortedLms, sumL, sumS, sa);
+    return sa;
+}
+
+} // namespace
+
+namespace SuffixArray {
+
+std::vector<int32_t> build(const uint8_t* text, size_t size, unsigned threads)
+{
+    if (!text || size == 0 || size > MAX_TEXT_SIZE) return {};
+    return sais(text, static_cast<int32_t>(size), 255, Parallel::threadCount(threads));
+}
+
+} // namespace SuffixArray
@@ -0,0 +1,180 @@
+/**
+ * @file SyntheticImage.cpp
+ * @brief Stand-in ffxv_s.exe module image for tests and benchmarks
+ */
+
+#include "SyntheticImage.h"
+#include "Patches.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+using SyntheticImage::TEXT_RVA;
+
+constexpr size_t PAGE_SIZE = 0x1000;
+constexpr uint32_t NT_OFFSET = 0x80;
+constexpr uint16_t OPTIONAL_HEADER_SIZE = 0xF0;
+constexpr uint32_t TIME_DATE_STAMP = 0x5C8A1F00;
+
+// Reference build layout (see Patches.h and docs/ffxv_unlock_research.md)
+constexpr uint32_t TABLE_LOOKUP_RVA = 0x751CAC;     // movzx eax, byte [r8+rax+table]
+constexpr uint32_t DISPATCH_RVA = 0x751CD5 - 3;     // movsxd rax, ebp before the mov at 0x751CD5
+constexpr uint32_t HANDLERS_RVA = 0x751E00;
+constexpr uint32_t HANDLER_COUNT = 5;
+constexpr uint32_t HANDLER_SPACING = 0x10;
+
+/// Kept clear of the unhinted sites so they never land in the hinted code
+constexpr uint32_t RESERVED_BEGIN = 0x750000;
+constexpr uint32_t RESERVED_END = 0x754000;
+
+template <typename T>
+void put(std::vector<uint8_t>& image, size_t offset, T value)
+{
+    std::memcpy(image.data() + offset, &value, sizeof(T));
+}
+
+void putBytes(std::vector<uint8_t>& image, size_t offset, ByteView bytes)
+{
+    std::copy(bytes.begin(), bytes.end(), image.begin() + offset);
+}
+
+void writeSection(std::vector<uint8_t>& image, size_t header, const char* name, uint32_t rva, uint32_t size,
+                  uint32_t characteristics)
+{
+    std::memcpy(image.data() + header, name, std::min<size_t>(std::strlen(name), 8));
+    put<uint32_t>(image, header + 8, size);             // VirtualSize
+    put<uint32_t>(image, header + 12, rva);             // VirtualAddress
+    put<uint32_t>(image, header + 16, size);            // SizeOfRawData
+    put<uint32_t>(image, header + 20, rva);             // PointerToRawData (file laid out as mapped)
+    put<uint32_t>(image, header + 36, characteristics);
+}
+
+void writeHeaders(std::vector<uint8_t>& image, uint64_t imageBase, uint32_t textSize, uint32_t rdataRva)
+{
+    put<uint16_t>(image, 0, 0x5A4D);                    // "MZ"
+    put<uint32_t>(image, 0x3C, NT_OFFSET);
+    put<uint32_t>(image, NT_OFFSET, 0x00004550);        // "PE\0\0"
+
+    size_t file = NT_OFFSET + 4;
+    put<uint16_t>(image, file + 0, 0x8664);             // AMD64
+    put<uint16_t>(image, file + 2, 2);                  // Sections
+    put<uint32_t>(image, file + 4, TIME_DATE_STAMP);
+    put<uint16_t>(image, file + 16, OPTIONAL_HEADER_SIZE);
+    put<uint16_t>(image, file + 18, 0x0022);            // Executable, large address aware
+
+    size_t optional = file + 20;
+    put<uint16_t>(image, optional + 0, 0x020B);         // PE32+
+    put<uint32_t>(image, optional + 4, textSize);       // SizeOfCode
+    put<uint32_t>(image, optional + 16, TEXT_RVA);      // AddressOfEntryPoint
+    put<uint32_t>(image, optional + 20, TEXT_RVA);      // BaseOfCode
+    put<uint64_t>(image, optional + 24, imageBase);
+    put<uint32_t>(image, optional + 32, PAGE_SIZE);     // SectionAlignment
+    put<uint32_t>(image, optional + 36, PAGE_SIZE);     // FileAlignment
+    put<uint16_t>(image, optional + 40, 6);             // OS version
+    put<uint16_t>(image, optional + 48, 6);             // Subsystem version
+    put<uint32_t>(image, optional + 56, static_cast<uint32_t>(image.size()));
+    put<uint32_t>(image, optional + 60, PAGE_SIZE);     // SizeOfHeaders
+    put<uint16_t>(image, optional + 68, 2);             // Windows GUI
+    put<uint32_t>(image, optional + 108, 16);           // NumberOfRvaAndSizes
+
+    size_t sections = optional + OPTIONAL_HEADER_SIZE;
+    writeSection(image, sections, ".text", TEXT_RVA, textSize, 0x60000020);       // Code, execute, read
+    writeSection(image, sections + 40, ".rdata", rdataRva, SyntheticImage::RDATA_SIZE, 0x40000040);
+}
+
+/// xorshift64; any fixed sequence will do
+void fillText(std::vector<uint8_t>& image, uint32_t textSize)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = TEXT_RVA; i < TEXT_RVA + textSize; i += 8) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        std::memcpy(image.data() + i, &state, std::min<size_t>(8, TEXT_RVA + textSize - i));
+    }
+}
+
+/// The match and the original bytes at match + offset (they overlap or coincide for most patches)
+void placePatch(SyntheticImage::Image& image, const Patches::Patch& patch, uint32_t matchRva)
+{
+    putBytes(image.bytes, matchRva, patch.pattern);
+    putBytes(image.bytes, matchRva + patch.offset, patch.original);
+    image.sites.push_back({patch.name, static_cast<uint32_t>(matchRva + patch.offset)});
+}
+
+void placeReference(SyntheticImage::Image& image, const Patches::OperandReference& reference, uint32_t matchRva,
+                    uint32_t targetRva)
+{
+    putBytes(image.bytes, matchRva, reference.pattern);
+    put<uint32_t>(image.bytes, matchRva + reference.operandOffset, targetRva);
+    image.sites.push_back({reference.name, matchRva});
+}
+
+} // namespace
+
+namespace SyntheticImage {
+
+bool build(size_t size, uint64_t imageBase, Image& image)
+{
+    size = (size + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    if (size < MIN_SIZE || size > 0xFFFFF000ull) {
+        return false;
+    }
+
+    image.bytes.assign(size, 0);
+    image.sites.clear();
+    image.rdataRva = static_cast<uint32_t>(size - RDATA_SIZE);
+    image.textSize = image.rdataRva - TEXT_RVA;
+    writeHeaders(image.bytes, imageBase, image.textSize, image.rdataRva);
+    fillText(image.bytes, image.textSize);
+
+    // Phase 4 to 6 code around the tables, at the reference build's RVAs
+    uint32_t tableRva = static_cast<uint32_t>(Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+    uint32_t jumpTableRva = static_cast<uint32_t>(Patches::JUMP_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+    placeReference(image, Patches::UNLOCK_TABLE_REFERENCE, TABLE_LOOKUP_RVA, tableRva);
+    placeReference(image, Patches::JUMP_TABLE_REFERENCE, DISPATCH_RVA, jumpTableRva);
+
+    std::fill(image.bytes.begin() + tableRva, image.bytes.begin() + jumpTableRva, 0);
+    image.sites.push_back({"Unlock Table", tableRva});
+    for (uint32_t i = 0; i < Patches::JUMP_TABLE_ENTRIES; ++i) {
+        put<uint32_t>(image.bytes, jumpTableRva + i * 4, HANDLERS_RVA + (i % HANDLER_COUNT) * HANDLER_SPACING);
+    }
+    image.sites.push_back({"Jump Table", jumpTableRva});
+
+    // Hinted patches at their hints; the others spread evenly over .text
+    std::vector<const Patches::Patch*> unhinted;
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        if (patch->section == Patches::SectionHint::RData) continue;
+        if (patch->rvaHint != 0) {
+            placePatch(image, *patch, patch->rvaHint - patch->offset);
+        } else {
+            unhinted.push_back(patch);
+        }
+    }
+    for (size_t i = 0; i < unhinted.size(); ++i) {
+        uint32_t rva = static_cast<uint32_t>(TEXT_RVA + uint64_t(image.textSize) * (i + 1) / (unhinted.size() + 1));
+        rva &= ~0xFu;
+        if (rva >= RESERVED_BEGIN - 0x100 && rva < RESERVED_END) rva = RESERVED_END;
+        placePatch(image, *unhinted[i], rva);
+    }
+
+    // URLs as NUL-terminated strings; the API base on its own, as the game has it
+    uint32_t rdata = image.rdataRva;
+    for (const char* text : {Patches::URL_OAUTH2_AUTHORIZE_TEXT, Patches::TWITCH_API_PREFIX, Patches::URL_BLOG_TEXT}) {
+        size_t length = std::strlen(text) + 1;
+        std::memcpy(image.bytes.data() + rdata, text, length);
+        rdata += static_cast<uint32_t>((length + 15) & ~size_t(15));
+    }
+    for (const Patches::Patch* patch : Patches::getURLPatches()) {
+        auto match = std::search(image.bytes.begin() + image.rdataRva, image.bytes.end(),
+                                 patch->pattern.begin(), patch->pattern.end());
+        if (match != image.bytes.end()) {
+            image.sites.push_back({patch->name, static_cast<uint32_t>(match - image.bytes.begin())});
+        }
+    }
+    return true;
+}
+
+} // namespace SyntheticImage
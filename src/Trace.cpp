@@ -0,0 +1,222 @@
+/**
+ * @file Trace.cpp
+ * @brief Per-thread span buffers and Chrome trace-event JSON export
+ *
+ * Each recording thread owns one Buffer. Only that thread writes it: the
+ * event is filled in, then the count is published with a release store. The
+ * exporter reads the count with an acquire load and copies that many
+ * events. Buffers are reset lazily by their own thread when it sees a new
+ * session, so enabling never touches another thread's events.
+ *
+ * A thread that exits leaves its buffer in the registry, so its events can
+ * still be exported; the next thread to record takes it over.
+ *
+ * The registry mutex is taken once per thread (on its first event), for
+ * setThreadName, and by the exporter; never on the recording path.
+ */
+
+#include "Trace.h"
+
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Trace {
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    const char* argName;
+    int64_t argValue;
+    int64_t startNs;        ///< Since the session epoch
+    int64_t durationNs;
+    char detail[DETAIL_SIZE];
+};
+
+struct Buffer {
+    std::atomic<uint32_t> session{0};
+    std::atomic<size_t> count{0};
+    std::atomic<size_t> dropped{0};
+    uint32_t threadId = 0;
+    const char* threadName = nullptr;   ///< Guarded by g_registryMutex
+    std::unique_ptr<Event[]> events{new Event[BUFFER_EVENTS]};
+};
+
+std::atomic<uint32_t> g_session{0};
+std::atomic<int64_t> g_epochNs{0};
+
+std::mutex g_registryMutex;
+std::vector<std::shared_ptr<Buffer>> g_buffers;   // Kept after their thread exits, for reuse
+
+thread_local std::shared_ptr<Buffer> t_buffer;
+thread_local const char* t_threadName = nullptr;
+
+int64_t sinceEpoch(std::chrono::steady_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+Buffer& localBuffer()
+{
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        // A buffer only the registry holds belongs to a thread that has
+        // exited; its track continues with this thread, so worker threads
+        // started per call do not each keep a buffer
+        for (const std::shared_ptr<Buffer>& buffer : g_buffers) {
+            if (buffer.use_count() == 1) {
+                t_buffer = buffer;
+                break;
+            }
+        }
+        if (!t_buffer) {
+            t_buffer = std::make_shared<Buffer>();
+            t_buffer->threadId = static_cast<uint32_t>(g_buffers.size() + 1);
+            g_buffers.push_back(t_buffer);
+        }
+        t_buffer->threadName = t_threadName;
+    }
+    return *t_buffer;
+}
+
+void appendEscaped(std::string& out, const char* text)
+{
+    for (; *text; ++text) {
+        unsigned char c = static_cast<unsigned char>(*text);
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += static_cast<char>(c);
+        } else if (c < 0x20) {
+            char escape[8];
+            std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+            out += escape;
+        } else {
+            out += static_cast<char>(c);
+        }
+    }
+}
+
+} // namespace
+
+void setEnabled(bool enabled)
+{
+    if (enabled) {
+        g_epochNs.store(sinceEpoch(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+        g_session.fetch_add(1, std::memory_order_acq_rel);
+    }
+    detail::enabled.store(enabled, std::memory_order_release);
+}
+
+void setThreadName(const char* name)
+{
+    t_threadName = name;
+    if (t_buffer) {
+        std::lock_guard<std::mutex> lock(g_registryMutex);
+        t_buffer->threadName = name;
+    }
+}
+
+void detail::record(const char* name, const char* category, std::chrono::steady_clock::time_point start,
+                    const char* argName, int64_t argValue, const char* text)
+{
+    int64_t end = sinceEpoch(std::chrono::steady_clock::now());
+    int64_t epoch = g_epochNs.load(std::memory_order_relaxed);
+    int64_t begin = sinceEpoch(start);
+    if (begin < epoch) return;  // Started in an earlier session
+
+    Buffer& buffer = localBuffer();
+    uint32_t session = g_session.load(std::memory_order_acquire);
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        buffer.count.store(0, std::memory_order_relaxed);
+        buffer.dropped.store(0, std::memory_order_relaxed);
+        buffer.session.store(session, std::memory_order_release);
+    }
+
+    size_t count = buffer.count.load(std::memory_order_relaxed);
+    if (count == BUFFER_EVENTS) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Event& event = buffer.events[count];
+    event.name = name;
+    event.category = category;
+    event.argName = argName;
+    event.argValue = argValue;
+    event.startNs = begin - epoch;
+    event.durationNs = end - begin;
+    size_t i = 0;
+    for (; text[i] && i < DETAIL_SIZE - 1; ++i) event.detail[i] = text[i];
+    event.detail[i] = '\0';
+    buffer.count.store(count + 1, std::memory_order_release);
+}
+
+std::string toChromeJson()
+{
+    uint32_t session = g_session.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+
+    std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out += "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"FFXV Unlocker\"}}";
+
+    char number[96];
+    for (const std::shared_ptr<Buffer>& buffer : g_buffers) {
+        if (buffer->session.load(std::memory_order_acquire) != session) continue;
+        size_t count = buffer->count.load(std::memory_order_acquire);
+
+        if (buffer->threadName) {
+            std::snprintf(number, sizeof(number), ",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u",
+                          buffer->threadId);
+            out += number;
+            out += ",\"args\":{\"name\":\"";
+            appendEscaped(out, buffer->threadName);
+            out += "\"}}";
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            const Event& event = buffer->events[i];
+            out += ",\n{\"ph\":\"X\",\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"cat\":\"";
+            appendEscaped(out, event.category);
+            std::snprintf(number, sizeof(number), "\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+                          buffer->threadId, event.startNs / 1e3, event.durationNs / 1e3);
+            out += number;
+            if (event.argName || event.detail[0]) {
+                out += ",\"args\":{";
+                if (event.argName) {
+                    out += '"';
+                    appendEscaped(out, event.argName);
+                    std::snprintf(number, sizeof(number), "\":%lld", static_cast<long long>(event.argValue));
+                    out += number;
+                }
+                if (event.detail[0]) {
+                    out += event.argName ? ",\"detail\":\"" : "\"detail\":\"";
+                    appendEscaped(out, event.detail);
+                    out += '"';
+                }
+                out += '}';
+            }
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+size_t droppedEvents()
+{
+    uint32_t session = g_session.load(std::memory_order_acquire);
+    std::lock_guard<std::mutex> lock(g_registryMutex);
+    size_t dropped = 0;
+    for (const std::shared_ptr<Buffer>& buffer : g_buffers) {
+        if (buffer->session.load(std::memory_order_acquire) == session) {
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return dropped;
+}
+
+} // namespace Trace
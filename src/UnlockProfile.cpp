@@ -0,0 +1,179 @@
+/**
+ * @file UnlockProfile.cpp
+ * @brief Unlock profile parsing and name resolution
+ */
+
+#include "UnlockProfile.h"
+#include "MappedFile.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace {
+
+/// Words and "quoted strings"; '#' outside quotes ends the line
+bool tokenize(const std::string& line, std::vector<std::string>& tokens, std::string& error)
+{
+    tokens.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        char c = line[i];
+        if (c == ' ' || c == '\t' || c == '\r') {
+            ++i;
+        } else if (c == '#') {
+            break;
+        } else if (c == '"') {
+            size_t end = line.find('"', i + 1);
+            if (end == std::string::npos) {
+                error = "unterminated string";
+                return false;
+            }
+            tokens.push_back(line.substr(i + 1, end - i - 1));
+            i = end + 1;
+        } else {
+            size_t end = line.find_first_of(" \t\r#", i);
+            if (end == std::string::npos) end = line.size();
+            tokens.push_back(line.substr(i, end - i));
+            i = end;
+        }
+    }
+    return true;
+}
+
+bool parseSwitch(const std::string& text, bool& value)
+{
+    if (text == "on") {
+        value = true;
+    } else if (text == "off") {
+        value = false;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseUnsigned(const std::string& text, uint32_t maximum, uint32_t& value)
+{
+    if (text.empty() || text[0] < '0' || text[0] > '9') return false;
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long parsed = std::strtoull(text.c_str(), &end, 10);
+    if (errno != 0 || *end != '\0' || parsed > maximum) return false;
+    value = static_cast<uint32_t>(parsed);
+    return true;
+}
+
+} // namespace
+
+bool UnlockProfile::load(const std::string& path)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        m_lastError = "Cannot open " + path + ": " + file.getLastError();
+        return false;
+    }
+    return parse(std::string(reinterpret_cast<const char*>(file.data()), file.size()));
+}
+
+bool UnlockProfile::parse(const std::string& text)
+{
+    *this = UnlockProfile();
+
+    std::vector<std::string> tokens;
+    int lineNumber = 0;
+    auto lineError = [&](const std::string& message) {
+        m_lastError = "line " + std::to_string(lineNumber) + ": " + message;
+        return false;
+    };
+
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        ++lineNumber;
+
+        std::string tokenError;
+        if (!tokenize(line, tokens, tokenError)) return lineError(tokenError);
+        if (tokens.empty()) continue;
+
+        const std::string& keyword = tokens[0];
+        uint32_t value = 0;
+
+        if (keyword == "item" || keyword == "bundle" || keyword == "patch") {
+            if (tokens.size() != 2 || tokens[1].empty()) {
+                return lineError("expected: " + keyword + " \"name\"");
+            }
+            (keyword == "item" ? m_items : keyword == "bundle" ? m_bundles : m_patches).push_back(tokens[1]);
+        } else if (keyword == "server" || keyword == "resident") {
+            if (tokens.size() != 2 || !parseSwitch(tokens[1], keyword == "server" ? m_server : m_resident)) {
+                return lineError("expected: " + keyword + " on|off");
+            }
+        } else if (keyword == "port") {
+            if (tokens.size() != 2 || !parseUnsigned(tokens[1], 65535, value) || value == 0) {
+                return lineError("expected: port <1-65535>");
+            }
+            m_port = static_cast<uint16_t>(value);
+        } else if (keyword == "freeze" || keyword == "wait") {
+            if (tokens.size() != 2 || !parseUnsigned(tokens[1], UINT32_MAX, value)) {
+                return lineError("expected: " + keyword + (keyword == "freeze" ? " <ms>" : " <seconds>"));
+            }
+            (keyword == "freeze" ? m_freezeMs : m_waitSeconds) = value;
+        } else {
+            return lineError("unknown setting '" + keyword + "'");
+        }
+    }
+
+    if (m_server && !m_resident) {
+        m_lastError = "server on needs resident on";
+        return false;
+    }
+    if (m_freezeMs != 0 && !m_resident) {
+        m_lastError = "freeze needs resident on";
+        return false;
+    }
+    return true;
+}
+
+bool UnlockProfile::resolve(const UnlockRegistry& registry, UnlockMask& mask, std::vector<Patches::Patch*>& patches)
+{
+    mask = 0;
+    patches.clear();
+
+    for (const std::string& name : m_items) {
+        size_t index = 0;
+        while (index < registry.itemCount() && registry.itemName(index) != name) ++index;
+        if (index == registry.itemCount()) {
+            m_lastError = "Unknown item: " + name;
+            return false;
+        }
+        if (!registry.itemSelectable(index)) {
+            m_lastError = "Item needs the Platform Exclusives patches: " + name;
+            return false;
+        }
+        mask |= UnlockRegistry::bit(registry.itemId(index));
+    }
+
+    for (const std::string& name : m_bundles) {
+        size_t index = 0;
+        while (index < registry.bundleCount() && registry.bundleName(index) != name) ++index;
+        if (index == registry.bundleCount()) {
+            m_lastError = "Unknown bundle: " + name;
+            return false;
+        }
+        mask |= registry.bundleMask(index);
+    }
+
+    std::vector<Patches::Patch*> all = Patches::getAllPatches();
+    for (const std::string& name : m_patches) {
+        auto it = all.begin();
+        while (it != all.end() && (*it)->name != name) ++it;
+        if (it == all.end()) {
+            m_lastError = "Unknown patch: " + name;
+            return false;
+        }
+        patches.push_back(*it);
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file UnlockRegistry.cpp
+ * @brief Structure-of-arrays view of the unlock items and bundles
+ */
+
+#include "UnlockRegistry.h"
+
+void UnlockRegistry::rebuild()
+{
+    m_tableBase = Patches::activeUnlockTableBase;
+
+    m_itemIds.clear();
+    m_bundleMasks.clear();
+    m_items = m_selectable = m_bundles = 0;
+    m_categorySpans = {};
+    m_categoryMasks = {};
+    m_indexById.fill(0xFF);
+    m_stringPool.clear();
+    m_itemNames.clear();
+    m_itemDescriptions.clear();
+    m_bundleNames.clear();
+    m_bundleDescriptions.clear();
+    m_itemDefinitions.clear();
+    m_bundleDefinitions.clear();
+
+    // Indexed by Patches::UnlockCategory; Twitch Prime content is bundles only
+    static const std::vector<Patches::UnlockItem*> NO_ITEMS;
+    const std::vector<Patches::UnlockItem*>* categories[CATEGORY_COUNT] = {
+        &Patches::getNormallyUnavailableItems(),
+        &NO_ITEMS,
+        &Patches::getSteamItems(),
+        &Patches::getOriginItems(),
+        &Patches::getMicrosoftStoreItems(),
+        &Patches::getPromotionalItems()
+    };
+
+    for (size_t category = 0; category < CATEGORY_COUNT; ++category) {
+        m_categorySpans[category].first = static_cast<uint8_t>(m_itemIds.size());
+        for (auto* item : *categories[category]) {
+            if (item->itemId >= MAX_TABLE_BYTES) continue;
+
+            m_indexById[item->itemId] = static_cast<uint8_t>(m_itemIds.size());
+            m_itemIds.push_back(item->itemId);
+            m_itemNames.push_back(addString(item->name));
+            m_itemDescriptions.push_back(addString(item->description));
+            m_itemDefinitions.push_back(item);
+
+            m_items |= bit(item->itemId);
+            m_categoryMasks[category] |= bit(item->itemId);
+            if (item->selectable) m_selectable |= bit(item->itemId);
+        }
+        m_categorySpans[category].count =
+            static_cast<uint8_t>(m_itemIds.size() - m_categorySpans[category].first);
+    }
+
+    for (auto* bundle : Patches::getTwitchPrimeBundles()) {
+        UnlockMask mask = maskOf(*bundle);
+        m_bundleMasks.push_back(mask);
+        m_bundleNames.push_back(addString(bundle->name));
+        m_bundleDescriptions.push_back(addString(bundle->description));
+        m_bundleDefinitions.push_back(bundle);
+        m_bundles |= mask;
+    }
+    m_categoryMasks[size_t(Patches::UnlockCategory::TwitchPrime)] = m_bundles;
+}
+
+std::optional<size_t> UnlockRegistry::indexOfItem(uint8_t itemId) const
+{
+    if (itemId >= MAX_TABLE_BYTES || m_indexById[itemId] == 0xFF) {
+        return std::nullopt;
+    }
+    return m_indexById[itemId];
+}
+
+UnlockMask UnlockRegistry::maskOf(const std::vector<Patches::UnlockItem*>& items) const
+{
+    UnlockMask mask = 0;
+    for (const auto* item : items) {
+        if (item->itemId < MAX_TABLE_BYTES) mask |= bit(item->itemId);
+    }
+    return mask;
+}
+
+UnlockMask UnlockRegistry::maskOf(const std::vector<Patches::UnlockBundle*>& bundles) const
+{
+    UnlockMask mask = 0;
+    for (const auto* bundle : bundles) {
+        mask |= maskOf(*bundle);
+    }
+    return mask;
+}
+
+UnlockMask UnlockRegistry::maskOf(const Patches::UnlockBundle& bundle) const
+{
+    UnlockMask mask = 0;
+    for (uintptr_t address : bundle.addresses) {
+        // Bundle addresses are absolute; anything outside the table is ignored
+        if (address >= m_tableBase && address - m_tableBase < MAX_TABLE_BYTES) {
+            mask |= bit(static_cast<uint8_t>(address - m_tableBase));
+        }
+    }
+    return mask;
+}
+
+uint32_t UnlockRegistry::addString(const std::string& text)
+{
+    uint32_t offset = static_cast<uint32_t>(m_stringPool.size());
+    m_stringPool.append(text);
+    m_stringPool.push_back('\0');
+    return offset;
+}
@@ -0,0 +1,85 @@
+/**
+ * @file WindowsBackend.cpp
+ * @brief Process memory access on Windows; the MemoryBackend under MemoryEditor
+ */
+
+#include "WindowsBackend.h"
+
+WindowsBackend::~WindowsBackend()
+{
+    close();
+}
+
+bool WindowsBackend::open(DWORD processId)
+{
+    close();
+    m_handle = OpenProcess(
+        PROCESS_VM_READ | PROCESS_VM_WRITE | PROCESS_VM_OPERATION | PROCESS_QUERY_INFORMATION,
+        FALSE,
+        processId
+    );
+    if (!m_handle) {
+        m_lastError = GetLastError();
+        return false;
+    }
+    m_processId = processId;
+    return true;
+}
+
+void WindowsBackend::close()
+{
+    if (m_handle) {
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+    }
+    m_processId = 0;
+}
+
+bool WindowsBackend::isRunning() const
+{
+    DWORD exitCode = 0;
+    return m_handle && GetExitCodeProcess(m_handle, &exitCode) && exitCode == STILL_ACTIVE;
+}
+
+size_t WindowsBackend::read(uintptr_t address, void* buffer, size_t size) const
+{
+    SIZE_T bytesRead = 0;
+    if (!m_handle || !ReadProcessMemory(m_handle, reinterpret_cast<LPCVOID>(address), buffer, size, &bytesRead)) {
+        return 0;
+    }
+    return bytesRead;
+}
+
+bool WindowsBackend::writeProtected(uintptr_t address, ByteView data)
+{
+    DWORD oldProtection;
+    if (!protect(address, data.size, PAGE_EXECUTE_READWRITE, oldProtection)) {
+        return false;
+    }
+
+    bool success = write(address, data);
+
+    // Always restore protection, even if the write failed
+    DWORD temp;
+    protect(address, data.size, oldProtection, temp);
+    return success;
+}
+
+bool WindowsBackend::write(uintptr_t address, ByteView data)
+{
+    SIZE_T bytesWritten = 0;
+    if (!WriteProcessMemory(m_handle, reinterpret_cast<LPVOID>(address), data.data, data.size, &bytesWritten)) {
+        m_lastError = GetLastError();
+        return false;
+    }
+    return bytesWritten == data.size;
+}
+
+bool WindowsBackend::protect(uintptr_t address, size_t size, DWORD newProtection, DWORD& oldProtection)
+{
+    if (!VirtualProtectEx(m_handle, reinterpret_cast<LPVOID>(address), size, newProtection, &oldProtection)) {
+        m_lastError = GetLastError();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file WriteTransaction.cpp
+ * @brief Coalesces many small writes into few protected writes
+ */
+
+#include "WriteTransaction.h"
+#include "MemoryBackend.h"
+
+#include <algorithm>
+
+void WriteTransaction::add(uintptr_t address, ByteView data)
+{
+    if (data.empty()) return;
+    m_writes.push_back({address, m_data.size(), data.size});
+    m_data.insert(m_data.end(), data.begin(), data.end());
+}
+
+std::vector<WriteTransaction::Run> WriteTransaction::plan(const MemoryReader& read) const
+{
+    std::vector<Write> writes = m_writes;
+    std::stable_sort(writes.begin(), writes.end(),
+                     [](const Write& a, const Write& b) { return a.address < b.address; });
+
+    std::vector<Run> runs;
+    size_t first = 0;
+    while (first < writes.size()) {
+        uintptr_t start = writes[first].address;
+        uintptr_t end = start + writes[first].size;
+        size_t last = first + 1;
+        while (last < writes.size() && writes[last].address <= end + m_mergeGap) {
+            end = std::max(end, writes[last].address + writes[last].size);
+            ++last;
+        }
+
+        Run run;
+        run.address = start;
+        run.writes = last - first;
+        run.bytes.resize(end - start);
+        if (run.writes == 1 || read(start, run.bytes.data(), run.bytes.size()) == run.bytes.size()) {
+            // Overlaps resolve to the write added last
+            std::vector<const Write*> merged;
+            for (size_t i = first; i < last; ++i) merged.push_back(&writes[i]);
+            std::stable_sort(merged.begin(), merged.end(),
+                             [](const Write* a, const Write* b) { return a->offset < b->offset; });
+            for (const Write* write : merged) {
+                std::copy_n(m_data.begin() + write->offset, write->size,
+                            run.bytes.begin() + (write->address - start));
+            }
+        } else {
+            run.bytes.clear();
+        }
+        runs.push_back(std::move(run));
+        first = last;
+    }
+    return runs;
+}
+
+bool WriteTransaction::commit(MemoryBackend& backend) const
+{
+    bool allSuccess = true;
+    for (const Run& run : plan(backend.reader())) {
+        allSuccess &= !run.bytes.empty() && backend.writeProtected(run.address, run.bytes);
+    }
+    return allSuccess;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file X86Length.cpp
+ * @brief Table-driven x86-64 instruction length decoder
+ */
+
+#include "X86Length.h"
+
+namespace {
+
+// Per-opcode operand flags
+enum : uint8_t {
+    M   = 0x01,  ///< ModRM (and SIB/displacement) follows
+    I8  = 0x02,  ///< imm8 / rel8
+    I16 = 0x04,  ///< imm16
+    IZ  = 0x08,  ///< imm16 with 0x66, else imm32
+    IV  = 0x10,  ///< imm64 with REX.W, imm16 with 0x66, else imm32 (mov r, imm)
+    I32 = 0x20,  ///< imm32 / rel32 regardless of operand size
+    MO  = 0x40,  ///< moffs: 8 bytes, 4 with 0x67
+    X   = 0x80   ///< Invalid in 64-bit mode (or handled before the table)
+};
+
+/// One-byte opcode map. 0x0F, REX, VEX/EVEX/XOP and prefixes are handled in code.
+constexpr uint8_t ONE_BYTE[256] = {
+//  0       1       2       3       4       5       6       7       8       9       A       B       C       D       E       F
+    M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,      // 0
+    M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,      // 1
+    M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,      // 2
+    M,      M,      M,      M,      I8,     IZ,     X,      X,      M,      M,      M,      M,      I8,     IZ,     X,      X,      // 3
+    X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      X,      // 4
+    0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      // 5
+    X,      X,      X,      M,      X,      X,      X,      X,      IZ,     M|IZ,   I8,     M|I8,   0,      0,      0,      0,      // 6
+    I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     // 7
+    M|I8,   M|IZ,   X,      M|I8,   M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 8
+    0,      0,      0,      0,      0,      0,      0,      0,      0,      0,      X,      0,      0,      0,      0,      0,      // 9
+    MO,     MO,     MO,     MO,     0,      0,      0,      0,      I8,     IZ,     0,      0,      0,      0,      0,      0,      // A
+    I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     IV,     IV,     IV,     IV,     IV,     IV,     IV,     IV,     // B
+    M|I8,   M|I8,   I16,    0,      X,      X,      M|I8,   M|IZ,   I16|I8, 0,      I16,    0,      0,      I8,     X,      0,      // C
+    M,      M,      M,      M,      X,      X,      X,      0,      M,      M,      M,      M,      M,      M,      M,      M,      // D
+    I8,     I8,     I8,     I8,     I8,     I8,     I8,     I8,     I32,    I32,    X,      I8,     0,      0,      0,      0,      // E
+    X,      0,      X,      X,      0,      0,      M,      M,      0,      0,      0,      0,      0,      0,      M,      M       // F
+};
+
+/// Two-byte map (0F xx). 0F 38 and 0F 3A are handled in code.
+constexpr uint8_t TWO_BYTE[256] = {
+//  0       1       2       3       4       5       6       7       8       9       A       B       C       D       E       F
+    M,      M,      M,      M,      X,      0,      0,      0,      0,      0,      X,      0,      X,      M,      0,      M|I8,   // 0
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 1
+    M,      M,      M,      M,      X,      X,      X,      X,      M,      M,      M,      M,      M,      M,      M,      M,      // 2
+    0,      0,      0,      0,      0,      0,      X,      0,      X,      X,      X,      X,      X,      X,      X,      X,      // 3
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 4
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 5
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 6
+    M|I8,   M|I8,   M|I8,   M|I8,   M,      M,      M,      0,      M,      M,      X,      X,      M,      M,      M,      M,      // 7
+    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    I32,    // 8
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // 9
+    0,      0,      0,      M,      M|I8,   M,      X,      X,      0,      0,      0,      M,      M|I8,   M,      M,      M,      // A
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M|I8,   M,      M,      M,      M,      M,      // B
+    M,      M,      M|I8,   M,      M|I8,   M|I8,   M|I8,   M,      0,      0,      0,      0,      0,      0,      0,      0,      // C
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // D
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      // E
+    M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M,      M       // F
+};
+
+enum class OpcodeMap { OneByte, TwoByte, ThreeByte38, ThreeByte3A, Xop8, Xop9, XopA };
+
+bool isLegacyPrefix(uint8_t byte)
+{
+    switch (byte) {
+    case 0xF0: case 0xF2: case 0xF3:
+    case 0x2E: case 0x36: case 0x3E: case 0x26: case 0x64: case 0x65:
+    case 0x66: case 0x67:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool isRelativeBranch(OpcodeMap map, uint8_t opcode)
+{
+    if (map == OpcodeMap::TwoByte) return (opcode & 0xF0) == 0x80;           // jcc rel32
+    if (map != OpcodeMap::OneByte) return false;
+    return (opcode & 0xF0) == 0x70 || (opcode >= 0xE0 && opcode <= 0xE3) ||  // jcc rel8, loop, jrcxz
+           opcode == 0xE8 || opcode == 0xE9 || opcode == 0xEB;               // call, jmp
+}
+
+/**
+ * @brief Bytes taken by ModRM, SIB and displacement; 0 if they run past end
+ *
+ * Fills in the displacement fields of instruction, relative to the ModRM byte.
+ */
+size_t modrmLength(const uint8_t* p, const uint8_t* end, X86::Instruction& instruction)
+{
+    if (p >= end) return 0;
+    uint8_t mod = p[0] >> 6;
+    uint8_t rm = p[0] & 7;
+
+    size_t length = 1;
+    size_t displacement = 0;
+    if (mod != 3) {
+        if (rm == 4) {
+            if (p + 1 >= end) return 0;
+            ++length;
+            if (mod == 0 && (p[1] & 7) == 5) displacement = 4;  // SIB with no base: disp32
+        }
+        if (mod == 0 && rm == 5) {                               // RIP-relative disp32
+            displacement = 4;
+            instruction.ripRelative = true;
+        }
+        if (mod == 1) displacement = 1;
+        if (mod == 2) displacement = 4;
+    }
+    if (displacement) {
+        instruction.displacementOffset = static_cast<uint8_t>(length);
+        instruction.displacementSize = static_cast<uint8_t>(displacement);
+    }
+    length += displacement;
+    return p + length <= end ? length : 0;
+}
+
+} // namespace
+
+namespace X86 {
+
+bool decode(const uint8_t* code, size_t size, Instruction& instruction)
+{
+    instruction = Instruction();
+    if (size > MAX_INSTRUCTION_LENGTH) size = MAX_INSTRUCTION_LENGTH;
+    const uint8_t* p = code;
+    const uint8_t* end = code + size;
+
+    bool operandSize16 = false;
+    bool addressSize32 = false;
+    bool rexW = false;
+
+    // Legacy prefixes, then an optional REX that must directly precede the opcode
+    while (p < end) {
+        if (isLegacyPrefix(*p)) {
+            operandSize16 |= (*p == 0x66);
+            addressSize32 |= (*p == 0x67);
+            rexW = false;                       // A REX followed by a prefix is ignored
+        } else if ((*p & 0xF0) == 0x40) {
+            rexW = (*p & 0x08) != 0;
+        } else {
+            break;
+        }
+        ++p;
+    }
+    if (p >= end) return false;
+
+    OpcodeMap map = OpcodeMap::OneByte;
+    uint8_t opcode = *p++;
+    bool vex = false;
+
+    // 8F is pop r/m unless the map field is 8 or above, which pop's ModRM.reg cannot be
+    bool xop = opcode == 0x8F && p < end && (p[0] & 0x1F) >= 8;
+    if (opcode == 0xC5 || opcode == 0xC4 || opcode == 0x62 || xop) {
+        // VEX (2 or 3 bytes), XOP (3 bytes) and EVEX (4 bytes) carry the map in the prefix
+        size_t prefixBytes = opcode == 0xC5 ? 1 : opcode == 0x62 ? 3 : 2;
+        if (p + prefixBytes >= end) return false;
+        uint8_t mapSelect = opcode == 0xC5 ? 1 : (p[0] & (opcode == 0x62 ? 0x07 : 0x1F));
+        if (xop != (mapSelect >= 8)) return false;             // Maps 8-10 are XOP's alone
+        p += prefixBytes;
+        opcode = *p++;
+        vex = true;
+
+        switch (mapSelect) {
+        case 1: map = OpcodeMap::TwoByte; break;
+        case 2: map = OpcodeMap::ThreeByte38; break;
+        case 3: map = OpcodeMap::ThreeByte3A; break;
+        case 5: case 6: map = OpcodeMap::ThreeByte38; break;  // EVEX FP16 maps: ModRM, no immediate
+        case 8: map = OpcodeMap::Xop8; break;
+        case 9: map = OpcodeMap::Xop9; break;
+        case 10: map = OpcodeMap::XopA; break;
+        default: return false;
+        }
+    } else if (opcode == 0x0F) {
+        if (p >= end) return false;
+        opcode = *p++;
+        map = OpcodeMap::TwoByte;
+        if (opcode == 0x38 || opcode == 0x3A) {
+            map = opcode == 0x38 ? OpcodeMap::ThreeByte38 : OpcodeMap::ThreeByte3A;
+            if (p >= end) return false;
+            opcode = *p++;
+        }
+    }
+
+    uint8_t flags;
+    switch (map) {
+    case OpcodeMap::OneByte:     flags = ONE_BYTE[opcode]; break;
+    case OpcodeMap::TwoByte:     flags = TWO_BYTE[opcode]; break;
+    case OpcodeMap::ThreeByte38: flags = M; break;
+    case OpcodeMap::ThreeByte3A: flags = M | I8; break;
+    case OpcodeMap::Xop8:        flags = M | I8; break;
+    case OpcodeMap::Xop9:        flags = M; break;
+    case OpcodeMap::XopA:        flags = M | I32; break;  // bextr, lwpins, lwpval
+    }
+    if (vex) {
+        // Every VEX/EVEX/XOP instruction has ModRM except vzeroupper/vzeroall
+        flags = (map == OpcodeMap::TwoByte && opcode == 0x77) ? 0 : M | (flags & (I8 | I32));
+    }
+    if (flags & X) return false;
+
+    if (flags & M) {
+        size_t length = modrmLength(p, end, instruction);
+        if (length == 0) return false;
+        if (instruction.displacementSize) {
+            instruction.displacementOffset = static_cast<uint8_t>(instruction.displacementOffset + (p - code));
+        }
+
+        // Group 3 test has an immediate only in its /0 and /1 forms
+        if (map == OpcodeMap::OneByte && (opcode == 0xF6 || opcode == 0xF7) && ((p[0] >> 3) & 7) < 2) {
+            flags |= opcode == 0xF6 ? I8 : IZ;
+        }
+        p += length;
+    }
+
+    size_t immediate = 0;
+    if (flags & I8)  immediate += 1;
+    if (flags & I16) immediate += 2;
+    if (flags & IZ)  immediate += operandSize16 ? 2 : 4;
+    if (flags & IV)  immediate += rexW ? 8 : operandSize16 ? 2 : 4;
+    if (flags & I32) immediate += 4;
+    if (flags & MO)  immediate += addressSize32 ? 4 : 8;
+
+    if (immediate > size_t(end - p)) return false;
+    if (immediate) {
+        instruction.immediateOffset = static_cast<uint8_t>(p - code);
+        instruction.immediateSize = static_cast<uint8_t>(immediate);
+        instruction.relativeBranch = isRelativeBranch(map, opcode);
+    }
+    instruction.length = static_cast<uint8_t>(p + immediate - code);
+    return true;
+}
+
+bool onBoundaries(const uint8_t* code, size_t size, std::initializer_list<size_t> positions)
+{
+    size_t last = 0;
+    for (size_t position : positions) {
+        if (position > last) last = position;
+    }
+
+    // Walk instruction starts up to the furthest position and tick off each hit
+    size_t pending = positions.size();
+    size_t offset = 0;
+    while (true) {
+        for (size_t position : positions) {
+            if (position == offset) --pending;
+        }
+        if (offset >= last) break;
+
+        size_t length = instructionLength(code + offset, size - offset);
+        if (length == 0) return false;
+        offset += length;
+    }
+    return pending == 0 && offset == last;
+}
+
+} // namespace X86
@@ -0,0 +1,227 @@
+/**
+ * @file XrefIndex.cpp
+ * @brief Code references into an address range (RIP-relative, rel32, imm64)
+ */
+
+#include "XrefIndex.h"
+#include "X86Length.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Xref {
+
+namespace {
+
+/// Offsets filtered per pass before the survivors are collected
+constexpr size_t FILTER_BLOCK = 4096;
+
+struct CodeRange {
+    uint32_t begin;
+    uint32_t end;
+};
+
+std::vector<CodeRange> codeRanges(const Image& image)
+{
+    std::vector<CodeRange> ranges;
+    for (const Pe::Section& section : image.code) {
+        if (section.virtualAddress >= image.size) continue;
+        uint32_t end = static_cast<uint32_t>(std::min<uint64_t>(
+            uint64_t(section.virtualAddress) + section.virtualSize, image.size));
+        ranges.push_back({section.virtualAddress, end});
+    }
+    return ranges;
+}
+
+/**
+ * @brief The reference an instruction makes, if any
+ * @param field Set to the offset of the operand inside the instruction
+ */
+bool referenceOf(const Image& image, uint32_t rva, const X86::Instruction& instruction,
+                 Reference& reference, uint8_t& field)
+{
+    const uint8_t* code = image.data + rva;
+    int64_t target;
+
+    if (instruction.ripRelative && instruction.displacementSize == 4) {
+        int32_t displacement;
+        std::memcpy(&displacement, code + instruction.displacementOffset, sizeof(displacement));
+        target = int64_t(rva) + instruction.length + displacement;
+        reference.kind = Kind::Data;
+        field = instruction.displacementOffset;
+    } else if (instruction.relativeBranch && instruction.immediateSize == 4) {
+        int32_t relative;
+        std::memcpy(&relative, code + instruction.immediateOffset, sizeof(relative));
+        target = int64_t(rva) + instruction.length + relative;
+        reference.kind = Kind::Branch;
+        field = instruction.immediateOffset;
+    } else if (!instruction.relativeBranch && instruction.immediateSize == 8) {
+        uint64_t value;
+        std::memcpy(&value, code + instruction.immediateOffset, sizeof(value));
+        if (value < image.imageBase) return false;
+        target = static_cast<int64_t>(std::min<uint64_t>(value - image.imageBase, image.size));
+        reference.kind = Kind::Absolute;
+        field = instruction.immediateOffset;
+    } else {
+        return false;
+    }
+
+    if (target < 0 || uint64_t(target) >= image.size) return false;
+    reference.from = rva;
+    reference.target = static_cast<uint32_t>(target);
+    return true;
+}
+
+/// Decodes one instruction at rva; a byte that does not decode is skipped
+uint32_t step(const Image& image, uint32_t rva, uint32_t end, X86::Instruction& instruction)
+{
+    if (X86::decode(image.data + rva, end - rva, instruction)) return rva + instruction.length;
+    instruction = X86::Instruction();
+    return rva + 1;
+}
+
+} // namespace
+
+const char* kindName(Kind kind)
+{
+    switch (kind) {
+    case Kind::Data:     return "data";
+    case Kind::Branch:   return "branch";
+    case Kind::Absolute: return "absolute";
+    }
+    return "";
+}
+
+bool Image::open(const uint8_t* image, size_t imageSize)
+{
+    Pe::Headers headers;
+    if (!Pe::parseHeaders(image, imageSize, headers)) return false;
+
+    data = image;
+    size = imageSize;
+    imageBase = headers.imageBase;
+    code.clear();
+    for (const Pe::Section& section : headers.sections) {
+        if (section.isExecutable()) code.push_back(section);
+    }
+    return true;
+}
+
+bool referenceAt(const Image& image, uint32_t rva, Reference& reference)
+{
+    X86::Instruction instruction;
+    uint8_t field;
+    return image.data && rva < image.size &&
+           X86::decode(image.data + rva, image.size - rva, instruction) &&
+           referenceOf(image, rva, instruction, reference, field);
+}
+
+std::vector<Reference> scan(const Image& image, uint32_t targetBegin, uint32_t targetEnd)
+{
+    std::vector<Reference> references;
+    if (!image.data || targetBegin >= targetEnd) return references;
+
+    // disp32 at offset i resolves to (i + 4 + immediate size) + disp32, and
+    // the immediate after it is 0, 1, 2 or 4 bytes; accept all of those
+    const uint32_t dataLow = targetBegin - 4;
+    const uint32_t dataSpan = targetEnd - targetBegin + 4;
+    const uint64_t absoluteLow = image.imageBase + targetBegin;
+    const uint64_t absoluteSpan = targetEnd - targetBegin;
+
+    for (const CodeRange& section : codeRanges(image)) {
+        if (section.end - section.begin < 4) continue;
+        const uint32_t last = section.end - 4;                  // Last disp32 start
+        const uint32_t wideLast = image.size >= 8 ? static_cast<uint32_t>(
+            std::min<size_t>(last, image.size - 8)) : 0;        // Last imm64 start
+
+        std::vector<uint32_t> candidates;
+        uint8_t hits[FILTER_BLOCK];
+        for (uint32_t block = section.begin; block <= last; block += FILTER_BLOCK) {
+            uint32_t count = std::min<uint32_t>(FILTER_BLOCK, last - block + 1);
+            const uint8_t* code = image.data + block;
+
+            uint32_t wide = block <= wideLast ? std::min<uint32_t>(count, wideLast - block + 1) : 0;
+            for (uint32_t i = 0; i < wide; ++i) {
+                uint32_t displacement;
+                uint64_t value;
+                std::memcpy(&displacement, code + i, sizeof(displacement));
+                std::memcpy(&value, code + i, sizeof(value));
+                uint32_t resolved = block + i + 4 + displacement;
+                hits[i] = (resolved - dataLow < dataSpan) | (value - absoluteLow < absoluteSpan);
+            }
+            for (uint32_t i = wide; i < count; ++i) {
+                uint32_t displacement;
+                std::memcpy(&displacement, code + i, sizeof(displacement));
+                hits[i] = block + i + 4 + displacement - dataLow < dataSpan;
+            }
+
+            for (uint32_t i = 0; i < count; ++i) {
+                if (hits[i]) candidates.push_back(block + i);
+            }
+        }
+
+        // Confirm in order, continuing one sweep for candidates close together
+        uint32_t rva = section.begin;       // Last decoded instruction
+        uint32_t next = section.begin;      // The one after it
+        X86::Instruction instruction;
+        for (uint32_t candidate : candidates) {
+            if (candidate >= next && candidate - next > RESYNC_WINDOW) {
+                next = candidate - RESYNC_WINDOW;
+            }
+            while (next <= candidate) {
+                rva = next;
+                next = step(image, rva, section.end, instruction);
+            }
+            // rva is now the instruction covering the candidate
+
+            Reference reference;
+            uint8_t field;
+            if (instruction.length && referenceOf(image, rva, instruction, reference, field) &&
+                rva + field == candidate && reference.target >= targetBegin && reference.target < targetEnd) {
+                references.push_back(reference);
+            }
+        }
+    }
+
+    std::sort(references.begin(), references.end(),
+              [](const Reference& a, const Reference& b) { return a.from < b.from; });
+    return references;
+}
+
+} // namespace Xref
+
+void XrefIndex::build(const Xref::Image& image)
+{
+    m_references.clear();
+    if (!image.data) return;
+
+    for (const Xref::CodeRange& section : Xref::codeRanges(image)) {
+        X86::Instruction instruction;
+        for (uint32_t rva = section.begin; rva < section.end;) {
+            uint32_t next = Xref::step(image, rva, section.end, instruction);
+            Xref::Reference reference;
+            uint8_t field;
+            if (instruction.length && Xref::referenceOf(image, rva, instruction, reference, field)) {
+                m_references.push_back(reference);
+            }
+            rva = next;
+        }
+    }
+
+    std::sort(m_references.begin(), m_references.end(), [](const Xref::Reference& a, const Xref::Reference& b) {
+        return a.target != b.target ? a.target < b.target : a.from < b.from;
+    });
+}
+
+std::vector<Xref::Reference> XrefIndex::referencesTo(uint32_t targetBegin, uint32_t targetEnd) const
+{
+    auto first = std::lower_bound(m_references.begin(), m_references.end(), targetBegin,
+                                  [](const Xref::Reference& r, uint32_t target) { return r.target < target; });
+    auto last = std::lower_bound(first, m_references.end(), targetEnd,
+                                 [](const Xref::Reference& r, uint32_t target) { return r.target < target; });
+
+    std::vector<Xref::Reference> references(first, last);
+    std::sort(references.begin(), references.end(),
+              [](const Xref::Reference& a, const Xref::Reference& b) { return a.from < b.from; });
+    return references;
+}
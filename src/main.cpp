@@ -1,6 +1,10 @@
 #include <QApplication>
+#include <QCoreApplication>
 #include <QMessageBox>
 #include <Windows.h>
+#include <cstdio>
+#include <cstring>
+#include "HeadlessRunner.h"
 #include "MainWindow.h"
 
 bool isRunningAsAdmin()
@@ -35,8 +39,52 @@ bool requestElevation()
     return ShellExecuteExW(&sei);
 }
 
+/// Path after --profile, or nullptr when the GUI should start
+const char* profileArgument(int argc, char* argv[])
+{
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--profile") == 0) {
+            return argv[i + 1];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Headless mode: no window, no prompts, log to the launching console
+ *
+ * Needs no desktop session, so it also runs from services and launch
+ * scripts. Exit codes are HeadlessRunner::ExitCode.
+ */
+int runHeadless(int argc, char* argv[], const char* profilePath)
+{
+    // A WIN32-subsystem executable has no console of its own
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        std::freopen("CONOUT$", "w", stdout);
+        std::freopen("CONOUT$", "w", stderr);
+    }
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("FFXV Unlocker");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("FFXVUnlocker");
+
+    if (!isRunningAsAdmin()) {
+        std::fprintf(stderr, "Warning: not running as administrator, attaching to the game may fail\n");
+    }
+
+    HeadlessRunner runner;
+    QObject::connect(&runner, &HeadlessRunner::finished, &app, &QCoreApplication::exit);
+    runner.start(QString::fromLocal8Bit(profilePath));
+    return app.exec();
+}
+
 int main(int argc, char* argv[])
 {
+    if (const char* profilePath = profileArgument(argc, argv)) {
+        return runHeadless(argc, argv, profilePath);
+    }
+
     QApplication app(argc, argv);
     app.setApplicationName("FFXV Unlocker");
     app.setApplicationVersion("1.0.0");
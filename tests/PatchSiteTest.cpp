@@ -0,0 +1,141 @@
+/**
+ * @file PatchSiteTest.cpp
+ * @brief PatchSite and JumpTable against the synthetic module
+ *
+ * Usage:
+ *   patch_site_test
+ *
+ * Every code patch must be found and recognised at its site, before and
+ * after it is applied; hinted patches must be found at their hint. Every
+ * code patch must replace whole instructions, and the boundary check must
+ * reject a patch that splits one. Jump table retargets must be validated,
+ * journaled, rolled back and restored, and refused once the table changed
+ * elsewhere.
+ *
+ * Prints each failure and exits with 1 if there was any.
+ */
+
+#include "JumpTable.h"
+#include "MemoryBackend.h"
+#include "PatchSite.h"
+#include "ScanEngine.h"
+#include "SyntheticImage.h"
+
+#include <cstdio>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void check(bool condition, const std::string& what)
+{
+    if (condition) return;
+    std::fprintf(stderr, "%s\n", what.c_str());
+    ++g_failures;
+}
+
+void checkPatchSites(InMemoryBackend& target)
+{
+    MemoryReader read = target.reader();
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        if (patch->section == Patches::SectionHint::RData) continue;
+
+        auto match = Scan::findPattern(read, target.base(), target.bytes().size(), patch->pattern, patch->mask);
+        check(match.has_value(), patch->name + ": not found");
+        if (!match) continue;
+        check(PatchSite::matches(read, *match, *patch), patch->name + ": site does not match");
+        if (patch->rvaHint != 0) {
+            check(PatchSite::atHint(read, target.base(), *patch) == match, patch->name + ": not found at its hint");
+        }
+
+        check(PatchSite::onBoundaries(read, *match, *patch), patch->name + ": not on boundaries");
+
+        // Still the right site once our bytes are on it
+        target.writeProtected(*match + patch->offset, patch->patched);
+        check(PatchSite::matches(read, *match, *patch), patch->name + ": patched site does not match");
+        if (patch->rvaHint != 0) {
+            check(PatchSite::atHint(read, target.base(), *patch) == match, patch->name + ": patched, not at its hint");
+        }
+        check(PatchSite::onBoundaries(read, *match, *patch), patch->name + ": patched, not on boundaries");
+        target.writeProtected(*match + patch->offset, patch->original);
+    }
+
+    // nop; xor eax, eax; ret; int3...
+    static constexpr uint8_t CODE[] = {0x90, 0x31, 0xC0, 0xC3, 0xCC, 0xCC, 0xCC, 0xCC};
+    static constexpr uint8_t MOV_EAX_1[] = {0xB8, 0x01, 0x00, 0x00, 0x00};
+    static constexpr uint8_t XOR_EAX_EAX[] = {0x33, 0xC0};
+    InMemoryBackend code(0x1000, std::vector<uint8_t>(std::begin(CODE), std::end(CODE)));
+
+    // Starts in the middle of the xor
+    Patches::Patch split = {"Split", "", ByteView(CODE, 4), ByteView(CODE + 2, 5), MOV_EAX_1, 2, {},
+                            Patches::SectionHint::Text};
+    check(PatchSite::matches(code.reader(), 0x1000, split), "Split: site does not match");
+    check(!PatchSite::onBoundaries(code.reader(), 0x1000, split), "Split: not rejected");
+
+    // The other encoding of the same xor
+    Patches::Patch whole = {"Whole", "", ByteView(CODE, 4), ByteView(CODE + 1, 2), XOR_EAX_EAX, 1, {},
+                            Patches::SectionHint::Text};
+    check(PatchSite::onBoundaries(code.reader(), 0x1000, whole), "Whole: rejected");
+}
+
+void checkJumpTable(InMemoryBackend& target)
+{
+    uintptr_t base = target.base() + (Patches::JUMP_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+    JumpTable table;
+    table.reset(base, target.base());
+
+    std::vector<JumpTable::Entry> entries = table.read(target);
+    check(entries.size() == Patches::JUMP_TABLE_ENTRIES, "Jump table: not read");
+    if (entries.size() != Patches::JUMP_TABLE_ENTRIES) return;
+
+    size_t changed = 0;
+    uintptr_t handler = entries[1].target;
+    check(table.retarget(target, {{entries[0].itemId, handler}}, changed) && changed == 1,
+          "Jump table: retarget failed");
+    check(table.read(target)[0].offset == entries[1].offset, "Jump table: entry not written");
+    check(table.read(target)[0].originalOffset == entries[0].offset, "Jump table: original not kept");
+
+    check(!table.retarget(target, {{entries[2].itemId, handler + 1}}, changed), "Jump table: bad target taken");
+    check(!table.retarget(target, {{0x10, handler}}, changed), "Jump table: bad item taken");
+    check(table.journalSize() == 1, "Jump table: failed retarget journaled");
+
+    check(table.retarget(target, {{entries[2].itemId, handler}, {entries[3].itemId, handler}}, changed) &&
+          changed == 2, "Jump table: second retarget failed");
+    check(table.rollback(target, changed) && changed == 2, "Jump table: rollback failed");
+    check(table.read(target)[2].offset == entries[2].offset, "Jump table: rollback not written");
+    check(table.read(target)[0].offset == entries[1].offset, "Jump table: rollback went too far");
+
+    // Changed by someone else: nothing is written over it
+    uint32_t foreign = entries[4].offset;
+    target.writeProtected(base + 5 * sizeof(uint32_t), ByteView(reinterpret_cast<const uint8_t*>(&foreign), 4));
+    check(!table.retarget(target, {{entries[6].itemId, handler}}, changed), "Jump table: foreign change ignored");
+    uint32_t own = entries[5].offset;
+    target.writeProtected(base + 5 * sizeof(uint32_t), ByteView(reinterpret_cast<const uint8_t*>(&own), 4));
+
+    check(table.restore(target, changed) && changed == 1 && table.journalSize() == 0, "Jump table: restore failed");
+    std::vector<JumpTable::Entry> restored = table.read(target);
+    for (size_t i = 0; i < restored.size(); ++i) {
+        check(restored[i].offset == entries[i].offset, "Jump table: entry " + std::to_string(i) + " not restored");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    SyntheticImage::Image image;
+    if (!SyntheticImage::build(SyntheticImage::MIN_SIZE, Patches::DEFAULT_IMAGE_BASE, image)) {
+        std::fprintf(stderr, "Cannot build the synthetic image\n");
+        return 2;
+    }
+    InMemoryBackend target(Patches::DEFAULT_IMAGE_BASE, std::move(image.bytes));
+
+    checkPatchSites(target);
+    checkJumpTable(target);
+
+    std::printf("%d failures\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
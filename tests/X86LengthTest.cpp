@@ -0,0 +1,122 @@
+/**
+ * @file X86LengthTest.cpp
+ * @brief X86::decode against a corpus of known encodings
+ *
+ * Usage:
+ *   x86_length_test <x86_lengths.txt>
+ *
+ * Every corpus instruction must decode to its own length, with code after
+ * it or without, and must be rejected when cut one byte short. Lines marked
+ * "invalid" must be rejected. Every built-in .text patch must also replace
+ * whole instructions.
+ *
+ * Prints each failure and exits with 1 if there was any.
+ */
+
+#include "Patches.h"
+#include "X86Length.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+int g_failures = 0;
+
+void fail(int lineNumber, const std::string& text, const std::string& message)
+{
+    std::fprintf(stderr, "line %d: %s: %s\n", lineNumber, text.c_str(), message.c_str());
+    ++g_failures;
+}
+
+bool parseHex(const std::string& text, std::vector<uint8_t>& bytes)
+{
+    std::istringstream stream(text);
+    std::string token;
+    bytes.clear();
+    while (stream >> token) {
+        if (token.size() != 2) return false;
+        char* end = nullptr;
+        unsigned long value = std::strtoul(token.c_str(), &end, 16);
+        if (end != token.c_str() + 2) return false;
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+    return !bytes.empty();
+}
+
+void checkInstruction(int lineNumber, const std::string& text, const std::vector<uint8_t>& bytes)
+{
+    std::vector<uint8_t> followed = bytes;
+    followed.insert(followed.end(), {0x90, 0x90, 0x90, 0x90});
+
+    size_t length = X86::instructionLength(bytes.data(), bytes.size());
+    if (length != bytes.size()) {
+        fail(lineNumber, text, "decoded as " + std::to_string(length) + " bytes");
+        return;
+    }
+    length = X86::instructionLength(followed.data(), followed.size());
+    if (length != bytes.size()) {
+        fail(lineNumber, text, "decoded as " + std::to_string(length) + " bytes with code after it");
+    }
+    if (X86::instructionLength(bytes.data(), bytes.size() - 1) != 0) {
+        fail(lineNumber, text, "decoded when cut one byte short");
+    }
+}
+
+void checkBuiltinPatches()
+{
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        if (patch->section != Patches::SectionHint::Text) continue;
+        if (!X86::isWholeInstructions(patch->patched.data, patch->patched.size)) {
+            std::fprintf(stderr, "%s: patched bytes are not whole instructions\n", patch->name.c_str());
+            ++g_failures;
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: x86_length_test <x86_lengths.txt>\n");
+        return 2;
+    }
+    std::ifstream corpus(argv[1]);
+    if (!corpus) {
+        std::fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 2;
+    }
+
+    std::string line;
+    std::vector<uint8_t> bytes;
+    int lineNumber = 0;
+    int checked = 0;
+    while (std::getline(corpus, line)) {
+        ++lineNumber;
+        std::string text = line.substr(0, line.find('#'));
+        if (text.find_first_not_of(" \t\r") == std::string::npos) continue;
+
+        bool invalid = text.compare(0, 7, "invalid") == 0;
+        if (invalid) text.erase(0, 7);
+        if (!parseHex(text, bytes)) {
+            fail(lineNumber, line, "malformed corpus line");
+            continue;
+        }
+
+        if (invalid) {
+            if (X86::instructionLength(bytes.data(), bytes.size()) != 0) fail(lineNumber, line, "not rejected");
+        } else {
+            checkInstruction(lineNumber, line, bytes);
+        }
+        ++checked;
+    }
+    checkBuiltinPatches();
+
+    std::printf("%d encodings, %d failures\n", checked, g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
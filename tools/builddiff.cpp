@@ -0,0 +1,185 @@
+/**
+ * @file builddiff.cpp
+ * @brief Carries patch sites and table addresses over to a new game build
+ *
+ * Usage: builddiff [-j threads] <old ffxv_s.exe> <new ffxv_s.exe> [rva...]
+ *
+ * Aligns the two executables, then maps every built-in patch site (found by
+ * its pattern in the old build), the unlock table, the jump table and any
+ * extra RVAs given to the new build, each with a confidence score. Patch
+ * sites are checked against their pattern in the new build.
+ *
+ * Prints a draft build block for the signature source; entries below
+ * REVIEW_CONFIDENCE or failing the pattern check are commented out.
+ */
+
+#include "BuildDiff.h"
+#include "BuildFingerprint.h"
+#include "MappedFile.h"
+#include "Patches.h"
+#include "PeImage.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr double REVIEW_CONFIDENCE = 0.6;
+
+bool loadImage(const char* path, std::vector<uint8_t>& image)
+{
+    MappedFile file;
+    if (!file.open(path)) {
+        std::cerr << "builddiff: " << file.getLastError() << "\n";
+        return false;
+    }
+    if (!Pe::mapImage(file.data(), file.size(), image)) {
+        std::cerr << "builddiff: " << path << " is not a PE32+ image\n";
+        return false;
+    }
+    return true;
+}
+
+bool matchesAt(const std::vector<uint8_t>& image, size_t position, const Patches::Patch& patch)
+{
+    if (position > image.size() || image.size() - position < patch.pattern.size) return false;
+    for (size_t i = 0; i < patch.pattern.size; ++i) {
+        uint8_t mask = patch.mask.empty() ? 0xFF : patch.mask[i];
+        if ((image[position + i] & mask) != (patch.pattern[i] & mask)) return false;
+    }
+    return true;
+}
+
+std::optional<uint32_t> findPattern(const std::vector<uint8_t>& image, const Patches::Patch& patch)
+{
+    for (size_t i = 0; i + patch.pattern.size <= image.size(); ++i) {
+        if (matchesAt(image, i, patch)) return static_cast<uint32_t>(i);
+    }
+    return std::nullopt;
+}
+
+std::optional<BuildFingerprint> fingerprintOf(const std::vector<uint8_t>& image)
+{
+    auto reader = [&image](uintptr_t address, void* buffer, size_t size) -> size_t {
+        if (address >= image.size()) return 0;
+        size_t length = std::min(size, image.size() - address);
+        std::memcpy(buffer, image.data() + address, length);
+        return length;
+    };
+    return BuildFingerprint::compute(reader, 0);
+}
+
+void printMapping(const char* label, const BuildDiff::Mapping& mapping, const char* note)
+{
+    std::printf("  %-40s 0x%08X -> 0x%08X  %3.0f%%  %s%s%s\n", label, mapping.oldRva, mapping.newRva,
+                mapping.confidence * 100, BuildDiff::methodName(mapping.method),
+                mapping.interpolated ? ", interpolated" : "", note);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    unsigned threads = 0;
+    int arg = 1;
+    std::vector<uint32_t> extra;
+    try {
+        if (argc > 2 && std::string(argv[1]) == "-j") {
+            threads = static_cast<unsigned>(std::stoul(argv[2]));
+            arg = 3;
+        }
+        for (int i = arg + 2; i < argc; ++i) {
+            size_t used = 0;
+            extra.push_back(static_cast<uint32_t>(std::stoul(argv[i], &used, 0)));
+            if (argv[i][used] != '\0') throw std::invalid_argument(argv[i]);
+        }
+    } catch (const std::exception&) {
+        arg = argc;
+    }
+    if (argc - arg < 2) {
+        std::cerr << "Usage: builddiff [-j threads] <old ffxv_s.exe> <new ffxv_s.exe> [rva...]\n";
+        return 2;
+    }
+
+    std::vector<uint8_t> oldImage, newImage;
+    if (!loadImage(argv[arg], oldImage) || !loadImage(argv[arg + 1], newImage)) return 1;
+
+    BuildDiff diff;
+    if (!diff.build(oldImage.data(), oldImage.size(), newImage.data(), newImage.size(), threads)) {
+        std::cerr << "builddiff: " << diff.getLastError() << "\n";
+        return 1;
+    }
+    const BuildDiff::Stats& stats = diff.stats();
+    std::printf("# %zu -> %zu functions: %zu identical, %zu by anchors, %zu by neighbours\n",
+                stats.oldFunctions, stats.newFunctions, stats.identical, stats.anchored, stats.neighbours);
+    std::printf("# %zu of %zu instructions aligned, %.1f ms on %u threads\n",
+                stats.alignedInstructions, stats.oldInstructions, stats.elapsedMs, stats.threads);
+
+    // Draft lines of the build block, commented out when doubtful
+    std::vector<std::string> lines;
+    char line[256];
+    auto addLine = [&](bool confident, const char* format, auto... values) {
+        std::snprintf(line, sizeof(line), format, values...);
+        lines.push_back(std::string(confident ? "    " : "#   ") + line);
+    };
+
+    std::printf("\nPatch sites (pattern match RVA):\n");
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        auto oldRva = findPattern(oldImage, *patch);
+        if (!oldRva) {
+            std::printf("  %-40s not found in the old build\n", patch->name.c_str());
+            continue;
+        }
+        auto mapping = diff.map(*oldRva);
+        if (!mapping) {
+            std::printf("  %-40s 0x%08X -> unmapped\n", patch->name.c_str(), *oldRva);
+            continue;
+        }
+        bool verified = matchesAt(newImage, mapping->newRva, *patch);
+        printMapping(patch->name.c_str(), *mapping, verified ? ", pattern verified" : ", PATTERN MISMATCH");
+        addLine(verified && mapping->confidence >= REVIEW_CONFIDENCE, "address \"%s\" 0x%X",
+                patch->name.c_str(), mapping->newRva);
+    }
+
+    std::printf("\nTables:\n");
+    struct Table {
+        const char* label;
+        const char* keyword;
+        uint32_t rva;
+    };
+    const Table tables[] = {
+        {"Unlock table", "table_base", static_cast<uint32_t>(Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE)},
+        {"Jump table", "jump_table", static_cast<uint32_t>(Patches::JUMP_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE)},
+    };
+    for (const Table& table : tables) {
+        auto mapping = diff.map(table.rva);
+        if (!mapping) {
+            std::printf("  %-40s 0x%08X -> unmapped\n", table.label, table.rva);
+            continue;
+        }
+        printMapping(table.label, *mapping, "");
+        addLine(mapping->confidence >= REVIEW_CONFIDENCE, "%s 0x%X", table.keyword, mapping->newRva);
+    }
+
+    if (!extra.empty()) std::printf("\nRequested:\n");
+    for (uint32_t rva : extra) {
+        std::snprintf(line, sizeof(line), "0x%X", rva);
+        auto mapping = diff.map(rva);
+        if (!mapping) {
+            std::printf("  %-40s 0x%08X -> unmapped\n", line, rva);
+            continue;
+        }
+        printMapping(line, *mapping, "");
+    }
+
+    auto fingerprint = fingerprintOf(newImage);
+    std::printf("\nbuild \"New build\" 0x%s\n", fingerprint ? fingerprint->toString().c_str() : "0000000000000000");
+    for (const std::string& entry : lines) std::printf("%s\n", entry.c_str());
+    std::printf("end\n");
+    return 0;
+}
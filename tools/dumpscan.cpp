@@ -0,0 +1,318 @@
+/**
+ * @file dumpscan.cpp
+ * @brief Offline scans of a crash dump or raw memory dump of the game
+ *
+ * Usage:
+ *   dumpscan info [-b base] <dump>
+ *   dumpscan check [-b base] <dump>
+ *   dumpscan find [-b base] [-n limit] <dump> <pattern>...
+ *   dumpscan value [-b base] [-n limit] <dump> <type> <value>
+ *
+ * <dump> is a Windows minidump (.dmp) or any other file, taken as raw memory
+ * starting at base (default: ffxv_s.exe's preferred image base, so a module
+ * dumped by RVA reads at its usual addresses).
+ *
+ *   info   memory regions, modules and the ffxv_s.exe build fingerprint
+ *   check  the state of every built-in patch site (original, patched, or
+ *          not found, with near matches) and of the unlock table, as
+ *          MemoryEditor would see them when attaching
+ *   find   addresses of hex patterns ("83 F8 ?? 77", ?? = any byte),
+ *          "s:" ASCII text or "w:" UTF-16LE text
+ *   value  addresses holding a value; type is u8, u16, u32, u64, f32 or f64
+ *
+ * Works on any platform; the dump is memory-mapped, not loaded.
+ */
+
+#include "BuildFingerprint.h"
+#include "FuzzyMatch.h"
+#include "MemoryDump.h"
+#include "PatchSite.h"
+#include "Patches.h"
+#include "UnlockRegistry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr const char* MODULE_NAME = "ffxv_s.exe";
+constexpr unsigned CANDIDATE_MAX_DISTANCE = 2;
+constexpr size_t CANDIDATE_LIMIT = 5;
+constexpr size_t DEFAULT_LIMIT = 100;
+
+void usage()
+{
+    std::cerr << "Usage: dumpscan info [-b base] <dump>\n"
+                 "       dumpscan check [-b base] <dump>\n"
+                 "       dumpscan find [-b base] [-n limit] <dump> <pattern>...\n"
+                 "       dumpscan value [-b base] [-n limit] <dump> <u8|u16|u32|u64|f32|f64> <value>\n"
+                 "Patterns: hex bytes with ?? wildcards, s:<ascii> or w:<utf-16le>\n";
+}
+
+/// fmsearch's pattern syntax plus ?? wildcards; mask is left empty when exact
+bool parsePattern(const std::string& text, std::vector<uint8_t>& bytes, std::vector<uint8_t>& mask)
+{
+    bytes.clear();
+    mask.clear();
+    if (text.compare(0, 2, "s:") == 0) {
+        bytes.assign(text.begin() + 2, text.end());
+        return !bytes.empty();
+    }
+    if (text.compare(0, 2, "w:") == 0) {
+        for (size_t i = 2; i < text.size(); ++i) {
+            bytes.push_back(static_cast<uint8_t>(text[i]));
+            bytes.push_back(0);
+        }
+        return !bytes.empty();
+    }
+
+    std::string digits;
+    for (char c : text) {
+        if (std::isspace(static_cast<unsigned char>(c))) continue;
+        if (c != '?' && !std::isxdigit(static_cast<unsigned char>(c))) return false;
+        digits += c;
+    }
+    if (digits.empty() || digits.size() % 2 != 0) return false;
+    bool wildcards = false;
+    for (size_t i = 0; i < digits.size(); i += 2) {
+        std::string pair = digits.substr(i, 2);
+        if (pair == "??") {
+            bytes.push_back(0);
+            mask.push_back(0);
+            wildcards = true;
+        } else if (pair.find('?') != std::string::npos) {
+            return false;
+        } else {
+            bytes.push_back(static_cast<uint8_t>(std::stoul(pair, nullptr, 16)));
+            mask.push_back(0xFF);
+        }
+    }
+    if (!wildcards) mask.clear();
+    return true;
+}
+
+/// Little-endian bytes of a value as the game stores it
+bool encodeValue(const std::string& type, const std::string& text, std::vector<uint8_t>& bytes)
+{
+    auto store = [&bytes](const void* value, size_t size) {
+        const uint8_t* p = static_cast<const uint8_t*>(value);
+        bytes.assign(p, p + size);
+        return true;
+    };
+    try {
+        if (type == "f32") {
+            float value = std::stof(text);
+            return store(&value, sizeof(value));
+        }
+        if (type == "f64") {
+            double value = std::stod(text);
+            return store(&value, sizeof(value));
+        }
+        unsigned long long value = text[0] == '-' ? static_cast<unsigned long long>(std::stoll(text, nullptr, 0))
+                                                  : std::stoull(text, nullptr, 0);
+        if (type == "u8") return store(&value, 1);
+        if (type == "u16") return store(&value, 2);
+        if (type == "u32") return store(&value, 4);
+        if (type == "u64") return store(&value, 8);
+    } catch (const std::exception&) {
+    }
+    return false;
+}
+
+/// The game module in the dump; a raw dump is taken as the module itself
+bool locateModule(const MemoryDump& dump, uint64_t& base, uint64_t& size)
+{
+    if (const MemoryDump::Module* module = dump.findModule(MODULE_NAME)) {
+        base = module->base;
+        size = module->size;
+        return true;
+    }
+    if (dump.format() == MemoryDump::Format::Raw) {
+        base = dump.regions().front().address;
+        size = dump.regions().front().size;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Match start of a patch site, original or patched
+ *
+ * Tries the RVA hint, then the pattern. An applied patch no longer matches
+ * its pattern, so the last resort searches the bytes the patch leaves alone
+ * and keeps the first candidate PatchSite accepts.
+ */
+std::optional<uint64_t> locateSite(const MemoryDump& dump, uint64_t base, uint64_t size, const Patches::Patch& patch)
+{
+    MemoryReader read = dump.reader();
+    if (auto site = PatchSite::atHint(read, static_cast<uintptr_t>(base), patch)) return *site;
+    if (auto site = dump.findPattern(base, size, patch.pattern, patch.mask)) return site;
+
+    std::vector<uint8_t> mask = patch.mask.empty() ? std::vector<uint8_t>(patch.pattern.size, 0xFF)
+                                                   : patch.mask.toVector();
+    for (ptrdiff_t i = std::max<ptrdiff_t>(patch.offset, 0);
+         i < patch.offset + ptrdiff_t(patch.patched.size) && size_t(i) < mask.size(); ++i) {
+        mask[size_t(i)] = 0;
+    }
+    if (std::all_of(mask.begin(), mask.end(), [](uint8_t m) { return m == 0; })) return std::nullopt;
+
+    for (uint64_t candidate : dump.findAll(base, size, patch.pattern, mask)) {
+        if (PatchSite::matches(read, static_cast<uintptr_t>(candidate), patch)) return candidate;
+    }
+    return std::nullopt;
+}
+
+int info(const MemoryDump& dump)
+{
+    std::printf("%s, %zu regions, %llu bytes\n",
+                dump.format() == MemoryDump::Format::Minidump ? "minidump" : "raw dump",
+                dump.regions().size(), static_cast<unsigned long long>(dump.totalSize()));
+    for (const MemoryDump::Region& region : dump.regions()) {
+        std::printf("  %016llX-%016llX\n", static_cast<unsigned long long>(region.address),
+                    static_cast<unsigned long long>(region.address + region.size));
+    }
+    if (!dump.modules().empty()) std::printf("%zu modules\n", dump.modules().size());
+    for (const MemoryDump::Module& module : dump.modules()) {
+        std::printf("  %016llX %08X %s\n", static_cast<unsigned long long>(module.base), module.size,
+                    module.name.c_str());
+    }
+
+    uint64_t base = 0, size = 0;
+    if (!locateModule(dump, base, size)) {
+        std::printf("%s not in the module list\n", MODULE_NAME);
+        return 0;
+    }
+    auto fingerprint = BuildFingerprint::compute(dump.reader(), static_cast<uintptr_t>(base));
+    std::printf("%s at 0x%llX, fingerprint %s\n", MODULE_NAME, static_cast<unsigned long long>(base),
+                fingerprint ? fingerprint->toString().c_str() : "unavailable (headers not in dump)");
+    return 0;
+}
+
+int check(const MemoryDump& dump)
+{
+    uint64_t base = 0, size = 0;
+    if (!locateModule(dump, base, size)) {
+        std::cerr << "dumpscan: " << MODULE_NAME << " not in the module list\n";
+        return 1;
+    }
+    std::printf("%s at 0x%llX (0x%llX bytes)\n", MODULE_NAME, static_cast<unsigned long long>(base),
+                static_cast<unsigned long long>(size));
+
+    std::printf("\nPatch sites:\n");
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        if (auto address = locateSite(dump, base, size, *patch)) {
+            std::vector<uint8_t> current(patch->patched.size);
+            bool patched = dump.read(*address + patch->offset, current.data(), current.size()) == current.size() &&
+                           std::equal(current.begin(), current.end(), patch->patched.begin());
+            std::printf("  %-40s %s 0x%llX\n", patch->name.c_str(), patched ? "PATCHED  " : "original ",
+                        static_cast<unsigned long long>(*address - base));
+            continue;
+        }
+
+        std::printf("  %-40s not found\n", patch->name.c_str());
+        unsigned distance = std::min(CANDIDATE_MAX_DISTANCE, Fuzzy::maxUsefulDistance(patch->pattern, patch->mask));
+        for (const Fuzzy::Match& match :
+             dump.findPatternFuzzy(base, size, patch->pattern, patch->mask, distance, CANDIDATE_LIMIT)) {
+            std::printf("      near 0x%llX: %s\n", static_cast<unsigned long long>(match.offset),
+                        match.describe().c_str());
+        }
+    }
+
+    std::printf("\nUnlock table:\n");
+    uint64_t table = base + (Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+    size_t enabled = 0, missing = 0;
+    UnlockRegistry registry;
+    registry.rebuild();
+    for (size_t i = 0; i < registry.itemCount(); ++i) {
+        uint8_t value = 0;
+        if (dump.read(table + registry.itemId(i), &value, 1) != 1) {
+            ++missing;
+            continue;
+        }
+        if (value == 0) continue;
+        std::string name(registry.itemName(i));
+        std::printf("  0x%02X %-40s %02X\n", registry.itemId(i), name.c_str(), value);
+        ++enabled;
+    }
+    std::printf("  %zu enabled%s\n", enabled, missing ? ", table not (fully) in dump" : "");
+    return 0;
+}
+
+int find(const MemoryDump& dump, size_t limit, int argc, char* argv[], int arg)
+{
+    for (int i = arg; i < argc; ++i) {
+        std::vector<uint8_t> pattern, mask;
+        if (!parsePattern(argv[i], pattern, mask)) {
+            std::cerr << "dumpscan: bad pattern: " << argv[i] << "\n";
+            return 2;
+        }
+        std::vector<uint64_t> matches = dump.findAll(0, UINT64_MAX, pattern, mask, limit);
+        std::printf("%s: %zu%s\n", argv[i], matches.size(), matches.size() == limit ? "+" : "");
+        for (uint64_t address : matches) std::printf("  0x%llX\n", static_cast<unsigned long long>(address));
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        usage();
+        return 2;
+    }
+    std::string command = argv[1];
+    uint64_t rawBase = Patches::DEFAULT_IMAGE_BASE;
+    size_t limit = DEFAULT_LIMIT;
+
+    int arg = 2;
+    try {
+        for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+            std::string option = argv[arg];
+            if (option == "-b") {
+                rawBase = std::stoull(argv[arg + 1], nullptr, 0);
+            } else if (option == "-n") {
+                limit = std::stoul(argv[arg + 1]);
+            } else {
+                arg = argc;
+            }
+        }
+    } catch (const std::exception&) {
+        arg = argc;
+    }
+    if (arg >= argc) {
+        usage();
+        return 2;
+    }
+
+    MemoryDump dump;
+    if (!dump.open(argv[arg], rawBase)) {
+        std::cerr << "dumpscan: " << dump.getLastError() << "\n";
+        return 1;
+    }
+    ++arg;
+
+    if (command == "info" && arg == argc) return info(dump);
+    if (command == "check" && arg == argc) return check(dump);
+    if (command == "find" && arg < argc) return find(dump, limit, argc, argv, arg);
+    if (command == "value" && argc - arg == 2) {
+        std::vector<uint8_t> bytes;
+        if (!encodeValue(argv[arg], argv[arg + 1], bytes)) {
+            usage();
+            return 2;
+        }
+        std::vector<uint64_t> matches = dump.findAll(0, UINT64_MAX, bytes, {}, limit);
+        std::printf("%s %s: %zu%s\n", argv[arg], argv[arg + 1], matches.size(), matches.size() == limit ? "+" : "");
+        for (uint64_t address : matches) std::printf("  0x%llX\n", static_cast<unsigned long long>(address));
+        return 0;
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,291 @@
+/**
+ * @file fakegame.cpp
+ * @brief Stand-in ffxv_s.exe process on Linux for end-to-end benchmarks
+ *
+ * Usage:
+ *   fakegame [-i ffxv_s.exe] [-b base] [-s size] [-p period_ms] [-t seconds] [-v]
+ *
+ * Maps a module at base (default: the game's preferred image base) and
+ * keeps reading what the unlocker changes, the way the game does:
+ *
+ *   -i  the sections of a real ffxv_s.exe, laid out by RVA
+ *   (default) a SyntheticImage of the given size (default 32 MB), with the
+ *       patch sites, unlock table, jump table and Twitch URLs at the
+ *       reference build's RVAs
+ *
+ * The module is a memfd named ffxv_s.exe, mapped section by section with
+ * .text read/execute and .rdata read-only, so /proc/<pid>/maps lists it
+ * like a loaded module. The process names itself ffxv_s.exe and allows
+ * any process of the same user to read and write its memory.
+ *
+ * Every period (default 100 ms) the unlock table, the jump table, every
+ * patch site and the URL strings are read, and each change is printed:
+ *
+ *   ready <pid> 0x140000000 0x2000000 <fingerprint>
+ *   item 0x27 00 -> 01
+ *   jump 0x20 0x751E10 -> 0x751E00
+ *   patch "Unlock 1 - Bounds Bypass" applied
+ *   url 0x141FF0000 http://localhost:443/kraken/oauth2/...
+ *
+ * Runs until killed or for -t seconds. Output is line-buffered.
+ */
+
+#include "BuildFingerprint.h"
+#include "MappedFile.h"
+#include "Patches.h"
+#include "PeImage.h"
+#include "SyntheticImage.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE 0x100000
+#endif
+
+namespace {
+
+constexpr const char* MODULE_NAME = "ffxv_s.exe";
+constexpr size_t PAGE_SIZE = 0x1000;
+constexpr size_t MAX_URL_LENGTH = 512;
+
+std::atomic<bool> g_stop{false};
+
+void usage()
+{
+    std::cerr << "Usage: fakegame [-i ffxv_s.exe] [-b base] [-s size] [-p period_ms] [-t seconds] [-v]\n";
+}
+
+/// A patch site the loop watches: the original bytes at match + offset
+struct Watch {
+    std::string name;
+    uint32_t rva;
+    std::vector<uint8_t> original;
+    bool applied = false;
+};
+
+/**
+ * @brief Maps the image at base through a memfd named like the game module
+ * @return Module base, or nullptr with the reason printed
+ */
+uint8_t* mapModule(const std::vector<uint8_t>& image, uint64_t base)
+{
+    int fd = memfd_create(MODULE_NAME, MFD_CLOEXEC);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(image.size())) != 0 ||
+        write(fd, image.data(), image.size()) != static_cast<ssize_t>(image.size())) {
+        std::perror("fakegame: memfd");
+        return nullptr;
+    }
+    void* mapped = mmap(reinterpret_cast<void*>(base), image.size(), PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED_NOREPLACE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED || reinterpret_cast<uint64_t>(mapped) != base) {
+        std::fprintf(stderr, "fakegame: cannot map 0x%zX bytes at 0x%llX\n", image.size(),
+                     static_cast<unsigned long long>(base));
+        return nullptr;
+    }
+
+    // Page protections as the loader sets them; writes from outside go
+    // through /proc/<pid>/mem, which is not bound by them
+    Pe::Headers headers;
+    uint8_t* module = static_cast<uint8_t*>(mapped);
+    if (Pe::parseHeaders(module, PAGE_SIZE, headers)) {
+        mprotect(module, PAGE_SIZE, PROT_READ);
+        for (const Pe::Section& section : headers.sections) {
+            size_t size = (section.virtualSize + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+            if (section.virtualAddress + size > image.size()) continue;
+            int protection = PROT_READ;
+            if (section.isExecutable()) protection |= PROT_EXEC;
+            if (section.isWritable()) protection |= PROT_WRITE;
+            mprotect(module + section.virtualAddress, size, protection);
+        }
+    }
+    return module;
+}
+
+/// Code patch sites found in the image; a real build may lack some
+std::vector<Watch> patchWatches(const std::vector<uint8_t>& image)
+{
+    std::vector<Watch> watches;
+    for (const Patches::Patch* patch : Patches::getAllPatches()) {
+        if (patch->section == Patches::SectionHint::RData) continue;
+        for (size_t i = 0; i + patch->pattern.size <= image.size(); ++i) {
+            bool match = true;
+            for (size_t b = 0; b < patch->pattern.size && match; ++b) {
+                uint8_t mask = patch->mask.empty() ? 0xFF : patch->mask[b];
+                match = (image[i + b] & mask) == (patch->pattern[b] & mask);
+            }
+            if (match) {
+                watches.push_back({patch->name, static_cast<uint32_t>(i + patch->offset), patch->original.toVector()});
+                break;
+            }
+        }
+    }
+    return watches;
+}
+
+/// Offsets of the URL strings the game builds requests from
+std::vector<uint32_t> urlOffsets(const uint8_t* module, size_t size)
+{
+    std::vector<uint32_t> offsets;
+    for (const char* prefix : {Patches::TWITCH_API_PREFIX, Patches::TWITCH_BLOG_PREFIX}) {
+        size_t length = std::strlen(prefix);
+        for (const uint8_t* at = module; (at = static_cast<const uint8_t*>(
+                 memmem(at, size - (at - module), prefix, length))) != nullptr; ++at) {
+            offsets.push_back(static_cast<uint32_t>(at - module));
+        }
+    }
+    return offsets;
+}
+
+void run(volatile const uint8_t* module, uint64_t base, size_t size, std::vector<Watch>& watches, int periodMs,
+         int seconds)
+{
+    const uint32_t tableRva = static_cast<uint32_t>(Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+    const uint32_t jumpTableRva = static_cast<uint32_t>(Patches::JUMP_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+    const size_t tableSize = jumpTableRva - tableRva;
+
+    std::vector<uint8_t> items(tableSize);
+    std::vector<uint32_t> jumps(Patches::JUMP_TABLE_ENTRIES);
+    std::vector<uint32_t> urls = urlOffsets(const_cast<const uint8_t*>(module), size);
+    std::vector<std::string> urlText(urls.size());
+    bool first = true;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (!g_stop.load() && (seconds == 0 || std::chrono::steady_clock::now() < deadline)) {
+        // Phase 4: the item byte table
+        for (size_t id = 0; id < tableSize; ++id) {
+            uint8_t value = module[tableRva + id];
+            if (!first && value != items[id]) std::printf("item 0x%02zX %02X -> %02X\n", id, items[id], value);
+            items[id] = value;
+        }
+
+        // Phase 6: the dispatch targets
+        for (size_t i = 0; i < jumps.size(); ++i) {
+            uint32_t target = 0;
+            for (size_t b = 0; b < 4; ++b) target |= uint32_t(module[jumpTableRva + i * 4 + b]) << (8 * b);
+            if (!first && target != jumps[i]) {
+                std::printf("jump 0x%02zX 0x%X -> 0x%X\n", i + Patches::JUMP_TABLE_FIRST_ITEM, jumps[i], target);
+            }
+            jumps[i] = target;
+        }
+
+        // The code the unlock checks run through
+        for (Watch& watch : watches) {
+            bool original = true;
+            for (size_t b = 0; b < watch.original.size(); ++b) {
+                original &= module[watch.rva + b] == watch.original[b];
+            }
+            if (original == watch.applied) {
+                std::printf("patch \"%s\" %s\n", watch.name.c_str(), original ? "restored" : "applied");
+                watch.applied = !original;
+            }
+        }
+
+        // The URLs requests are built from
+        for (size_t i = 0; i < urls.size(); ++i) {
+            std::string text;
+            for (size_t b = 0; b < MAX_URL_LENGTH && urls[i] + b < size && module[urls[i] + b]; ++b) {
+                text += static_cast<char>(module[urls[i] + b]);
+            }
+            if (!first && text != urlText[i]) {
+                std::printf("url 0x%llX %s\n", static_cast<unsigned long long>(base + urls[i]),
+                            text.c_str());
+            }
+            urlText[i] = std::move(text);
+        }
+
+        first = false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(periodMs));
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string imagePath;
+    uint64_t base = Patches::DEFAULT_IMAGE_BASE;
+    size_t size = SyntheticImage::DEFAULT_SIZE;
+    int periodMs = 100;
+    int seconds = 0;
+    bool verbose = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "-v") {
+                verbose = true;
+                continue;
+            }
+            if (i + 1 >= argc) throw std::invalid_argument(option);
+            std::string value = argv[++i];
+            if (option == "-i") imagePath = value;
+            else if (option == "-b") base = std::stoull(value, nullptr, 0);
+            else if (option == "-s") size = std::stoull(value, nullptr, 0);
+            else if (option == "-p") periodMs = std::stoi(value);
+            else if (option == "-t") seconds = std::stoi(value);
+            else throw std::invalid_argument(option);
+        }
+    } catch (const std::exception&) {
+        usage();
+        return 2;
+    }
+
+    std::vector<uint8_t> image;
+    SyntheticImage::Image synthetic;
+    if (!imagePath.empty()) {
+        MappedFile file;
+        if (!file.open(imagePath)) {
+            std::cerr << "fakegame: " << file.getLastError() << "\n";
+            return 1;
+        }
+        if (!Pe::mapImage(file.data(), file.size(), image)) {
+            std::cerr << "fakegame: " << imagePath << " is not a PE32+ image\n";
+            return 1;
+        }
+    } else {
+        if (!SyntheticImage::build(size, base, synthetic)) {
+            std::cerr << "fakegame: image size must be at least 0x" << std::hex << SyntheticImage::MIN_SIZE << "\n";
+            return 2;
+        }
+        image = synthetic.bytes;
+    }
+    image.resize((image.size() + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1));
+
+    uint8_t* module = mapModule(image, base);
+    if (!module) return 1;
+
+    prctl(PR_SET_NAME, MODULE_NAME);
+    prctl(PR_SET_PTRACER, PR_SET_PTRACER_ANY);
+    std::signal(SIGINT, [](int) { g_stop.store(true); });
+    std::signal(SIGTERM, [](int) { g_stop.store(true); });
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+
+    MemoryReader self = [](uintptr_t address, void* buffer, size_t bytes) {
+        std::memcpy(buffer, reinterpret_cast<const void*>(address), bytes);
+        return bytes;
+    };
+    auto fingerprint = BuildFingerprint::compute(self, reinterpret_cast<uintptr_t>(module));
+    std::printf("ready %d 0x%llX 0x%zX %s\n", static_cast<int>(getpid()), static_cast<unsigned long long>(base),
+                image.size(), fingerprint ? fingerprint->toString().c_str() : "-");
+    if (verbose) {
+        for (const SyntheticImage::Site& site : synthetic.sites) {
+            std::printf("site 0x%06X %s\n", site.rva, site.name.c_str());
+        }
+    }
+
+    std::vector<Watch> watches = patchWatches(image);
+    run(module, base, image.size(), watches, periodMs, seconds);
+    return 0;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file fmsearch.cpp
+ * @brief Substring search over a game image or memory dump via an FM-index
+ *
+ * Usage:
+ *   fmsearch build [-j threads] <image> <index.fmi>
+ *   fmsearch count <index.fmi> <pattern>...
+ *   fmsearch locate [-n limit] <index.fmi> <pattern>...
+ *
+ * <image> is a PE32+ executable (laid out by RVA, so locations are RVAs) or
+ * any other file, taken as a raw dump (locations are file offsets).
+ *
+ * Patterns are hex bytes ("83F833" or "83 F8 33"), "s:" followed by ASCII
+ * text ("s:FFXV_TP_"), or "w:" followed by text to search as UTF-16LE
+ * ("w:api.twitch.tv").
+ *
+ * build prints the time of each construction phase, so the tool doubles as
+ * the construction benchmark.
+ */
+
+#include "FmIndex.h"
+#include "MappedFile.h"
+#include "PeImage.h"
+
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+void usage()
+{
+    std::cerr << "Usage: fmsearch build [-j threads] <image> <index.fmi>\n"
+                 "       fmsearch count <index.fmi> <pattern>...\n"
+                 "       fmsearch locate [-n limit] <index.fmi> <pattern>...\n"
+                 "Patterns: hex bytes, s:<ascii> or w:<utf-16le>\n";
+}
+
+bool parsePattern(const std::string& text, std::vector<uint8_t>& bytes)
+{
+    bytes.clear();
+    if (text.compare(0, 2, "s:") == 0) {
+        bytes.assign(text.begin() + 2, text.end());
+        return !bytes.empty();
+    }
+    if (text.compare(0, 2, "w:") == 0) {
+        for (size_t i = 2; i < text.size(); ++i) {
+            bytes.push_back(static_cast<uint8_t>(text[i]));
+            bytes.push_back(0);
+        }
+        return !bytes.empty();
+    }
+
+    std::string digits;
+    for (char c : text) {
+        if (std::isspace(static_cast<unsigned char>(c))) continue;
+        if (!std::isxdigit(static_cast<unsigned char>(c))) return false;
+        digits += c;
+    }
+    if (digits.empty() || digits.size() % 2 != 0) return false;
+    for (size_t i = 0; i < digits.size(); i += 2) {
+        bytes.push_back(static_cast<uint8_t>(std::stoul(digits.substr(i, 2), nullptr, 16)));
+    }
+    return true;
+}
+
+int build(int argc, char* argv[])
+{
+    unsigned threads = 0;
+    int arg = 2;
+    if (argc > arg + 1 && std::string(argv[arg]) == "-j") {
+        threads = static_cast<unsigned>(std::stoul(argv[arg + 1]));
+        arg += 2;
+    }
+    if (argc - arg != 2) {
+        usage();
+        return 2;
+    }
+
+    MappedFile file;
+    if (!file.open(argv[arg])) {
+        std::cerr << "fmsearch: " << file.getLastError() << "\n";
+        return 1;
+    }
+
+    // A PE file is searched as the loader maps it; anything else as is
+    std::vector<uint8_t> image;
+    const uint8_t* text = file.data();
+    size_t size = file.size();
+    bool isPe = Pe::mapImage(file.data(), file.size(), image);
+    if (isPe) {
+        text = image.data();
+        size = image.size();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    FmIndex index;
+    FmIndex::BuildStats stats;
+    if (!index.build(text, size, threads, &stats)) {
+        std::cerr << "fmsearch: " << index.getLastError() << "\n";
+        return 1;
+    }
+    double total = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%s: %zu bytes (%s), %u threads\n", argv[arg], size, isPe ? "PE image" : "raw", stats.threads);
+    std::printf("  suffix sort  %10.1f ms\n", stats.suffixSortMs);
+    std::printf("  bwt          %10.1f ms\n", stats.bwtMs);
+    std::printf("  rank tables  %10.1f ms\n", stats.rankMs);
+    std::printf("  samples      %10.1f ms\n", stats.sampleMs);
+    std::printf("  total        %10.1f ms (%.1f MB/s), %zu bytes in memory\n", total,
+                size / 1048576.0 / (total / 1000.0), index.memoryUsage());
+
+    if (!index.save(argv[arg + 1])) {
+        std::cerr << "fmsearch: cannot write " << argv[arg + 1] << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+int query(int argc, char* argv[], bool locate)
+{
+    size_t limit = 0;
+    int arg = 2;
+    if (locate && argc > arg + 1 && std::string(argv[arg]) == "-n") {
+        limit = std::stoul(argv[arg + 1]);
+        arg += 2;
+    }
+    if (argc - arg < 2) {
+        usage();
+        return 2;
+    }
+
+    FmIndex index;
+    if (!index.load(argv[arg])) {
+        std::cerr << "fmsearch: " << argv[arg] << ": " << index.getLastError() << "\n";
+        return 1;
+    }
+
+    int status = 0;
+    for (int i = arg + 1; i < argc; ++i) {
+        std::vector<uint8_t> pattern;
+        if (!parsePattern(argv[i], pattern)) {
+            std::cerr << "fmsearch: invalid pattern " << argv[i] << "\n";
+            status = 1;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        if (!locate) {
+            size_t hits = index.count(pattern);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::printf("%s: %zu (%.3f ms)\n", argv[i], hits, ms);
+            continue;
+        }
+
+        std::vector<uint32_t> positions = index.locate(pattern, limit);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%s: %zu shown (%.3f ms)\n", argv[i], positions.size(), ms);
+        for (uint32_t position : positions) {
+            std::printf("  0x%X\n", position);
+        }
+    }
+    return status;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::string command = argc > 1 ? argv[1] : "";
+    try {
+        if (command == "build") return build(argc, argv);
+        if (command == "count") return query(argc, argv, false);
+        if (command == "locate") return query(argc, argv, true);
+    } catch (const std::exception&) {
+        // Only the numeric option parsing throws
+    }
+    usage();
+    return 2;
+}
@@ -0,0 +1,304 @@
+/**
+ * @file procscan.cpp
+ * @brief Times attach, scan and apply against a live process on Linux
+ *
+ * Usage:
+ *   procscan [-a] [-n rounds] <pid|name>
+ *   procscan [-a] [-n rounds] [-t threads] [-p profile] <pid|name>...
+ *
+ * Runs the steps MemoryEditor takes on attach against a running process,
+ * normally fakegame (name ffxv_s.exe), through ProcessMemory:
+ *
+ *   attach       open the process
+ *   module       find ffxv_s.exe in its memory map
+ *   fingerprint  BuildFingerprint::compute over the live module
+ *   scan         every built-in patch pattern and both table references
+ *   apply        (-a) write every code patch and enable every unlock item,
+ *   restore      then write the original bytes back
+ *
+ * Each step is repeated for the given number of rounds (default 5) and
+ * reported as min / median / max milliseconds, followed by where each
+ * pattern was found.
+ *
+ * Given several processes, or a profile, all of them are driven together
+ * through a SessionManager instead (threads: at most that many at once,
+ * 0 = one per process):
+ *
+ *   attach       open every process and find its module
+ *   prepare      identify each build, locate and check the patch sites
+ *   apply        (-a) write the patches and unlock bytes on every process,
+ *   restore      then put the original bytes back
+ *
+ * The patches and bytes are the profile's items, bundles and patches, or
+ * by default Unlock 1 and 2 with every unlock byte. A name picks the first
+ * process with that name, so several instances are given by PID. The
+ * timings are followed by each process's build and state.
+ */
+
+#include "BuildFingerprint.h"
+#include "Patches.h"
+#include "ProcessMemory.h"
+#include "SessionManager.h"
+#include "UnlockProfile.h"
+#include "UnlockRegistry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr const char* MODULE_NAME = "ffxv_s.exe";
+
+void usage()
+{
+    std::cerr << "Usage: procscan [-a] [-n rounds] <pid|name>\n"
+                 "       procscan [-a] [-n rounds] [-t threads] [-p profile] <pid|name>...\n";
+}
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+struct Site {
+    std::string name;
+    uint64_t address;               ///< Of the patch (match + offset)
+    std::vector<uint8_t> original;
+    std::vector<uint8_t> patched;
+};
+
+/// Step timings in the order the steps first ran
+class Timings {
+public:
+    void record(const char* step, double ms)
+    {
+        if (!m_timings.count(step)) m_order.push_back(step);
+        m_timings[step].push_back(ms);
+    }
+
+    void print()
+    {
+        std::printf("  %-12s %10s %10s %10s\n", "step", "min ms", "median ms", "max ms");
+        for (const std::string& step : m_order) {
+            std::vector<double>& values = m_timings[step];
+            std::sort(values.begin(), values.end());
+            std::printf("  %-12s %10.3f %10.3f %10.3f\n", step.c_str(), values.front(), values[values.size() / 2],
+                        values.back());
+        }
+    }
+
+private:
+    std::map<std::string, std::vector<double>> m_timings;
+    std::vector<std::string> m_order;
+};
+
+bool attach(ProcessMemory& process, const std::string& target)
+{
+    bool byPid = target.find_first_not_of("0123456789") == std::string::npos;
+    return byPid ? process.attach(std::atoi(target.c_str())) : process.attachByName(target);
+}
+
+const char* stateName(SessionManager::State state)
+{
+    switch (state) {
+    case SessionManager::State::Added: return "added";
+    case SessionManager::State::Ready: return "ready";
+    case SessionManager::State::Applied: return "applied";
+    case SessionManager::State::Restored: return "restored";
+    case SessionManager::State::Failed: return "failed";
+    }
+    return "?";
+}
+
+/// Several processes through one SessionManager; @return Exit code
+int runSessions(const std::vector<std::string>& targets, const std::string& profilePath, bool apply, int rounds,
+                unsigned threads)
+{
+    UnlockRegistry registry;
+    registry.rebuild();
+    UnlockMask mask = registry.itemMask();
+    std::vector<Patches::Patch*> patches = Patches::getUnlockAllWithWorkshopPatches();
+    if (!profilePath.empty()) {
+        UnlockProfile profile;
+        mask = 0;
+        patches.clear();
+        if (!profile.load(profilePath) || !profile.resolve(registry, mask, patches)) {
+            std::cerr << "procscan: " << profilePath << ": " << profile.getLastError() << "\n";
+            return 1;
+        }
+    }
+
+    Timings timings;
+    std::vector<SessionManager::TargetStatus> status;
+    for (int round = 0; round < rounds; ++round) {
+        SessionManager manager(threads);
+        auto start = Clock::now();
+        for (const std::string& target : targets) {
+            auto process = std::make_unique<ProcessMemory>();
+            if (!attach(*process, target)) {
+                std::cerr << "procscan: " << target << ": " << process->getLastError() << "\n";
+                return 1;
+            }
+            std::optional<ProcessMemory::Module> module = process->findModule(MODULE_NAME);
+            if (!module) {
+                std::cerr << "procscan: " << MODULE_NAME << " is not mapped in process " << process->pid() << "\n";
+                return 1;
+            }
+            std::string name = "pid " + std::to_string(process->pid());
+            manager.add(name, std::move(process), static_cast<uintptr_t>(module->base),
+                        static_cast<size_t>(module->size));
+        }
+        timings.record("attach", elapsedMs(start));
+
+        start = Clock::now();
+        size_t ready = manager.prepare(patches);
+        timings.record("prepare", elapsedMs(start));
+
+        if (apply && ready == targets.size()) {
+            start = Clock::now();
+            manager.apply(patches, mask);
+            timings.record("apply", elapsedMs(start));
+
+            start = Clock::now();
+            manager.restore(patches);
+            timings.record("restore", elapsedMs(start));
+        }
+        status = manager.status();
+    }
+
+    std::printf("%d rounds, %zu processes, %zu patches\n", rounds, targets.size(), patches.size());
+    timings.print();
+    std::printf("\n");
+    bool ok = true;
+    for (const SessionManager::TargetStatus& target : status) {
+        ok &= target.state != SessionManager::State::Failed;
+        std::printf("  %-12s %-18s %-9s %s\n", target.name.c_str(),
+                    target.build ? target.build->toString().c_str() : "-", stateName(target.state),
+                    target.error.c_str());
+    }
+    return ok ? 0 : 1;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool apply = false;
+    int rounds = 5;
+    unsigned threads = 0;
+    std::string profilePath;
+    int arg = 1;
+    for (; arg < argc && argv[arg][0] == '-'; ++arg) {
+        std::string option = argv[arg];
+        if (option == "-a") {
+            apply = true;
+        } else if (option == "-n" && arg + 1 < argc) {
+            rounds = std::max(1, std::atoi(argv[++arg]));
+        } else if (option == "-t" && arg + 1 < argc) {
+            threads = static_cast<unsigned>(std::max(0, std::atoi(argv[++arg])));
+        } else if (option == "-p" && arg + 1 < argc) {
+            profilePath = argv[++arg];
+        } else {
+            usage();
+            return 2;
+        }
+    }
+    if (arg == argc) {
+        usage();
+        return 2;
+    }
+    if (arg + 1 != argc || !profilePath.empty()) {
+        return runSessions(std::vector<std::string>(argv + arg, argv + argc), profilePath, apply, rounds, threads);
+    }
+    std::string target = argv[arg];
+
+    Timings timings;
+
+    std::map<std::string, std::optional<uint64_t>> found;
+    std::optional<BuildFingerprint> fingerprint;
+    ProcessMemory process;
+    for (int round = 0; round < rounds; ++round) {
+        auto start = Clock::now();
+        if (!attach(process, target)) {
+            std::cerr << "procscan: " << process.getLastError() << "\n";
+            return 1;
+        }
+        timings.record("attach", elapsedMs(start));
+
+        start = Clock::now();
+        std::optional<ProcessMemory::Module> module = process.findModule(MODULE_NAME);
+        if (!module) {
+            std::cerr << "procscan: " << MODULE_NAME << " is not mapped in process " << process.pid() << "\n";
+            return 1;
+        }
+        timings.record("module", elapsedMs(start));
+
+        start = Clock::now();
+        fingerprint = BuildFingerprint::compute(process.reader(), static_cast<uintptr_t>(module->base));
+        timings.record("fingerprint", elapsedMs(start));
+
+        start = Clock::now();
+        std::vector<Site> sites;
+        for (const Patches::Patch* patch : Patches::getAllPatches()) {
+            auto match = process.findPattern(module->base, module->size, patch->pattern, patch->mask);
+            found[patch->name] = match;
+            if (match && patch->section != Patches::SectionHint::RData) {
+                sites.push_back({patch->name, *match + patch->offset, patch->original.toVector(),
+                                 patch->patched.toVector()});
+            }
+        }
+        for (const Patches::OperandReference* reference :
+             {&Patches::UNLOCK_TABLE_REFERENCE, &Patches::JUMP_TABLE_REFERENCE}) {
+            found[reference->name] = process.findPattern(module->base, module->size, reference->pattern,
+                                                         reference->mask);
+        }
+        timings.record("scan", elapsedMs(start));
+
+        if (apply) {
+            uint64_t table = module->base + (Patches::UNLOCK_TABLE_BASE - Patches::DEFAULT_IMAGE_BASE);
+            UnlockRegistry registry;
+            registry.rebuild();
+            std::vector<uint8_t> before(registry.itemCount());
+            for (size_t i = 0; i < before.size(); ++i) process.read(table + registry.itemId(i), &before[i], 1);
+
+            start = Clock::now();
+            bool ok = true;
+            for (const Site& site : sites) ok &= process.write(site.address, site.patched.data(), site.patched.size());
+            uint8_t enabled = 1;
+            for (size_t i = 0; i < before.size(); ++i) ok &= process.write(table + registry.itemId(i), &enabled, 1);
+            timings.record("apply", elapsedMs(start));
+
+            start = Clock::now();
+            for (const Site& site : sites) ok &= process.write(site.address, site.original.data(), site.original.size());
+            for (size_t i = 0; i < before.size(); ++i) ok &= process.write(table + registry.itemId(i), &before[i], 1);
+            timings.record("restore", elapsedMs(start));
+            if (!ok) {
+                std::cerr << "procscan: " << process.getLastError() << "\n";
+                return 1;
+            }
+        }
+        process.detach();
+    }
+
+    std::printf("%d rounds, fingerprint %s\n", rounds, fingerprint ? fingerprint->toString().c_str() : "-");
+    timings.print();
+    std::printf("\n");
+    for (const auto& [name, address] : found) {
+        if (address) {
+            std::printf("  %-40s 0x%llX\n", name.c_str(), static_cast<unsigned long long>(*address));
+        } else {
+            std::printf("  %-40s not found\n", name.c_str());
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+/**
+ * @file sigdbc.cpp
+ * @brief Signature database compiler (.fxs text -> .fxsd binary)
+ *
+ * Usage: sigdbc <input.fxs> <output.fxsd>
+ *
+ * The output is loaded back through SignatureDatabase before it is written,
+ * so a file produced by this tool is guaranteed to pass load-time validation.
+ */
+
+#include "SignatureDatabase.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+int main(int argc, char* argv[])
+{
+    if (argc != 3) {
+        std::cerr << "Usage: sigdbc <input.fxs> <output.fxsd>\n";
+        return 2;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::cerr << "sigdbc: cannot read " << argv[1] << "\n";
+        return 1;
+    }
+    std::stringstream source;
+    source << input.rdbuf();
+
+    std::vector<uint8_t> binary;
+    std::string error;
+    if (!SignatureDatabase::compile(source.str(), binary, error)) {
+        std::cerr << argv[1] << ": " << error << "\n";
+        return 1;
+    }
+
+    SignatureDatabase check;
+    if (!check.loadFromMemory(binary.data(), binary.size())) {
+        std::cerr << "sigdbc: compiled output failed validation: " << check.getLastError() << "\n";
+        return 1;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary | std::ios::trunc);
+    if (!output.write(reinterpret_cast<const char*>(binary.data()), binary.size())) {
+        std::cerr << "sigdbc: cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    std::printf("%s: version %u, %zu patches, %zu items, %zu bundles, %zu builds, %zu bytes\n",
+                argv[2], check.dataVersion(), check.patchCount(), check.itemCount(),
+                check.bundleCount(), check.buildCount(), binary.size());
+    return 0;
+}
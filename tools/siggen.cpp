@@ -0,0 +1,118 @@
+/**
+ * @file siggen.cpp
+ * @brief Unique signature generator for code addresses in a game build
+ *
+ * Usage: siggen [-i <index.fxng>] <ffxv_s.exe> <rva> [rva...]
+ *
+ * Maps the executable the way the loader would, indexes the image once and
+ * prints a .fxs pattern line for each RVA (decimal or 0x-prefixed hex),
+ * ready to paste into a patch block.
+ *
+ * With -i the index is loaded from the given file if it was built for this
+ * executable, and otherwise built and saved there for the next run.
+ */
+
+#include "BuildFingerprint.h"
+#include "MappedFile.h"
+#include "NgramIndex.h"
+#include "PeImage.h"
+#include "SignatureGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int first = 1;
+    std::string indexPath;
+    if (argc > 2 && std::string(argv[1]) == "-i") {
+        indexPath = argv[2];
+        first = 3;
+    }
+    if (argc - first < 2) {
+        std::cerr << "Usage: siggen [-i <index.fxng>] <ffxv_s.exe> <rva> [rva...]\n";
+        return 2;
+    }
+    const char* exePath = argv[first];
+
+    MappedFile file;
+    if (!file.open(exePath)) {
+        std::cerr << "siggen: " << file.getLastError() << "\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> image;
+    if (!Pe::mapImage(file.data(), file.size(), image)) {
+        std::cerr << "siggen: " << exePath << " is not a PE32+ image\n";
+        return 1;
+    }
+    file.close();
+
+    auto start = std::chrono::steady_clock::now();
+    NgramIndex index;
+    std::optional<BuildFingerprint> fingerprint;
+    if (!indexPath.empty()) {
+        auto reader = [&image](uintptr_t address, void* buffer, size_t size) -> size_t {
+            if (address >= image.size()) return 0;
+            size_t length = std::min(size, image.size() - address);
+            std::memcpy(buffer, image.data() + address, length);
+            return length;
+        };
+        fingerprint = BuildFingerprint::compute(reader, 0);
+    }
+
+    if (fingerprint && index.load(indexPath, fingerprint->hash, image.size(), image.data())) {
+        std::printf("# %s: index loaded in %.1f ms\n", indexPath.c_str(), millisecondsSince(start));
+    } else {
+        if (!index.build(image.data(), image.size())) {
+            std::cerr << "siggen: cannot index " << exePath << ": " << index.getLastError() << "\n";
+            return 1;
+        }
+        std::printf("# %s: %zu bytes indexed in %.1f ms (%zu bytes of postings)\n", exePath, image.size(),
+                    millisecondsSince(start), index.postingsSize());
+        if (fingerprint && !index.save(indexPath, fingerprint->hash)) {
+            std::cerr << "siggen: cannot write " << indexPath << "\n";
+        }
+    }
+
+    SignatureGenerator generator(index);
+    int status = 0;
+    for (int i = first + 1; i < argc; ++i) {
+        uint32_t rva = 0;
+        try {
+            size_t used = 0;
+            rva = static_cast<uint32_t>(std::stoul(argv[i], &used, 0));
+            if (argv[i][used] != '\0') throw std::invalid_argument(argv[i]);
+        } catch (const std::exception&) {
+            std::cerr << "siggen: invalid RVA " << argv[i] << "\n";
+            status = 1;
+            continue;
+        }
+
+        start = std::chrono::steady_clock::now();
+        SignatureGenerator::Signature signature;
+        if (!generator.generate(rva, signature)) {
+            std::cerr << "siggen: " << generator.getLastError() << "\n";
+            status = 1;
+            continue;
+        }
+        std::printf("# 0x%X: %zu bytes, %zu instructions, %.2f ms\n", rva, signature.pattern.size(),
+                    signature.instructions, millisecondsSince(start));
+        std::printf("    pattern %s\n", signature.toString().c_str());
+    }
+    return status;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file urlscan.cpp
+ * @brief Lists the strings / URLs in a game build and drafts redirect patches
+ *
+ * Usage: urlscan [-a] [-f] [-m min_length] [-p port] <ffxv_s.exe|dump>
+ *
+ * Sweeps the data sections of a PE32+ executable (laid out by RVA), or the
+ * whole file for a raw dump (file offsets), for printable ASCII and UTF-16LE
+ * strings of at least min_length characters (default 6).
+ *
+ *   (default)  URLs only, as "rva encoding text"
+ *   -a         every string
+ *   -f         a .fxs patch block per URL that a localhost:<port> redirect
+ *              fits in, ready to review and paste into the signature source
+ *              (implies URLs only)
+ *
+ * URLs the built-in redirect patches already cover are marked and get no
+ * patch block.
+ */
+
+#include "MappedFile.h"
+#include "Patches.h"
+#include "PeImage.h"
+#include "StringExtractor.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct Region {
+    const uint8_t* data;
+    size_t size;
+    uint32_t rva;
+    const char* section;    ///< .fxs section hint
+};
+
+const char* sectionHint(const Pe::Section& section)
+{
+    if (section.name == ".rdata") return "rdata";
+    if (section.name == ".data") return "data";
+    return "any";
+}
+
+/// Built-in URL patch whose pattern starts at this string, if any
+const Patches::Patch* builtinPatch(const Strings::Record& url)
+{
+    if (url.encoding != Strings::Encoding::Ascii) return nullptr;
+    std::string bytes = url.text;
+    if (url.terminated) bytes += '\0';
+    for (const Patches::Patch* patch : Patches::getURLPatches()) {
+        if (patch->pattern.size <= bytes.size() &&
+            std::memcmp(patch->pattern.data, bytes.data(), patch->pattern.size) == 0) {
+            return patch;
+        }
+    }
+    return nullptr;
+}
+
+/// .fxs byte list: quoted runs of printable ASCII, hex bytes for the rest
+std::string fxsBytes(const std::vector<uint8_t>& bytes, bool quoteText)
+{
+    std::string out;
+    bool inQuote = false;
+    char hex[4];
+    for (uint8_t c : bytes) {
+        bool printable = quoteText && c >= 0x20 && c <= 0x7E;
+        if (printable != inQuote) {
+            if (!out.empty()) out += inQuote ? "\" " : " ";
+            if (printable) out += '"';
+            inQuote = printable;
+        } else if (!printable && !out.empty()) {
+            out += ' ';
+        }
+        if (printable) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += static_cast<char>(c);
+        } else {
+            std::snprintf(hex, sizeof(hex), "%02X", c);
+            out += hex;
+        }
+    }
+    if (inQuote) out += '"';
+    return out;
+}
+
+std::string hostOf(const std::string& url)
+{
+    size_t begin = url.find("://") + 3;
+    size_t end = url.find_first_of("/:?#", begin);
+    return url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+}
+
+void printPatch(const Strings::Record& url, const Strings::Redirect& redirect, const char* section)
+{
+    bool ascii = url.encoding == Strings::Encoding::Ascii;
+    std::string host = hostOf(url.text);
+    std::printf("patch \"%s URL Redirect 0x%X\" \"Redirects %s%s to localhost\"\n",
+                host.c_str(), url.rva, host.c_str(), ascii ? "" : " (UTF-16)");
+    std::printf("    section %s\n", section);
+    std::printf("    pattern %s\n", fxsBytes(redirect.original, ascii).c_str());
+    std::printf("    offset 0\n");
+    std::printf("    original %s\n", fxsBytes(redirect.original, ascii).c_str());
+    std::printf("    patched %s\n", fxsBytes(redirect.patched, ascii).c_str());
+    std::printf("end\n\n");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    bool all = false;
+    bool patches = false;
+    size_t minLength = Strings::DEFAULT_MIN_LENGTH;
+    uint16_t port = Patches::REDIRECT_PORT;
+
+    int arg = 1;
+    try {
+        for (; arg < argc - 1 && argv[arg][0] == '-'; ++arg) {
+            std::string option = argv[arg];
+            if (option == "-a") {
+                all = true;
+            } else if (option == "-f") {
+                patches = true;
+            } else if (option == "-m" && arg + 2 < argc) {
+                minLength = std::stoul(argv[++arg]);
+            } else if (option == "-p" && arg + 2 < argc) {
+                port = static_cast<uint16_t>(std::stoul(argv[++arg]));
+            } else {
+                arg = argc;
+            }
+        }
+    } catch (const std::exception&) {
+        arg = argc;
+    }
+    if (arg != argc - 1 || minLength == 0) {
+        std::cerr << "Usage: urlscan [-a] [-f] [-m min_length] [-p port] <ffxv_s.exe|dump>\n";
+        return 2;
+    }
+
+    MappedFile file;
+    if (!file.open(argv[arg])) {
+        std::cerr << "urlscan: " << file.getLastError() << "\n";
+        return 1;
+    }
+
+    // Data sections of a PE image; a dump is searched whole
+    std::vector<uint8_t> image;
+    std::vector<Region> regions;
+    Pe::Headers headers;
+    if (Pe::mapImage(file.data(), file.size(), image) && Pe::parseHeaders(image.data(), image.size(), headers)) {
+        for (const Pe::Section& section : headers.sections) {
+            if (section.isExecutable() || section.virtualAddress >= image.size()) continue;
+            size_t size = std::min<size_t>(section.virtualSize, image.size() - section.virtualAddress);
+            regions.push_back({image.data() + section.virtualAddress, size, section.virtualAddress, sectionHint(section)});
+        }
+    } else {
+        regions.push_back({file.data(), file.size(), 0, "any"});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<Strings::Record, const char*>> found;
+    size_t swept = 0;
+    for (const Region& region : regions) {
+        std::vector<Strings::Record> records = Strings::extract(region.data, region.size, region.rva, minLength);
+        if (!all || patches) records = Strings::urls(records);
+        for (Strings::Record& record : records) found.emplace_back(std::move(record), region.section);
+        swept += region.size;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("# %zu strings in %zu bytes, %.1f ms (%.0f MB/s)\n", found.size(), swept, ms,
+                swept / 1048576.0 / (ms / 1000.0));
+
+    size_t drafted = 0;
+    for (const auto& [record, section] : found) {
+        const Patches::Patch* builtin = builtinPatch(record);
+        if (!patches) {
+            std::printf("0x%08X  %-8s  %s%s\n", record.rva, Strings::encodingName(record.encoding),
+                        record.text.c_str(), builtin ? "    # built-in" : "");
+            continue;
+        }
+
+        if (builtin) {
+            std::printf("# 0x%X: covered by \"%s\"\n", record.rva, builtin->name.c_str());
+            continue;
+        }
+        auto redirect = Strings::redirect(record, port);
+        if (!redirect) {
+            std::printf("# 0x%X: localhost:%u does not fit in %s\n", record.rva, port, record.text.c_str());
+            continue;
+        }
+        printPatch(record, *redirect, section);
+        ++drafted;
+    }
+    if (patches) std::printf("# %zu patch blocks\n", drafted);
+    return 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file xrefs.cpp
+ * @brief Lists the code that references an address or range in a game build
+ *
+ * Usage: xrefs [-s] <ffxv_s.exe> <target> [target...]
+ *
+ * A target is an RVA (decimal or 0x-prefixed hex) or an RVA range
+ * "begin-end" (end exclusive), e.g. the unlock table "0x752038-0x75206C".
+ *
+ * The executable sections are swept once into an xref index and every
+ * target is answered from it. With -s each target is scanned for instead,
+ * which is quicker for a single query on a large image.
+ */
+
+#include "MappedFile.h"
+#include "PeImage.h"
+#include "XrefIndex.h"
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool parseTarget(const std::string& text, uint32_t& begin, uint32_t& end)
+{
+    size_t dash = text.find('-', 1);
+    try {
+        begin = static_cast<uint32_t>(std::stoul(text.substr(0, dash), nullptr, 0));
+        end = dash == std::string::npos ? begin + 1
+                                        : static_cast<uint32_t>(std::stoul(text.substr(dash + 1), nullptr, 0));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return begin < end;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int first = 1;
+    bool scanOnly = false;
+    if (argc > 1 && std::string(argv[1]) == "-s") {
+        scanOnly = true;
+        first = 2;
+    }
+    if (argc - first < 2) {
+        std::cerr << "Usage: xrefs [-s] <ffxv_s.exe> <rva|begin-end> [...]\n";
+        return 2;
+    }
+    const char* exePath = argv[first];
+
+    MappedFile file;
+    if (!file.open(exePath)) {
+        std::cerr << "xrefs: " << file.getLastError() << "\n";
+        return 1;
+    }
+
+    std::vector<uint8_t> mapped;
+    Xref::Image image;
+    if (!Pe::mapImage(file.data(), file.size(), mapped) || !image.open(mapped.data(), mapped.size())) {
+        std::cerr << "xrefs: " << exePath << " is not a PE32+ image\n";
+        return 1;
+    }
+    file.close();
+
+    XrefIndex index;
+    if (!scanOnly) {
+        auto start = std::chrono::steady_clock::now();
+        index.build(image);
+        std::printf("# %zu references indexed in %.1f ms\n", index.count(), millisecondsSince(start));
+    }
+
+    int status = 0;
+    for (int i = first + 1; i < argc; ++i) {
+        uint32_t begin, end;
+        if (!parseTarget(argv[i], begin, end)) {
+            std::cerr << "xrefs: invalid target " << argv[i] << "\n";
+            status = 1;
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Xref::Reference> references =
+            scanOnly ? Xref::scan(image, begin, end) : index.referencesTo(begin, end);
+        std::printf("%s: %zu references (%.3f ms)\n", argv[i], references.size(), millisecondsSince(start));
+        for (const Xref::Reference& reference : references) {
+            std::printf("  0x%08X  %-8s -> 0x%X\n", reference.from, Xref::kindName(reference.kind), reference.target);
+        }
+    }
+    return status;
+}